@@ -63,30 +63,30 @@ public:
 
         Entity entity = getScene().createEntity("Floor")
             .add<TransformComponent>(glm::vec3{ 0.f, 1.0f, 0.f }, glm::vec3{ 1.f, 1.f, 1.f }, glm::vec3{ 0.0f, 0.0f, 0.0f })
-            .add<MeshComponent>(quad)
+            .add<MeshComponent>(rm.getHandle(quad))
             .add<MaterialComponent>();/*MaterialComponent::Builder()
-				.setMaterial(stylizedStoneMaterial)
+				.setMaterial(rm.getHandle(stylizedStoneMaterial))
                 .setTilingFactor(2.0f)
 				.build());*/
 
         entity = getScene().createEntity("Left Wall")
             .add<TransformComponent>(glm::vec3{ -1.f, 0.f, 0.f }, glm::vec3{ 1.f, 1.f, 1.f }, glm::vec3{ 0.0f, 0.0f, glm::pi<float>() / 2 })
-            .add<MeshComponent>(quad);
+            .add<MeshComponent>(rm.getHandle(quad));
         entity.addAndGet<MaterialComponent>().tint = glm::vec3{ 1.0f, 0.f, 0.f };
 
         entity = getScene().createEntity("Right Wall")
             .add<TransformComponent>(glm::vec3{ 1.f, 0.f, 0.f }, glm::vec3{ 1.f, 1.f, 1.f }, glm::vec3{ 0.0f, 0.0f, -glm::pi<float>() / 2 })
-            .add<MeshComponent>(quad);
+            .add<MeshComponent>(rm.getHandle(quad));
 		entity.addAndGet<MaterialComponent>().tint = glm::vec3{ 0.f, 1.0f, 0.f };
 
         entity = getScene().createEntity("Front Wall")
             .add<TransformComponent>(glm::vec3{ 0.f, 0.f, 1.f }, glm::vec3{ 1.f, 1.f, 1.f }, glm::vec3{ glm::pi<float>() / 2, 0.0f, 0.0f })
-            .add<MeshComponent>(quad);
+            .add<MeshComponent>(rm.getHandle(quad));
         entity.addAndGet<MaterialComponent>();// .tint = glm::vec3{ 0.f, 0.0f, 1.f };
 
         entity = getScene().createEntity("Roof")
             .add<TransformComponent>(glm::vec3{ 0.f, -1.f, 0.f }, glm::vec3{ 1.f, 1.f, 1.f }, glm::vec3{ glm::pi<float>(), 0.0f, 0.0f })
-            .add<MeshComponent>(quad)
+            .add<MeshComponent>(rm.getHandle(quad))
             .add<MaterialComponent>();
     }
 
@@ -127,21 +127,21 @@ public:
 
         Entity entity = getScene().createEntity("vase")
             .add<TransformComponent>(glm::vec3{ -0.75f, 0.99f, 0.1f }, glm::vec3{ 1.0f, 1.0f, 1.0f }, glm::vec3{0.0f, glm::pi<float>()/4, 0.0f})
-            .add<MeshComponent>(vaseMesh);
+            .add<MeshComponent>(rm.getHandle(vaseMesh));
         entity.addAndGet<MaterialComponent>(MaterialComponent::Builder()
-            .setMaterial(glassMaterial).build()).tint = glm::vec3(0.63f, 0.84f, 0.99f);
+            .setMaterial(rm.getHandle(glassMaterial)).build()).tint = glm::vec3(0.63f, 0.84f, 0.99f);
 
         entity = getScene().createEntity("teapot")
             .add<TransformComponent>(glm::vec3{ 0.5f, 1.0f, 0.7f }, glm::vec3{ 0.15f, 0.15f, 0.15f }, glm::vec3{ glm::pi<float>(), -glm::pi<float>()/1.6, 0.0f })
-            .add<MeshComponent>(teapotMesh);
+            .add<MeshComponent>(rm.getHandle(teapotMesh));
         entity.addAndGet<MaterialComponent>(MaterialComponent::Builder()
-            .setMaterial(metallicMaterial).build()).tint = glm::vec3(0.737, 0.776, 0.8);
+            .setMaterial(rm.getHandle(metallicMaterial)).build()).tint = glm::vec3(0.737, 0.776, 0.8);
 
         entity = getScene().createEntity("vase2")
             .add<TransformComponent>(glm::vec3{ -0.65f, 0.99f, 0.4f }, glm::vec3{ 1.8f, 1.4f, 1.8f }, glm::vec3{ 0.0f, 0.0f, 0.0f })
-            .add<MeshComponent>(vaseMesh);
+            .add<MeshComponent>(rm.getHandle(vaseMesh));
         entity.addAndGet<MaterialComponent>(MaterialComponent::Builder()
-            .setMaterial(glassMaterial).build());// .tint = glm::vec3(0.63f, 0.84f, 0.99f);
+            .setMaterial(rm.getHandle(glassMaterial)).build());// .tint = glm::vec3(0.63f, 0.84f, 0.99f);
 	}
 
     void createRubikCube() {
@@ -162,9 +162,9 @@ public:
 
         Entity entity = getScene().createEntity("rubik")
             .add<TransformComponent>(glm::vec3{ -0.75f, 0.9f, -0.3f }, glm::vec3{ 0.1f, 0.1f, 0.1f }, glm::vec3{ 0.0f, -glm::pi<float>()/2.5, 0.0f})
-            .add<MeshComponent>(rubikMesh)
+            .add<MeshComponent>(rm.getHandle(rubikMesh))
             .add<MaterialComponent>(MaterialComponent::Builder()
-                .setMaterial(rubikMaterial).build());
+                .setMaterial(rm.getHandle(rubikMaterial)).build());
 
     }
 
@@ -188,9 +188,9 @@ public:
 
         Entity entity = getScene().createEntity("lamp")
             .add<TransformComponent>(glm::vec3{ 0.6f, 1.0f, 0.6f }, glm::vec3{ 2.4f, 2.8f, 2.4f }, glm::vec3{ glm::pi<float>(), glm::pi<float>() / 4, 0.0f })
-            .add<MeshComponent>(lampMesh)
+            .add<MeshComponent>(rm.getHandle(lampMesh))
             .add<MaterialComponent>(MaterialComponent::Builder()
-                .setMaterial(lampMaterial).build());
+                .setMaterial(rm.getHandle(lampMaterial)).build());
     }
 
     void createRoofLight() {
@@ -209,9 +209,9 @@ public:
 
         Entity entity = getScene().createEntity("roofLight")
             .add<TransformComponent>(glm::vec3{ 0.0f, -1.1f, 0.0f }, glm::vec3{ 0.25f, 0.25f, 0.25f }, glm::vec3{ glm::pi<float>(), 0.0, 0.0})
-            .add<MeshComponent>(roofLightMesh)
+            .add<MeshComponent>(rm.getHandle(roofLightMesh))
             .add<MaterialComponent>(MaterialComponent::Builder()
-                .setMaterial(roofLightMaterial).build());
+                .setMaterial(rm.getHandle(roofLightMaterial)).build());
     }
 
     void createPencilAndPen() {
@@ -232,15 +232,15 @@ public:
 
         Entity entity = getScene().createEntity("pencil")
             .add<TransformComponent>(glm::vec3{ 0.65f, 0.985f, -0.1f }, glm::vec3{ 0.1f, 0.1f, 0.1f }, glm::vec3{ 0.0f, -glm::pi<float>() / 10, 0.0f })
-            .add<MeshComponent>(pencilMesh)
+            .add<MeshComponent>(rm.getHandle(pencilMesh))
             .add<MaterialComponent>(MaterialComponent::Builder()
-                .setMaterial(pencilMaterial).build());
+                .setMaterial(rm.getHandle(pencilMaterial)).build());
 
         entity = getScene().createEntity("pencil2")
             .add<TransformComponent>(glm::vec3{ 0.55f, 0.985f, 0.0f }, glm::vec3{ 0.1f, 0.1f, 0.1f }, glm::vec3{ 0.0f, -glm::pi<float>() / 12, 0.0f })
-            .add<MeshComponent>(pencilMesh)
+            .add<MeshComponent>(rm.getHandle(pencilMesh))
             .add<MaterialComponent>(MaterialComponent::Builder()
-                .setMaterial(pencilMaterial).build());
+                .setMaterial(rm.getHandle(pencilMaterial)).build());
         
     }
 
@@ -328,12 +328,12 @@ public:
 
         /*auto volumeCubeEntity = getScene().createEntity("Volume Cube")
             .add<TransformComponent>(glm::vec3{ 0.0f, 0.0f, 0.0f }, glm::vec3{ 0.5f }, glm::vec3{ 0.0f, 0.0f, 0.0f })
-            .add<MeshComponent>(cubeModel)
+            .add<MeshComponent>(rm.getHandle(cubeModel))
             .add<VolumeComponent>(VolumeComponent::Builder()
                 .setAbsorption(glm::vec4{ 0.3f })
                 .setScattering(glm::vec4{ 0.3f })
                 .setPhaseFunctionG(0.5f)
-                .setDensityTexture(rm.get<Image>(TEXTURES_PATH + "noise/perlin_worley.png"))
+                .setDensityTexture(rm.getHandle<Image>(TEXTURES_PATH + "noise/perlin_worley.png"))
                 .build());*/
 
         auto emissiveMat = Material::Builder()
@@ -344,9 +344,9 @@ public:
 
         auto emissiveSphere = getScene().createEntity("Emissive sphere")
             .add<TransformComponent>(glm::vec3{ 0.0f, -0.45f, 0.6f }, glm::vec3{ 0.5f }, glm::vec3{ 0.0f, 0.0f, 0.0f })
-            .add<MeshComponent>(sphereModel)
+            .add<MeshComponent>(rm.getHandle(sphereModel))
             .add<MaterialComponent>(MaterialComponent::Builder()
-                .setMaterial(emissiveMat)
+                .setMaterial(rm.getHandle(emissiveMat))
                 .build());
 
 
@@ -368,20 +368,20 @@ public:
 
         /*Entity entity = getScene().createEntity("glass cube")
             .add<TransformComponent>(glm::vec3{ 0.0f, 0.0f, 0.0f }, glm::vec3{ 0.1f }, glm::vec3{ 0.0f, glm::pi<float>() / 4, 0.0f })
-            .add<MeshComponent>(cubeModel)
+            .add<MeshComponent>(rm.getHandle(cubeModel))
             .add<MaterialComponent>(MaterialComponent::Builder()
-                .setMaterial(glassMaterial)
+                .setMaterial(rm.getHandle(glassMaterial))
                 .setTint(glm::vec4(1.0f, 0.0f, 0.0f, 1.0f))
                 .build());*/
 
         Entity entity = getScene().createEntity("Bunny")
             .add<TransformComponent>(glm::vec3{ 0.0f }, glm::vec3{ 3.0f, 3.0f, 3.0f }, glm::vec3{ 0.0f, 0.0f, glm::pi<float>()})
-            .add<MeshComponent>(bunny)
+            .add<MeshComponent>(rm.getHandle(bunny))
             .add<VolumeComponent>(VolumeComponent::Builder()
                 .setAbsorption(glm::vec4{ 0.1f })
                 .setScattering(glm::vec4{ 0.9f })
                 .setPhaseFunctionG(0.5f)
-                .setDensityTexture(rm.get<Image>(TEXTURES_PATH + "/noise/perlin_worley.png"))
+                .setDensityTexture(rm.getHandle<Image>(TEXTURES_PATH + "/noise/perlin_worley.png"))
                 .build());
     }
 
@@ -29,10 +29,13 @@ namespace PXTEngine {
         createDefaultResources();
         {
             PXT_PROFILE("PXTEngine::Application::loadScene");
+            PXT_STARTUP_PHASE("Load scene");
             loadScene();
         }
         registerResources();
 
+        PXT_STARTUP_PHASE("Create descriptor sets and render systems");
+
         // create the pool manager, ubo buffers, and global descriptor sets
         createDescriptorPoolAllocator();
         createUboBuffers();
@@ -55,10 +58,12 @@ namespace PXTEngine {
         }
 
 		// create the render systems
+        PXT_STARTUP_PHASE("Create master render system");
         m_masterRenderSystem = createUnique<MasterRenderSystem>(
             m_context,
             m_renderer,
             m_descriptorAllocator,
+            m_resourceManager,
             m_textureRegistry,
 			m_materialRegistry,
 			m_blasRegistry,
@@ -69,6 +74,16 @@ namespace PXTEngine {
         m_window.setEventCallback([this]<typename E>(E&& event) {
             onEvent(std::forward<E>(event));
         });
+
+        // record the session from the loaded scene, written when the recording is stopped or the application closes
+        if (const char* recordFile = std::getenv("PXT_RECORD")) {
+            m_inputRecorder.startRecording(recordFile, m_window.getExtent(), InputRecorder::DEFAULT_FIXED_DELTA_TIME);
+        }
+
+        // replay a recorded session and quit, used to benchmark the engine from scripts
+        if (const char* replayFile = std::getenv("PXT_REPLAY")) {
+            m_inputRecorder.startReplay(replayFile, m_window.getExtent(), true);
+        }
     }
 
 	void Application::createDescriptorPoolAllocator() {
@@ -119,6 +134,8 @@ namespace PXTEngine {
     }
 
     void Application::createDefaultResources() {
+        PXT_STARTUP_PHASE("Create default resources");
+
         // color are stored in RGBA format but bytes are reversed (Little-Endian Systems)
         // 0x0A0B0C0D -> Alpha = 0A, Blue = 0B, Green = 0C, Red = 0D
         std::unordered_map<std::string, std::pair<uint32_t, ImageFormat>> defaultImagesData = {
@@ -171,6 +188,8 @@ namespace PXTEngine {
         blueNoiseInfo.filtering = ImageFiltering::Nearest;
         blueNoiseInfo.flags = ImageFlags::UnnormalizedCoordinates;
 
+		PXT_STARTUP_PHASE("Load blue noise textures");
+
 		std::string blueNoiseFile;
 
 		for (uint32_t i = 0; i < BLUE_NOISE_TEXTURE_COUNT; i++) {
@@ -180,6 +199,8 @@ namespace PXTEngine {
     }
 
     void Application::registerResources() {
+        PXT_STARTUP_PHASE("Register resources");
+
         // TODO: we will eventually redo all resource management, this sucks :)
 
 		// iterate over resource and register images
@@ -208,15 +229,26 @@ namespace PXTEngine {
         Camera camera;
         
         auto currentTime = std::chrono::high_resolution_clock::now();
-    
+
+        // closed once the first frame rendering the scene has been presented, to end the startup report
+        // (the frames before show a placeholder while the render systems are created)
+        std::optional<StartupProfiler::Scope> firstFramePhase;
+        firstFramePhase.emplace("First frame");
+
         m_scene.onStart();
         uint32_t frameCount = 0;
         while (isRunning()) {
             glfwPollEvents();
 
+            // the transient data of the previous frame is released
+            FrameArena::beginFrame();
+
             auto newTime = std::chrono::high_resolution_clock::now();
-            float elapsedTime = std::chrono::duration<float>(newTime - currentTime).count();
+            float measuredTime = std::chrono::duration<float>(newTime - currentTime).count();
             currentTime = newTime;
+
+            // when replaying a recording, the recorded input and delta time are used instead
+            float elapsedTime = m_inputRecorder.beginFrame(m_window.getBaseWindow(), measuredTime);
             
             m_scene.onUpdate(elapsedTime);
 
@@ -225,6 +257,9 @@ namespace PXTEngine {
             if (auto commandBuffer = m_renderer.beginFrame()) {
                 int frameIndex = m_renderer.getFrameIndex();
 
+                // the frame is recorded with the render path ready at its beginning
+                const bool isRenderPathReady = m_masterRenderSystem->isRenderPathReady();
+
                 FrameInfo frameInfo = {
                     frameIndex,
                     elapsedTime,
@@ -232,7 +267,7 @@ namespace PXTEngine {
                     camera,
                     m_globalDescriptorSets[frameIndex],
 					m_scene,
-                    m_renderer.getSwapChainCurrentFrameFence(),                                   // Frame fence
+                    m_context.getFrameTimeline().getNextValue(),                                  // Frame timeline value
                     m_renderer.getSwapChainImageAvailableSemaphore(),                             // Wait semaphore
                     m_renderer.getSwapChainRenderFinishedSemaphore(
                         m_renderer.getSwapChainCurrentImageIndex()
@@ -241,6 +276,12 @@ namespace PXTEngine {
 
                 GlobalUbo ubo{};
                 ubo.ambientLightColor = m_scene.getEnvironment()->getAmbientLight();
+
+                const auto& irradianceSH = m_scene.getEnvironment()->getIrradianceSH();
+                for (uint32_t i = 0; i < IBL::IrradianceSH::COEFFICIENT_COUNT; i++) {
+                    ubo.irradianceSH[i] = glm::vec4(irradianceSH.coefficients[i], 0.0f);
+                }
+
                 ubo.frameCount = frameCount++;
 
 				m_masterRenderSystem->onUpdate(frameInfo, ubo);
@@ -252,19 +293,26 @@ namespace PXTEngine {
 
                 m_renderer.endFrame();
 
+                if (firstFramePhase && isRenderPathReady) {
+                    firstFramePhase.reset();
+                    StartupProfiler::finish();
+                }
+
                 // TODO: i dont like this
 				m_masterRenderSystem->postFrameUpdate(frameInfo);
             }
 
             // tracy end frame mark
             FrameMark;
+
+            AllocationTracker::endFrame();
         }
 
         vkDeviceWaitIdle(m_context.getDevice());
     }
 
     bool Application::isRunning() {
-        return !m_window.shouldClose() && m_running;
+        return !m_window.shouldClose() && m_running && !m_inputRecorder.isFinished();
     }
 
     void Application::onEvent(Event& event) {
@@ -298,12 +346,20 @@ namespace PXTEngine {
 int main() {
 
 	PXTEngine::Logger::init();
+	PXTEngine::StartupProfiler::start();
 
    // TODO: what is happening here? indentation? missing try catch?
 
-        auto app = PXTEngine::initApplication();
+        PXTEngine::Application* app = nullptr;
+        {
+            PXT_STARTUP_PHASE("Create application");
+            app = PXTEngine::initApplication();
+        }
 
-        app->start();
+        {
+            PXT_STARTUP_PHASE("Start application");
+            app->start();
+        }
         app->run();
 
         delete app;
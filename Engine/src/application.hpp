@@ -2,6 +2,7 @@
 
 #include "core/pch.hpp"
 #include "core/events/event.hpp"
+#include "core/input/input_recorder.hpp"
 #include "graphics/window.hpp"
 #include "graphics/context/context.hpp"
 #include "graphics/renderer.hpp"
@@ -42,6 +43,10 @@ namespace PXTEngine {
             return m_resourceManager;
         }
 
+        InputRecorder& getInputRecorder() {
+            return m_inputRecorder;
+        }
+
 		Shared<DescriptorAllocatorGrowable> getDescriptorAllocator() {
 			return m_descriptorAllocator;
 		}
@@ -77,6 +82,8 @@ namespace PXTEngine {
 
         Scene m_scene{};
 
+        InputRecorder m_inputRecorder{};
+
         ResourceManager m_resourceManager{};
         TextureRegistry m_textureRegistry{m_context};
 		MaterialRegistry m_materialRegistry{m_context, m_textureRegistry};
@@ -0,0 +1,271 @@
+#include "core/allocation_tracker.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace PXTEngine {
+
+	namespace {
+		// Everything here is constant-initialized: allocations can happen before any
+		// dynamic initializer has run and after the static destructors.
+
+		struct Counters {
+			std::atomic<uint64_t> allocationCount{0};
+			std::atomic<uint64_t> allocatedBytes{0};
+			std::atomic<uint64_t> liveBytes{0};
+			std::atomic<uint64_t> peakBytes{0};
+			std::atomic<uint64_t> frameAllocationCount{0};
+			std::atomic<uint64_t> frameAllocatedBytes{0};
+		};
+
+		// only touched by endFrame, on the main thread
+		struct FrameHistory {
+			uint64_t allocationCount = 0;
+			uint64_t allocatedBytes = 0;
+			uint32_t framesWithAllocations = 0;
+			bool isReported = false;
+		};
+
+		Counters g_counters[AllocationTracker::MAX_SUBSYSTEMS];
+		FrameHistory g_frameHistory[AllocationTracker::MAX_SUBSYSTEMS];
+
+		std::atomic<const char*> g_names[AllocationTracker::MAX_SUBSYSTEMS];
+		std::atomic<uint32_t> g_subsystemCount{1}; // the untracked subsystem is always there
+		std::atomic_flag g_registrationLock = ATOMIC_FLAG_INIT;
+
+		thread_local uint32_t t_currentSubsystem = AllocationTracker::UNTRACKED_SUBSYSTEM;
+
+		const char* getSubsystemName(const uint32_t subsystem) {
+			return subsystem == AllocationTracker::UNTRACKED_SUBSYSTEM ? "Untracked" : g_names[subsystem].load();
+		}
+
+		std::string formatBytes(const uint64_t bytes) {
+			if (bytes >= 1024 * 1024) return std::format("{:.2f} MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+			if (bytes >= 1024) return std::format("{:.2f} KB", static_cast<double>(bytes) / 1024.0);
+			return std::format("{} B", bytes);
+		}
+	}
+
+	uint32_t AllocationTracker::registerSubsystem(const char* name) {
+		while (g_registrationLock.test_and_set(std::memory_order_acquire)) {}
+
+		// the same name used in several places is the same subsystem
+		const uint32_t count = g_subsystemCount.load();
+		uint32_t subsystem = count;
+		for (uint32_t i = 1; i < count; i++) {
+			if (std::strcmp(g_names[i].load(), name) == 0) {
+				subsystem = i;
+				break;
+			}
+		}
+
+		if (subsystem == count) {
+			if (count < MAX_SUBSYSTEMS) {
+				g_names[count].store(name);
+				g_subsystemCount.store(count + 1);
+			} else {
+				subsystem = UNTRACKED_SUBSYSTEM;
+			}
+		}
+
+		g_registrationLock.clear(std::memory_order_release);
+		return subsystem;
+	}
+
+	uint32_t AllocationTracker::getCurrentSubsystem() {
+		return t_currentSubsystem;
+	}
+
+	uint32_t AllocationTracker::exchangeCurrentSubsystem(const uint32_t subsystem) {
+		const uint32_t previous = t_currentSubsystem;
+		t_currentSubsystem = subsystem;
+		return previous;
+	}
+
+	void AllocationTracker::recordAllocation(const uint32_t subsystem, const size_t size) {
+		Counters& counters = g_counters[subsystem];
+		counters.allocationCount.fetch_add(1, std::memory_order_relaxed);
+		counters.allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		counters.frameAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		counters.frameAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+		const uint64_t liveBytes = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+		uint64_t peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+		while (liveBytes > peakBytes && !counters.peakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed)) {}
+	}
+
+	void AllocationTracker::recordDeallocation(const uint32_t subsystem, const size_t size) {
+		g_counters[subsystem].liveBytes.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+	void AllocationTracker::endFrame() {
+		if constexpr (!isEnabled()) return;
+
+		const uint32_t count = g_subsystemCount.load();
+		for (uint32_t i = 0; i < count; i++) {
+			Counters& counters = g_counters[i];
+			FrameHistory& history = g_frameHistory[i];
+
+			history.allocationCount = counters.frameAllocationCount.exchange(0, std::memory_order_relaxed);
+			history.allocatedBytes = counters.frameAllocatedBytes.exchange(0, std::memory_order_relaxed);
+			history.framesWithAllocations = history.allocationCount > 0 ? history.framesWithAllocations + 1 : 0;
+
+			if (history.framesWithAllocations < STEADY_STATE_FRAMES) {
+				history.isReported = false;
+			} else if (!history.isReported && i != UNTRACKED_SUBSYSTEM) {
+				history.isReported = true;
+				PXT_WARN("Subsystem '{}' has allocated in each of the last {} frames ({} allocations, {} in the last one)",
+					getSubsystemName(i), STEADY_STATE_FRAMES, history.allocationCount, formatBytes(history.allocatedBytes));
+			}
+		}
+	}
+
+	std::vector<AllocationTracker::SubsystemStats> AllocationTracker::getStats() {
+		const uint32_t count = g_subsystemCount.load();
+
+		std::vector<SubsystemStats> stats(count);
+		for (uint32_t i = 0; i < count; i++) {
+			const Counters& counters = g_counters[i];
+			const FrameHistory& history = g_frameHistory[i];
+
+			stats[i].name = getSubsystemName(i);
+			stats[i].allocationCount = counters.allocationCount.load(std::memory_order_relaxed);
+			stats[i].allocatedBytes = counters.allocatedBytes.load(std::memory_order_relaxed);
+			stats[i].liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+			stats[i].peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+			stats[i].frameAllocationCount = history.allocationCount;
+			stats[i].frameAllocatedBytes = history.allocatedBytes;
+			stats[i].framesWithAllocations = history.framesWithAllocations;
+			stats[i].isAllocatingEveryFrame = history.framesWithAllocations >= STEADY_STATE_FRAMES;
+		}
+		return stats;
+	}
+
+	uint64_t AllocationTracker::getTotalAllocationCount() {
+		const uint32_t count = g_subsystemCount.load();
+
+		uint64_t total = 0;
+		for (uint32_t i = 0; i < count; i++) {
+			total += g_counters[i].allocationCount.load(std::memory_order_relaxed);
+		}
+		return total;
+	}
+
+	void AllocationTracker::updateUi() {
+		if constexpr (!isEnabled()) {
+			ImGui::TextWrapped("Allocation tracking is disabled, configure with -DPXT_TRACK_ALLOCATIONS=ON to enable it.");
+			return;
+		}
+
+		ImGui::Text("Subsystems allocating in each of the last %u frames are highlighted", STEADY_STATE_FRAMES);
+
+		constexpr ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp;
+		if (!ImGui::BeginTable("Allocations", 6, flags)) return;
+
+		ImGui::TableSetupColumn("Subsystem");
+		ImGui::TableSetupColumn("Allocations");
+		ImGui::TableSetupColumn("Live");
+		ImGui::TableSetupColumn("Peak");
+		ImGui::TableSetupColumn("Frame allocs");
+		ImGui::TableSetupColumn("Frame bytes");
+		ImGui::TableHeadersRow();
+
+		for (const SubsystemStats& stats : getStats()) {
+			const ImVec4 color = stats.isAllocatingEveryFrame
+				? ImVec4(0.9f, 0.6f, 0.1f, 1.0f)
+				: ImGui::GetStyleColorVec4(ImGuiCol_Text);
+
+			ImGui::TableNextRow();
+			ImGui::TableNextColumn();
+			ImGui::TextColored(color, "%s", stats.name.c_str());
+			ImGui::TableNextColumn();
+			ImGui::TextColored(color, "%llu", static_cast<unsigned long long>(stats.allocationCount));
+			ImGui::TableNextColumn();
+			ImGui::TextColored(color, "%s", formatBytes(stats.liveBytes).c_str());
+			ImGui::TableNextColumn();
+			ImGui::TextColored(color, "%s", formatBytes(stats.peakBytes).c_str());
+			ImGui::TableNextColumn();
+			ImGui::TextColored(color, "%llu", static_cast<unsigned long long>(stats.frameAllocationCount));
+			ImGui::TableNextColumn();
+			ImGui::TextColored(color, "%s", formatBytes(stats.frameAllocatedBytes).c_str());
+		}
+
+		ImGui::EndTable();
+	}
+}
+
+#if defined(PXT_TRACK_ALLOCATIONS)
+
+// Replacements of the global allocation functions. Every block starts with a header
+// storing its size and the subsystem it is charged to, in front of the returned pointer.
+// Memory allocated with malloc directly (stb, the Vulkan driver, ImGui) is not seen.
+
+namespace {
+	struct alignas(16) AllocationHeader {
+		void* block;
+		size_t size;
+		uint32_t subsystem;
+	};
+
+	void* trackedAllocate(size_t size, size_t alignment) noexcept {
+		alignment = std::max(alignment, alignof(AllocationHeader));
+
+		void* block = std::malloc(size + sizeof(AllocationHeader) + alignment - 1);
+		if (!block) return nullptr;
+
+		const uintptr_t address = (reinterpret_cast<uintptr_t>(block) + sizeof(AllocationHeader) + alignment - 1) & ~(alignment - 1);
+
+		AllocationHeader* header = reinterpret_cast<AllocationHeader*>(address) - 1;
+		header->block = block;
+		header->size = size;
+		header->subsystem = PXTEngine::AllocationTracker::getCurrentSubsystem();
+
+		PXTEngine::AllocationTracker::recordAllocation(header->subsystem, size);
+		return reinterpret_cast<void*>(address);
+	}
+
+	void* trackedAllocateOrThrow(size_t size, const size_t alignment) {
+		if (size == 0) size = 1;
+
+		while (true) {
+			if (void* pointer = trackedAllocate(size, alignment)) return pointer;
+
+			std::new_handler handler = std::get_new_handler();
+			if (!handler) throw std::bad_alloc();
+			handler();
+		}
+	}
+
+	void trackedFree(void* pointer) noexcept {
+		if (!pointer) return;
+
+		const AllocationHeader* header = static_cast<AllocationHeader*>(pointer) - 1;
+		PXTEngine::AllocationTracker::recordDeallocation(header->subsystem, header->size);
+		std::free(header->block);
+	}
+}
+
+void* operator new(size_t size) { return trackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return trackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment) { return trackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return trackedAllocateOrThrow(size, static_cast<size_t>(alignment)); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size ? size : 1, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size ? size : 1, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAllocate(size ? size : 1, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAllocate(size ? size : 1, static_cast<size_t>(alignment)); }
+
+void operator delete(void* pointer) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(pointer); }
+
+#endif
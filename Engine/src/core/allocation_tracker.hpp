@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PXTEngine {
+
+	/**
+	 * @class AllocationTracker
+	 *
+	 * @brief Attributes the CPU heap allocations of the engine to subsystems.
+	 *
+	 * Compiled in with the PXT_TRACK_ALLOCATIONS option: the global operator new/delete
+	 * are then replaced (see allocation_tracker.cpp) and every allocation is charged to the
+	 * innermost PXT_ALLOCATION_SCOPE active on the allocating thread, or to "Untracked".
+	 * The memory is released to the subsystem that allocated it, whichever scope frees it.
+	 *
+	 * For every subsystem it keeps the allocation count, the live and peak bytes and the
+	 * allocations of the last frame. A subsystem that keeps allocating in every frame for
+	 * STEADY_STATE_FRAMES frames is flagged, in steady state the per-frame work should reuse
+	 * its memory.
+	 *
+	 * Without the option the scopes compile to nothing and the statistics stay empty.
+	 */
+	class AllocationTracker {
+	public:
+		static constexpr uint32_t MAX_SUBSYSTEMS = 64;
+		static constexpr uint32_t UNTRACKED_SUBSYSTEM = 0;
+		static constexpr uint32_t STEADY_STATE_FRAMES = 120;
+
+		struct SubsystemStats {
+			std::string name;
+			uint64_t allocationCount = 0;
+			uint64_t allocatedBytes = 0; // total, freed memory included
+			uint64_t liveBytes = 0;
+			uint64_t peakBytes = 0;
+			uint64_t frameAllocationCount = 0; // last completed frame
+			uint64_t frameAllocatedBytes = 0;
+			uint32_t framesWithAllocations = 0; // consecutive frames, up to the last one
+			bool isAllocatingEveryFrame = false;
+		};
+
+		/**
+		 * @brief Sets the subsystem charged for the allocations of the current thread
+		 * while in scope, the previous one is restored on destruction.
+		 */
+		class Scope {
+		public:
+			explicit Scope(const uint32_t subsystem) : m_previous(exchangeCurrentSubsystem(subsystem)) {}
+			~Scope() { exchangeCurrentSubsystem(m_previous); }
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			uint32_t m_previous;
+		};
+
+		static constexpr bool isEnabled() {
+#if defined(PXT_TRACK_ALLOCATIONS)
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		/**
+		 * @brief Returns the index of a subsystem, registering it on the first call.
+		 * Does not allocate. Past MAX_SUBSYSTEMS the allocations go to "Untracked".
+		 *
+		 * @param name A string literal, it is stored by pointer.
+		 */
+		static uint32_t registerSubsystem(const char* name);
+
+		static uint32_t getCurrentSubsystem();
+		static uint32_t exchangeCurrentSubsystem(uint32_t subsystem);
+
+		/**
+		 * @brief Closes the current frame: moves the per-frame counters into the statistics
+		 * and updates the steady state flags. Called once per frame by the application.
+		 */
+		static void endFrame();
+
+		/**
+		 * @brief Copies the statistics of the registered subsystems.
+		 */
+		static std::vector<SubsystemStats> getStats();
+
+		/**
+		 * @brief Number of allocations made so far by all subsystems. Does not allocate.
+		 */
+		static uint64_t getTotalAllocationCount();
+
+		static void recordAllocation(uint32_t subsystem, size_t size);
+		static void recordDeallocation(uint32_t subsystem, size_t size);
+
+		static void updateUi();
+	};
+}
+
+#define PXT_ALLOCATION_CONCAT_IMPL(a, b) a##b
+#define PXT_ALLOCATION_CONCAT(a, b) PXT_ALLOCATION_CONCAT_IMPL(a, b)
+
+#if defined(PXT_TRACK_ALLOCATIONS)
+// Charges the allocations made until the end of the enclosing block to the named subsystem
+#define PXT_ALLOCATION_SCOPE(name) \
+	static const uint32_t PXT_ALLOCATION_CONCAT(pxtAllocationSubsystem, __LINE__) = \
+		::PXTEngine::AllocationTracker::registerSubsystem(name); \
+	::PXTEngine::AllocationTracker::Scope PXT_ALLOCATION_CONCAT(pxtAllocationScope, __LINE__)( \
+		PXT_ALLOCATION_CONCAT(pxtAllocationSubsystem, __LINE__))
+#else
+#define PXT_ALLOCATION_SCOPE(name)
+#endif
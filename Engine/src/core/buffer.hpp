@@ -8,15 +8,21 @@ namespace PXTEngine {
         uint8_t* bytes = nullptr;
         size_t size = 0;
 
+#if defined(PXT_TRACK_ALLOCATIONS)
+        // subsystem charged for the bytes, UINT32_MAX if they were not allocated by
+        // the buffer (e.g. the pixels loaded by stb in the TextureImporter)
+        uint32_t trackedSubsystem = UINT32_MAX;
+#endif
+
         Buffer() = default;
 
         Buffer(size_t size) : size(size) {
-            bytes = (uint8_t*) malloc(size);
+            bytes = allocate(size);
         }
 
         // Constructor that copies data
         Buffer(const void* data, const size_t size) : size(size) {
-            bytes = (uint8_t*) malloc(size);
+            bytes = allocate(size);
             if (bytes) {
                 memcpy(bytes, data, size);
             } else {
@@ -31,7 +37,7 @@ namespace PXTEngine {
         // Copy Constructor (Deep Copy)
         Buffer(const Buffer& other) : size(other.size) {
             if (other.bytes) {
-                bytes = (uint8_t*) malloc(size);
+                bytes = allocate(size);
                 if (bytes) {
                     memcpy(bytes, other.bytes, size);
                 } else {
@@ -50,7 +56,7 @@ namespace PXTEngine {
 
                 size = other.size;
                 if (other.bytes) {
-                    bytes = (uint8_t*) malloc(size);
+                    bytes = allocate(size);
                     if (bytes) {
                         memcpy(bytes, other.bytes, size);
                     } else {
@@ -70,6 +76,12 @@ namespace PXTEngine {
 
         void release() {
             if (bytes) {
+#if defined(PXT_TRACK_ALLOCATIONS)
+                if (trackedSubsystem != UINT32_MAX) {
+                    AllocationTracker::recordDeallocation(trackedSubsystem, size);
+                    trackedSubsystem = UINT32_MAX;
+                }
+#endif
                 free(bytes);
                 bytes = nullptr;
                 size = 0;
@@ -84,6 +96,19 @@ namespace PXTEngine {
         size_t getSize() const {
             return size;
         }
+
+    private:
+        // the bytes are malloc'd and not new'd, so they are charged to the allocation tracker here
+        uint8_t* allocate(const size_t allocationSize) {
+            uint8_t* allocation = (uint8_t*) malloc(allocationSize);
+#if defined(PXT_TRACK_ALLOCATIONS)
+            if (allocation) {
+                trackedSubsystem = AllocationTracker::getCurrentSubsystem();
+                AllocationTracker::recordAllocation(trackedSubsystem, allocationSize);
+            }
+#endif
+            return allocation;
+        }
     };
     
 }
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "core/frame_arena.hpp"
+
+#include <mutex>
+#include <new>
+
+namespace PXTEngine {
+
+	namespace {
+		size_t alignUp(const size_t value, const size_t alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		/**
+		 * @brief Arena of a thread, its statistics are published at every reset so that
+		 * the other threads can read them.
+		 */
+		struct ThreadArena {
+			LinearArena arena;
+			uint64_t frame = 0;
+
+			std::atomic<size_t> lastFrameBytes{0};
+			std::atomic<size_t> highWaterMark{0};
+			std::atomic<size_t> capacity{0};
+
+			ThreadArena();
+			~ThreadArena();
+
+			void reset() {
+				lastFrameBytes.store(arena.getUsedBytes(), std::memory_order_relaxed);
+				highWaterMark.store(arena.getHighWaterMark(), std::memory_order_relaxed);
+				arena.reset();
+				capacity.store(arena.getCapacity(), std::memory_order_relaxed);
+			}
+		};
+
+		std::mutex g_threadArenasMutex;
+		std::vector<ThreadArena*> g_threadArenas;
+
+		ThreadArena::ThreadArena() {
+			capacity.store(arena.getCapacity(), std::memory_order_relaxed);
+
+			std::lock_guard lock(g_threadArenasMutex);
+			g_threadArenas.push_back(this);
+		}
+
+		ThreadArena::~ThreadArena() {
+			std::lock_guard lock(g_threadArenasMutex);
+			std::erase(g_threadArenas, this);
+		}
+
+		std::string formatBytes(const size_t bytes) {
+			if (bytes >= 1024 * 1024) return std::format("{:.2f} MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+			return std::format("{:.2f} KB", static_cast<double>(bytes) / 1024.0);
+		}
+	}
+
+	LinearArena::LinearArena(const size_t capacity) {
+		addBlock(capacity);
+	}
+
+	LinearArena::~LinearArena() {
+		releaseBlocks();
+	}
+
+	void* LinearArena::allocate(const size_t size, const size_t alignment) {
+		PXT_ASSERT(alignment <= MAX_ALIGNMENT && (alignment & (alignment - 1)) == 0, "Unsupported arena alignment");
+
+		Block* block = &m_blocks.back();
+		size_t offset = alignUp(block->offset, alignment);
+
+		if (offset + size > block->capacity) {
+			// the blocks are aligned to MAX_ALIGNMENT, the allocation goes at the start of the new one
+			addBlock(std::max(block->capacity * 2, alignUp(size, MAX_ALIGNMENT)));
+			block = &m_blocks.back();
+			offset = 0;
+		}
+
+		m_usedBytes += offset + size - block->offset;
+		block->offset = offset + size;
+
+		m_lastAllocation = block->data + offset;
+		return m_lastAllocation;
+	}
+
+	void LinearArena::deallocate(void* pointer, size_t) {
+		if (pointer == nullptr || pointer != m_lastAllocation) return;
+
+		Block& block = m_blocks.back();
+		const size_t offset = static_cast<size_t>(m_lastAllocation - block.data);
+		m_usedBytes -= block.offset - offset;
+		block.offset = offset;
+		m_lastAllocation = nullptr;
+	}
+
+	void LinearArena::reset() {
+		m_highWaterMark = std::max(m_highWaterMark, m_usedBytes);
+
+		if (m_blocks.size() > 1) {
+			// the blocks chained during the frame are merged, the next frames fit in one block
+			const size_t capacity = alignUp(std::max(m_highWaterMark, getCapacity()), MAX_ALIGNMENT);
+			releaseBlocks();
+			addBlock(capacity);
+		}
+
+		m_blocks.back().offset = 0;
+		m_usedBytes = 0;
+		m_lastAllocation = nullptr;
+		m_resetCount++;
+	}
+
+#ifndef NDEBUG
+	void LinearArena::checkNotResetSince(const uint64_t resetCount) const {
+		PXT_ASSERT(m_resetCount == resetCount, "Frame arena memory used after its arena was reset, a frame container outlived its frame");
+	}
+#endif
+
+	size_t LinearArena::getCapacity() const {
+		size_t capacity = 0;
+		for (const Block& block : m_blocks) {
+			capacity += block.capacity;
+		}
+		return capacity;
+	}
+
+	void LinearArena::addBlock(const size_t capacity) {
+		PXT_ALLOCATION_SCOPE("FrameArena");
+
+		std::byte* data = static_cast<std::byte*>(::operator new(capacity, std::align_val_t(MAX_ALIGNMENT)));
+		m_blocks.push_back({ data, capacity, 0 });
+	}
+
+	void LinearArena::releaseBlocks() {
+		for (const Block& block : m_blocks) {
+			::operator delete(block.data, std::align_val_t(MAX_ALIGNMENT));
+		}
+		m_blocks.clear();
+	}
+
+	LinearArena& FrameArena::get() {
+		thread_local ThreadArena threadArena;
+
+		// the arenas of the other threads are reset the first time they are used in a new frame
+		const uint64_t frame = s_frame.load(std::memory_order_relaxed);
+		if (threadArena.frame != frame) {
+			threadArena.reset();
+			threadArena.frame = frame;
+		}
+
+		return threadArena.arena;
+	}
+
+	void FrameArena::beginFrame() {
+		s_frame.fetch_add(1, std::memory_order_relaxed);
+		get();
+	}
+
+	FrameArena::Stats FrameArena::getStats() {
+		std::lock_guard lock(g_threadArenasMutex);
+
+		Stats stats{};
+		stats.threadCount = static_cast<uint32_t>(g_threadArenas.size());
+		for (const ThreadArena* threadArena : g_threadArenas) {
+			stats.lastFrameBytes += threadArena->lastFrameBytes.load(std::memory_order_relaxed);
+			stats.highWaterMark += threadArena->highWaterMark.load(std::memory_order_relaxed);
+			stats.capacity += threadArena->capacity.load(std::memory_order_relaxed);
+		}
+		return stats;
+	}
+
+	void FrameArena::updateUi() {
+		const Stats stats = getStats();
+
+		ImGui::Text("Frame arenas (%u threads)", stats.threadCount);
+		ImGui::Text("Last frame: %s", formatBytes(stats.lastFrameBytes).c_str());
+		ImGui::Text("High water mark: %s", formatBytes(stats.highWaterMark).c_str());
+		ImGui::Text("Capacity: %s", formatBytes(stats.capacity).c_str());
+	}
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PXTEngine {
+
+	/**
+	 * @class LinearArena
+	 *
+	 * @brief Bump allocator: allocating moves an offset forward, everything is released at once
+	 * with reset().
+	 *
+	 * When the current block is full a bigger one is chained. On reset, an arena that needed
+	 * more than one block replaces them with a single block as large as the most memory it has
+	 * ever used, so after a few frames it stops allocating altogether.
+	 *
+	 * Not thread safe, see FrameArena for the per-thread arenas.
+	 */
+	class LinearArena {
+	public:
+		static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+		static constexpr size_t MAX_ALIGNMENT = 64;
+
+		explicit LinearArena(size_t capacity = DEFAULT_CAPACITY);
+		~LinearArena();
+
+		LinearArena(const LinearArena&) = delete;
+		LinearArena& operator=(const LinearArena&) = delete;
+
+		/**
+		 * @param alignment A power of two, at most MAX_ALIGNMENT.
+		 */
+		void* allocate(size_t size, size_t alignment);
+
+		/**
+		 * @brief Gives the memory back only if it is the last allocation (e.g. a container
+		 * freeing the storage it has just grown out of), otherwise it waits for the reset.
+		 */
+		void deallocate(void* pointer, size_t size);
+
+		/**
+		 * @brief Releases every allocation. The memory handed out before must not be used anymore.
+		 */
+		void reset();
+
+		size_t getUsedBytes() const { return m_usedBytes; }
+		size_t getCapacity() const;
+		size_t getHighWaterMark() const { return std::max(m_highWaterMark, m_usedBytes); }
+
+		/**
+		 * @brief Number of resets so far, the memory handed out before the last one is invalid.
+		 */
+		uint64_t getResetCount() const { return m_resetCount; }
+
+#ifndef NDEBUG
+		/**
+		 * @brief Asserts that the arena has not been reset since getResetCount() returned resetCount.
+		 */
+		void checkNotResetSince(uint64_t resetCount) const;
+#endif
+
+	private:
+		struct Block {
+			std::byte* data;
+			size_t capacity;
+			size_t offset;
+		};
+
+		void addBlock(size_t capacity);
+		void releaseBlocks();
+
+		std::vector<Block> m_blocks;
+		size_t m_usedBytes = 0;
+		size_t m_highWaterMark = 0;
+		std::byte* m_lastAllocation = nullptr;
+		uint64_t m_resetCount = 0;
+	};
+
+	/**
+	 * @class FrameArena
+	 *
+	 * @brief The per-frame arenas, one for each thread, for the transient CPU data of a frame:
+	 * lists built and consumed within the frame, descriptor writes, sorting buffers, ...
+	 *
+	 * beginFrame() starts a new frame: the arena of the main thread is reset right away, the
+	 * arena of any other thread the first time that thread uses it in the new frame. Memory from
+	 * a frame arena must never outlive the frame it was allocated in. This holds for the worker
+	 * threads too: a container a worker keeps across frames is overwritten as soon as that worker
+	 * allocates in the next frame, so worker-owned frame containers must be destroyed (or
+	 * cleared and never reused) before the frame ends. Debug builds assert when a container
+	 * allocates or frees arena memory after its arena has been reset.
+	 *
+	 * Containers use it through ArenaAllocator, FrameVector is the common case:
+	 *
+	 *     FrameVector<SkinnedInstance*> instancesToSkin;
+	 */
+	class FrameArena {
+	public:
+		struct Stats {
+			uint32_t threadCount = 0;
+			size_t lastFrameBytes = 0; // summed over the threads
+			size_t highWaterMark = 0;
+			size_t capacity = 0;
+		};
+
+		/**
+		 * @brief The frame arena of the calling thread.
+		 */
+		static LinearArena& get();
+
+		/**
+		 * @brief Starts a new frame, called by the application at the beginning of every frame.
+		 */
+		static void beginFrame();
+
+		static Stats getStats();
+
+		static void updateUi();
+
+	private:
+		static inline std::atomic<uint64_t> s_frame{0};
+	};
+
+	/**
+	 * @brief STL allocator that takes its memory from a LinearArena, by default the frame
+	 * arena of the thread constructing it.
+	 */
+	template<typename T>
+	class ArenaAllocator {
+	public:
+		using value_type = T;
+
+		ArenaAllocator() : ArenaAllocator(FrameArena::get()) {}
+		explicit ArenaAllocator(LinearArena& arena) : m_arena(&arena), m_resetCount(arena.getResetCount()) {}
+
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.getArena()), m_resetCount(other.getResetCount()) {}
+
+		T* allocate(const size_t count) {
+#ifndef NDEBUG
+			m_arena->checkNotResetSince(m_resetCount);
+#endif
+			return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* pointer, const size_t count) {
+#ifndef NDEBUG
+			m_arena->checkNotResetSince(m_resetCount);
+#endif
+			m_arena->deallocate(pointer, count * sizeof(T));
+		}
+
+		LinearArena* getArena() const { return m_arena; }
+
+		/**
+		 * @brief Reset count of the arena when the allocator was created: a container is only
+		 * valid until its arena is reset again.
+		 */
+		uint64_t getResetCount() const { return m_resetCount; }
+
+		template<typename U>
+		bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.getArena(); }
+
+	private:
+		LinearArena* m_arena;
+		uint64_t m_resetCount;
+	};
+
+	template<typename T>
+	using FrameVector = std::vector<T, ArenaAllocator<T>>;
+}
@@ -5,6 +5,7 @@
 #include "application.hpp"
 #include "core/input/key_code.hpp"
 #include "core/input/mapper/glfw_input_mapper.hpp"
+#include "core/input/input_state.hpp"
 
 namespace PXTEngine {
 
@@ -14,6 +15,9 @@ namespace PXTEngine {
      * 
      * The Input class provides static methods for querying input events such as key presses, 
      * mouse button presses, and mouse movement.
+     * 
+     * While an input recording is replayed (see InputRecorder) the queries read the
+     * replayed state instead of the window.
      */
     class Input {
     public:
@@ -24,6 +28,7 @@ namespace PXTEngine {
          * @return True if the key is released, false otherwise.
          */
         static bool isKeyReleased(KeyCode key) {
+            if (s_replayedState) return !s_replayedState->isKeyPressed(key);
             return glfwGetKey(getWindow(), mapToGLFWKey(key)) == GLFW_RELEASE;
         }
         
@@ -34,6 +39,7 @@ namespace PXTEngine {
          * @return True if the key is currently pressed, false otherwise.
          */
         static bool isKeyPressed(KeyCode key) {
+            if (s_replayedState) return s_replayedState->isKeyPressed(key);
             return glfwGetKey(getWindow(), mapToGLFWKey(key)) == GLFW_PRESS;
         }
 
@@ -44,6 +50,7 @@ namespace PXTEngine {
          * @return True if the key is being repeated, false otherwise.
          */
         static bool isKeyRepeated(KeyCode key) {
+            if (s_replayedState) return false;
             return glfwGetKey(getWindow(), mapToGLFWKey(key)) == GLFW_REPEAT;
         }
 
@@ -54,6 +61,7 @@ namespace PXTEngine {
          * @return True if the mouse button is pressed, false otherwise.
          */
         static bool isMouseButtonPressed(MouseButton button) {
+            if (s_replayedState) return s_replayedState->isMouseButtonPressed(button);
             return glfwGetMouseButton(getWindow(), mapToGLFWMouseButton(button)) == GLFW_PRESS;
         }
 
@@ -63,14 +71,25 @@ namespace PXTEngine {
          * @return The current mouse position.
          */
         static glm::vec2 getMousePosition() {
+            if (s_replayedState) return s_replayedState->mousePosition;
+
             double x, y;
 		    glfwGetCursorPos(getWindow(), &x, &y);
             return { x, y };
         }
 
+        /**
+         * @brief Replaces the window as the source of the input, nullptr restores it.
+         */
+        static void setReplayedState(const InputState* state) {
+            s_replayedState = state;
+        }
+
     private:
         static GLFWwindow* getWindow() {
             return Application::get().getWindow().getBaseWindow();
         }
+
+        static inline const InputState* s_replayedState = nullptr;
     };
 }
\ No newline at end of file
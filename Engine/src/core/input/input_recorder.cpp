@@ -0,0 +1,391 @@
+#include "core/input/input_recorder.hpp"
+
+#include "core/input/input.hpp"
+#include "scene/ecs/entity.hpp"
+#include "application.hpp"
+
+namespace PXTEngine {
+
+    namespace {
+        constexpr size_t KEY_BYTES = (InputState::KEY_COUNT + 7) / 8;
+
+        struct FileHeader {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t frameCount;
+            uint32_t windowWidth;
+            uint32_t windowHeight;
+            float fixedDeltaTime;
+        };
+
+        template<typename T>
+        void writeValue(std::ofstream& file, const T& value) {
+            file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        template<typename T>
+        void readValue(std::ifstream& file, T& value) {
+            file.read(reinterpret_cast<char*>(&value), sizeof(T));
+        }
+
+        void writeString(std::ofstream& file, const std::string& value) {
+            writeValue(file, static_cast<uint32_t>(value.size()));
+            file.write(value.data(), static_cast<std::streamsize>(value.size()));
+        }
+
+        void readString(std::ifstream& file, std::string& value) {
+            uint32_t size = 0;
+            readValue(file, size);
+            if (!file) return;
+
+            value.resize(size);
+            file.read(value.data(), static_cast<std::streamsize>(size));
+        }
+    }
+
+    InputRecorder::~InputRecorder() {
+        // don't lose a recording when the application is closed while recording
+        if (m_mode == Mode::Recording) {
+            try {
+                stopRecording();
+            } catch (const std::exception& e) {
+                PXT_ERROR("{}", e.what());
+            }
+        }
+
+        if (m_mode == Mode::Replaying) {
+            Input::setReplayedState(nullptr);
+        }
+    }
+
+    void InputRecorder::startRecording(const std::filesystem::path& filePath, VkExtent2D windowExtent, float fixedDeltaTime) {
+        if (m_mode == Mode::Replaying) stopReplay();
+
+        m_mode = Mode::Recording;
+        m_frames.clear();
+        m_filePath = filePath;
+        m_windowExtent = windowExtent;
+        m_fixedDeltaTime = fixedDeltaTime;
+
+        m_cameraTransform.reset();
+        if (Entity camera = Application::get().getScene().getMainCameraEntity()) {
+            m_cameraTransform = camera.get<TransformComponent>();
+        }
+
+        // the layout is loaded from the ini file at the first ImGui frame, load it now to store it
+        m_uiSettings.clear();
+        if (ImGui::GetCurrentContext()) {
+            const ImGuiIO& io = ImGui::GetIO();
+            if (io.IniFilename && std::filesystem::exists(io.IniFilename)) {
+                ImGui::LoadIniSettingsFromDisk(io.IniFilename);
+            }
+            m_uiSettings = ImGui::SaveIniSettingsToMemory();
+        }
+
+        PXT_INFO("Recording input to {}", filePath.string());
+    }
+
+    void InputRecorder::stopRecording() {
+        if (m_mode != Mode::Recording) return;
+
+        m_mode = Mode::Idle;
+        writeFile(m_filePath);
+
+        PXT_INFO("Input recording saved to {} ({} frames)", m_filePath.string(), m_frames.size());
+    }
+
+    void InputRecorder::startReplay(const std::filesystem::path& filePath, VkExtent2D windowExtent, bool exitWhenFinished) {
+        if (m_mode == Mode::Recording) stopRecording();
+
+        readFile(filePath);
+
+        if (windowExtent.width != m_windowExtent.width || windowExtent.height != m_windowExtent.height) {
+            PXT_WARN("Input recording made with a {}x{} window, replayed with {}x{}: the ui input will not match",
+                m_windowExtent.width, m_windowExtent.height, windowExtent.width, windowExtent.height);
+        }
+
+        m_mode = Mode::Replaying;
+        m_filePath = filePath;
+        m_currentFrame = 0;
+        m_exitWhenFinished = exitWhenFinished;
+        m_isFinished = false;
+        m_replayStats = {};
+
+        if (m_cameraTransform) {
+            if (Entity camera = Application::get().getScene().getMainCameraEntity()) {
+                camera.get<TransformComponent>() = *m_cameraTransform;
+            }
+        } else {
+            PXT_WARN("Input recording {} has no camera transform, the replay starts from the current camera", filePath.string());
+        }
+
+        if (ImGui::GetCurrentContext()) {
+            ImGuiIO& io = ImGui::GetIO();
+
+            // the replayed mouse state has to be applied in the frame it was recorded in
+            m_savedTrickleEventQueue = io.ConfigInputTrickleEventQueue;
+            io.ConfigInputTrickleEventQueue = false;
+
+            // the recorded windows replace the ini file ones, which keeps the user's layout
+            if (!m_uiSettings.empty()) {
+                ImGui::LoadIniSettingsFromMemory(m_uiSettings.data(), m_uiSettings.size());
+                m_savedIniFilename = io.IniFilename;
+                io.IniFilename = nullptr;
+            }
+        }
+
+        PXT_INFO("Replaying input from {} ({} frames)", filePath.string(), m_frames.size());
+    }
+
+    void InputRecorder::stopReplay() {
+        if (m_mode != Mode::Replaying) return;
+
+        m_mode = Mode::Idle;
+        Input::setReplayedState(nullptr);
+
+        if (ImGui::GetCurrentContext()) {
+            ImGuiIO& io = ImGui::GetIO();
+            io.ConfigInputTrickleEventQueue = m_savedTrickleEventQueue;
+            if (m_savedIniFilename) {
+                io.IniFilename = m_savedIniFilename;
+                m_savedIniFilename = nullptr;
+            }
+        }
+    }
+
+    void InputRecorder::finishReplay() {
+        stopReplay();
+
+        PXT_INFO("Input replay finished: {} frames, average {:.3f} ms, max {:.3f} ms",
+            m_replayStats.frameCount, m_replayStats.getAverageMs(), m_replayStats.maxMs);
+
+        m_isFinished = m_exitWhenFinished;
+    }
+
+    float InputRecorder::beginFrame(GLFWwindow* window, float elapsedTime) {
+        if (m_mode == Mode::Recording) {
+            Frame frame{};
+            frame.deltaTime = m_fixedDeltaTime > 0.0f ? m_fixedDeltaTime : elapsedTime;
+            frame.input = InputState::capture(window);
+
+            m_frames.push_back(frame);
+            return frame.deltaTime;
+        }
+
+        if (m_mode == Mode::Replaying) {
+            // elapsed time is the duration of the previous replayed frame
+            if (m_currentFrame > 0) {
+                const float elapsedMs = elapsedTime * 1000.0f;
+                m_replayStats.frameCount++;
+                m_replayStats.totalMs += elapsedMs;
+                m_replayStats.maxMs = std::max(m_replayStats.maxMs, elapsedMs);
+            }
+
+            // the live input is replaced, escape is the way out of a replay
+            if (m_currentFrame >= m_frames.size() || glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+                finishReplay();
+                return elapsedTime;
+            }
+
+            const Frame& frame = m_frames[m_currentFrame++];
+            Input::setReplayedState(&frame.input);
+            return frame.deltaTime;
+        }
+
+        return elapsedTime;
+    }
+
+    void InputRecorder::applyUiInput() {
+        if (m_mode != Mode::Replaying || m_currentFrame == 0) return;
+
+        const UiInputState& ui = m_frames[m_currentFrame - 1].ui;
+        ImGuiIO& io = ImGui::GetIO();
+
+        // drop the live events queued by the platform backend
+        io.ClearEventsQueue();
+
+        io.AddMousePosEvent(ui.mousePosition.x, ui.mousePosition.y);
+        for (int i = 0; i < ImGuiMouseButton_COUNT; i++) {
+            io.AddMouseButtonEvent(i, (ui.mouseButtons >> i) & 1);
+        }
+        if (ui.mouseWheel.x != 0.0f || ui.mouseWheel.y != 0.0f) {
+            io.AddMouseWheelEvent(ui.mouseWheel.x, ui.mouseWheel.y);
+        }
+
+        io.DeltaTime = std::max(m_frames[m_currentFrame - 1].deltaTime, std::numeric_limits<float>::min());
+    }
+
+    void InputRecorder::captureUiInput() {
+        if (m_mode != Mode::Recording || m_frames.empty()) return;
+
+        const ImGuiIO& io = ImGui::GetIO();
+        UiInputState& ui = m_frames.back().ui;
+
+        ui.mousePosition = { io.MousePos.x, io.MousePos.y };
+        ui.mouseWheel = { io.MouseWheelH, io.MouseWheel };
+        ui.mouseButtons = 0;
+        for (int i = 0; i < ImGuiMouseButton_COUNT; i++) {
+            if (io.MouseDown[i]) ui.mouseButtons |= 1 << i;
+        }
+    }
+
+    uint32_t InputRecorder::pinAdaptiveValue(const AdaptiveValue adaptiveValue, const uint32_t value) {
+        const auto index = static_cast<size_t>(adaptiveValue);
+
+        if (m_mode == Mode::Recording && !m_frames.empty()) {
+            m_frames.back().adaptiveValues[index] = value;
+        } else if (m_mode == Mode::Replaying && m_currentFrame > 0) {
+            // 0 if the controller did not run in the recorded frame
+            const uint32_t recordedValue = m_frames[m_currentFrame - 1].adaptiveValues[index];
+            if (recordedValue > 0) return recordedValue;
+        }
+
+        return value;
+    }
+
+    void InputRecorder::writeFile(const std::filesystem::path& filePath) const {
+        if (filePath.has_parent_path()) {
+            std::filesystem::create_directories(filePath.parent_path());
+        }
+
+        std::ofstream file(filePath, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open input recording for writing: " + filePath.string());
+        }
+
+        FileHeader header{};
+        header.magic = FILE_MAGIC;
+        header.version = FILE_VERSION;
+        header.frameCount = static_cast<uint32_t>(m_frames.size());
+        header.windowWidth = m_windowExtent.width;
+        header.windowHeight = m_windowExtent.height;
+        header.fixedDeltaTime = m_fixedDeltaTime;
+        writeValue(file, header);
+
+        writeValue(file, static_cast<uint8_t>(m_cameraTransform.has_value()));
+        if (m_cameraTransform) {
+            writeValue(file, m_cameraTransform->translation);
+            writeValue(file, m_cameraTransform->scale);
+            writeValue(file, m_cameraTransform->rotation);
+        }
+        writeString(file, m_uiSettings);
+
+        for (const Frame& frame : m_frames) {
+            writeValue(file, frame.deltaTime);
+
+            std::array<uint8_t, KEY_BYTES> keyBytes{};
+            for (size_t i = 0; i < InputState::KEY_COUNT; i++) {
+                if (frame.input.keys[i]) keyBytes[i / 8] |= 1 << (i % 8);
+            }
+            writeValue(file, keyBytes);
+
+            writeValue(file, static_cast<uint16_t>(frame.input.mouseButtons.to_ulong()));
+            writeValue(file, frame.input.mousePosition);
+
+            writeValue(file, frame.ui.mousePosition);
+            writeValue(file, frame.ui.mouseWheel);
+            writeValue(file, frame.ui.mouseButtons);
+
+            writeValue(file, frame.adaptiveValues);
+        }
+
+        if (!file) {
+            throw std::runtime_error("Failed to write input recording: " + filePath.string());
+        }
+    }
+
+    void InputRecorder::readFile(const std::filesystem::path& filePath) {
+        std::ifstream file(filePath, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Failed to open input recording: " + filePath.string());
+        }
+
+        FileHeader header{};
+        readValue(file, header);
+        if (!file || header.magic != FILE_MAGIC) {
+            throw std::runtime_error("Not an input recording: " + filePath.string());
+        }
+        if (header.version == 0 || header.version > FILE_VERSION) {
+            throw std::runtime_error("Unsupported input recording version " + std::to_string(header.version) + ": " + filePath.string());
+        }
+
+        m_windowExtent = { header.windowWidth, header.windowHeight };
+        m_fixedDeltaTime = header.fixedDeltaTime;
+
+        m_cameraTransform.reset();
+        m_uiSettings.clear();
+        if (header.version >= 3) {
+            uint8_t hasCameraTransform = 0;
+            readValue(file, hasCameraTransform);
+            if (hasCameraTransform) {
+                TransformComponent& transform = m_cameraTransform.emplace();
+                readValue(file, transform.translation);
+                readValue(file, transform.scale);
+                readValue(file, transform.rotation);
+            }
+            readString(file, m_uiSettings);
+        }
+
+        m_frames.assign(header.frameCount, Frame{});
+        for (Frame& frame : m_frames) {
+            readValue(file, frame.deltaTime);
+
+            std::array<uint8_t, KEY_BYTES> keyBytes{};
+            readValue(file, keyBytes);
+            for (size_t i = 0; i < InputState::KEY_COUNT; i++) {
+                frame.input.keys[i] = (keyBytes[i / 8] >> (i % 8)) & 1;
+            }
+
+            uint16_t mouseButtons = 0;
+            readValue(file, mouseButtons);
+            frame.input.mouseButtons = std::bitset<InputState::MOUSE_BUTTON_COUNT>(mouseButtons);
+            readValue(file, frame.input.mousePosition);
+
+            readValue(file, frame.ui.mousePosition);
+            readValue(file, frame.ui.mouseWheel);
+            readValue(file, frame.ui.mouseButtons);
+
+            // the older recordings let the controllers adapt during the replay
+            if (header.version >= 2) {
+                readValue(file, frame.adaptiveValues);
+            }
+        }
+
+        if (!file) {
+            m_frames.clear();
+            throw std::runtime_error("Truncated input recording: " + filePath.string());
+        }
+    }
+
+    void InputRecorder::updateUi() {
+        switch (m_mode) {
+            case Mode::Idle: {
+                // both start with the application, from the freshly loaded scene
+                ImGui::TextWrapped("Record with PXT_RECORD=<file>, replay with PXT_REPLAY=<file>");
+
+                if (m_replayStats.frameCount > 0) {
+                    ImGui::Text("Last replay: %u frames, avg %.3f ms, max %.3f ms",
+                        m_replayStats.frameCount, m_replayStats.getAverageMs(), m_replayStats.maxMs);
+                }
+                break;
+            }
+            case Mode::Recording: {
+                ImGui::Text("Recording to %s: %zu frames", m_filePath.string().c_str(), m_frames.size());
+
+                if (ImGui::Button("Stop Recording", ImVec2(150, 0))) {
+                    try {
+                        stopRecording();
+                    } catch (const std::exception& e) {
+                        PXT_ERROR("{}", e.what());
+                    }
+                }
+                break;
+            }
+            case Mode::Replaying: {
+                ImGui::Text("Replaying: frame %zu / %zu", m_currentFrame, m_frames.size());
+                ImGui::Text("Press Escape to stop");
+                break;
+            }
+        }
+    }
+}
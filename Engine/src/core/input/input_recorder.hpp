@@ -0,0 +1,183 @@
+#pragma once
+
+#include "core/pch.hpp"
+
+#include "core/input/input_state.hpp"
+#include "scene/ecs/component.hpp"
+
+namespace PXTEngine {
+
+    /**
+     * @class InputRecorder
+     * @brief Records the per-frame input of a session to a binary file and replays it.
+     *
+     * Every frame stores the delta time, the state queried through the Input class (used by the
+     * camera controller and the other scripts) and the mouse state seen by ImGui, so that the
+     * parameters changed through the ui are changed again at the same frame.
+     *
+     * A replay feeds the recorded delta times back instead of the measured ones, i.e. it runs
+     * with a fixed timestep independent of how long the frames take to render, and the same
+     * camera path and interactions are reproduced frame by frame. This makes it usable to
+     * compare the frame times of two versions of the engine (A/B profiling).
+     *
+     * The values the adaptive controllers choose from the GPU timings (see AdaptiveValue) are
+     * recorded too, and forced while replaying: otherwise a faster or slower version would render
+     * a different amount of work for the same frames.
+     *
+     * Recordings and replays start with the application (PXT_RECORD and PXT_REPLAY), so that
+     * both run from the freshly loaded scene: the scripts keep state the recording can't restore.
+     * The file also stores the main camera transform and the ImGui window layout, restored before
+     * the first replayed frame, since the ui mouse positions only hit the same widgets with the
+     * same layout.
+     *
+     * The frames are kept in memory and the file is written when the recording stops.
+     * Keyboard input typed into ImGui widgets is not recorded.
+     */
+    class InputRecorder {
+    public:
+        enum class Mode : uint8_t {
+            Idle,
+            Recording,
+            Replaying,
+        };
+
+        /**
+         * @brief Mouse state as seen by ImGui in a frame.
+         */
+        struct UiInputState {
+            glm::vec2 mousePosition{0.0f};
+            glm::vec2 mouseWheel{0.0f};
+            uint8_t mouseButtons = 0; // one bit per ImGui mouse button
+        };
+
+        /**
+         * @brief The values chosen by the adaptive controllers, pinned with pinAdaptiveValue().
+         */
+        enum class AdaptiveValue : uint8_t {
+            SamplesPerPixel,  // SampleBudgetController
+            DensitySlabCount, // slabs of the volume generated by DensityTextureRenderSystem
+            Count,
+        };
+
+        static constexpr size_t ADAPTIVE_VALUE_COUNT = static_cast<size_t>(AdaptiveValue::Count);
+        static constexpr float DEFAULT_FIXED_DELTA_TIME = 1.0f / 60.0f;
+
+        struct Frame {
+            float deltaTime = 0.0f;
+            InputState input;
+            UiInputState ui;
+            std::array<uint32_t, ADAPTIVE_VALUE_COUNT> adaptiveValues{}; // 0 if not chosen in the frame
+        };
+
+        /**
+         * @brief Frame times measured while replaying, to compare runs.
+         */
+        struct ReplayStats {
+            uint32_t frameCount = 0;
+            float totalMs = 0.0f;
+            float maxMs = 0.0f;
+
+            float getAverageMs() const { return frameCount > 0 ? totalMs / static_cast<float>(frameCount) : 0.0f; }
+        };
+
+        InputRecorder() = default;
+        ~InputRecorder();
+
+        InputRecorder(const InputRecorder&) = delete;
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        /**
+         * @brief Starts recording the input of the next frames.
+         * Must be called before the first frame, once the scene is loaded.
+         *
+         * @param filePath File written when the recording stops.
+         * @param fixedDeltaTime If greater than 0, the frames are simulated with this delta time
+         * instead of the measured one while recording too.
+         */
+        void startRecording(const std::filesystem::path& filePath, VkExtent2D windowExtent, float fixedDeltaTime = 0.0f);
+
+        /**
+         * @brief Stops the recording and writes the file.
+         *
+         * @throws std::runtime_error If the file cannot be written.
+         */
+        void stopRecording();
+
+        /**
+         * @brief Loads a recording and starts replaying it from the next frame.
+         * Must be called before the first frame, once the scene is loaded: the recorded camera
+         * transform and ui layout are restored here.
+         *
+         * @param exitWhenFinished If true, isFinished() becomes true at the end of the replay,
+         * the application uses it to close itself (for benchmarks run from scripts).
+         * @throws std::runtime_error If the file cannot be read or is not a valid recording.
+         */
+        void startReplay(const std::filesystem::path& filePath, VkExtent2D windowExtent, bool exitWhenFinished = false);
+        void stopReplay();
+
+        /**
+         * @brief Captures or replays the input of a new frame. Must be called once per frame,
+         * after the window events have been polled and before the scene is updated.
+         *
+         * @param elapsedTime Measured time since the last frame, in seconds.
+         * @return The delta time the frame has to be simulated with.
+         */
+        float beginFrame(GLFWwindow* window, float elapsedTime);
+
+        /**
+         * @brief Replaces the ImGui mouse input with the replayed one.
+         * Must be called after the ImGui platform backend new frame and before ImGui::NewFrame.
+         */
+        void applyUiInput();
+
+        /**
+         * @brief Stores the mouse input ImGui has used this frame.
+         * Must be called after ImGui::NewFrame.
+         */
+        void captureUiInput();
+
+        /**
+         * @brief Pins a value chosen by an adaptive controller this frame: it is stored while
+         * recording and replaced with the recorded one while replaying.
+         *
+         * @param value The value chosen by the controller, greater than 0.
+         * @return The value the frame has to use.
+         */
+        uint32_t pinAdaptiveValue(AdaptiveValue adaptiveValue, uint32_t value);
+
+        Mode getMode() const { return m_mode; }
+        bool isFinished() const { return m_isFinished; }
+        const ReplayStats& getReplayStats() const { return m_replayStats; }
+
+        void updateUi();
+
+    private:
+        static constexpr uint32_t FILE_MAGIC = 0x52545850; // "PXTR"
+        static constexpr uint32_t FILE_VERSION = 3; // 1: without the adaptive values, 2: without the camera and ui layout
+
+        void writeFile(const std::filesystem::path& filePath) const;
+        void readFile(const std::filesystem::path& filePath);
+
+        void finishReplay();
+
+        Mode m_mode = Mode::Idle;
+
+        std::vector<Frame> m_frames;
+        size_t m_currentFrame = 0;
+
+        std::filesystem::path m_filePath;
+        VkExtent2D m_windowExtent{};
+        float m_fixedDeltaTime = 0.0f;
+
+        // state at the first frame, restored before replaying
+        std::optional<TransformComponent> m_cameraTransform;
+        std::string m_uiSettings;
+
+        // replay
+        bool m_exitWhenFinished = false;
+        bool m_isFinished = false;
+        bool m_savedTrickleEventQueue = true;
+        const char* m_savedIniFilename = nullptr;
+        ReplayStats m_replayStats{};
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "core/pch.hpp"
+
+#include "core/input/key_code.hpp"
+#include "core/input/mapper/glfw_input_mapper.hpp"
+
+#include <bitset>
+
+namespace PXTEngine {
+
+    /**
+     * @struct InputState
+     * @brief Snapshot of the keyboard and mouse state that the Input class can query.
+     *
+     * Used to record the input of a frame and to replay it later in place of the window.
+     */
+    struct InputState {
+        static constexpr size_t KEY_COUNT = static_cast<size_t>(KeyCode::RightFn) + 1;
+        static constexpr size_t MOUSE_BUTTON_COUNT = static_cast<size_t>(MouseButton::Button8) + 1;
+
+        std::bitset<KEY_COUNT> keys;
+        std::bitset<MOUSE_BUTTON_COUNT> mouseButtons;
+        glm::vec2 mousePosition{0.0f};
+
+        bool isKeyPressed(KeyCode key) const {
+            return keys.test(static_cast<size_t>(key));
+        }
+
+        bool isMouseButtonPressed(MouseButton button) const {
+            return mouseButtons.test(static_cast<size_t>(button));
+        }
+
+        /**
+         * @brief Reads the current state of every mapped key and mouse button of a window.
+         */
+        static InputState capture(GLFWwindow* window) {
+            InputState state;
+
+            for (size_t i = 0; i < KEY_COUNT; i++) {
+                const int glfwKey = mapToGLFWKey(static_cast<KeyCode>(i));
+                // querying an unknown key is a glfw error
+                if (glfwKey != GLFW_KEY_UNKNOWN) {
+                    state.keys[i] = glfwGetKey(window, glfwKey) == GLFW_PRESS;
+                }
+            }
+
+            for (size_t i = 0; i < MOUSE_BUTTON_COUNT; i++) {
+                const MouseButton button = static_cast<MouseButton>(i);
+                if (button != MouseButton::Unknown) {
+                    state.mouseButtons[i] = glfwGetMouseButton(window, mapToGLFWMouseButton(button)) == GLFW_PRESS;
+                }
+            }
+
+            double x, y;
+            glfwGetCursorPos(window, &x, &y);
+            state.mousePosition = { x, y };
+
+            return state;
+        }
+    };
+}
@@ -76,6 +76,9 @@
 // --- Engine-Specific Headers --- //
 
 #include "core/memory.hpp"
+#include "core/allocation_tracker.hpp"
+#include "core/startup_profiler.hpp"
+#include "core/frame_arena.hpp"
 #include "core/logger.hpp"
 #include "core/diagnostics.hpp"
 #include "core/constants.hpp"
\ No newline at end of file
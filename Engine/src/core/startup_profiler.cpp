@@ -0,0 +1,232 @@
+#include "core/startup_profiler.hpp"
+
+#include "core/allocation_tracker.hpp"
+#include "core/logger.hpp"
+#include "core/platform.hpp"
+
+#include <fstream>
+#include <optional>
+#include <thread>
+
+#if defined(PXT_PLATFORM_WINDOWS)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+namespace PXTEngine {
+
+	namespace {
+		// only touched by the main thread, the other ones only add to the read bytes
+		std::vector<StartupProfiler::Phase> g_phases;
+		std::vector<uint32_t> g_phaseStack;
+		std::thread::id g_mainThread;
+
+		// read by the scopes opened on any thread, g_mainThread is set before it is
+		std::atomic<bool> g_isRecording{false};
+
+		// from start() to finish()
+		std::optional<StartupProfiler::Scope> g_rootPhase;
+
+		uint64_t getProcessCpuTimeNs() {
+#if defined(PXT_PLATFORM_WINDOWS)
+			FILETIME creationTime, exitTime, kernelTime, userTime;
+			if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) return 0;
+
+			// 100 ns ticks
+			const auto toTicks = [](const FILETIME& time) {
+				return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+			};
+			return (toTicks(kernelTime) + toTicks(userTime)) * 100;
+#else
+			timespec time{};
+			if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0) return 0;
+
+			return static_cast<uint64_t>(time.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(time.tv_nsec);
+#endif
+		}
+
+		std::string formatBytes(const uint64_t bytes) {
+			if (bytes >= 1024 * 1024) return std::format("{:.2f} MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+			if (bytes >= 1024) return std::format("{:.2f} KB", static_cast<double>(bytes) / 1024.0);
+			return std::format("{} B", bytes);
+		}
+
+		double getSelfWallMs(const StartupProfiler::Phase& phase) {
+			double childrenMs = 0.0;
+			for (const uint32_t child : phase.children) {
+				childrenMs += g_phases[child].wallMs;
+			}
+
+			// the children of a phase entered several times may overlap its own calls only partially
+			return std::max(phase.wallMs - childrenMs, 0.0);
+		}
+
+		void appendJsonString(std::string& json, const char* value) {
+			json += '"';
+			for (const char* c = value; *c != '\0'; c++) {
+				if (*c == '"' || *c == '\\') json += '\\';
+				json += *c;
+			}
+			json += '"';
+		}
+	}
+
+	StartupProfiler::Scope::Scope(const char* name) {
+		if (!isRecording() || std::this_thread::get_id() != g_mainThread) return;
+
+		m_phase = enterPhase(name);
+		m_begin = takeSnapshot();
+	}
+
+	StartupProfiler::Scope::~Scope() {
+		// finish() may have been called in the meantime, the phase is then left as it was
+		if (m_phase == NO_PARENT || !isRecording()) return;
+
+		const Snapshot end = takeSnapshot();
+
+		Phase& phase = g_phases[m_phase];
+		phase.wallMs += std::chrono::duration<double, std::milli>(end.wallTime - m_begin.wallTime).count();
+		phase.cpuMs += static_cast<double>(end.cpuTimeNs - m_begin.cpuTimeNs) * 1e-6;
+		phase.readBytes += end.readBytes - m_begin.readBytes;
+		phase.allocationCount += end.allocationCount - m_begin.allocationCount;
+
+		exitPhase(m_phase);
+	}
+
+	StartupProfiler::Scope::Snapshot StartupProfiler::Scope::takeSnapshot() {
+		return Snapshot{
+			std::chrono::steady_clock::now(),
+			getProcessCpuTimeNs(),
+			s_readBytes.load(std::memory_order_relaxed),
+			AllocationTracker::getTotalAllocationCount()
+		};
+	}
+
+	uint32_t StartupProfiler::enterPhase(const char* name) {
+		const uint32_t parent = g_phaseStack.empty() ? NO_PARENT : g_phaseStack.back();
+
+		// merge with a previous call under the same parent
+		uint32_t phase = NO_PARENT;
+		if (parent != NO_PARENT) {
+			for (const uint32_t child : g_phases[parent].children) {
+				if (std::strcmp(g_phases[child].name, name) == 0) {
+					phase = child;
+					break;
+				}
+			}
+		}
+
+		if (phase == NO_PARENT) {
+			phase = static_cast<uint32_t>(g_phases.size());
+			g_phases.push_back(Phase{ name, parent });
+
+			if (parent != NO_PARENT) {
+				g_phases[parent].children.push_back(phase);
+			}
+		}
+
+		g_phases[phase].callCount++;
+		g_phaseStack.push_back(phase);
+		return phase;
+	}
+
+	void StartupProfiler::exitPhase(const uint32_t phase) {
+		PXT_ASSERT(!g_phaseStack.empty() && g_phaseStack.back() == phase, "Startup phases must be exited in reverse order");
+		g_phaseStack.pop_back();
+	}
+
+	void StartupProfiler::start() {
+		PXT_ASSERT(g_phases.empty(), "StartupProfiler::start called twice");
+
+		g_mainThread = std::this_thread::get_id();
+		g_isRecording.store(true, std::memory_order_release);
+
+		g_rootPhase.emplace("Startup");
+	}
+
+	bool StartupProfiler::isRecording() {
+		return g_isRecording.load(std::memory_order_acquire);
+	}
+
+	void StartupProfiler::recordFileRead(const std::filesystem::path& filePath) {
+		std::error_code error;
+		const uintmax_t size = std::filesystem::file_size(filePath, error);
+		if (!error) recordRead(size);
+	}
+
+	const std::vector<StartupProfiler::Phase>& StartupProfiler::getPhases() {
+		return g_phases;
+	}
+
+	void StartupProfiler::finish() {
+		if (!isRecording()) return;
+
+		// the phases still open are left out of the root, they keep the values of their previous calls
+		PXT_ASSERT(g_phaseStack.size() == 1, "StartupProfiler::finish called with phases still open");
+		g_phaseStack.resize(1);
+		g_rootPhase.reset();
+
+		g_isRecording.store(false, std::memory_order_release);
+
+		PXT_INFO("Startup phases (wall ms | self ms | cpu ms | read | allocations | calls):");
+		logPhase(0, 0);
+
+		if (const char* reportFile = std::getenv("PXT_STARTUP_REPORT")) {
+			writeJson(reportFile);
+			PXT_INFO("Startup report written to {}", reportFile);
+		}
+	}
+
+	void StartupProfiler::logPhase(const uint32_t phase, const uint32_t depth) {
+		const Phase& p = g_phases[phase];
+
+		const std::string allocations = AllocationTracker::isEnabled() ? std::to_string(p.allocationCount) : "-";
+		PXT_INFO("{:{}}{}: {:.1f} | {:.1f} | {:.1f} | {} | {} | {}", "", depth * 2, p.name,
+			p.wallMs, getSelfWallMs(p), p.cpuMs, formatBytes(p.readBytes), allocations, p.callCount);
+
+		for (const uint32_t child : p.children) {
+			logPhase(child, depth + 1);
+		}
+	}
+
+	void StartupProfiler::writeJson(const std::filesystem::path& filePath) {
+		if (g_phases.empty()) return;
+
+		std::string json;
+		writeJsonPhase(json, 0, 0);
+		json += "\n";
+
+		std::ofstream file(filePath, std::ios::binary);
+		if (!file) {
+			PXT_ERROR("Failed to open the startup report file {}", filePath.string());
+			return;
+		}
+		file << json;
+	}
+
+	void StartupProfiler::writeJsonPhase(std::string& json, const uint32_t phase, const uint32_t depth) {
+		const Phase& p = g_phases[phase];
+		const std::string indent(depth * 2, ' ');
+
+		json += indent + "{ \"name\": ";
+		appendJsonString(json, p.name);
+		json += std::format(", \"calls\": {}, \"wallMs\": {:.3f}, \"selfMs\": {:.3f}, \"cpuMs\": {:.3f}, \"readBytes\": {}, \"allocations\": ",
+			p.callCount, p.wallMs, getSelfWallMs(p), p.cpuMs, p.readBytes);
+		json += AllocationTracker::isEnabled() ? std::to_string(p.allocationCount) : "null";
+
+		if (p.children.empty()) {
+			json += ", \"children\": [] }";
+			return;
+		}
+
+		json += ", \"children\": [\n";
+		for (size_t i = 0; i < p.children.size(); i++) {
+			if (i > 0) json += ",\n";
+			writeJsonPhase(json, p.children[i], depth + 1);
+		}
+		json += "\n" + indent + "] }";
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace PXTEngine {
+
+	/**
+	 * @class StartupProfiler
+	 *
+	 * @brief Breaks the time to first frame down into a tree of phases.
+	 *
+	 * Recording starts with start() in main and ends with finish(), called by the
+	 * application once the first frame rendering the scene has been presented. In between, every
+	 * PXT_STARTUP_PHASE opened on the main thread becomes a node of the tree, nested in
+	 * the phase enclosing it. The phases entered several times under the same parent
+	 * (one shader compilation per pipeline, one BLAS per mesh...) are merged into one node
+	 * counting the calls.
+	 *
+	 * For every phase it keeps the wall time, the CPU time of the process (worker threads
+	 * included), the bytes read from disk (reported by the file loaders with recordRead)
+	 * and, with PXT_TRACK_ALLOCATIONS, the number of heap allocations. The values include
+	 * the nested phases, the report also shows the self wall time.
+	 *
+	 * finish() logs the report and, if the PXT_STARTUP_REPORT environment variable is set,
+	 * writes it as JSON to the file it names. Once finished the phases cost a branch.
+	 */
+	class StartupProfiler {
+	public:
+		static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+		struct Phase {
+			const char* name;
+			uint32_t parent = NO_PARENT;
+			std::vector<uint32_t> children;
+
+			uint32_t callCount = 0;
+			double wallMs = 0.0;
+			double cpuMs = 0.0;
+			uint64_t readBytes = 0;
+			uint64_t allocationCount = 0;
+		};
+
+		/**
+		 * @brief Enters a phase while in scope, does nothing off the main thread or
+		 * outside of start() and finish().
+		 */
+		class Scope {
+		public:
+			explicit Scope(const char* name);
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			struct Snapshot {
+				std::chrono::steady_clock::time_point wallTime;
+				uint64_t cpuTimeNs;
+				uint64_t readBytes;
+				uint64_t allocationCount;
+			};
+
+			static Snapshot takeSnapshot();
+
+			uint32_t m_phase = NO_PARENT;
+			Snapshot m_begin{};
+		};
+
+		/**
+		 * @brief Starts recording, on the main thread: the phases of the other threads are ignored.
+		 * Opens the root phase, which lasts until finish().
+		 */
+		static void start();
+
+		/**
+		 * @brief Closes the root phase, logs the report and writes the JSON file if asked to.
+		 */
+		static void finish();
+
+		static bool isRecording();
+
+		/**
+		 * @brief Counts bytes read from disk, from any thread. Charged to every phase open
+		 * on the main thread while they are read.
+		 */
+		static void recordRead(uint64_t bytes) {
+			s_readBytes.fetch_add(bytes, std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Counts a whole file as read, for the loaders that don't expose the bytes they read.
+		 */
+		static void recordFileRead(const std::filesystem::path& filePath);
+
+		/**
+		 * @brief The recorded phases, the first one is the root.
+		 */
+		static const std::vector<Phase>& getPhases();
+
+		static void writeJson(const std::filesystem::path& filePath);
+
+	private:
+		static uint32_t enterPhase(const char* name);
+		static void exitPhase(uint32_t phase);
+
+		static void logPhase(uint32_t phase, uint32_t depth);
+		static void writeJsonPhase(std::string& json, uint32_t phase, uint32_t depth);
+
+		static inline std::atomic<uint64_t> s_readBytes{0};
+	};
+}
+
+#define PXT_STARTUP_PHASE_CONCAT_IMPL(a, b) a##b
+#define PXT_STARTUP_PHASE_CONCAT(a, b) PXT_STARTUP_PHASE_CONCAT_IMPL(a, b)
+
+// Records the rest of the enclosing block as a startup phase, see StartupProfiler
+#define PXT_STARTUP_PHASE(name) \
+	::PXTEngine::StartupProfiler::Scope PXT_STARTUP_PHASE_CONCAT(pxtStartupPhase, __LINE__)(name)
@@ -4,29 +4,129 @@
 
 namespace PXTEngine {
 
-	UUID::UUID(const std::string& uuidString) {
+	namespace {
+
+		/**
+		 * @brief Small and fast PRNG (xoshiro256**) used to generate UUIDs.
+		 *
+		 * One instance lives in every thread and is seeded lazily on first use,
+		 * so std::random_device is queried only once per thread instead of
+		 * once per generated UUID.
+		 */
+		class UUIDRandom {
+		public:
+			UUIDRandom() {
+				std::random_device rd;
+				uint64_t seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+
+				// Expand the seed with splitmix64, as recommended by the xoshiro authors.
+				for (uint64_t& s : m_state) {
+					seed += 0x9E3779B97F4A7C15ULL;
+					uint64_t z = seed;
+					z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+					z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+					s = z ^ (z >> 31);
+				}
+			}
+
+			uint64_t next() {
+				const uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+				const uint64_t t = m_state[1] << 17;
+
+				m_state[2] ^= m_state[0];
+				m_state[3] ^= m_state[1];
+				m_state[1] ^= m_state[2];
+				m_state[0] ^= m_state[3];
+				m_state[2] ^= t;
+				m_state[3] = rotl(m_state[3], 45);
+
+				return result;
+			}
+
+		private:
+			static uint64_t rotl(const uint64_t x, const int k) {
+				return (x << k) | (x >> (64 - k));
+			}
+
+			uint64_t m_state[4];
+		};
+
+		UUIDRandom& threadRandom() {
+			thread_local UUIDRandom random;
+			return random;
+		}
+
+		// Lowercase hex pair for every byte value, used by toChars.
+		constexpr std::array<char, 512> HEX_PAIRS = [] {
+			constexpr char digits[] = "0123456789abcdef";
+			std::array<char, 512> table{};
+			for (size_t i = 0; i < 256; i++) {
+				table[i * 2] = digits[i >> 4];
+				table[i * 2 + 1] = digits[i & 0xF];
+			}
+			return table;
+		}();
+
+		// Nibble value for every character, 0xFF marks an invalid hex digit.
+		constexpr std::array<uint8_t, 256> HEX_VALUES = [] {
+			std::array<uint8_t, 256> table{};
+			table.fill(0xFF);
+			for (uint8_t i = 0; i < 10; i++) table['0' + i] = i;
+			for (uint8_t i = 0; i < 6; i++) {
+				table['a' + i] = 10 + i;
+				table['A' + i] = 10 + i;
+			}
+			return table;
+		}();
+
+		// Parses `count` hex digits starting at `str` into `value`. Returns false on invalid digits.
+		bool parseHex(const char* str, const size_t count, uint64_t& value) {
+			for (size_t i = 0; i < count; i++) {
+				const uint8_t nibble = HEX_VALUES[static_cast<uint8_t>(str[i])];
+				if (nibble == 0xFF) return false;
+				value = (value << 4) | nibble;
+			}
+			return true;
+		}
+
+		// Writes the `byteCount` most significant bytes of `value` (starting at `shift`) as hex.
+		char* writeHex(char* out, const uint64_t value, int shift, size_t byteCount) {
+			for (; byteCount > 0; byteCount--, shift -= 8) {
+				const size_t byte = (value >> shift) & 0xFF;
+				*out++ = HEX_PAIRS[byte * 2];
+				*out++ = HEX_PAIRS[byte * 2 + 1];
+			}
+			return out;
+		}
+	}
+
+	UUID::UUID(const std::string_view uuidString) {
         // Length: 32 hex characters + 4 hyphens = 36 characters.
-        if (uuidString.length() != 36) return;
-        
+        if (uuidString.length() != STRING_LENGTH) return;
 
         // Check hyphen positions.
-        if (uuidString[8]  != '-' || uuidString[13] != '-' || 
+        if (uuidString[8]  != '-' || uuidString[13] != '-' ||
             uuidString[18] != '-' || uuidString[23] != '-') {
             return;
         }
 
-        // Create a copy of the string and remove the hyphens.
-        std::string hexString = uuidString;
-        std::erase(hexString, '-');
+        const char* str = uuidString.data();
+        uint64_t high = 0;
+        uint64_t low = 0;
 
-        try {
-            // The first 16 hex characters represent the high 64 bits.
-            m_high = std::stoull(hexString.substr(0, 16), nullptr, 16);
-            // The next 16 hex characters represent the low 64 bits.
-            m_low = std::stoull(hexString.substr(16, 16), nullptr, 16);
-        } catch (const std::exception& _) {
-            return;
-        }
+        // The first 16 hex characters represent the high 64 bits,
+        // the next 16 hex characters represent the low 64 bits.
+        const bool valid =
+            parseHex(str, 8, high) &&
+            parseHex(str + 9, 4, high) &&
+            parseHex(str + 14, 4, high) &&
+            parseHex(str + 19, 4, low) &&
+            parseHex(str + 24, 12, low);
+
+        if (!valid) return;
+
+        m_high = high;
+        m_low = low;
     }
 
 	UUID::UUID() {
@@ -48,12 +148,10 @@ namespace PXTEngine {
 		// UUID v4 structure: 128 bits of random data with version and variant bits set.
 		// Version 4 (0100) is in bits 60-63. Variant (10xx) is in bits 64-65.
 
-		std::random_device rd;
-		std::mt19937_64 gen(rd());
-		std::uniform_int_distribution<uint64_t> dist;
+		UUIDRandom& random = threadRandom();
 
-		uint64_t randomHigh = dist(gen);
-		uint64_t randomLow = dist(gen);
+		uint64_t randomHigh = random.next();
+		uint64_t randomLow = random.next();
 
 		// Set version 4 (0100) in high part (bits 12-15 from right).
 		randomHigh = (randomHigh & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000004000ULL;
@@ -66,45 +164,59 @@ namespace PXTEngine {
 
     UUID UUID::generateUUIDv7() {
         // UUID v7 structure: 48-bit timestamp | 4-bit version |
-        //                    | 12-bit rand_a | 2-bit variant | 62-bit rand_b
+        //                    | 12-bit counter (rand_a) | 2-bit variant | 62-bit rand_b
+
+        // Per-thread state to keep UUIDs generated within the same millisecond ordered.
+        thread_local uint64_t lastTimestampMs = 0;
+        thread_local uint64_t counter = 0;
+
+        UUIDRandom& random = threadRandom();
 
         // Get 48-bit Unix Epoch timestamp in milliseconds.
         auto now = std::chrono::system_clock::now();
         uint64_t timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
         timestampMs &= 0xFFFFFFFFFFFFULL; // Mask to 48 bits
 
-        // Generate random bits for rand_a (12 bits) and rand_b (62 bits).
-        std::random_device rd;
-        std::mt19937_64 gen(rd());
-        std::uniform_int_distribution<uint64_t> dist;
-
-        const uint64_t randomAPart = dist(gen); // Use lower 12 bits for rand_a
-        const uint64_t randomBPart = dist(gen); // Use lower 62 bits for rand_b
+        if (timestampMs > lastTimestampMs) {
+            // New millisecond: seed the counter randomly, keeping the top bit clear
+            // so there is room for at least 2048 increments before overflowing.
+            lastTimestampMs = timestampMs;
+            counter = random.next() >> 53; // 11 random bits
+        } else if (++counter > 0xFFFULL) {
+            // Counter overflow (or clock going backwards): borrow the next millisecond.
+            lastTimestampMs++;
+            counter = 0;
+        }
 
-        // Assemble high 64 bits: timestamp (48) | version (7) | rand_a (12 random)
-        uint64_t high = (timestampMs << 16) |   // Timestamp shifted
-			(0x7ULL << 12) |                    // Version 7 shifted
-			(randomAPart & 0xFFFULL);           // rand_a (12 random bits) placed
+        // Assemble high 64 bits: timestamp (48) | version (7) | counter (12)
+        uint64_t high = ((lastTimestampMs & 0xFFFFFFFFFFFFULL) << 16) | // Timestamp shifted
+			(0x7ULL << 12) |                                           // Version 7 shifted
+			counter;                                                   // Monotonic counter placed
 
-        // Assemble low 64 bits: variant (10xx) | rand_b (62 random)
-			uint64_t low = (0x8ULL << 60) |       // Variant 1 (10) shifted
-            (randomBPart & 0x3FFFFFFFFFFFFFFULL); // Rand_b (62 random bits) placed
+        // Assemble low 64 bits: variant (10) | rand_b (62 random)
+		uint64_t low = (0x2ULL << 62) |             // Variant 1 (10) shifted
+            (random.next() & 0x3FFFFFFFFFFFFFFFULL); // Rand_b (62 random bits) placed
 
         return { high, low };
     }
 
-    std::string UUID::toString() const {
-        std::stringstream ss;
-        ss << std::hex << std::setfill('0');
-
-        // Extract and format parts from m_high and m_low based on standard UUID string layout.
-        ss << std::setw(8) << (m_high >> 32) << "-";            // First 32 bits of m_high
-        ss << std::setw(4) << ((m_high >> 16) & 0xFFFF) << "-"; // Next 16 bits of m_high
-        ss << std::setw(4) << (m_high & 0xFFFF) << "-";         // Last 16 bits of m_high
-        ss << std::setw(4) << (m_low >> 48) << "-";             // First 16 bits of m_low
-        ss << std::setw(12) << (m_low & 0xFFFFFFFFFFFFULL);     // Last 48 bits of m_low
+    void UUID::toChars(char* out) const {
+        // Layout: 8-4-4-4-12 hex characters.
+        out = writeHex(out, m_high, 56, 4); // First 32 bits of m_high
+        *out++ = '-';
+        out = writeHex(out, m_high, 24, 2); // Next 16 bits of m_high
+        *out++ = '-';
+        out = writeHex(out, m_high, 8, 2);  // Last 16 bits of m_high
+        *out++ = '-';
+        out = writeHex(out, m_low, 56, 2);  // First 16 bits of m_low
+        *out++ = '-';
+        writeHex(out, m_low, 40, 6);        // Last 48 bits of m_low
+    }
 
-        return ss.str();
+    std::string UUID::toString() const {
+        std::string result(STRING_LENGTH, '\0');
+        toChars(result.data());
+        return result;
     }
 
 };
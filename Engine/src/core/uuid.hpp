@@ -35,12 +35,13 @@ namespace PXTEngine {
 
         /**
 	     * @brief Constructs a UUID from a standard hyphenated string representation.
-	     * Parses a string in the format "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx".
+	     * Parses a string in the format "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx"
+	     * (hex digits are case-insensitive).
 	     * If the string is not valid, the UUID will be initialized to zero.
 	     *
 	     * @param uuidString The string representation of the UUID.
 	     */
-        explicit UUID(const std::string& uuidString);
+        explicit UUID(std::string_view uuidString);
 
 		bool operator==(const UUID& other) const {
 			return m_high == other.m_high && m_low == other.m_low;
@@ -54,6 +55,16 @@ namespace PXTEngine {
          */
         [[nodiscard]] std::string toString() const;
 
+        /**
+         * @brief Writes the hyphenated string representation of the UUID into
+         * a caller provided buffer, without allocating.
+         *
+         * @param out Buffer of at least STRING_LENGTH characters. No null terminator is written.
+         */
+        void toChars(char* out) const;
+
+        static constexpr size_t STRING_LENGTH = 36;
+
     private:
 		UUID(const uint64_t high, const uint64_t low)
 			: m_high(high), m_low(low) {}
@@ -63,7 +74,8 @@ namespace PXTEngine {
 
         /**
 	     * @brief Generates a Universally Unique Identifier (UUID) according to version 4.
-	     * UUID v4 is random and not time-based. Thread-safe.
+	     * UUID v4 is random and not time-based. Thread-safe, every thread owns
+	     * its own lazily seeded generator.
 	     * 
 	     * @return A new UUID of version 4 (binary representation).
 	     */
@@ -73,11 +85,11 @@ namespace PXTEngine {
 	     * @brief Generates a Universally Unique Identifier (UUID) according to version 7.
 	     * UUID v7 is time-based with a random component.
 	     *
-	     * @note Deviation from Standard UUIDv7 (RFC 9562): This implementation omits the
-	     * standard monotonic counter. The 12 bits intended for the counter are filled
-	     * with random data instead, losing the standard guarantee of monotonic ordering
-	     * within the same millisecond and relies solely on randomness for uniqueness in
-		 * rapid bursts within that time. (Very unlikely to happen in practice)
+	     * The 12 bit rand_a field is used as a monotonic counter (RFC 9562, method 1):
+	     * it is seeded randomly on every new millisecond and incremented for each UUID
+	     * generated within the same millisecond, so UUIDs created by the same thread
+	     * are strictly increasing. When the counter overflows the timestamp is advanced
+	     * by one millisecond.
 	     *
 	     * @return A new UUID of version 7 (binary representation).
 	     */
@@ -97,17 +109,23 @@ template<>
 struct std::hash<PXTEngine::UUID> {
     /**
      * @brief Computes the hash for a given UUID.
-     * Combines the hash values of the high and low 64-bit components.
+     * Folds the high and low 64-bit components together and runs the result
+     * through a 64-bit avalanche finalizer (MurmurHash3 fmix64), so that
+     * v7 UUIDs, which share most of their timestamp bits, still spread
+     * evenly across buckets.
      *
      * @param uuid The UUID to be hashed.
      * @return The hash value of the UUID as size_t.
      */
     std::size_t operator()(const PXTEngine::UUID& uuid) const noexcept {
-        constexpr std::hash<uint64_t> hasher;
+        uint64_t h = (uuid.m_high * 0x9E3779B97F4A7C15ULL) ^ uuid.m_low;
 
-        const uint64_t h1 = hasher(uuid.m_high);
-        const uint64_t h2 = hasher(uuid.m_low);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
 
-        return h1 ^ h2;
+        return static_cast<std::size_t>(h);
     }
 };
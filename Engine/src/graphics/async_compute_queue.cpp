@@ -0,0 +1,114 @@
+#include "graphics/async_compute_queue.hpp"
+
+namespace PXTEngine {
+
+	AsyncComputeQueue::AsyncComputeQueue(Context& context) : m_context(context), m_timeline(context.getDevice()) {
+		PXT_ASSERT(m_context.hasAsyncCompute(), "AsyncComputeQueue needs a dedicated compute queue family");
+
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.queueFamilyIndex = m_context.getComputeQueueFamily();
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+		if (vkCreateCommandPool(m_context.getDevice(), &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create async compute command pool!");
+		}
+
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocInfo.commandPool = m_commandPool;
+		allocInfo.commandBufferCount = MAX_SUBMISSIONS_PER_FRAME;
+
+		for (auto& frameCommandBuffers : m_commandBuffers) {
+			if (vkAllocateCommandBuffers(m_context.getDevice(), &allocInfo, frameCommandBuffers.data()) != VK_SUCCESS) {
+				throw std::runtime_error("failed to allocate async compute command buffers!");
+			}
+		}
+	}
+
+	AsyncComputeQueue::~AsyncComputeQueue() {
+		m_timeline.waitIdle();
+
+		for (auto& frameCommandBuffers : m_commandBuffers) {
+			vkFreeCommandBuffers(m_context.getDevice(), m_commandPool, MAX_SUBMISSIONS_PER_FRAME, frameCommandBuffers.data());
+		}
+		vkDestroyCommandPool(m_context.getDevice(), m_commandPool, nullptr);
+	}
+
+	void AsyncComputeQueue::beginFrame(const uint32_t frameIndex) {
+		PXT_ASSERT(frameIndex < SwapChain::MAX_FRAMES_IN_FLIGHT, "AsyncComputeQueue frame index out of range");
+
+		// usually already reached: the graphics frame waiting on it has been waited on too
+		m_timeline.wait(m_frameValues[frameIndex]);
+		m_begunCounts[frameIndex] = 0;
+	}
+
+	VkCommandBuffer AsyncComputeQueue::begin(const uint32_t frameIndex) {
+		PXT_ASSERT(frameIndex < SwapChain::MAX_FRAMES_IN_FLIGHT, "AsyncComputeQueue frame index out of range");
+		PXT_ASSERT(m_begunCounts[frameIndex] < MAX_SUBMISSIONS_PER_FRAME, "Too many async compute submissions in a frame");
+
+		VkCommandBuffer commandBuffer = m_commandBuffers[frameIndex][m_begunCounts[frameIndex]++];
+		vkResetCommandBuffer(commandBuffer, 0);
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+			throw std::runtime_error("failed to begin recording async compute command buffer!");
+		}
+
+		return commandBuffer;
+	}
+
+	uint64_t AsyncComputeQueue::submit(const uint32_t frameIndex, const std::vector<SemaphoreWait>& waits) {
+		PXT_ASSERT(m_begunCounts[frameIndex] > 0, "No async compute command buffer begun");
+
+		VkCommandBuffer commandBuffer = m_commandBuffers[frameIndex][m_begunCounts[frameIndex] - 1];
+
+		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("failed to record async compute command buffer!");
+		}
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &commandBuffer;
+
+		// unlike a binary semaphore, the timeline can be signaled whether or not someone waits on it
+		const uint64_t value = m_timeline.advance();
+		const VkSemaphore semaphore = m_timeline.getSemaphore();
+
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &value;
+
+		std::vector<VkSemaphore> waitSemaphores;
+		std::vector<VkPipelineStageFlags> waitStages;
+		std::vector<uint64_t> waitValues;
+		for (const SemaphoreWait& wait : waits) {
+			waitSemaphores.push_back(wait.semaphore);
+			waitStages.push_back(wait.stage);
+			waitValues.push_back(wait.value);
+		}
+
+		timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+		timelineInfo.pWaitSemaphoreValues = waitValues.data();
+
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+		submitInfo.pWaitSemaphores = waitSemaphores.data();
+		submitInfo.pWaitDstStageMask = waitStages.data();
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &semaphore;
+
+		if (vkQueueSubmit(m_context.getComputeQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+			throw std::runtime_error("failed to submit async compute command buffer!");
+		}
+
+		m_frameValues[frameIndex] = value;
+		return value;
+	}
+}
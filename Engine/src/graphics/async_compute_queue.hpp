@@ -0,0 +1,77 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/context/context.hpp"
+#include "graphics/swap_chain.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @brief Records and submits compute work to the dedicated compute queue, so that it runs
+	 * alongside the frame's graphics work instead of being serialized with it.
+	 *
+	 * Every frame in flight owns MAX_SUBMISSIONS_PER_FRAME command buffers. Every submission
+	 * signals the next value of the queue's own timeline, which the graphics submissions can
+	 * wait on (see Renderer::addWaitSemaphore) at the stages reading the compute results, and
+	 * which tells when the command buffers of a frame index can be recorded again.
+	 * Only available when the device exposes a compute family without graphics
+	 * (Context::hasAsyncCompute), otherwise the work is recorded into the graphics command buffer.
+	 *
+	 * Resources written here and read by the graphics queue must be created with
+	 * Context::getAsyncComputeQueueFamilies, no ownership transfers are recorded.
+	 */
+	class AsyncComputeQueue {
+	public:
+		AsyncComputeQueue(Context& context);
+		~AsyncComputeQueue();
+
+		AsyncComputeQueue(const AsyncComputeQueue&) = delete;
+		AsyncComputeQueue& operator=(const AsyncComputeQueue&) = delete;
+
+		// the density generation and the denoiser
+		static constexpr uint32_t MAX_SUBMISSIONS_PER_FRAME = 2;
+
+		/**
+		 * @brief Waits for the last submission made with frameIndex, so that its command buffers
+		 * can be recorded again. Must be called once per frame, before begin().
+		 */
+		void beginFrame(uint32_t frameIndex);
+
+		/**
+		 * @brief Begins the next command buffer of frameIndex.
+		 *
+		 * @return The command buffer to record the compute work into.
+		 */
+		VkCommandBuffer begin(uint32_t frameIndex);
+
+		/**
+		 * @brief Ends and submits the command buffer begun last with frameIndex.
+		 *
+		 * @param waits The semaphores the work waits on, e.g. the frame timeline for the work
+		 * reading what the graphics queue rendered. Their submissions must already be made.
+		 *
+		 * @return The timeline value signaled when the work completes, to wait on (any number
+		 * of times) with getTimeline().
+		 */
+		uint64_t submit(uint32_t frameIndex, const std::vector<SemaphoreWait>& waits = {});
+
+		// signaled by the compute queue only, separate from the frame timeline of the graphics queue
+		TimelineSemaphore& getTimeline() { return m_timeline; }
+
+		/**
+		 * @brief The wait making a graphics submission depend on the compute work that signaled value.
+		 */
+		SemaphoreWait getWait(uint64_t value, VkPipelineStageFlags stage) const {
+			return SemaphoreWait{ m_timeline.getSemaphore(), stage, value };
+		}
+
+	private:
+		Context& m_context;
+		TimelineSemaphore m_timeline;
+
+		VkCommandPool m_commandPool = VK_NULL_HANDLE;
+		std::array<std::array<VkCommandBuffer, MAX_SUBMISSIONS_PER_FRAME>, SwapChain::MAX_FRAMES_IN_FLIGHT> m_commandBuffers{};
+		std::array<uint32_t, SwapChain::MAX_FRAMES_IN_FLIGHT> m_begunCounts{}; // command buffers begun since beginFrame
+		std::array<uint64_t, SwapChain::MAX_FRAMES_IN_FLIGHT> m_frameValues{}; // last value signaled per frame index
+	};
+}
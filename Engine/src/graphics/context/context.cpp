@@ -1,7 +1,40 @@
 #include "graphics/context/context.hpp"
 
+#include "utils/hash_func.hpp"
+
+#include <bit>
+#include <numeric>
+
 namespace PXTEngine {
 
+	namespace {
+
+		/**
+		 * @brief Appends the fields of a create info to a cache key, one word per field.
+		 * Fields are copied one by one (instead of hashing the raw struct) so that
+		 * padding bytes and pointers never end up in the key.
+		 */
+		class CacheKeyWriter {
+		public:
+			explicit CacheKeyWriter(std::vector<uint64_t>& words) : m_words(words) {}
+
+			template <typename T>
+			CacheKeyWriter& add(const T value) {
+				if constexpr (std::is_same_v<T, float>) {
+					m_words.push_back(std::bit_cast<uint32_t>(value));
+				} else if constexpr (std::is_pointer_v<T>) {
+					m_words.push_back(reinterpret_cast<uint64_t>(value));
+				} else {
+					m_words.push_back(static_cast<uint64_t>(value));
+				}
+				return *this;
+			}
+
+		private:
+			std::vector<uint64_t>& m_words;
+		};
+	}
+
     Context::Context(Window& window)
         : m_window(window),
         m_instance{ "PXT Engine" },
@@ -10,11 +43,50 @@ namespace PXTEngine {
         m_device{ m_window, m_instance, m_surface, m_physicalDevice } {
 
 		createCommandPool();
+		m_frameTimeline = createUnique<TimelineSemaphore>(m_device.getDevice());
     }
 
 	Context::~Context() {
+		destroyCachedObjects();
         vkDestroyCommandPool(m_device.getDevice(), m_commandPool, nullptr);
 	}
+
+	void Context::destroyCachedObjects() {
+		VkDevice device = m_device.getDevice();
+
+		for (auto pipelineLayout : m_pipelineLayoutCache.objects | std::views::values) {
+			vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+		}
+		for (auto pipelineLayout : m_pipelineLayoutCache.uncached) {
+			vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+		}
+
+		for (auto setLayout : m_descriptorSetLayoutCache.objects | std::views::values) {
+			vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+		}
+		for (auto setLayout : m_descriptorSetLayoutCache.uncached) {
+			vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+		}
+
+		for (auto sampler : m_samplerCache.objects | std::views::values) {
+			vkDestroySampler(device, sampler, nullptr);
+		}
+		for (auto sampler : m_samplerCache.uncached) {
+			vkDestroySampler(device, sampler, nullptr);
+		}
+
+		m_pipelineLayoutCache = {};
+		m_descriptorSetLayoutCache = {};
+		m_samplerCache = {};
+	}
+
+	std::size_t Context::ObjectCacheKeyHash::operator()(const ObjectCacheKey& key) const noexcept {
+		std::size_t seed = key.words.size();
+		for (const uint64_t word : key.words) {
+			hashCombine(seed, word);
+		}
+		return seed;
+	}
     
 
     void Context::createCommandPool() {
@@ -46,13 +118,28 @@ namespace PXTEngine {
         throw std::runtime_error("failed to find suitable memory type!");
     }
 
+	std::vector<uint32_t> Context::getAsyncComputeQueueFamilies() {
+		if (!hasAsyncCompute()) return {};
+
+		return { m_physicalDevice.findQueueFamilies().graphicsFamily, getComputeQueueFamily() };
+	}
+
 	void Context::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-                               VkBuffer &buffer, VkDeviceMemory &bufferMemory) {
+                               VkBuffer &buffer, VkDeviceMemory &bufferMemory,
+                               const std::vector<uint32_t>& queueFamilies) {
         VkBufferCreateInfo bufferInfo{};
         bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         bufferInfo.size = size;
         bufferInfo.usage = usage;
-        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        // shared by several queues without ownership transfers
+        if (queueFamilies.size() > 1) {
+            bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+            bufferInfo.pQueueFamilyIndices = queueFamilies.data();
+        } else {
+            bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        }
 
         if (vkCreateBuffer(m_device.getDevice(), &bufferInfo, nullptr, &buffer) !=
             VK_SUCCESS) {
@@ -189,14 +276,145 @@ namespace PXTEngine {
 	}
 
 	VkSampler Context::createSampler(const VkSamplerCreateInfo& samplerInfo) {
+		std::lock_guard lock(m_cacheMutex);
+
+		ObjectCacheKey key;
+		CacheKeyWriter(key.words)
+			.add(samplerInfo.flags)
+			.add(samplerInfo.magFilter)
+			.add(samplerInfo.minFilter)
+			.add(samplerInfo.mipmapMode)
+			.add(samplerInfo.addressModeU)
+			.add(samplerInfo.addressModeV)
+			.add(samplerInfo.addressModeW)
+			.add(samplerInfo.mipLodBias)
+			.add(samplerInfo.anisotropyEnable)
+			.add(samplerInfo.anisotropyEnable ? samplerInfo.maxAnisotropy : 0.0f)
+			.add(samplerInfo.compareEnable)
+			.add(samplerInfo.compareEnable ? samplerInfo.compareOp : VK_COMPARE_OP_NEVER)
+			.add(samplerInfo.minLod)
+			.add(samplerInfo.maxLod)
+			.add(samplerInfo.borderColor)
+			.add(samplerInfo.unnormalizedCoordinates);
+
+		if (samplerInfo.pNext == nullptr) {
+			if (auto it = m_samplerCache.objects.find(key); it != m_samplerCache.objects.end()) {
+				return it->second;
+			}
+		}
+
 		VkSampler sampler;
 		if (vkCreateSampler(m_device.getDevice(), &samplerInfo, nullptr, &sampler) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create texture sampler!");
 		}
 
+		if (samplerInfo.pNext == nullptr) {
+			m_samplerCache.objects.emplace(std::move(key), sampler);
+		} else {
+			m_samplerCache.uncached.push_back(sampler);
+		}
+
 		return sampler;
 	}
 
+	VkDescriptorSetLayout Context::createDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo& layoutInfo) {
+		std::lock_guard lock(m_cacheMutex);
+
+		// bindings may come in any order (e.g. from an unordered_map), sort them
+		// so that equivalent layouts produce the same key
+		std::vector<uint32_t> order(layoutInfo.bindingCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::ranges::sort(order, {}, [&](const uint32_t i) { return layoutInfo.pBindings[i].binding; });
+
+		// the only extension struct we know how to key is the binding flags one
+		const VkDescriptorBindingFlags* bindingFlags = nullptr;
+		bool cacheable = true;
+		for (auto* next = static_cast<const VkBaseInStructure*>(layoutInfo.pNext); next; next = next->pNext) {
+			if (next->sType == VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO) {
+				const auto* flagsInfo = reinterpret_cast<const VkDescriptorSetLayoutBindingFlagsCreateInfo*>(next);
+				bindingFlags = flagsInfo->bindingCount > 0 ? flagsInfo->pBindingFlags : nullptr;
+			} else {
+				cacheable = false;
+			}
+		}
+
+		ObjectCacheKey key;
+		CacheKeyWriter writer(key.words);
+		writer.add(layoutInfo.flags).add(layoutInfo.bindingCount);
+		for (const uint32_t i : order) {
+			const VkDescriptorSetLayoutBinding& binding = layoutInfo.pBindings[i];
+			writer.add(binding.binding)
+				.add(binding.descriptorType)
+				.add(binding.descriptorCount)
+				.add(binding.stageFlags)
+				.add(bindingFlags ? bindingFlags[i] : 0u);
+
+			// immutable samplers come from the sampler cache, so their handles are stable
+			if (binding.pImmutableSamplers) {
+				for (uint32_t j = 0; j < binding.descriptorCount; j++) {
+					writer.add(binding.pImmutableSamplers[j]);
+				}
+			}
+		}
+
+		if (cacheable) {
+			if (auto it = m_descriptorSetLayoutCache.objects.find(key); it != m_descriptorSetLayoutCache.objects.end()) {
+				return it->second;
+			}
+		}
+
+		VkDescriptorSetLayout setLayout;
+		if (vkCreateDescriptorSetLayout(m_device.getDevice(), &layoutInfo, nullptr, &setLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create descriptor set layout!");
+		}
+
+		if (cacheable) {
+			m_descriptorSetLayoutCache.objects.emplace(std::move(key), setLayout);
+		} else {
+			m_descriptorSetLayoutCache.uncached.push_back(setLayout);
+		}
+
+		return setLayout;
+	}
+
+	VkPipelineLayout Context::createPipelineLayout(const VkPipelineLayoutCreateInfo& pipelineLayoutInfo) {
+		std::lock_guard lock(m_cacheMutex);
+
+		ObjectCacheKey key;
+		CacheKeyWriter writer(key.words);
+		writer.add(pipelineLayoutInfo.flags).add(pipelineLayoutInfo.setLayoutCount);
+		for (uint32_t i = 0; i < pipelineLayoutInfo.setLayoutCount; i++) {
+			writer.add(pipelineLayoutInfo.pSetLayouts[i]);
+		}
+
+		writer.add(pipelineLayoutInfo.pushConstantRangeCount);
+		for (uint32_t i = 0; i < pipelineLayoutInfo.pushConstantRangeCount; i++) {
+			const VkPushConstantRange& range = pipelineLayoutInfo.pPushConstantRanges[i];
+			writer.add(range.stageFlags).add(range.offset).add(range.size);
+		}
+
+		const bool cacheable = pipelineLayoutInfo.pNext == nullptr;
+
+		if (cacheable) {
+			if (auto it = m_pipelineLayoutCache.objects.find(key); it != m_pipelineLayoutCache.objects.end()) {
+				return it->second;
+			}
+		}
+
+		VkPipelineLayout pipelineLayout;
+		if (vkCreatePipelineLayout(m_device.getDevice(), &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+
+		if (cacheable) {
+			m_pipelineLayoutCache.objects.emplace(std::move(key), pipelineLayout);
+		} else {
+			m_pipelineLayoutCache.uncached.push_back(pipelineLayout);
+		}
+
+		return pipelineLayout;
+	}
+
     void Context::createShaderModuleFromSpirV(const std::vector<char>& code, VkShaderModule* shaderModule) {
         VkShaderModuleCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -5,6 +5,9 @@
 #include "graphics/context/surface.hpp"
 #include "graphics/context/physical_device.hpp"
 #include "graphics/context/logical_device.hpp"
+#include "graphics/context/timeline_semaphore.hpp"
+
+#include <mutex>
 
 namespace PXTEngine {
 
@@ -46,6 +49,33 @@ namespace PXTEngine {
 		VkQueue getGraphicsQueue() { return m_device.getGraphicsQueue(); }
 		VkQueue getPresentQueue() { return m_device.getPresentQueue(); }
 
+		/**
+		 * @brief The queue of the dedicated compute family, the graphics queue if the device has none.
+		 */
+		VkQueue getComputeQueue() { return m_device.getComputeQueue(); }
+		uint32_t getComputeQueueFamily() const { return m_device.getComputeQueueFamily(); }
+
+		/**
+		 * @brief Whether compute work can be submitted to a queue running alongside the graphics one.
+		 */
+		bool hasAsyncCompute() const { return m_device.hasAsyncCompute(); }
+
+		/**
+		 * @brief The timeline signaled by the graphics queue once per frame: a frame is complete
+		 * when the timeline reaches the value it was submitted with (FrameInfo::timelineValue).
+		 *
+		 * It is the completion primitive of the renderer: resources still used by the frames in
+		 * flight are released, reclaimed or read back once the timeline reaches the value of the
+		 * last frame using them, instead of draining the queues.
+		 */
+		TimelineSemaphore& getFrameTimeline() { return *m_frameTimeline; }
+
+		/**
+		 * @brief The queue families a resource shared by the graphics and async compute queues
+		 * must be created with (VK_SHARING_MODE_CONCURRENT), empty without async compute.
+		 */
+		std::vector<uint32_t> getAsyncComputeQueueFamilies();
+
 		/* ----------------------- Buffer Helper Functions ----------------------- */
 
 		/**
@@ -70,9 +100,11 @@ namespace PXTEngine {
 		 * @param properties The memory properties of the buffer.
 		 * @param buffer The buffer handle.
 		 * @param bufferMemory The buffer memory handle.
+		 * @param queueFamilies The queue families accessing the buffer concurrently, exclusive if empty.
 		 */
 		void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-						  VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+						  VkBuffer& buffer, VkDeviceMemory& bufferMemory,
+						  const std::vector<uint32_t>& queueFamilies = {});
 
 		/**
 		* @brief Begins single-time commands.
@@ -139,16 +171,47 @@ namespace PXTEngine {
 		*/
 		VkImageView createImageView(const VkImageViewCreateInfo& viewInfo);
 
+		/* ----------------------- Cached Object Functions ----------------------- */
+
 		/**
-		* @brief Creates a sampler for an image.
+		* @brief Returns a sampler matching the given create info.
 		* 
-		* This function creates a sampler for an image, which is used to sample the image data.
+		* Samplers are cached by their create info: requesting a sampler with the same settings
+		* twice returns the same handle, keeping the sampler count well below
+		* maxSamplerAllocationCount. The returned sampler is owned by the context
+		* and must not be destroyed by the caller.
 		* 
 		* @param samplerInfo The sampler create info.
 		* @return The sampler handle.
 		*/
 		VkSampler createSampler(const VkSamplerCreateInfo& samplerInfo);
 
+		/**
+		 * @brief Returns a descriptor set layout matching the given create info.
+		 *
+		 * Layouts are cached by their bindings (in any order) and flags, identical layouts share
+		 * the same handle. The returned layout is owned by the context and must not be destroyed
+		 * by the caller.
+		 *
+		 * @param layoutInfo The descriptor set layout create info.
+		 * @return The descriptor set layout handle.
+		 */
+		VkDescriptorSetLayout createDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo& layoutInfo);
+
+		/**
+		 * @brief Returns a pipeline layout matching the given create info.
+		 *
+		 * Layouts are cached by their set layouts and push constant ranges. Since set layouts are
+		 * cached too, render systems declaring the same interface end up sharing one pipeline layout.
+		 * The returned layout is owned by the context and must not be destroyed by the caller.
+		 *
+		 * @param pipelineLayoutInfo The pipeline layout create info.
+		 * @return The pipeline layout handle.
+		 */
+		VkPipelineLayout createPipelineLayout(const VkPipelineLayoutCreateInfo& pipelineLayoutInfo);
+
+		/* ----------------------- End Cached Object Functions ---------------------- */
+
 		/**
 		 * @brief Creates a shader module from SPIR-V code.
 		 * 
@@ -193,6 +256,26 @@ namespace PXTEngine {
 		/* ----------------------- End Buffer Helper Functions ---------------------- */
 		
 	private:
+		/**
+		 * @brief Flattened create info used as the key of the object caches.
+		 */
+		struct ObjectCacheKey {
+			std::vector<uint64_t> words;
+
+			bool operator==(const ObjectCacheKey& other) const = default;
+		};
+
+		struct ObjectCacheKeyHash {
+			std::size_t operator()(const ObjectCacheKey& key) const noexcept;
+		};
+
+		template <typename T>
+		struct ObjectCache {
+			std::unordered_map<ObjectCacheKey, T, ObjectCacheKeyHash> objects;
+			// objects whose create info has an unknown pNext chain, owned but not shared
+			std::vector<T> uncached;
+		};
+
 		/**
 		 * @brief Creates a command pool.
 		 *
@@ -200,13 +283,24 @@ namespace PXTEngine {
 		 */
 		void createCommandPool();
 
+		/**
+		 * @brief Destroys every object owned by the caches.
+		 */
+		void destroyCachedObjects();
+
 		Window& m_window;
 		Instance m_instance;
 		Surface m_surface;
 		PhysicalDevice m_physicalDevice;
 		LogicalDevice m_device;
 
+		Unique<TimelineSemaphore> m_frameTimeline;
+
 		VkCommandPool m_commandPool;
 
+		std::mutex m_cacheMutex;
+		ObjectCache<VkSampler> m_samplerCache;
+		ObjectCache<VkDescriptorSetLayout> m_descriptorSetLayoutCache;
+		ObjectCache<VkPipelineLayout> m_pipelineLayoutCache;
 	};
 }
\ No newline at end of file
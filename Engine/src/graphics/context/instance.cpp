@@ -98,6 +98,8 @@ namespace PXTEngine {
     /* --------------------- End of local callback functions -------------------- */
 
     Instance::Instance(const std::string& appName) {
+        PXT_STARTUP_PHASE("Create Vulkan instance");
+
         createInstance(appName);
         setupDebugMessenger();
     }
@@ -4,6 +4,8 @@ namespace PXTEngine {
 
     LogicalDevice::LogicalDevice(Window& window, Instance& instance, Surface& surface, PhysicalDevice& physicalDevice)
 		: m_window{ window }, m_instance{ instance }, m_surface(surface), m_physicalDevice(physicalDevice) {
+        PXT_STARTUP_PHASE("Create logical device");
+
         createLogicalDevice();
 
         // Load ray tracing function pointers after the device is created -- global
@@ -19,6 +21,9 @@ namespace PXTEngine {
 
         std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
         std::set<uint32_t> uniqueQueueFamilies = {indices.graphicsFamily, indices.presentFamily};
+        if (indices.computeFamilyHasValue) {
+            uniqueQueueFamilies.insert(indices.computeFamily);
+        }
 
         float queuePriority = 1.0f;
         for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -68,6 +73,11 @@ namespace PXTEngine {
         VkPhysicalDeviceRayTracingValidationFeaturesNV rayTracingValidationFeatures{};
 		rayTracingValidationFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_VALIDATION_FEATURES_NV;
 
+        // Timeline semaphores (core in 1.2), the frame synchronization is built on them
+        VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphoreFeatures{};
+        timelineSemaphoreFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
 		// 2d view of 3d images
 		VkPhysicalDeviceImage2DViewOf3DFeaturesEXT image2DViewOf3DFeatures{};
 		image2DViewOf3DFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_IMAGE_2D_VIEW_OF_3D_FEATURES_EXT;
@@ -75,11 +85,12 @@ namespace PXTEngine {
 
         // --- Feature Chaining ---
         // Chain the features in this order 
-        // BDA -> Descriptor Indexing -> Accel Struct -> RT Pipeline
+        // BDA -> Descriptor Indexing -> Accel Struct -> RT Pipeline -> Timeline Semaphore
         bufferDeviceAddressFeatures.pNext = &indexingFeatures;
         indexingFeatures.pNext = &accelStructFeatures;
         accelStructFeatures.pNext = &rtPipelineFeatures;
-        rtPipelineFeatures.pNext = &image2DViewOf3DFeatures;
+        rtPipelineFeatures.pNext = &timelineSemaphoreFeatures;
+        timelineSemaphoreFeatures.pNext = &image2DViewOf3DFeatures;
         image2DViewOf3DFeatures.pNext = &rayTracingValidationFeatures;
         rayTracingValidationFeatures.pNext = nullptr; // Make sure the last one points to nullptr
 
@@ -121,6 +132,10 @@ namespace PXTEngine {
             throw std::runtime_error("Required rayTracingPipeline feature is not supported!");
         }
 
+        if (!timelineSemaphoreFeatures.timelineSemaphore) {
+            throw std::runtime_error("Required timelineSemaphore feature is not supported!");
+        }
+
 		// Check if 2d view of 3d images is supported
 		if (!image2DViewOf3DFeatures.image2DViewOf3D ||
 			!image2DViewOf3DFeatures.sampler2DViewOf3D) {
@@ -162,5 +177,12 @@ namespace PXTEngine {
 
         vkGetDeviceQueue(m_device, indices.graphicsFamily, 0, &m_graphicsQueue);
         vkGetDeviceQueue(m_device, indices.presentFamily, 0, &m_presentQueue);
+
+        // without a dedicated compute family the compute work is submitted to the graphics queue
+        m_hasAsyncCompute = indices.computeFamilyHasValue;
+        m_computeQueueFamily = m_hasAsyncCompute ? indices.computeFamily : indices.graphicsFamily;
+        vkGetDeviceQueue(m_device, m_computeQueueFamily, 0, &m_computeQueue);
+
+        PXT_INFO("Async compute: {}", m_hasAsyncCompute ? "enabled" : "not available, using the graphics queue");
     }
 }
\ No newline at end of file
@@ -36,6 +36,13 @@ namespace PXTEngine {
         VkQueue getGraphicsQueue() { return m_graphicsQueue; }
         VkQueue getPresentQueue() { return m_presentQueue; }
 
+        /**
+         * @brief The queue of the dedicated compute family, the graphics queue if the device has none.
+         */
+        VkQueue getComputeQueue() { return m_computeQueue; }
+        uint32_t getComputeQueueFamily() const { return m_computeQueueFamily; }
+        bool hasAsyncCompute() const { return m_hasAsyncCompute; }
+
     private:
         /**
          * @brief Creates a logical device.
@@ -54,6 +61,10 @@ namespace PXTEngine {
         
         VkQueue m_graphicsQueue;
         VkQueue m_presentQueue;
+        VkQueue m_computeQueue;
+
+        uint32_t m_computeQueueFamily;
+        bool m_hasAsyncCompute = false;
     };
 
 }
\ No newline at end of file
@@ -29,6 +29,8 @@ namespace PXTEngine {
     };
 
     PhysicalDevice::PhysicalDevice(Instance& instance, Surface& surface) : m_instance(instance), m_surface(surface) {
+        PXT_STARTUP_PHASE("Pick physical device");
+
         pickPhysicalDevice();
     }
 
@@ -236,6 +238,20 @@ namespace PXTEngine {
             i++;
         }
 
+        // the loop above stops at the first complete set, the dedicated compute family
+        // (without graphics) is searched separately among all of them
+        for (uint32_t family = 0; family < queueFamilyCount; family++) {
+            const VkQueueFamilyProperties& queueFamily = queueFamilies[family];
+
+            if (queueFamily.queueCount > 0 &&
+                (queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+                !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+                indices.computeFamily = family;
+                indices.computeFamilyHasValue = true;
+                break;
+            }
+        }
+
         return indices;
     }
 
@@ -81,6 +81,15 @@ namespace PXTEngine {
          */
         uint32_t presentFamily;
 
+        /**
+         * @brief Index of a queue family that supports compute but not graphics operations.
+         *
+         * Work submitted to it can run alongside the graphics queue (async compute).
+         * It is optional: when the device has no such family the compute work stays on the
+         * graphics queue.
+         */
+        uint32_t computeFamily;
+
         /**
          * @brief Indicates if a valid graphics queue family index has been found.
          *
@@ -95,6 +104,14 @@ namespace PXTEngine {
          */
         bool presentFamilyHasValue = false;
 
+        /**
+         * @brief Indicates if a dedicated compute queue family has been found.
+         *
+         * Set to `true` if `computeFamily` has been assigned a valid queue index.
+         * Not required by `isComplete()`.
+         */
+        bool computeFamilyHasValue = false;
+
         /**
          * @brief Checks if both required queue families have been found.
          *
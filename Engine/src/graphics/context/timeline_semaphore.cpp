@@ -0,0 +1,55 @@
+#include "graphics/context/timeline_semaphore.hpp"
+
+namespace PXTEngine {
+
+	TimelineSemaphore::TimelineSemaphore(VkDevice device) : m_device(device) {
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+
+		if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_semaphore) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create timeline semaphore!");
+		}
+	}
+
+	TimelineSemaphore::~TimelineSemaphore() {
+		vkDestroySemaphore(m_device, m_semaphore, nullptr);
+	}
+
+	uint64_t TimelineSemaphore::getCompletedValue() {
+		uint64_t value = 0;
+		if (vkGetSemaphoreCounterValue(m_device, m_semaphore, &value) == VK_SUCCESS) {
+			m_completedValue = std::max(m_completedValue, value);
+		}
+
+		return m_completedValue;
+	}
+
+	bool TimelineSemaphore::isComplete(const uint64_t value) {
+		// avoid the query when the cached value already tells
+		return value <= m_completedValue || value <= getCompletedValue();
+	}
+
+	void TimelineSemaphore::wait(const uint64_t value) {
+		PXT_ASSERT(value <= m_submittedValue, "Waiting for a timeline value that was never submitted");
+
+		if (isComplete(value)) return;
+
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &m_semaphore;
+		waitInfo.pValues = &value;
+
+		if (vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+			throw std::runtime_error("failed to wait for timeline semaphore!");
+		}
+
+		m_completedValue = std::max(m_completedValue, value);
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "core/pch.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @class TimelineSemaphore
+	 *
+	 * @brief A monotonically increasing GPU counter (VK_KHR_timeline_semaphore, core in 1.2).
+	 *
+	 * Every submission signaling it is given the next value with advance(), so that
+	 * "work N is complete" becomes a comparison against getCompletedValue(). The host can
+	 * query or wait for any value, and other submissions can wait on it with a value instead
+	 * of a fence or a binary semaphore. Only one queue may signal a timeline, the values have
+	 * to be signaled in increasing order.
+	 */
+	class TimelineSemaphore {
+	public:
+		TimelineSemaphore(VkDevice device);
+		~TimelineSemaphore();
+
+		TimelineSemaphore(const TimelineSemaphore&) = delete;
+		TimelineSemaphore& operator=(const TimelineSemaphore&) = delete;
+
+		VkSemaphore getSemaphore() const { return m_semaphore; }
+
+		/**
+		 * @brief Reserves the value signaled by the next submission, to be called right before submitting it.
+		 */
+		uint64_t advance() { return ++m_submittedValue; }
+
+		/**
+		 * @brief The value the work being recorded will signal, once it is submitted.
+		 */
+		uint64_t getNextValue() const { return m_submittedValue + 1; }
+
+		// the value of the last submission, the timeline reaches it once everything submitted is complete
+		uint64_t getSubmittedValue() const { return m_submittedValue; }
+
+		/**
+		 * @brief The value the GPU has reached, every submission signaling a value up to it is complete.
+		 */
+		uint64_t getCompletedValue();
+
+		bool isComplete(uint64_t value);
+
+		/**
+		 * @brief Blocks until the GPU reaches value.
+		 */
+		void wait(uint64_t value);
+
+		/**
+		 * @brief Blocks until everything submitted so far is complete.
+		 */
+		void waitIdle() { wait(m_submittedValue); }
+
+	private:
+		VkDevice m_device;
+		VkSemaphore m_semaphore = VK_NULL_HANDLE;
+
+		uint64_t m_submittedValue = 0;
+		uint64_t m_completedValue = 0; // cached, only ever grows
+	};
+}
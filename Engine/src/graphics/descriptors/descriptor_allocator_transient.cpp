@@ -0,0 +1,62 @@
+#include "graphics/descriptors/descriptor_allocator_transient.hpp"
+
+namespace PXTEngine {
+
+	DescriptorAllocatorTransient::DescriptorAllocatorTransient(Context& context, const uint32_t setsPerPool,
+		std::span<PoolSizeRatio> poolRatios) :
+		m_context(context),
+		m_ratios(poolRatios.begin(), poolRatios.end()),
+		m_setsPerPool(setsPerPool) {
+
+		for (FramePools& frame : m_framePools) {
+			frame.pools.push_back(createPool());
+		}
+	}
+
+	void DescriptorAllocatorTransient::beginFrame(const uint32_t frameIndex) {
+		PXT_ASSERT(frameIndex < m_framePools.size(), "Frame index out of range");
+
+		m_frameIndex = frameIndex;
+
+		FramePools& frame = m_framePools[frameIndex];
+
+		// only the pools used last time this frame index was recorded need a reset
+		const size_t usedPools = std::min(frame.current + 1, frame.pools.size());
+		for (size_t i = 0; i < usedPools; i++) {
+			frame.pools[i]->resetPool();
+		}
+
+		frame.current = 0;
+	}
+
+	void DescriptorAllocatorTransient::allocate(VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptorSet) {
+		FramePools& frame = m_framePools[m_frameIndex];
+
+		if (frame.pools[frame.current]->allocateDescriptorSet(descriptorSetLayout, descriptorSet)) {
+			return;
+		}
+
+		// the current pool is exhausted, move on to the next one (kept from previous frames if possible)
+		frame.current++;
+		if (frame.current == frame.pools.size()) {
+			frame.pools.push_back(createPool());
+		}
+
+		if (!frame.pools[frame.current]->allocateDescriptorSet(descriptorSetLayout, descriptorSet)) {
+			throw std::runtime_error("Failed to allocate transient descriptor set!");
+		}
+	}
+
+	Unique<DescriptorPool> DescriptorAllocatorTransient::createPool() const {
+		std::vector<VkDescriptorPoolSize> poolSizes;
+		poolSizes.reserve(m_ratios.size());
+		for (auto [type, ratio] : m_ratios) {
+			poolSizes.emplace_back(type, static_cast<uint32_t>(ratio * m_setsPerPool));
+		}
+
+		return DescriptorPool::Builder(m_context)
+			.addPoolSizes(poolSizes)
+			.setMaxSets(m_setsPerPool)
+			.build();
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/descriptors/descriptor_allocator.hpp"
+#include "graphics/swap_chain.hpp"
+
+namespace PXTEngine {
+	/**
+	 * @brief Linear descriptor set allocator for data that only lives for one frame.
+	 *
+	 * Every frame in flight owns its own list of descriptor pools. Descriptor sets are
+	 * allocated linearly from the current pool of the active frame, moving on to the next
+	 * one (creating it if needed) when the pool is exhausted. Sets are never freed
+	 * individually: all pools of a frame are reset at once with vkResetDescriptorPool when
+	 * that frame index is reused, which is safe because the frame's timeline value has already been
+	 * waited on by then.
+	 *
+	 * After a few frames the pool lists reach their steady state size, from there on
+	 * allocation is just a call into the already existing pools.
+	 *
+	 * @note Sets allocated from this allocator must not be used after the frame they were
+	 * allocated in has completed on the GPU.
+	 */
+	class DescriptorAllocatorTransient {
+	public:
+		DescriptorAllocatorTransient(Context& context, uint32_t setsPerPool, std::span<PoolSizeRatio> poolRatios);
+
+		DescriptorAllocatorTransient(const DescriptorAllocatorTransient&) = delete;
+		DescriptorAllocatorTransient& operator=(const DescriptorAllocatorTransient&) = delete;
+
+		/**
+		 * @brief Makes frameIndex the active frame and resets all of its pools.
+		 *
+		 * Must be called once per frame, after the frame timeline value of the frame has been waited on
+		 * (i.e. after Renderer::beginFrame) and before any allocation for that frame.
+		 *
+		 * @param frameIndex Index of the frame in flight that is being recorded.
+		 */
+		void beginFrame(uint32_t frameIndex);
+
+		/**
+		 * @brief Allocates a descriptor set valid until the current frame completes.
+		 *
+		 * @param descriptorSetLayout Layout used for the descriptor set.
+		 * @param descriptorSet Reference to the descriptor set to be allocated.
+		 * @throws std::runtime_error If the set does not fit even in a fresh pool.
+		 */
+		void allocate(VkDescriptorSetLayout descriptorSetLayout, VkDescriptorSet& descriptorSet);
+
+	private:
+		struct FramePools {
+			std::vector<Unique<DescriptorPool>> pools;
+			size_t current = 0; // index of the pool allocations are served from
+		};
+
+		/**
+		 * @brief Creates a new descriptor pool sized by the configured ratios.
+		 */
+		[[nodiscard]]
+		Unique<DescriptorPool> createPool() const;
+
+		Context& m_context;
+
+		std::vector<PoolSizeRatio> m_ratios;
+		uint32_t m_setsPerPool;
+
+		std::vector<FramePools> m_framePools{ SwapChain::MAX_FRAMES_IN_FLIGHT };
+		uint32_t m_frameIndex = 0;
+	};
+}
@@ -37,17 +37,45 @@ namespace PXTEngine {
         descriptorSetLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
         descriptorSetLayoutInfo.bindingCount = static_cast<uint32_t>(setLayoutBindings.size());
         descriptorSetLayoutInfo.pBindings = setLayoutBindings.data();
-        
-        if (vkCreateDescriptorSetLayout(
-                m_context.getDevice(),
-                &descriptorSetLayoutInfo,
-                nullptr,
-                &m_descriptorSetLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create descriptor set layout!");
-        }
+
+        m_descriptorSetLayout = m_context.createDescriptorSetLayout(descriptorSetLayoutInfo);
     }
 
     DescriptorSetLayout::~DescriptorSetLayout() {
-        vkDestroyDescriptorSetLayout(m_context.getDevice(), m_descriptorSetLayout, nullptr);
+        // the layout itself is owned by the context cache
+        for (auto updateTemplate : m_updateTemplates | std::views::values) {
+            vkDestroyDescriptorUpdateTemplate(m_context.getDevice(), updateTemplate, nullptr);
+        }
+    }
+
+    VkDescriptorUpdateTemplate DescriptorSetLayout::getUpdateTemplate(
+        std::span<const VkDescriptorUpdateTemplateEntry> entries) {
+
+        // entries are fully determined by binding and offset, the rest comes from the layout
+        FrameVector<uint32_t> key;
+        key.reserve(entries.size() * 2);
+        for (const auto& entry : entries) {
+            key.push_back(entry.dstBinding);
+            key.push_back(static_cast<uint32_t>(entry.offset));
+        }
+
+        if (auto it = m_updateTemplates.find(key); it != m_updateTemplates.end()) {
+            return it->second;
+        }
+
+        VkDescriptorUpdateTemplateCreateInfo templateInfo{};
+        templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+        templateInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+        templateInfo.pDescriptorUpdateEntries = entries.data();
+        templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        templateInfo.descriptorSetLayout = m_descriptorSetLayout;
+
+        VkDescriptorUpdateTemplate updateTemplate;
+        if (vkCreateDescriptorUpdateTemplate(m_context.getDevice(), &templateInfo, nullptr, &updateTemplate) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create descriptor update template!");
+        }
+
+        m_updateTemplates.emplace(std::vector<uint32_t>(key.begin(), key.end()), updateTemplate);
+        return updateTemplate;
     }
 }
\ No newline at end of file
@@ -63,16 +63,40 @@ namespace PXTEngine {
 
         /**
          * @brief Returns the Vulkan descriptor set layout handle.
+         * The handle is shared between identical layouts and owned by the Context cache.
          * @return VkDescriptorSetLayout object.
          */
         [[nodiscard]]
         VkDescriptorSetLayout getDescriptorSetLayout() const { return m_descriptorSetLayout; }
 
     private:
+        /**
+         * @brief Returns the descriptor update template that writes the given bindings,
+         * creating it on first use.
+         *
+         * @param entries Template entries, one for each written binding, with offsets into
+         *                the packed data blob built by the DescriptorWriter.
+         * @return The descriptor update template handle.
+         */
+        VkDescriptorUpdateTemplate getUpdateTemplate(std::span<const VkDescriptorUpdateTemplateEntry> entries);
+
+        // orders the template keys, transparent so that they can be looked up with a FrameVector
+        struct UpdateTemplateKeyLess {
+            using is_transparent = void;
+
+            template<typename A, typename B>
+            bool operator()(const A& a, const B& b) const {
+                return std::ranges::lexicographical_compare(a, b);
+            }
+        };
+
         Context& m_context;
         VkDescriptorSetLayout m_descriptorSetLayout;
         std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> m_bindings;
 
+        // update templates, keyed by the sequence of (binding, offset) they write
+        std::map<std::vector<uint32_t>, VkDescriptorUpdateTemplate, UpdateTemplateKeyLess> m_updateTemplates;
+
         friend class DescriptorWriter;
     };
 }
\ No newline at end of file
@@ -5,10 +5,10 @@ namespace PXTEngine {
         : m_context(context), m_setLayout(setLayout) {}
 
     void DescriptorWriter::updateSet(VkDescriptorSet& set) {
-        for (auto& write : m_writes) {
-            write.dstSet = set;
-        }
-        vkUpdateDescriptorSets(m_context.getDevice(), static_cast<uint32_t>(m_writes.size()), m_writes.data(), 0, nullptr);
+        if (m_entries.empty()) return;
+
+        VkDescriptorUpdateTemplate updateTemplate = m_setLayout.getUpdateTemplate(m_entries);
+        vkUpdateDescriptorSetWithTemplate(m_context.getDevice(), set, updateTemplate, m_data.data());
     }
 
 }
\ No newline at end of file
@@ -70,11 +70,14 @@ namespace PXTEngine {
 		 * @return Reference to the DescriptorWriter instance.
 		 */
         DescriptorWriter& writeTLAS(uint32_t binding, VkWriteDescriptorSetAccelerationStructureKHR writeInfo) {
-			return write(binding, &writeInfo, 1);
+			return write(binding, writeInfo.pAccelerationStructures, writeInfo.accelerationStructureCount);
         }
 
         /**
          * @brief Overwrites an existing descriptor set with the stored writes.
+         *
+         * All the writes are applied with a single vkUpdateDescriptorSetWithTemplate call, using an
+         * update template cached in the set layout for this combination of bindings.
          * 
          * @param set Reference to the descriptor set to be overwritten.
          */
@@ -83,8 +86,13 @@ namespace PXTEngine {
     private:
         /**
          * @brief Generic template function to write descriptor data.
+         *
+         * The descriptor infos are copied into a packed data blob right away, so the pointed
+         * data does not need to outlive the writer. Each write becomes one update template entry
+         * pointing at its slice of the blob.
          * 
-         * @tparam T Type of descriptor info (VkDescriptorBufferInfo or VkDescriptorImageInfo).
+         * @tparam T Type of descriptor info (VkDescriptorBufferInfo, VkDescriptorImageInfo
+         *           or VkAccelerationStructureKHR).
          * @param binding The binding index.
          * @param info Pointer to descriptor info.
          * @param count Number of descriptors.
@@ -92,7 +100,12 @@ namespace PXTEngine {
          * @return Reference to the DescriptorWriter instance.
          */
         template <typename T>
-        DescriptorWriter& write(uint32_t binding, T* info, uint32_t count) {
+        DescriptorWriter& write(uint32_t binding, const T* info, uint32_t count) {
+            PXT_STATIC_ASSERT((std::is_same_v<T, VkDescriptorBufferInfo> ||
+                               std::is_same_v<T, VkDescriptorImageInfo> ||
+                               std::is_same_v<T, VkAccelerationStructureKHR>),
+                              "Unsupported type for descriptor write");
+
 			size_t bindingCount = m_setLayout.m_bindings.count(binding);
 
             PXT_ASSERT(bindingCount == 1, "Layout does not contain specified binding");
@@ -100,29 +113,28 @@ namespace PXTEngine {
             auto& bindingDescription = m_setLayout.m_bindings[binding];
             
             PXT_ASSERT(bindingDescription.descriptorCount == count, "Binding descriptor info count mismatch");
-            
-            VkWriteDescriptorSet write{};
-            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            write.descriptorType = bindingDescription.descriptorType;
-            write.dstBinding = binding;
-            write.descriptorCount = count;
-            
-            if constexpr (std::is_same_v<T, VkDescriptorBufferInfo>) {
-                write.pBufferInfo = info;
-            } else if constexpr (std::is_same_v<T, VkDescriptorImageInfo>) {
-                write.pImageInfo = info;
-			} else if constexpr (std::is_same_v<T, VkWriteDescriptorSetAccelerationStructureKHR>) {
-				write.pNext = info;
-			} else {
-            	PXT_STATIC_ASSERT(false, "Unsupported type for descriptor write");
-            }
-            
-            m_writes.push_back(write);
+
+            // every info type is made of 8 byte fields/handles, keep each slice aligned to its type
+            const size_t offset = (m_data.size() + alignof(T) - 1) & ~(alignof(T) - 1);
+            m_data.resize(offset + sizeof(T) * count);
+            std::memcpy(m_data.data() + offset, info, sizeof(T) * count);
+
+            VkDescriptorUpdateTemplateEntry entry{};
+            entry.dstBinding = binding;
+            entry.dstArrayElement = 0;
+            entry.descriptorCount = count;
+            entry.descriptorType = bindingDescription.descriptorType;
+            entry.offset = offset;
+            entry.stride = sizeof(T);
+
+            m_entries.push_back(entry);
             return *this;
         }
 
 		Context& m_context;
         DescriptorSetLayout& m_setLayout;
-        std::vector<VkWriteDescriptorSet> m_writes;
+        // writers are short lived, their data lives in the frame arena
+        FrameVector<VkDescriptorUpdateTemplateEntry> m_entries;
+        FrameVector<std::byte> m_data;
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "graphics/descriptors/descriptor_allocator.hpp"
+#include "graphics/descriptors/descriptor_allocator_transient.hpp"
 #include "graphics/descriptors/descriptor_set_layout.hpp"
 #include "graphics/descriptors/descriptor_pool.hpp"
-#include "graphics/descriptors/descriptor_writer.hpp"
\ No newline at end of file
+#include "graphics/descriptors/descriptor_writer.hpp"
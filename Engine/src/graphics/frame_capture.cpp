@@ -0,0 +1,262 @@
+#include "graphics/frame_capture.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+namespace PXTEngine {
+
+	namespace {
+		const std::filesystem::path CAPTURES_DIRECTORY = "captures";
+
+		std::string makeTimestamp() {
+			const std::time_t now = std::time(nullptr);
+
+			char buffer[32];
+			std::strftime(buffer, sizeof(buffer), "%Y%m%d_%H%M%S", std::localtime(&now));
+			return buffer;
+		}
+
+		const char* getExtension(const FrameCapture::FileFormat format) {
+			return format == FrameCapture::FileFormat::Hdr ? ".hdr" : ".png";
+		}
+
+		bool isSrgbFormat(const VkFormat format) {
+			return format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_B8G8R8A8_SRGB;
+		}
+
+		float linearToSrgb(const float value) {
+			const float v = std::clamp(value, 0.0f, 1.0f);
+			return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+		}
+
+		float srgbToLinear(const float value) {
+			return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		/**
+		 * @brief Converts a texel of any readable format to a normalized rgb value, as stored
+		 * (i.e. still sRGB encoded for sRGB formats).
+		 */
+		glm::vec3 readTexel(const ReadbackService::ImageData& image, const size_t index) {
+			const uint8_t* texel = image.pixels.data() + index * image.texelSize;
+
+			switch (image.format) {
+				case VK_FORMAT_R8_UNORM:
+					return glm::vec3(static_cast<float>(texel[0]) / 255.0f);
+				case VK_FORMAT_R8G8B8A8_UNORM:
+				case VK_FORMAT_R8G8B8A8_SRGB:
+					return glm::vec3(texel[0], texel[1], texel[2]) / 255.0f;
+				case VK_FORMAT_B8G8R8A8_UNORM:
+				case VK_FORMAT_B8G8R8A8_SRGB:
+					return glm::vec3(texel[2], texel[1], texel[0]) / 255.0f;
+				case VK_FORMAT_R16G16B16A16_SFLOAT: {
+					uint16_t halfs[3];
+					std::memcpy(halfs, texel, sizeof(halfs));
+					return { glm::unpackHalf1x16(halfs[0]), glm::unpackHalf1x16(halfs[1]), glm::unpackHalf1x16(halfs[2]) };
+				}
+				case VK_FORMAT_R32_SFLOAT: {
+					float value;
+					std::memcpy(&value, texel, sizeof(float));
+					return glm::vec3(value);
+				}
+				case VK_FORMAT_R32G32B32A32_SFLOAT: {
+					glm::vec3 value;
+					std::memcpy(&value, texel, sizeof(glm::vec3));
+					return value;
+				}
+				default:
+					return glm::vec3(0.0f);
+			}
+		}
+	}
+
+	FrameCapture::FrameCapture(ReadbackService& readbackService)
+		: m_readbackService(readbackService) {
+
+		// png encoding is slow, a few writers keep up with a sequence at interactive frame rates
+		const uint32_t writerCount = std::clamp(std::thread::hardware_concurrency() / 4, 1u, 4u);
+		for (uint32_t i = 0; i < writerCount; i++) {
+			m_writers.emplace_back(&FrameCapture::writerLoop, this);
+		}
+	}
+
+	FrameCapture::~FrameCapture() {
+		// the images already read back are still written
+		{
+			std::lock_guard lock(m_jobsMutex);
+			m_isStopping = true;
+		}
+		m_jobsCondition.notify_all();
+
+		for (std::thread& writer : m_writers) {
+			writer.join();
+		}
+	}
+
+	void FrameCapture::requestScreenshot(const std::filesystem::path& filePath) {
+		const FileFormat format = filePath.extension() == ".hdr" ? FileFormat::Hdr : FileFormat::Png;
+		m_requestedScreenshot = std::make_pair(filePath, format);
+	}
+
+	void FrameCapture::startSequence(const std::filesystem::path& directory, const FileFormat format, const uint32_t frameCount) {
+		m_isCapturingSequence = true;
+		m_sequenceDirectory = directory;
+		m_sequenceFormat = format;
+		m_sequenceFrameCount = frameCount;
+		m_sequenceFrame = 0;
+		m_droppedFrames = 0;
+
+		PXT_INFO("Capturing image sequence into {}", directory.string());
+	}
+
+	void FrameCapture::stopSequence() {
+		if (!m_isCapturingSequence) return;
+
+		m_isCapturingSequence = false;
+		PXT_INFO("Image sequence capture stopped: {} frames, {} dropped", m_sequenceFrame, m_droppedFrames);
+	}
+
+	void FrameCapture::update(VkCommandBuffer commandBuffer, VulkanImage& image, const VkPipelineStageFlags srcStage) {
+		// hand the images read back to the writers
+		std::erase_if(m_pendingCaptures, [this](PendingCapture& pending) {
+			if (!ReadbackService::isReady(pending.image)) return false;
+
+			{
+				std::lock_guard lock(m_jobsMutex);
+				m_jobs.push_back({ pending.image.get(), std::move(pending.filePath), pending.format });
+			}
+			m_jobsCondition.notify_one();
+
+			return true;
+		});
+
+		if (m_requestedScreenshot) {
+			capture(commandBuffer, image, srcStage, m_requestedScreenshot->first, m_requestedScreenshot->second);
+			m_requestedScreenshot.reset();
+		}
+
+		if (m_isCapturingSequence) {
+			size_t queuedImages;
+			{
+				std::lock_guard lock(m_jobsMutex);
+				queuedImages = m_pendingCaptures.size() + m_jobs.size() + m_activeJobs;
+			}
+
+			if (queuedImages >= MAX_QUEUED_IMAGES) {
+				m_droppedFrames++;
+			} else {
+				char fileName[32];
+				std::snprintf(fileName, sizeof(fileName), "frame_%05u", m_sequenceFrame);
+
+				const std::filesystem::path filePath = m_sequenceDirectory / (std::string(fileName) + getExtension(m_sequenceFormat));
+				capture(commandBuffer, image, srcStage, filePath, m_sequenceFormat);
+			}
+
+			m_sequenceFrame++;
+			if (m_sequenceFrameCount > 0 && m_sequenceFrame >= m_sequenceFrameCount) {
+				stopSequence();
+			}
+		}
+	}
+
+	void FrameCapture::capture(VkCommandBuffer commandBuffer, VulkanImage& image, const VkPipelineStageFlags srcStage,
+		const std::filesystem::path& filePath, const FileFormat format) {
+
+		m_pendingCaptures.push_back({ m_readbackService.readImage(commandBuffer, image, srcStage), filePath, format });
+	}
+
+	void FrameCapture::writerLoop() {
+		while (true) {
+			WriteJob job;
+			{
+				std::unique_lock lock(m_jobsMutex);
+				m_jobsCondition.wait(lock, [this] { return m_isStopping || !m_jobs.empty(); });
+
+				if (m_jobs.empty()) return; // stopping, and nothing left to write
+
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+				m_activeJobs++;
+			}
+
+			try {
+				writeImage(job);
+			} catch (const std::exception& e) {
+				PXT_ERROR("Failed to write capture {}: {}", job.filePath.string(), e.what());
+			}
+
+			std::lock_guard lock(m_jobsMutex);
+			m_activeJobs--;
+		}
+	}
+
+	void FrameCapture::writeImage(const WriteJob& job) {
+		const ReadbackService::ImageData& image = job.image;
+		const size_t texelCount = static_cast<size_t>(image.width) * image.height;
+		const bool isSrgb = isSrgbFormat(image.format);
+
+		if (job.filePath.has_parent_path()) {
+			std::filesystem::create_directories(job.filePath.parent_path());
+		}
+
+		int result;
+		if (job.format == FileFormat::Hdr) {
+			std::vector<float> rgb(texelCount * 3);
+			for (size_t i = 0; i < texelCount; i++) {
+				glm::vec3 color = readTexel(image, i);
+				if (isSrgb) {
+					color = { srgbToLinear(color.r), srgbToLinear(color.g), srgbToLinear(color.b) };
+				}
+
+				rgb[i * 3 + 0] = color.r;
+				rgb[i * 3 + 1] = color.g;
+				rgb[i * 3 + 2] = color.b;
+			}
+
+			result = stbi_write_hdr(job.filePath.string().c_str(), static_cast<int>(image.width),
+				static_cast<int>(image.height), 3, rgb.data());
+		} else {
+			std::vector<uint8_t> rgb(texelCount * 3);
+			for (size_t i = 0; i < texelCount; i++) {
+				const glm::vec3 color = readTexel(image, i);
+
+				for (int c = 0; c < 3; c++) {
+					// the rendered images are linear, except for the sRGB formats
+					const float encoded = isSrgb ? color[c] : linearToSrgb(color[c]);
+					rgb[i * 3 + c] = static_cast<uint8_t>(std::clamp(encoded, 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+			}
+
+			result = stbi_write_png(job.filePath.string().c_str(), static_cast<int>(image.width),
+				static_cast<int>(image.height), 3, rgb.data(), static_cast<int>(image.width) * 3);
+		}
+
+		if (result == 0) {
+			throw std::runtime_error("stb_image_write failed");
+		}
+	}
+
+	void FrameCapture::updateUi() {
+		ImGui::Checkbox("HDR (.hdr, linear)", &m_isHdrSelected);
+		const FileFormat format = m_isHdrSelected ? FileFormat::Hdr : FileFormat::Png;
+
+		if (ImGui::Button("Screenshot", ImVec2(150, 0))) {
+			requestScreenshot(CAPTURES_DIRECTORY / ("screenshot_" + makeTimestamp() + getExtension(format)));
+		}
+
+		ImGui::SameLine();
+
+		if (!m_isCapturingSequence) {
+			if (ImGui::Button("Start Sequence", ImVec2(150, 0))) {
+				startSequence(CAPTURES_DIRECTORY / ("sequence_" + makeTimestamp()), format);
+			}
+		} else {
+			if (ImGui::Button("Stop Sequence", ImVec2(150, 0))) {
+				stopSequence();
+			}
+			ImGui::Text("Captured frames: %u (dropped: %u)", m_sequenceFrame, m_droppedFrames);
+		}
+	}
+}
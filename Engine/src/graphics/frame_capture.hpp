@@ -0,0 +1,109 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/readback_service.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace PXTEngine {
+
+	/**
+	 * @brief Saves the rendered image to disk, as single screenshots or as image sequences.
+	 *
+	 * The image is read back through the ReadbackService, so requesting a capture only records
+	 * a copy in the frame command buffer. The encoding and the file writes are done by a few
+	 * writer threads, this way capturing a sequence costs the render thread a memcpy per frame.
+	 * If the writers fall behind, the frames of a sequence are dropped (and counted) instead of
+	 * stalling the renderer.
+	 */
+	class FrameCapture {
+	public:
+		enum class FileFormat : uint8_t {
+			Png, // 8 bit sRGB
+			Hdr, // 32 bit float linear (Radiance RGBE)
+		};
+
+		// images read back or waiting to be written, beyond this sequence frames are dropped
+		static constexpr uint32_t MAX_QUEUED_IMAGES = 16;
+
+		FrameCapture(ReadbackService& readbackService);
+		~FrameCapture();
+
+		FrameCapture(const FrameCapture&) = delete;
+		FrameCapture& operator=(const FrameCapture&) = delete;
+
+		/**
+		 * @brief Captures the next recorded frame to a file, the format is chosen by the
+		 * extension (.png or .hdr).
+		 */
+		void requestScreenshot(const std::filesystem::path& filePath);
+
+		/**
+		 * @brief Captures every frame into numbered files in a directory.
+		 *
+		 * @param frameCount Number of frames to capture, 0 to capture until stopSequence().
+		 */
+		void startSequence(const std::filesystem::path& directory, FileFormat format, uint32_t frameCount = 0);
+		void stopSequence();
+
+		bool isCapturingSequence() const { return m_isCapturingSequence; }
+
+		/**
+		 * @brief Records the readback of the image if a capture is requested for this frame,
+		 * and hands the images read back in the meantime to the writers.
+		 *
+		 * Must be called after ReadbackService::beginFrame, once the image has been rendered.
+		 *
+		 * @param srcStage Stage of the last write of the image.
+		 */
+		void update(VkCommandBuffer commandBuffer, VulkanImage& image, VkPipelineStageFlags srcStage);
+
+		void updateUi();
+
+	private:
+		struct PendingCapture {
+			std::future<ReadbackService::ImageData> image;
+			std::filesystem::path filePath;
+			FileFormat format;
+		};
+
+		struct WriteJob {
+			ReadbackService::ImageData image;
+			std::filesystem::path filePath;
+			FileFormat format;
+		};
+
+		void capture(VkCommandBuffer commandBuffer, VulkanImage& image, VkPipelineStageFlags srcStage,
+			const std::filesystem::path& filePath, FileFormat format);
+
+		void writerLoop();
+		static void writeImage(const WriteJob& job);
+
+		ReadbackService& m_readbackService;
+
+		std::vector<PendingCapture> m_pendingCaptures;
+		std::optional<std::pair<std::filesystem::path, FileFormat>> m_requestedScreenshot;
+
+		// sequence
+		bool m_isCapturingSequence = false;
+		std::filesystem::path m_sequenceDirectory;
+		FileFormat m_sequenceFormat = FileFormat::Png;
+		uint32_t m_sequenceFrameCount = 0;
+		uint32_t m_sequenceFrame = 0;
+		uint32_t m_droppedFrames = 0;
+
+		// writers
+		std::vector<std::thread> m_writers;
+		std::mutex m_jobsMutex;
+		std::condition_variable m_jobsCondition;
+		std::deque<WriteJob> m_jobs;
+		uint32_t m_activeJobs = 0; // jobs taken by a writer and not finished yet
+		bool m_isStopping = false;
+
+		// ui
+		bool m_isHdrSelected = false;
+	};
+}
@@ -3,6 +3,7 @@
 #include "core/pch.hpp"
 #include "scene/camera.hpp"
 #include "scene/scene.hpp"
+#include "graphics/ibl.hpp"
 
 namespace PXTEngine {
     struct PointLight {
@@ -18,6 +19,7 @@ namespace PXTEngine {
         PointLight pointLights[MAX_LIGHTS];
         int numLights;
         uint32_t frameCount;
+        alignas(16) glm::vec4 irradianceSH[IBL::IrradianceSH::COEFFICIENT_COUNT]{}; // rgb, see IBL::IrradianceSH
     };
 
     struct FrameInfo {
@@ -27,7 +29,7 @@ namespace PXTEngine {
         Camera& camera;
         VkDescriptorSet globalDescriptorSet;
         Scene& scene;
-        VkFence frameFence;        // The fence signaled when the command buffer is complete
+        uint64_t timelineValue;     // The frame timeline value signaled when the command buffer is complete
         VkSemaphore imageAvailable; // The semaphore signaled when the image is available
         VkSemaphore renderFinished; // The semaphore signaled when rendering is done
     };
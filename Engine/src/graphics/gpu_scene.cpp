@@ -0,0 +1,225 @@
+#include "graphics/gpu_scene.hpp"
+
+#include "graphics/resources/vk_mesh.hpp"
+
+namespace PXTEngine {
+
+	// must match the local size of the scatter shader
+	static constexpr uint32_t SCATTER_WORKGROUP_SIZE = 64;
+
+	struct ScatterPushConstants {
+		VkDeviceAddress updates;
+		VkDeviceAddress objects;
+		uint32_t updateCount;
+	};
+
+	GpuScene::GpuScene(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, ResourceManager& resourceManager,
+		MaterialRegistry& materialRegistry, BLASRegistry& blasRegistry, TextureRegistry& textureRegistry)
+		: m_context(context),
+		m_descriptorAllocator(std::move(descriptorAllocator)),
+		m_resourceManager(resourceManager),
+		m_materialRegistry(materialRegistry),
+		m_blasRegistry(blasRegistry),
+		m_textureRegistry(textureRegistry) {
+		createDescriptorSet();
+		createPipelineLayout();
+		m_scatterPipeline = createPipeline();
+
+		// the descriptor set must point to a buffer even before the first object is added
+		reallocateObjectBuffer(INITIAL_CAPACITY);
+	}
+
+	GpuScene::~GpuScene() = default;
+
+	void GpuScene::createDescriptorSet() {
+		m_descriptorSetLayout = DescriptorSetLayout::Builder(m_context)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				VK_SHADER_STAGE_VERTEX_BIT |
+				VK_SHADER_STAGE_FRAGMENT_BIT |
+				VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR |
+				VK_SHADER_STAGE_RAYGEN_BIT_KHR,
+				1)
+			.build();
+
+		m_descriptorAllocator->allocate(m_descriptorSetLayout->getDescriptorSetLayout(), m_descriptorSet);
+	}
+
+	void GpuScene::createPipelineLayout() {
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(ScatterPushConstants);
+
+		// both buffers are accessed through their device address, no descriptor sets needed
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 0;
+		pipelineLayoutInfo.pSetLayouts = nullptr;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		m_pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
+	}
+
+	Unique<Pipeline> GpuScene::createPipeline(bool useCompiledSpirvFiles) const {
+		PXT_ASSERT(m_pipelineLayout != nullptr, "Cannot create pipeline before pipeline layout");
+
+		ComputePipelineConfigInfo pipelineConfig{};
+		pipelineConfig.pipelineLayout = m_pipelineLayout;
+
+		const std::string baseShaderPath = useCompiledSpirvFiles ? SPV_SHADERS_PATH : SHADERS_PATH;
+		const std::string filenameSuffix = useCompiledSpirvFiles ? ".spv" : "";
+		std::string shaderFilePath = baseShaderPath + m_shaderPath + filenameSuffix;
+
+		return createUnique<Pipeline>(m_context, shaderFilePath, pipelineConfig);
+	}
+
+	void GpuScene::registerShaders(ShaderReloader& shaderReloader) {
+		shaderReloader.addPipeline("Scene scatter", { SHADERS_PATH + m_shaderPath }, [this] { return createPipeline(false); }, m_scatterPipeline);
+	}
+
+	void GpuScene::update(FrameInfo& frameInfo, bool isRaytracingEnabled) {
+		PXT_ALLOCATION_SCOPE("GpuScene");
+
+		// the render packets cache the BLAS addresses, they are only valid for the mode they were built in
+		if (isRaytracingEnabled != m_isRaytracingEnabled) {
+			RayTracingSceneData::invalidate(frameInfo.scene);
+			m_isRaytracingEnabled = isRaytracingEnabled;
+		}
+
+		RayTracingSceneData::Resolver resolver{};
+		resolver.getMeshAddresses = [this, isRaytracingEnabled](const ResourceHandle<Mesh> handle, const Mesh& mesh) {
+			const auto& vkMesh = static_cast<const VulkanMesh&>(mesh);
+
+			// the raster path has no use for the BLASes, they are only built for ray tracing
+			VkDeviceAddress blasAddress = 0;
+			if (isRaytracingEnabled) {
+				blasAddress = m_blasRegistry.getOrCreateBLAS(m_resourceManager.getShared(handle))->buffer->getDeviceAddress();
+			}
+
+			return RayTracingSceneData::MeshAddresses{
+				vkMesh.getVertexBufferDeviceAddress(),
+				vkMesh.getIndexBufferDeviceAddress(),
+				blasAddress
+			};
+		};
+		resolver.getMaterialIndex = [this](const ResourceId& id) { return m_materialRegistry.getIndex(id); };
+		resolver.getTextureIndex = [this](const ResourceId& id) { return m_textureRegistry.getIndex(id); };
+
+		m_sceneData.build(frameInfo.scene, m_resourceManager.getPools(), resolver, m_objects);
+
+		if (m_objects.getSlotCount() > m_capacity) {
+			reallocateObjectBuffer(m_objects.getSlotCount());
+		}
+
+		recordScatter(frameInfo);
+	}
+
+	void GpuScene::reallocateObjectBuffer(uint32_t minCapacity) {
+		uint32_t capacity = std::max(m_capacity, INITIAL_CAPACITY);
+		while (capacity < minCapacity) {
+			capacity *= 2;
+		}
+
+		// the frames in flight may still be reading the old buffer (and the descriptor set pointing to it)
+		if (m_objectBuffer != nullptr) {
+			m_context.getFrameTimeline().waitIdle();
+		}
+
+		m_objectBuffer = createUnique<VulkanBuffer>(
+			m_context,
+			sizeof(SceneObjectData),
+			capacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+		m_capacity = capacity;
+
+		// the new buffer starts empty, every object has to be scattered again
+		m_objects.invalidate();
+
+		auto bufferInfo = m_objectBuffer->descriptorInfo();
+
+		DescriptorWriter(m_context, *m_descriptorSetLayout)
+			.writeBuffer(0, &bufferInfo)
+			.updateSet(m_descriptorSet);
+	}
+
+	void GpuScene::recordScatter(FrameInfo& frameInfo) {
+		const std::span<const SceneObjectUpdate> updates = m_objects.getUpdates();
+		m_uploadedObjectCount = static_cast<uint32_t>(updates.size());
+
+		if (updates.empty()) return;
+
+		// the frame's timeline value has been reached, its update buffer is free to be rewritten
+		Unique<VulkanBuffer>& updateBuffer = m_updateBuffers[frameInfo.frameIndex];
+		if (updateBuffer == nullptr || updateBuffer->getInstanceCount() < updates.size()) {
+			uint32_t capacity = updateBuffer != nullptr ? updateBuffer->getInstanceCount() : INITIAL_CAPACITY;
+			while (capacity < updates.size()) {
+				capacity *= 2;
+			}
+
+			updateBuffer = createUnique<VulkanBuffer>(
+				m_context,
+				sizeof(SceneObjectUpdate),
+				capacity,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+			);
+			updateBuffer->map();
+		}
+
+		updateBuffer->writeToBuffer((void*)updates.data(), updates.size_bytes());
+		m_objects.clearUpdates();
+
+		// the previous frames read the objects in the raster and ray tracing shaders
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(
+			frameInfo.commandBuffer,
+			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0,
+			1, &barrier,
+			0, nullptr,
+			0, nullptr
+		);
+
+		m_scatterPipeline->bind(frameInfo.commandBuffer);
+
+		ScatterPushConstants push{};
+		push.updates = updateBuffer->getDeviceAddress();
+		push.objects = m_objectBuffer->getDeviceAddress();
+		push.updateCount = m_uploadedObjectCount;
+
+		vkCmdPushConstants(
+			frameInfo.commandBuffer,
+			m_pipelineLayout,
+			VK_SHADER_STAGE_COMPUTE_BIT,
+			0, sizeof(ScatterPushConstants),
+			&push
+		);
+
+		vkCmdDispatch(frameInfo.commandBuffer, (push.updateCount + SCATTER_WORKGROUP_SIZE - 1) / SCATTER_WORKGROUP_SIZE, 1, 1);
+
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		vkCmdPipelineBarrier(
+			frameInfo.commandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+			0,
+			1, &barrier,
+			0, nullptr,
+			0, nullptr
+		);
+	}
+}
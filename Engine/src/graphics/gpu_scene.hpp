@@ -0,0 +1,114 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/context/context.hpp"
+#include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
+#include "graphics/frame_info.hpp"
+#include "graphics/swap_chain.hpp"
+#include "graphics/descriptors/descriptors.hpp"
+#include "graphics/resources/vk_buffer.hpp"
+#include "graphics/resources/blas_registry.hpp"
+#include "graphics/resources/material_registry.hpp"
+#include "graphics/resources/texture_registry.hpp"
+#include "graphics/scene_object_table.hpp"
+#include "graphics/raytracing_scene_data.hpp"
+#include "resources/resource_manager.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @class GpuScene
+	 *
+	 * @brief The persistent, device local scene buffer: one SceneObjectData per rendered
+	 * entity (transforms, material, mesh ranges and bounds), read by the raster pipelines
+	 * through the object index pushed per draw and by the ray tracing shaders through
+	 * gl_InstanceCustomIndexEXT.
+	 *
+	 * Every frame the scene is walked on the CPU (see RayTracingSceneData::build), only the
+	 * entities whose data changed are written to a small per-frame update buffer as
+	 * (index, data) pairs, which a compute pass (scene_scatter.comp) scatters into the scene
+	 * buffer at the start of the frame's command buffer. The upload is proportional to what
+	 * changed, not to the size of the scene. The entities that did not change are not even
+	 * resolved, their RenderPacketComponent is reused.
+	 *
+	 * The buffer grows geometrically; growing waits for the device and re-uploads every object.
+	 */
+	class GpuScene {
+	public:
+		static constexpr uint32_t INITIAL_CAPACITY = 256;
+
+		GpuScene(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, ResourceManager& resourceManager, MaterialRegistry& materialRegistry, BLASRegistry& blasRegistry, TextureRegistry& textureRegistry);
+		~GpuScene();
+
+		GpuScene(const GpuScene&) = delete;
+		GpuScene& operator=(const GpuScene&) = delete;
+
+		/**
+		 * @brief Walks the scene, then records the scatter of the changed objects in the
+		 * frame's command buffer. Must be called before any pass reading the scene buffer
+		 * is recorded, and after the skinning pass (the deformed meshes are in the objects).
+		 *
+		 * @param frameInfo The frame information.
+		 * @param isRaytracingEnabled Whether the TLAS instances need the BLASes of the meshes.
+		 */
+		void update(FrameInfo& frameInfo, bool isRaytracingEnabled);
+
+		void registerShaders(ShaderReloader& shaderReloader);
+
+		/**
+		 * @brief The index of an entity in the scene buffer, SceneObjectTable::INVALID_INDEX
+		 * if it is not rendered.
+		 */
+		uint32_t getObjectIndex(entt::entity entity) const { return m_objects.getIndex(entity); }
+
+		// the TLAS instances, emitters and volumes of the last update, they refer to the scene buffer by index
+		RayTracingSceneData& getSceneData() { return m_sceneData; }
+
+		// the last update, for the ui
+		uint32_t getObjectCount() const { return m_objects.getObjectCount(); }
+		uint32_t getUploadedObjectCount() const { return m_uploadedObjectCount; }
+
+		VkDescriptorSet getDescriptorSet() const { return m_descriptorSet; }
+		VkDescriptorSetLayout getDescriptorSetLayout() const { return m_descriptorSetLayout->getDescriptorSetLayout(); }
+
+	private:
+		void createDescriptorSet();
+		void createPipelineLayout();
+		Unique<Pipeline> createPipeline(bool useCompiledSpirvFiles = true) const;
+
+		/**
+		 * @brief Replaces the scene buffer with one holding at least minCapacity objects
+		 * and queues every object for upload.
+		 */
+		void reallocateObjectBuffer(uint32_t minCapacity);
+
+		void recordScatter(FrameInfo& frameInfo);
+
+		Context& m_context;
+		Shared<DescriptorAllocatorGrowable> m_descriptorAllocator;
+		ResourceManager& m_resourceManager;
+		MaterialRegistry& m_materialRegistry;
+		BLASRegistry& m_blasRegistry;
+		TextureRegistry& m_textureRegistry;
+
+		SceneObjectTable m_objects;
+		RayTracingSceneData m_sceneData;
+		bool m_isRaytracingEnabled = false;
+		uint32_t m_uploadedObjectCount = 0;
+
+		Unique<VulkanBuffer> m_objectBuffer = nullptr;
+		uint32_t m_capacity = 0;
+
+		// (index, data) pairs written by the CPU, one buffer per frame in flight
+		std::array<Unique<VulkanBuffer>, SwapChain::MAX_FRAMES_IN_FLIGHT> m_updateBuffers;
+
+		Unique<DescriptorSetLayout> m_descriptorSetLayout = nullptr;
+		VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+
+		Unique<Pipeline> m_scatterPipeline;
+		VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+
+		const std::string m_shaderPath = "scene_scatter.comp";
+	};
+}
@@ -0,0 +1,99 @@
+#include "graphics/gpu_timer.hpp"
+
+namespace PXTEngine {
+
+	GpuTimer::GpuTimer(Context& context, const uint32_t regionCount)
+		: m_context(context), m_regionCount(regionCount) {
+		PXT_ASSERT(regionCount > 0, "GpuTimer needs at least one region");
+
+		const VkPhysicalDeviceProperties properties = m_context.getPhysicalDeviceProperties();
+		m_timestampPeriod = properties.limits.timestampPeriod;
+		m_isSupported = properties.limits.timestampComputeAndGraphics == VK_TRUE;
+
+		m_isRecorded.resize(static_cast<size_t>(SwapChain::MAX_FRAMES_IN_FLIGHT) * m_regionCount, false);
+
+		if (!m_isSupported) {
+			PXT_WARN("Timestamp queries are not supported, GPU timings will not be available");
+			return;
+		}
+
+		VkQueryPoolCreateInfo queryPoolInfo{};
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolInfo.queryCount = SwapChain::MAX_FRAMES_IN_FLIGHT * m_regionCount * 2;
+
+		if (vkCreateQueryPool(m_context.getDevice(), &queryPoolInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create timestamp query pool!");
+		}
+	}
+
+	GpuTimer::~GpuTimer() {
+		if (m_queryPool != VK_NULL_HANDLE) {
+			vkDestroyQueryPool(m_context.getDevice(), m_queryPool, nullptr);
+		}
+	}
+
+	void GpuTimer::begin(VkCommandBuffer commandBuffer, const uint32_t frameIndex, const uint32_t region,
+						 const VkPipelineStageFlagBits stage) {
+		if (!m_isSupported) return;
+
+		const uint32_t queryIndex = getQueryIndex(frameIndex, region);
+
+		vkCmdResetQueryPool(commandBuffer, m_queryPool, queryIndex, 2);
+		vkCmdWriteTimestamp(commandBuffer, stage, m_queryPool, queryIndex);
+	}
+
+	void GpuTimer::end(VkCommandBuffer commandBuffer, const uint32_t frameIndex, const uint32_t region,
+					   const VkPipelineStageFlagBits stage) {
+		if (!m_isSupported) return;
+
+		vkCmdWriteTimestamp(commandBuffer, stage, m_queryPool, getQueryIndex(frameIndex, region) + 1);
+
+		m_isRecorded[frameIndex * m_regionCount + region] = true;
+	}
+
+	std::optional<float> GpuTimer::getElapsedMs(const uint32_t frameIndex, const uint32_t region) {
+		const std::optional<Interval> interval = getInterval(frameIndex, region);
+		if (!interval) {
+			return std::nullopt;
+		}
+
+		return interval->getElapsedMs();
+	}
+
+	std::optional<GpuTimer::Interval> GpuTimer::getInterval(const uint32_t frameIndex, const uint32_t region) {
+		const size_t recordedIndex = frameIndex * m_regionCount + region;
+		if (!m_isSupported || !m_isRecorded[recordedIndex]) {
+			return std::nullopt;
+		}
+		m_isRecorded[recordedIndex] = false;
+
+		// pairs of (timestamp, availability)
+		std::array<uint64_t, 4> results{};
+		const VkResult result = vkGetQueryPoolResults(
+			m_context.getDevice(),
+			m_queryPool,
+			getQueryIndex(frameIndex, region),
+			2,
+			sizeof(results),
+			results.data(),
+			sizeof(uint64_t) * 2,
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT
+		);
+
+		if (result != VK_SUCCESS || results[1] == 0 || results[3] == 0 || results[2] < results[0]) {
+			return std::nullopt;
+		}
+
+		Interval interval{};
+		interval.beginNs = static_cast<double>(results[0]) * m_timestampPeriod;
+		interval.endNs = static_cast<double>(results[2]) * m_timestampPeriod;
+		return interval;
+	}
+
+	uint32_t GpuTimer::getQueryIndex(const uint32_t frameIndex, const uint32_t region) const {
+		PXT_ASSERT(frameIndex < SwapChain::MAX_FRAMES_IN_FLIGHT && region < m_regionCount, "GpuTimer query out of range");
+
+		return (frameIndex * m_regionCount + region) * 2;
+	}
+}
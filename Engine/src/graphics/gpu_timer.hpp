@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/context/context.hpp"
+#include "graphics/swap_chain.hpp"
+
+namespace PXTEngine {
+	/**
+	 * @brief Measures the GPU time of regions of a command buffer with timestamp queries.
+	 *
+	 * Every frame in flight owns its own pair of queries per region, so the results of a frame
+	 * are read back (without waiting) the next time the same frame index is recorded, when its
+	 * timeline value has already been reached. The measure is therefore always MAX_FRAMES_IN_FLIGHT
+	 * frames old, which is fine for budgeting and statistics.
+	 */
+	class GpuTimer {
+	public:
+		/**
+		 * @brief The timestamps of a region in nanoseconds. Timestamps share the device time
+		 * domain, so the intervals of regions recorded on different queues can be compared.
+		 */
+		struct Interval {
+			double beginNs = 0.0;
+			double endNs = 0.0;
+
+			float getElapsedMs() const { return static_cast<float>((endNs - beginNs) / 1e6); }
+
+			/**
+			 * @brief The time both intervals were running, in milliseconds.
+			 */
+			float getOverlapMs(const Interval& other) const {
+				const double overlapNs = std::min(endNs, other.endNs) - std::max(beginNs, other.beginNs);
+				return static_cast<float>(std::max(overlapNs, 0.0) / 1e6);
+			}
+		};
+
+		GpuTimer(Context& context, uint32_t regionCount = 1);
+		~GpuTimer();
+
+		GpuTimer(const GpuTimer&) = delete;
+		GpuTimer& operator=(const GpuTimer&) = delete;
+
+		/**
+		 * @brief Whether the graphics and compute queues support timestamps, if not begin() and end()
+		 * do nothing and getElapsedMs() never returns a value.
+		 */
+		bool isSupported() const { return m_isSupported; }
+
+		/**
+		 * @brief Writes the start timestamp of a region. Must be recorded outside of a render pass.
+		 */
+		void begin(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t region = 0,
+				   VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+
+		/**
+		 * @brief Writes the end timestamp of a region.
+		 */
+		void end(VkCommandBuffer commandBuffer, uint32_t frameIndex, uint32_t region = 0,
+				 VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+		/**
+		 * @brief Returns the GPU time of the region recorded the last time frameIndex was used.
+		 *
+		 * Call it after the frame timeline value has been waited on (e.g. after Renderer::beginFrame)
+		 * and before recording the region again. The result is consumed: a region that has not
+		 * been recorded again returns no value.
+		 *
+		 * @return The elapsed time in milliseconds, or std::nullopt if the region was not
+		 * recorded or its results are not available.
+		 */
+		std::optional<float> getElapsedMs(uint32_t frameIndex, uint32_t region = 0);
+
+		/**
+		 * @brief Same as getElapsedMs(), returning the timestamps of the region.
+		 */
+		std::optional<Interval> getInterval(uint32_t frameIndex, uint32_t region = 0);
+
+	private:
+		uint32_t getQueryIndex(uint32_t frameIndex, uint32_t region) const;
+
+		Context& m_context;
+
+		VkQueryPool m_queryPool = VK_NULL_HANDLE;
+		uint32_t m_regionCount;
+		float m_timestampPeriod = 1.0f; // nanoseconds per tick
+		bool m_isSupported = false;
+
+		// whether the queries of a region have been written for a frame index
+		std::vector<bool> m_isRecorded;
+	};
+}
@@ -0,0 +1,193 @@
+#include "graphics/ibl.hpp"
+
+namespace PXTEngine::IBL {
+
+	namespace {
+
+		// sRGB -> linear conversion for every 8 bit value
+		const std::array<float, 256> SRGB_TO_LINEAR = [] {
+			std::array<float, 256> table{};
+			for (uint32_t i = 0; i < 256; i++) {
+				const float c = static_cast<float>(i) / 255.0f;
+				table[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+			}
+			return table;
+		}();
+
+		// real spherical harmonics basis up to band 2
+		std::array<float, IrradianceSH::COEFFICIENT_COUNT> shBasis(const glm::vec3& n) {
+			return {
+				0.282095f,
+				0.488603f * n.y,
+				0.488603f * n.z,
+				0.488603f * n.x,
+				1.092548f * n.x * n.y,
+				1.092548f * n.y * n.z,
+				0.315392f * (3.0f * n.z * n.z - 1.0f),
+				1.092548f * n.x * n.z,
+				0.546274f * (n.x * n.x - n.y * n.y)
+			};
+		}
+
+		// cosine lobe convolution per band divided by PI (Ramamoorthi and Hanrahan)
+		constexpr std::array<float, 3> BAND_FACTORS = { 1.0f, 2.0f / 3.0f, 1.0f / 4.0f };
+
+		glm::vec3 readTexel(const uint8_t* face, const uint32_t size, const uint32_t x, const uint32_t y, const bool isSrgb) {
+			const uint8_t* texel = face + (static_cast<size_t>(y) * size + x) * 4;
+			if (isSrgb) {
+				return { SRGB_TO_LINEAR[texel[0]], SRGB_TO_LINEAR[texel[1]], SRGB_TO_LINEAR[texel[2]] };
+			}
+			return glm::vec3(texel[0], texel[1], texel[2]) / 255.0f;
+		}
+
+		float geometrySchlickGGX(const float NdotX, const float k) {
+			return NdotX / (NdotX * (1.0f - k) + k);
+		}
+	}
+
+	IrradianceSH IrradianceSH::constant(const glm::vec3& radiance) {
+		IrradianceSH sh{};
+		sh.coefficients[0] = radiance / 0.282095f;
+		return sh;
+	}
+
+	glm::vec3 IrradianceSH::evaluate(const glm::vec3& normal) const {
+		const auto basis = shBasis(normal);
+
+		glm::vec3 result{ 0.0f };
+		for (uint32_t i = 0; i < COEFFICIENT_COUNT; i++) {
+			result += coefficients[i] * basis[i];
+		}
+		return glm::max(result, glm::vec3(0.0f));
+	}
+
+	glm::vec3 cubeMapDirection(const uint32_t face, const float u, const float v) {
+		glm::vec3 dir;
+		switch (face) {
+		case CubeFace::RIGHT:  dir = { 1.0f, -v, -u }; break;
+		case CubeFace::LEFT:   dir = { -1.0f, -v, u }; break;
+		case CubeFace::TOP:    dir = { u, 1.0f, v }; break;
+		case CubeFace::BOTTOM: dir = { u, -1.0f, -v }; break;
+		case CubeFace::BACK:   dir = { u, -v, 1.0f }; break;
+		default:               dir = { -u, -v, -1.0f }; break;
+		}
+		return glm::normalize(dir);
+	}
+
+	IrradianceSH projectCubeMap(const std::array<const uint8_t*, 6>& faces, const uint32_t size,
+								const bool isSrgb, const uint32_t maxSamplesPerSide) {
+		PXT_ASSERT(size > 0 && maxSamplesPerSide > 0, "Cannot project an empty cube map");
+
+		const uint32_t samplesPerSide = std::min(size, maxSamplesPerSide);
+		const float texelSize = 2.0f / static_cast<float>(samplesPerSide);
+
+		std::array<glm::vec3, IrradianceSH::COEFFICIENT_COUNT> sums{};
+		float totalWeight = 0.0f;
+
+		for (uint32_t face = 0; face < 6; face++) {
+			for (uint32_t y = 0; y < samplesPerSide; y++) {
+				const float v = (static_cast<float>(y) + 0.5f) * texelSize - 1.0f;
+				const uint32_t texelY = y * size / samplesPerSide;
+
+				for (uint32_t x = 0; x < samplesPerSide; x++) {
+					const float u = (static_cast<float>(x) + 0.5f) * texelSize - 1.0f;
+					const uint32_t texelX = x * size / samplesPerSide;
+
+					// solid angle subtended by the texel
+					const float d = 1.0f + u * u + v * v;
+					const float weight = texelSize * texelSize / (d * std::sqrt(d));
+
+					const glm::vec3 radiance = readTexel(faces[face], size, texelX, texelY, isSrgb);
+					const auto basis = shBasis(cubeMapDirection(face, u, v));
+
+					for (uint32_t i = 0; i < IrradianceSH::COEFFICIENT_COUNT; i++) {
+						sums[i] += radiance * (basis[i] * weight);
+					}
+					totalWeight += weight;
+				}
+			}
+		}
+
+		// the weights should add up to 4PI, normalize to remove the discretization error
+		const float normalization = 4.0f * glm::pi<float>() / totalWeight;
+
+		IrradianceSH sh{};
+		for (uint32_t i = 0; i < IrradianceSH::COEFFICIENT_COUNT; i++) {
+			const uint32_t band = i == 0 ? 0 : (i < 4 ? 1 : 2);
+			sh.coefficients[i] = sums[i] * normalization * BAND_FACTORS[band];
+		}
+		return sh;
+	}
+
+	glm::vec2 hammersley(const uint32_t i, const uint32_t sampleCount) {
+		uint32_t bits = i;
+		bits = (bits << 16u) | (bits >> 16u);
+		bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+		bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+		bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+		bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+
+		return { static_cast<float>(i) / static_cast<float>(sampleCount), static_cast<float>(bits) * 2.3283064365386963e-10f };
+	}
+
+	glm::vec3 importanceSampleGGX(const glm::vec2& xi, const glm::vec3& n, const float roughness) {
+		const float a = roughness * roughness;
+
+		const float phi = 2.0f * glm::pi<float>() * xi.x;
+		const float cosTheta = std::sqrt((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+		const float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+
+		const glm::vec3 h{ std::cos(phi) * sinTheta, std::sin(phi) * sinTheta, cosTheta };
+
+		// tangent space to world space
+		const glm::vec3 up = std::abs(n.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+		const glm::vec3 tangent = glm::normalize(glm::cross(up, n));
+		const glm::vec3 bitangent = glm::cross(n, tangent);
+
+		return glm::normalize(tangent * h.x + bitangent * h.y + n * h.z);
+	}
+
+	glm::vec2 integrateBRDF(const float NdotV, const float roughness, const uint32_t sampleCount) {
+		const glm::vec3 v{ std::sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV };
+		const glm::vec3 n{ 0.0f, 0.0f, 1.0f };
+
+		// k for image based lighting (Karis 2013)
+		const float k = roughness * roughness / 2.0f;
+
+		float scale = 0.0f;
+		float bias = 0.0f;
+
+		for (uint32_t i = 0; i < sampleCount; i++) {
+			const glm::vec3 h = importanceSampleGGX(hammersley(i, sampleCount), n, roughness);
+			const glm::vec3 l = 2.0f * glm::dot(v, h) * h - v;
+
+			const float NdotL = std::max(l.z, 0.0f);
+			if (NdotL <= 0.0f) continue;
+
+			const float NdotH = std::max(h.z, 0.0f);
+			const float VdotH = std::max(glm::dot(v, h), 0.0f);
+
+			const float g = geometrySchlickGGX(NdotV, k) * geometrySchlickGGX(NdotL, k);
+			const float gVis = g * VdotH / (NdotH * NdotV);
+			const float fc = std::pow(1.0f - VdotH, 5.0f);
+
+			scale += (1.0f - fc) * gVis;
+			bias += fc * gVis;
+		}
+
+		return glm::vec2(scale, bias) / static_cast<float>(sampleCount);
+	}
+
+	std::vector<glm::vec2> generateBRDFLUT(const uint32_t size, const uint32_t sampleCount) {
+		std::vector<glm::vec2> lut(static_cast<size_t>(size) * size);
+
+		for (uint32_t y = 0; y < size; y++) {
+			const float roughness = (static_cast<float>(y) + 0.5f) / static_cast<float>(size);
+			for (uint32_t x = 0; x < size; x++) {
+				const float NdotV = (static_cast<float>(x) + 0.5f) / static_cast<float>(size);
+				lut[static_cast<size_t>(y) * size + x] = integrateBRDF(NdotV, roughness, sampleCount);
+			}
+		}
+		return lut;
+	}
+}
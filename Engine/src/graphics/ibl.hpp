@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/pch.hpp"
+
+namespace PXTEngine::IBL {
+
+	/**
+	 * @brief Diffuse environment lighting stored as L2 spherical harmonics (9 RGB coefficients).
+	 *
+	 * The coefficients already include the convolution with the clamped cosine lobe and the
+	 * division by PI, so evaluate() returns the outgoing radiance of a white lambertian surface
+	 * with the given normal: a constant environment of radiance L evaluates to L everywhere.
+	 */
+	struct IrradianceSH {
+		static constexpr uint32_t COEFFICIENT_COUNT = 9;
+
+		std::array<glm::vec3, COEFFICIENT_COUNT> coefficients{};
+
+		/**
+		 * @brief Creates the spherical harmonics of an environment with constant radiance.
+		 */
+		static IrradianceSH constant(const glm::vec3& radiance);
+
+		/**
+		 * @brief Evaluates the diffuse lighting for a surface with the given (normalized) normal.
+		 */
+		glm::vec3 evaluate(const glm::vec3& normal) const;
+	};
+
+	/**
+	 * @brief Returns the normalized direction of a cube map texel.
+	 *
+	 * Uses the Vulkan cube map convention (+X, -X, +Y, -Y, +Z, -Z face order).
+	 *
+	 * @param face Index of the cube face (see CubeFace).
+	 * @param u Horizontal texel coordinate in [-1, 1].
+	 * @param v Vertical texel coordinate in [-1, 1].
+	 */
+	glm::vec3 cubeMapDirection(uint32_t face, float u, float v);
+
+	/**
+	 * @brief Projects a RGBA8 cube map onto L2 spherical harmonics.
+	 *
+	 * Faces bigger than maxSamplesPerSide are point sampled on a coarser grid, which is more
+	 * than enough for the low frequency content that L2 harmonics can represent.
+	 *
+	 * @param faces Pointers to the pixels of the 6 faces, in cube map face order.
+	 * @param size Width and height of each face.
+	 * @param isSrgb Whether the pixels are sRGB encoded and need to be linearized.
+	 * @param maxSamplesPerSide Maximum number of samples taken along each side of a face.
+	 */
+	IrradianceSH projectCubeMap(const std::array<const uint8_t*, 6>& faces, uint32_t size,
+								bool isSrgb = true, uint32_t maxSamplesPerSide = 64);
+
+	/**
+	 * @brief Importance samples the GGX distribution around the normal n.
+	 *
+	 * @param xi Uniform random numbers in [0, 1).
+	 * @param n Normal (and view direction, since the split sum approximation assumes N = V = R).
+	 * @param roughness Perceptual roughness, squared internally.
+	 * @return The sampled half vector.
+	 */
+	glm::vec3 importanceSampleGGX(const glm::vec2& xi, const glm::vec3& n, float roughness);
+
+	/**
+	 * @brief Returns the i-th point of a Hammersley sequence of the given size.
+	 */
+	glm::vec2 hammersley(uint32_t i, uint32_t sampleCount);
+
+	/**
+	 * @brief Integrates the split sum BRDF term for the given view angle and roughness.
+	 *
+	 * @return The scale (x) and bias (y) to apply to F0.
+	 */
+	glm::vec2 integrateBRDF(float NdotV, float roughness, uint32_t sampleCount);
+
+	/**
+	 * @brief Generates a size x size BRDF lookup table on the CPU.
+	 *
+	 * Rows are indexed by roughness and columns by NdotV, texel centers are sampled.
+	 * It matches the output of the brdf_lut compute shader and is used as its fallback.
+	 */
+	std::vector<glm::vec2> generateBRDFLUT(uint32_t size, uint32_t sampleCount);
+}
@@ -0,0 +1,353 @@
+#include "graphics/ibl_baker.hpp"
+
+#include "graphics/ibl.hpp"
+#include "graphics/resources/vk_buffer.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+namespace PXTEngine {
+
+	struct PrefilterPushConstants {
+		float roughness;
+		uint32_t sampleCount;
+	};
+
+	struct BRDFLUTPushConstants {
+		uint32_t sampleCount;
+	};
+
+	// both shaders use 8x8 workgroups
+	static constexpr uint32_t WORKGROUP_SIZE = 8;
+
+	static constexpr VkFormat IBL_FORMAT = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+	IBLBaker::IBLBaker(Context& context) : m_context(context) {}
+
+	Unique<Pipeline> IBLBaker::createComputePipeline(const std::string& shaderFileName, VkPipelineLayout pipelineLayout) const {
+		ComputePipelineConfigInfo pipelineConfig{};
+		pipelineConfig.pipelineLayout = pipelineLayout;
+
+		return createUnique<Pipeline>(m_context, SPV_SHADERS_PATH + shaderFileName + ".spv", pipelineConfig);
+	}
+
+	Unique<CubeMap> IBLBaker::prefilterSpecular(CubeMap& environmentMap, const uint32_t size, const uint32_t mipLevels) {
+		PXT_STARTUP_PHASE("Prefilter environment map");
+
+		PXT_ASSERT(mipLevels > 1 && (size >> (mipLevels - 1)) > 0, "Too many mip levels for the prefiltered map size");
+
+		Unique<CubeMap> prefilteredMap = createUnique<CubeMap>(
+			m_context,
+			size,
+			IBL_FORMAT,
+			VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+			mipLevels
+		);
+
+		Unique<DescriptorSetLayout> setLayout = DescriptorSetLayout::Builder(m_context)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT) // environment map
+			.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)          // output mip level
+			.build();
+
+		// one set per mip level, only needed for this bake
+		Unique<DescriptorPool> descriptorPool = DescriptorPool::Builder(m_context)
+			.addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, mipLevels)
+			.addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, mipLevels)
+			.setMaxSets(mipLevels)
+			.build();
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(PrefilterPushConstants);
+
+		VkDescriptorSetLayout descriptorSetLayout = setLayout->getDescriptorSetLayout();
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		VkPipelineLayout pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
+		Unique<Pipeline> pipeline = createComputePipeline(m_prefilterShaderPath, pipelineLayout);
+
+		VkDescriptorImageInfo environmentImageInfo{};
+		environmentImageInfo.sampler = environmentMap.getImageSampler();
+		environmentImageInfo.imageView = environmentMap.getImageView();
+		environmentImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		// each mip level is written through its own array view (6 layers, one per face)
+		std::vector<VkImageView> mipViews(mipLevels, VK_NULL_HANDLE);
+		std::vector<VkDescriptorSet> descriptorSets(mipLevels, VK_NULL_HANDLE);
+
+		for (uint32_t mip = 0; mip < mipLevels; mip++) {
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.image = prefilteredMap->getVkImage();
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+			viewInfo.format = IBL_FORMAT;
+			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			viewInfo.subresourceRange.baseMipLevel = mip;
+			viewInfo.subresourceRange.levelCount = 1;
+			viewInfo.subresourceRange.baseArrayLayer = 0;
+			viewInfo.subresourceRange.layerCount = 6;
+
+			mipViews[mip] = m_context.createImageView(viewInfo);
+
+			VkDescriptorImageInfo mipImageInfo{};
+			mipImageInfo.imageView = mipViews[mip];
+			mipImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+			if (!descriptorPool->allocateDescriptorSet(descriptorSetLayout, descriptorSets[mip])) {
+				throw std::runtime_error("Failed to allocate descriptor set for specular prefiltering!");
+			}
+
+			DescriptorWriter(m_context, *setLayout)
+				.writeImage(0, &environmentImageInfo)
+				.writeImage(1, &mipImageInfo)
+				.updateSet(descriptorSets[mip]);
+		}
+
+		VkImageSubresourceRange fullRange{};
+		fullRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		fullRange.baseMipLevel = 0;
+		fullRange.levelCount = mipLevels;
+		fullRange.baseArrayLayer = 0;
+		fullRange.layerCount = 6;
+
+		VkCommandBuffer commandBuffer = m_context.beginSingleTimeCommands();
+
+		prefilteredMap->transitionImageLayout(
+			commandBuffer,
+			VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			fullRange
+		);
+
+		pipeline->bind(commandBuffer);
+
+		for (uint32_t mip = 0; mip < mipLevels; mip++) {
+			const uint32_t mipSize = size >> mip;
+
+			PrefilterPushConstants push{};
+			push.roughness = static_cast<float>(mip) / static_cast<float>(mipLevels - 1);
+			// the base level is a plain copy of the environment
+			push.sampleCount = mip == 0 ? 1 : PREFILTER_SAMPLE_COUNT;
+
+			vkCmdBindDescriptorSets(
+				commandBuffer,
+				VK_PIPELINE_BIND_POINT_COMPUTE,
+				pipelineLayout,
+				0, 1, &descriptorSets[mip],
+				0, nullptr
+			);
+
+			vkCmdPushConstants(
+				commandBuffer,
+				pipelineLayout,
+				VK_SHADER_STAGE_COMPUTE_BIT,
+				0, sizeof(PrefilterPushConstants),
+				&push
+			);
+
+			const uint32_t groupCount = (mipSize + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+			vkCmdDispatch(commandBuffer, groupCount, groupCount, 6);
+		}
+
+		prefilteredMap->transitionImageLayout(
+			commandBuffer,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			fullRange
+		);
+
+		m_context.endSingleTimeCommands(commandBuffer); // Submits and waits
+
+		for (VkImageView view : mipViews) {
+			vkDestroyImageView(m_context.getDevice(), view, nullptr);
+		}
+
+		return prefilteredMap;
+	}
+
+	Unique<VulkanImage> IBLBaker::createBRDFLUT(const uint32_t size, const bool useCompute) {
+		PXT_STARTUP_PHASE("Bake BRDF LUT");
+
+		Unique<VulkanImage> lut = createBRDFLUTImage(size);
+
+		if (useCompute) {
+			bakeBRDFLUT(*lut, size);
+		} else {
+			uploadBRDFLUT(*lut, size);
+		}
+
+		return lut;
+	}
+
+	Unique<VulkanImage> IBLBaker::createBRDFLUTImage(const uint32_t size) const {
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.format = IBL_FORMAT;
+		imageInfo.extent = { size, size, 1 };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		Unique<VulkanImage> lut = createUnique<VulkanImage>(m_context, imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = IBL_FORMAT;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_LINEAR;
+		samplerInfo.minFilter = VK_FILTER_LINEAR;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.maxAnisotropy = 1.0f;
+		samplerInfo.maxLod = 1.0f;
+
+		lut->createImageView(viewInfo);
+		lut->createSampler(samplerInfo);
+
+		return lut;
+	}
+
+	void IBLBaker::bakeBRDFLUT(VulkanImage& lut, const uint32_t size) {
+		Unique<DescriptorSetLayout> setLayout = DescriptorSetLayout::Builder(m_context)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+			.build();
+
+		Unique<DescriptorPool> descriptorPool = DescriptorPool::Builder(m_context)
+			.addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1)
+			.setMaxSets(1)
+			.build();
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(BRDFLUTPushConstants);
+
+		VkDescriptorSetLayout descriptorSetLayout = setLayout->getDescriptorSetLayout();
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		VkPipelineLayout pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
+		Unique<Pipeline> pipeline = createComputePipeline(m_brdfLutShaderPath, pipelineLayout);
+
+		VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+		if (!descriptorPool->allocateDescriptorSet(descriptorSetLayout, descriptorSet)) {
+			throw std::runtime_error("Failed to allocate descriptor set for the BRDF LUT!");
+		}
+
+		VkDescriptorImageInfo lutImageInfo = lut.getImageInfo(false);
+		lutImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+		DescriptorWriter(m_context, *setLayout)
+			.writeImage(0, &lutImageInfo)
+			.updateSet(descriptorSet);
+
+		VkCommandBuffer commandBuffer = m_context.beginSingleTimeCommands();
+
+		lut.transitionImageLayout(
+			commandBuffer,
+			VK_IMAGE_LAYOUT_GENERAL,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+		);
+
+		pipeline->bind(commandBuffer);
+
+		vkCmdBindDescriptorSets(
+			commandBuffer,
+			VK_PIPELINE_BIND_POINT_COMPUTE,
+			pipelineLayout,
+			0, 1, &descriptorSet,
+			0, nullptr
+		);
+
+		BRDFLUTPushConstants push{};
+		push.sampleCount = BRDF_LUT_SAMPLE_COUNT;
+
+		vkCmdPushConstants(
+			commandBuffer,
+			pipelineLayout,
+			VK_SHADER_STAGE_COMPUTE_BIT,
+			0, sizeof(BRDFLUTPushConstants),
+			&push
+		);
+
+		const uint32_t groupCount = (size + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE;
+		vkCmdDispatch(commandBuffer, groupCount, groupCount, 1);
+
+		lut.transitionImageLayout(
+			commandBuffer,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+		);
+
+		m_context.endSingleTimeCommands(commandBuffer); // Submits and waits
+	}
+
+	void IBLBaker::uploadBRDFLUT(VulkanImage& lut, const uint32_t size) {
+		const std::vector<glm::vec2> values = IBL::generateBRDFLUT(size, BRDF_LUT_SAMPLE_COUNT);
+
+		// RGBA16F texels, only the first two channels are used
+		std::vector<uint16_t> texels(values.size() * 4);
+		for (size_t i = 0; i < values.size(); i++) {
+			texels[i * 4 + 0] = glm::packHalf1x16(values[i].x);
+			texels[i * 4 + 1] = glm::packHalf1x16(values[i].y);
+			texels[i * 4 + 2] = glm::packHalf1x16(0.0f);
+			texels[i * 4 + 3] = glm::packHalf1x16(1.0f);
+		}
+
+		const VkDeviceSize bufferSize = texels.size() * sizeof(uint16_t);
+
+		VulkanBuffer stagingBuffer(
+			m_context,
+			bufferSize,
+			1,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+		);
+		stagingBuffer.map();
+		stagingBuffer.writeToBuffer(texels.data(), bufferSize);
+
+		lut.transitionImageLayoutSingleTimeCmd(
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT
+		);
+
+		m_context.copyBufferToImage(stagingBuffer.getBuffer(), lut.getVkImage(), size, size);
+
+		lut.transitionImageLayoutSingleTimeCmd(
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
+		);
+	}
+}
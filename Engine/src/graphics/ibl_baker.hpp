@@ -0,0 +1,66 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/context/context.hpp"
+#include "graphics/pipeline.hpp"
+#include "graphics/descriptors/descriptors.hpp"
+#include "graphics/resources/cube_map.hpp"
+#include "graphics/resources/vk_image.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @class IBLBaker
+	 * @brief Generates the GPU resources used for image based lighting in the raster path.
+	 *
+	 * - a GGX prefiltered specular cube map, where mip i is filtered with roughness i / (mipLevels - 1)
+	 * - the split sum BRDF lookup table (scale and bias to apply to F0, indexed by NdotV and roughness)
+	 *
+	 * Both are baked by compute shaders in a single blocking submission, they are meant to be
+	 * created once (e.g. when the skybox changes) and not every frame.
+	 * The diffuse part is projected to spherical harmonics on the CPU, see IBL::projectCubeMap.
+	 */
+	class IBLBaker {
+	public:
+		static constexpr uint32_t PREFILTERED_SIZE = 128;
+		static constexpr uint32_t PREFILTERED_MIP_LEVELS = 6;
+		static constexpr uint32_t PREFILTER_SAMPLE_COUNT = 1024;
+		static constexpr uint32_t BRDF_LUT_SIZE = 128;
+		static constexpr uint32_t BRDF_LUT_SAMPLE_COUNT = 512;
+
+		explicit IBLBaker(Context& context);
+
+		/**
+		 * @brief Creates the GGX prefiltered mip chain of an environment cube map.
+		 *
+		 * @param environmentMap The source cube map, in SHADER_READ_ONLY_OPTIMAL layout.
+		 * @param size Size of the base level of the prefiltered map.
+		 * @param mipLevels Number of roughness levels.
+		 * @return The prefiltered cube map, in SHADER_READ_ONLY_OPTIMAL layout.
+		 */
+		Unique<CubeMap> prefilterSpecular(CubeMap& environmentMap, uint32_t size = PREFILTERED_SIZE,
+										  uint32_t mipLevels = PREFILTERED_MIP_LEVELS);
+
+		/**
+		 * @brief Creates the split sum BRDF lookup table.
+		 *
+		 * @param size Width and height of the table.
+		 * @param useCompute Whether to bake it with the brdf_lut compute shader or on the CPU
+		 * (IBL::generateBRDFLUT) and upload it.
+		 * @return The lookup table, in SHADER_READ_ONLY_OPTIMAL layout.
+		 */
+		Unique<VulkanImage> createBRDFLUT(uint32_t size = BRDF_LUT_SIZE, bool useCompute = true);
+
+	private:
+		Unique<Pipeline> createComputePipeline(const std::string& shaderFileName, VkPipelineLayout pipelineLayout) const;
+
+		Unique<VulkanImage> createBRDFLUTImage(uint32_t size) const;
+		void bakeBRDFLUT(VulkanImage& lut, uint32_t size);
+		void uploadBRDFLUT(VulkanImage& lut, uint32_t size);
+
+		Context& m_context;
+
+		const std::string m_prefilterShaderPath = "prefilter_specular.comp";
+		const std::string m_brdfLutShaderPath = "brdf_lut.comp";
+	};
+}
@@ -0,0 +1,53 @@
+#include "graphics/material_shader_variants.hpp"
+
+#include "resources/resource_manager.hpp"
+
+namespace PXTEngine {
+
+	namespace {
+		// must match the defines of material_shader.frag
+		constexpr std::array<std::pair<MaterialFeature, const char*>, 7> FEATURE_DEFINES = {{
+			{ MATERIAL_FEATURE_ALBEDO_MAP, "HAS_ALBEDO_MAP" },
+			{ MATERIAL_FEATURE_NORMAL_MAP, "HAS_NORMAL_MAP" },
+			{ MATERIAL_FEATURE_AMBIENT_OCCLUSION_MAP, "HAS_AMBIENT_OCCLUSION_MAP" },
+			{ MATERIAL_FEATURE_EMISSIVE, "IS_EMISSIVE" },
+			{ MATERIAL_FEATURE_EMISSIVE_MAP, "HAS_EMISSIVE_MAP" },
+			{ MATERIAL_FEATURE_POINT_LIGHTS, "HAS_POINT_LIGHTS" },
+			{ MATERIAL_FEATURE_SHADOWS, "HAS_SHADOWS" }
+		}};
+
+		// the default material is not set without the application (e.g. in the benchmarks)
+		bool isMapSet(const Shared<Image>& map, Shared<Image> (Material::*getDefaultMap)() const) {
+			const Material* defaultMaterial = ResourceManager::defaultMaterial.get();
+			return map != nullptr && (defaultMaterial == nullptr || map != (defaultMaterial->*getDefaultMap)());
+		}
+	}
+
+	MaterialFeatureKey getMaterialFeatureKey(const Material& material) {
+		MaterialFeatureKey key = 0;
+
+		if (isMapSet(material.getAlbedoMap(), &Material::getAlbedoMap)) key |= MATERIAL_FEATURE_ALBEDO_MAP;
+		if (isMapSet(material.getNormalMap(), &Material::getNormalMap)) key |= MATERIAL_FEATURE_NORMAL_MAP;
+		if (isMapSet(material.getAmbientOcclusionMap(), &Material::getAmbientOcclusionMap)) key |= MATERIAL_FEATURE_AMBIENT_OCCLUSION_MAP;
+
+		if (material.isEmissive()) {
+			key |= MATERIAL_FEATURE_EMISSIVE;
+			if (isMapSet(material.getEmissiveMap(), &Material::getEmissiveMap)) key |= MATERIAL_FEATURE_EMISSIVE_MAP;
+		}
+
+		return key;
+	}
+
+	std::vector<std::pair<std::string, std::string>> getMaterialFeatureDefinitions(const MaterialFeatureKey key) {
+		// without MATERIAL_VARIANT the shader enables every feature, like the precompiled one
+		std::vector<std::pair<std::string, std::string>> definitions = { { "MATERIAL_VARIANT", "1" } };
+
+		for (const auto& [feature, define] : FEATURE_DEFINES) {
+			if (key & feature) {
+				definitions.emplace_back(define, "1");
+			}
+		}
+
+		return definitions;
+	}
+}
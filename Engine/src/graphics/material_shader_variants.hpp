@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "resources/types/material.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @enum MaterialFeature
+	 *
+	 * @brief The features the raster material shader is specialized on. Each one is a define
+	 * of material_shader.frag, a variant without a feature does not pay for it.
+	 *
+	 * The first ones come from the material (see getMaterialFeatureKey), the lighting ones
+	 * from the frame: the material render system adds them to the key of every draw.
+	 */
+	enum MaterialFeature : uint32_t {
+		MATERIAL_FEATURE_ALBEDO_MAP = 1 << 0,
+		MATERIAL_FEATURE_NORMAL_MAP = 1 << 1,
+		MATERIAL_FEATURE_AMBIENT_OCCLUSION_MAP = 1 << 2,
+		MATERIAL_FEATURE_EMISSIVE = 1 << 3,
+		MATERIAL_FEATURE_EMISSIVE_MAP = 1 << 4, // only set together with MATERIAL_FEATURE_EMISSIVE
+
+		MATERIAL_FEATURE_POINT_LIGHTS = 1 << 5, // the scene has point lights, the light loop runs
+		MATERIAL_FEATURE_SHADOWS = 1 << 6,      // a light has shadows to sample, only set with the point lights
+
+		// the precompiled shader, every feature enabled
+		MATERIAL_FEATURE_ALL = (1 << 7) - 1
+	};
+
+	/**
+	 * @brief A combination of MaterialFeature flags, the key of a material shader variant.
+	 */
+	using MaterialFeatureKey = uint32_t;
+
+	/**
+	 * @brief The features a material needs, derived from the maps it has and its emission.
+	 * The maps the builder filled in from the default material are neutral (white, flat
+	 * normal), the variant without them computes the same result and they don't count.
+	 */
+	MaterialFeatureKey getMaterialFeatureKey(const Material& material);
+
+	/**
+	 * @brief The defines compiling material_shader.frag into the variant of a key.
+	 */
+	std::vector<std::pair<std::string, std::string>> getMaterialFeatureDefinitions(MaterialFeatureKey key);
+}
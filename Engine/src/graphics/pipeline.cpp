@@ -11,8 +11,9 @@ namespace PXTEngine {
     };
 
     Pipeline::Pipeline(Context& context, const std::vector<std::string>& shaderFilePaths,
-                       const RasterizationPipelineConfigInfo& configInfo) : m_context(context) {
-        createGraphicsPipeline(shaderFilePaths, configInfo);
+                       const RasterizationPipelineConfigInfo& configInfo,
+                       const std::vector<std::pair<std::string, std::string>>& definitions) : m_context(context) {
+        createGraphicsPipeline(shaderFilePaths, configInfo, definitions);
     }
 
 	Pipeline::Pipeline(Context& context, const RayTracingPipelineConfigInfo& configInfo)
@@ -42,6 +43,7 @@ namespace PXTEngine {
 
         file.seekg(0);
         file.read(buffer.data(), fileSize);
+        StartupProfiler::recordRead(fileSize);
 
         file.close();
 
@@ -61,8 +63,11 @@ namespace PXTEngine {
 
 	void Pipeline::createGraphicsPipeline(
 		const std::vector<std::string>& shaderFilePaths,
-		const RasterizationPipelineConfigInfo& configInfo
+		const RasterizationPipelineConfigInfo& configInfo,
+		const std::vector<std::pair<std::string, std::string>>& definitions
 	) {
+		PXT_STARTUP_PHASE("Create graphics pipeline");
+
 		// Ensure that the pipeline layout and render pass are properly set.
 		PXT_ASSERT(configInfo.pipelineLayout != nullptr,
 			"Cannot create graphics pipeline: no pipelineLayout provided in config info");
@@ -94,7 +99,7 @@ namespace PXTEngine {
 		for (int i = 0; i < shaderFilePaths.size(); i++) {
 			const auto& filepath = shaderFilePaths[i];
 			// to handle memory stuff atomatically
-			shaders[i] = createUnique<VulkanShader>(m_context, filepath);
+			shaders[i] = createUnique<VulkanShader>(m_context, filepath, definitions);
 
 			VkPipelineShaderStageCreateInfo shaderStageCreateInfo = shaders[i]->getShaderStageCreateInfo();
 			shaderStageCreateInfo.pSpecializationInfo = &specializationInfo;
@@ -144,6 +149,8 @@ namespace PXTEngine {
 	}
 
 	void Pipeline::createRayTracingPipeline(const RayTracingPipelineConfigInfo& configInfo) {
+		PXT_STARTUP_PHASE("Create ray tracing pipeline");
+
 		// --- SPECIALIZATION CONSTANT SETUP (if needed for all shaders) ---
 		SpecializationData specializationData = { MAX_LIGHTS };
 
@@ -247,6 +254,8 @@ namespace PXTEngine {
 	}
 
 	void Pipeline::createComputePipeline(const std::string& shaderFilePath, const ComputePipelineConfigInfo& configInfo) {
+		PXT_STARTUP_PHASE("Create compute pipeline");
+
 		PXT_ASSERT(configInfo.pipelineLayout != nullptr,
 			"Cannot create compute pipeline: no pipelineLayout provided in config info");
 
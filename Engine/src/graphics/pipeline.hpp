@@ -78,8 +78,12 @@ namespace PXTEngine {
      */
     class Pipeline {
        public:
+        /**
+         * @param definitions The defines the shaders are compiled with, ignored for the precompiled (.spv) ones.
+         */
         Pipeline(Context& context, const std::vector<std::string>& shaderFilePaths,
-                 const RasterizationPipelineConfigInfo& configInfo);
+                 const RasterizationPipelineConfigInfo& configInfo,
+                 const std::vector<std::pair<std::string, std::string>>& definitions = {});
 		Pipeline(Context& context, const RayTracingPipelineConfigInfo& configInfo);
         Pipeline(Context& context, const std::string& shaderFilePath, const ComputePipelineConfigInfo& configInfo);
                  
@@ -100,7 +104,8 @@ namespace PXTEngine {
 
         void createGraphicsPipeline(
             const std::vector<std::string>& shaderFilePaths,
-            const RasterizationPipelineConfigInfo& configInfo);
+            const RasterizationPipelineConfigInfo& configInfo,
+            const std::vector<std::pair<std::string, std::string>>& definitions);
 
 		void createRayTracingPipeline(const RayTracingPipelineConfigInfo& configInfo);
 
@@ -0,0 +1,249 @@
+#include "graphics/raytracing_scene_data.hpp"
+
+#include "scene/ecs/component.hpp"
+#include "scene/ecs/entity.hpp"
+#include "graphics/material_shader_variants.hpp"
+
+namespace PXTEngine {
+
+	void RayTracingSceneData::build(Scene& scene, const ResourcePools& resources, const Resolver& resolver, SceneObjectTable& objects) {
+		PXT_ALLOCATION_SCOPE("RayTracingScene");
+
+		instances.clear();
+		emitters.clear();
+		volumes.clear();
+		volumeGrids.clear();
+
+		objects.beginUpdate();
+
+		// the packets are added by the scene to every entity with a mesh
+		auto view = scene.getEntitiesWith<TransformComponent, MeshComponent, RenderPacketComponent>();
+
+		uint32_t volumeIndex = 0; // for now just iterative increase
+		for (auto entityHandle : view) {
+			auto [transformComponent, meshComponent, packet] = view.get<TransformComponent, MeshComponent, RenderPacketComponent>(entityHandle);
+
+			// the volumes are few and edited in place, they are always rebuilt. A released mesh
+			// keeps its handle value but not its generation. The emitter index of a packet is
+			// in its scene object, it must still be the next emitter
+			const bool isClean = !packet.isDirty &&
+				!packet.hasVolume &&
+				packet.meshHandle == meshComponent.getRenderMesh() &&
+				resources.get<Mesh>().isValid(packet.meshHandle) &&
+				packet.isBuiltFrom(transformComponent) &&
+				(packet.emitterIndex == RenderPacketComponent::INVALID_INDEX || packet.emitterIndex == emitters.size()) &&
+				isMaterialUnchanged(Entity(entityHandle, &scene), packet, resources);
+
+			if (isClean) {
+				if (packet.objectIndex == RenderPacketComponent::INVALID_INDEX) continue;
+
+				objects.keep(packet.objectIndex);
+			} else {
+				buildPacket(Entity(entityHandle, &scene), transformComponent, meshComponent, packet,
+					resources, resolver, objects, volumeIndex);
+
+				if (packet.objectIndex == RenderPacketComponent::INVALID_INDEX) continue;
+			}
+
+			if (packet.emitterIndex != RenderPacketComponent::INVALID_INDEX) {
+				EmitterData emitterData{};
+				emitterData.instanceIndex = packet.objectIndex;
+				emitterData.numberOfFaces = packet.emitterFaceCount;
+				emitters.push_back(emitterData);
+			}
+
+			// Define the instance
+			VkAccelerationStructureInstanceKHR instance{};
+			instance.transform = toVkTransformMatrix(packet.objectToWorld);
+			instance.mask = 0xFF;
+
+			// we can get it in the shader via InstanceCustomIndexKHR
+			instance.instanceCustomIndex = packet.objectIndex; // slot of the entity in the scene buffer
+
+			instance.instanceShaderBindingTableRecordOffset = 0; // this is 0 for every instance for now
+			                                                     // it is the offset in the SBT hit region
+			                                                     // (which hit shader the instance should use)
+			instance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR; // Example flags
+			instance.accelerationStructureReference = packet.blasAddress;
+
+			instances.push_back(instance);
+		}
+
+		objects.endUpdate();
+	}
+
+	void RayTracingSceneData::invalidate(Scene& scene) {
+		for (auto [entityHandle, packet] : scene.getEntitiesWith<RenderPacketComponent>().each()) {
+			packet.isDirty = true;
+		}
+	}
+
+	bool RayTracingSceneData::isMaterialUnchanged(Entity entity, const RenderPacketComponent& packet, const ResourcePools& resources) {
+		if (!entity.has<MaterialComponent>()) {
+			return packet.isBuiltFrom(nullptr, nullptr);
+		}
+
+		const MaterialComponent& materialComponent = entity.get<MaterialComponent>();
+		return packet.isBuiltFrom(&materialComponent, resources.resolve(materialComponent.material));
+	}
+
+	void RayTracingSceneData::buildPacket(Entity entity, const TransformComponent& transformComponent,
+		const MeshComponent& meshComponent, RenderPacketComponent& packet, const ResourcePools& resources,
+		const Resolver& resolver, SceneObjectTable& objects, uint32_t& volumeIndex) {
+
+		constexpr uint32_t invalidIndex = RenderPacketComponent::INVALID_INDEX;
+
+		// TODO: may be passed as mat4x3 in the shader for memory bandwidth optimization
+		const glm::mat4 transform = transformComponent.mat4();
+
+		packet.translation = transformComponent.translation;
+		packet.scale = transformComponent.scale;
+		packet.rotation = transformComponent.rotation;
+		packet.objectToWorld = transform;
+		packet.meshHandle = meshComponent.getRenderMesh();
+		packet.mesh = resources.resolve(packet.meshHandle);
+		packet.blasAddress = 0;
+		packet.objectIndex = invalidIndex;
+		packet.emitterIndex = invalidIndex;
+		packet.emitterFaceCount = 0;
+		packet.materialFeatures = 0;
+		packet.materialHandle = {};
+		packet.material = nullptr;
+		packet.materialVersion = 0;
+		packet.tilingFactor = 1.0f;
+		packet.tint = glm::vec3(1.0f);
+		packet.hasMaterial = false;
+		packet.hasVolume = false;
+		packet.isDirty = false;
+
+		const Mesh* mesh = packet.mesh;
+		if (mesh == nullptr || !entity.hasAny<MaterialComponent, VolumeComponent>()) return;
+
+		const MeshAddresses addresses = resolver.getMeshAddresses(packet.meshHandle, *mesh);
+		packet.blasAddress = addresses.blas;
+
+		SceneObjectData objectData{};
+		objectData.objectToWorldMatrix = transform;
+		objectData.boundingSphere = transformBoundingSphere(mesh->getBoundingSphere(), transform);
+		objectData.textureTintColor = glm::vec4(1.0f);
+		objectData.vertexBufferAddress = addresses.vertexBuffer;
+		objectData.indexBufferAddress = addresses.indexBuffer;
+		objectData.vertexCount = mesh->getVertexCount();
+		objectData.indexCount = mesh->getIndexCount();
+		objectData.materialIndex = invalidIndex;
+		objectData.emitterIndex = invalidIndex;
+		objectData.volumeIndex = invalidIndex;
+		objectData.textureTilingFactor = 1.0f;
+
+		// the inverse is only recomputed for the entities that moved
+		const SceneObjectData* previousData = objects.find(entity);
+		objectData.worldToObjectMatrix = previousData != nullptr && previousData->objectToWorldMatrix == transform
+			? previousData->worldToObjectMatrix
+			: glm::inverse(transform);
+
+		// the emitters and volumes refer to the slot of the entity, the table keeps it
+		// stable across frames and only hands out a new one the first time
+		const uint32_t instanceIndex = objects.acquire(entity);
+		packet.objectIndex = instanceIndex;
+
+		// Add material properties to the instance data
+		if (entity.has<MaterialComponent>()) {
+			auto& materialComponent = entity.get<MaterialComponent>();
+			const Material* material = resources.resolve(materialComponent.material);
+
+			packet.hasMaterial = true;
+			packet.materialHandle = materialComponent.material;
+			packet.material = material;
+			packet.materialVersion = material != nullptr ? material->getVersion() : 0;
+			packet.tilingFactor = materialComponent.tilingFactor;
+			packet.tint = materialComponent.tint;
+
+			objectData.materialIndex = material != nullptr ? resolver.getMaterialIndex(material->id) : invalidIndex;
+			objectData.textureTintColor = glm::vec4(materialComponent.tint, 1.0f);
+			objectData.textureTilingFactor = materialComponent.tilingFactor;
+
+			if (material != nullptr) {
+				packet.materialFeatures = getMaterialFeatureKey(*material);
+			}
+
+			// register entities with emissive materials, the caller adds the emitter
+			if (material != nullptr && material->isEmissive()) {
+				packet.emitterIndex = static_cast<uint32_t>(emitters.size());
+				packet.emitterFaceCount = mesh->getIndexCount() / 3;
+				objectData.emitterIndex = packet.emitterIndex;
+			}
+		}
+
+		// Add volume properties to the instance data
+		if (entity.has<VolumeComponent>()) {
+			const VolumeComponent::Volume& volume = entity.get<VolumeComponent>().volume;
+
+			packet.hasVolume = true;
+			objectData.volumeIndex = volumeIndex++;
+
+			uint32_t densityTextureId = invalidIndex;
+			uint32_t detailTextureId = invalidIndex;
+
+			if (const Image* densityTexture = resources.resolve(volume.densityTexture)) {
+				densityTextureId = resolver.getTextureIndex(densityTexture->id);
+			}
+
+			if (const Image* detailTexture = resources.resolve(volume.detailTexture)) {
+				detailTextureId = resolver.getTextureIndex(detailTexture->id);
+			}
+
+			volumes.push_back(
+				VolumeData{
+					.absorption = volume.absorption,
+					.scattering = volume.scattering,
+					.phaseFunctionG = volume.phaseFunctionG,
+					.densityTextureId = densityTextureId,
+					.detailTextureId = detailTextureId,
+					.instanceIndex = instanceIndex,
+					.densityGrid = glm::uvec4(0, 0, 0, invalidIndex),
+					.densityMajorant = 0.0f
+				}
+			);
+
+			// the brick atlas keeps the grids it uploads alive
+			const Shared<DensityGrid>& densityGrid = resources.get<DensityGrid>().getShared(volume.densityGrid);
+			if (densityGrid != nullptr) {
+				volumeGrids.emplace_back(objectData.volumeIndex, densityGrid);
+			}
+		}
+
+		objects.set(instanceIndex, objectData);
+	}
+
+	glm::vec4 RayTracingSceneData::transformBoundingSphere(const glm::vec4& sphere, const glm::mat4& transform) {
+		const glm::vec3 center = transform * glm::vec4(glm::vec3(sphere), 1.0f);
+
+		// a non uniform scale stretches the sphere, the largest axis bounds it
+		const float scale = std::max({
+			glm::length(glm::vec3(transform[0])),
+			glm::length(glm::vec3(transform[1])),
+			glm::length(glm::vec3(transform[2]))
+		});
+
+		return glm::vec4(center, sphere.w * scale);
+	}
+
+	VkTransformMatrixKHR RayTracingSceneData::toVkTransformMatrix(const glm::mat4& matrix) {
+		VkTransformMatrixKHR vkMatrix;
+
+		// GLM matrices are column-major, VkTransformMatrixKHR is row-major.
+		// We need to transpose the 3x4 part and assign.
+		// The last row of a 4x4 homogeneous matrix (0,0,0,1) is omitted.
+
+		// vkMatrix.matrix[row][column]
+		// glmMatrix[column][row] (due to column-major order)
+
+		for (int row = 0; row < 3; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				vkMatrix.matrix[row][col] = matrix[col][row];
+			}
+		}
+
+		return vkMatrix;
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "resources/resource.hpp"
+#include "resources/resource_pool.hpp"
+#include "resources/types/mesh.hpp"
+#include "resources/types/density_grid.hpp"
+#include "scene/scene.hpp"
+#include "graphics/scene_object_table.hpp"
+
+namespace PXTEngine {
+
+	// forward declarations
+	class Entity;
+	struct TransformComponent;
+	struct MeshComponent;
+	struct RenderPacketComponent;
+
+	struct alignas(uint32_t) EmitterData {
+		uint32_t instanceIndex;
+		uint32_t numberOfFaces;
+	};
+
+	struct alignas(16) VolumeData {
+		glm::vec4 absorption;
+		glm::vec4 scattering;
+		float phaseFunctionG;
+		uint32_t densityTextureId;
+		uint32_t detailTextureId;
+		uint32_t instanceIndex;
+		alignas(16) glm::uvec4 densityGrid;  // xyz: grid resolution, w: first entry in the brick table (UINT32_MAX without a grid)
+		float densityMajorant;
+	};
+
+	/**
+	 * @struct RayTracingSceneData
+	 *
+	 * @brief The per-instance data of the ray traced scene: the TLAS instances and the
+	 * emitter and volume lists read by the shaders. The per-entity data goes to a
+	 * SceneObjectTable, shared with the raster pipelines, and the instances refer to it
+	 * by slot (instanceCustomIndex, EmitterData::instanceIndex, VolumeData::instanceIndex).
+	 *
+	 * Building it only walks the scene on the CPU, the handles of the components are resolved
+	 * in the resource pools and the GPU side of the resources (buffer addresses, registry
+	 * indices) is looked up through a Resolver. This keeps it out of
+	 * GpuScene, which uploads the result, and makes it measurable without a device
+	 * (see benchmarks/).
+	 */
+	struct RayTracingSceneData {
+		struct MeshAddresses {
+			VkDeviceAddress vertexBuffer = 0;
+			VkDeviceAddress indexBuffer = 0;
+			VkDeviceAddress blas = 0;
+		};
+
+		struct Resolver {
+			std::function<MeshAddresses(ResourceHandle<Mesh>, const Mesh&)> getMeshAddresses;
+			std::function<uint32_t(const ResourceId&)> getMaterialIndex;
+			std::function<uint32_t(const ResourceId&)> getTextureIndex;
+		};
+
+		std::vector<VkAccelerationStructureInstanceKHR> instances;
+		std::vector<EmitterData> emitters;
+		std::vector<VolumeData> volumes;
+
+		// volume index -> grid, the grid offsets in the brick atlas are filled by the caller
+		std::vector<std::pair<uint32_t, Shared<DensityGrid>>> volumeGrids;
+
+		/**
+		 * @brief Clears the lists (keeping their capacity) and rebuilds them from the
+		 * entities with a mesh and a material or a volume, setting their data in the
+		 * object table. The table only queues the entities that changed. The entities whose
+		 * mesh handle is stale are skipped.
+		 *
+		 * Only the entities whose RenderPacketComponent is out of date are resolved and
+		 * written to the table, the others only add their cached instance (and emitter).
+		 * The packets are stored in the scene, a scene must be built into a single table.
+		 */
+		void build(Scene& scene, const ResourcePools& resources, const Resolver& resolver, SceneObjectTable& objects);
+
+		/**
+		 * @brief Marks every render packet of the scene out of date, e.g. when the resolver
+		 * starts returning the BLASes.
+		 */
+		static void invalidate(Scene& scene);
+
+		/**
+		 * @brief World space bounding sphere of a mesh placed with the given transform.
+		 */
+		static glm::vec4 transformBoundingSphere(const glm::vec4& sphere, const glm::mat4& transform);
+
+		static VkTransformMatrixKHR toVkTransformMatrix(const glm::mat4& matrix);
+
+	private:
+		/**
+		 * @brief Whether the material component of an entity (and its material) is still
+		 * the one its packet was built from, they are edited in place without a patch.
+		 */
+		static bool isMaterialUnchanged(Entity entity, const RenderPacketComponent& packet, const ResourcePools& resources);
+
+		/**
+		 * @brief Rebuilds the packet of an entity and sets its scene object, or releases
+		 * it (INVALID_INDEX) if the entity has no material nor volume or its mesh is stale.
+		 */
+		void buildPacket(Entity entity, const TransformComponent& transformComponent,
+			const MeshComponent& meshComponent, RenderPacketComponent& packet, const ResourcePools& resources,
+			const Resolver& resolver, SceneObjectTable& objects, uint32_t& volumeIndex);
+	};
+}
@@ -0,0 +1,254 @@
+#include "graphics/readback_service.hpp"
+
+namespace PXTEngine {
+
+	namespace {
+		// satisfies the offset alignment of buffer copies, image copies (texel size) and 64 bit values
+		constexpr VkDeviceSize READBACK_ALIGNMENT = 16;
+
+		VkDeviceSize alignUp(const VkDeviceSize value, const VkDeviceSize alignment) {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
+	ReadbackService::ReadbackService(Context& context, const VkDeviceSize pageSize)
+		: m_context(context), m_pageSize(pageSize) {
+
+		// the CPU reads the staging memory, cached memory is much faster to read than write-combined
+		VkPhysicalDeviceMemoryProperties memoryProperties;
+		vkGetPhysicalDeviceMemoryProperties(m_context.getPhysicalDevice(), &memoryProperties);
+
+		m_memoryFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+			const VkMemoryPropertyFlags flags = memoryProperties.memoryTypes[i].propertyFlags;
+			if ((flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && (flags & VK_MEMORY_PROPERTY_HOST_CACHED_BIT)) {
+				m_memoryFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+				break;
+			}
+		}
+	}
+
+	ReadbackService::~ReadbackService() {
+		// resolve whatever is still in flight, nobody waiting on a future is left hanging
+		m_context.getFrameTimeline().waitIdle();
+
+		for (FrameReadbacks& frame : m_frames) {
+			resolve(frame);
+		}
+	}
+
+	void ReadbackService::beginFrame(const uint32_t frameIndex) {
+		PXT_ASSERT(frameIndex < m_frames.size(), "Frame index out of range");
+
+		m_frameIndex = frameIndex;
+
+		FrameReadbacks& frame = m_frames[frameIndex];
+		resolve(frame);
+
+		// the copies requested from now on are part of the frame being recorded
+		frame.timelineValue = m_context.getFrameTimeline().getNextValue();
+	}
+
+	void ReadbackService::resolve(FrameReadbacks& frame) {
+		if (frame.pending.empty()) return;
+
+		// a no-op when called from beginFrame, the frame index is reused only once its frame is complete
+		m_context.getFrameTimeline().wait(frame.timelineValue);
+
+		for (PendingRequest& request : frame.pending) {
+			Page& page = frame.pages[request.pageIndex];
+
+			if (!(m_memoryFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+				page.buffer->invalidate();
+			}
+
+			request.resolve(static_cast<const uint8_t*>(page.buffer->getMappedMemory()) + request.offset);
+		}
+
+		frame.pending.clear();
+
+		// the pages are kept mapped and reused, a capture in progress needs the same space every frame
+		for (Page& page : frame.pages) {
+			page.used = 0;
+		}
+	}
+
+	std::pair<size_t, VkDeviceSize> ReadbackService::allocate(const VkDeviceSize size) {
+		FrameReadbacks& frame = m_frames[m_frameIndex];
+
+		for (size_t i = 0; i < frame.pages.size(); i++) {
+			Page& page = frame.pages[i];
+
+			const VkDeviceSize offset = alignUp(page.used, READBACK_ALIGNMENT);
+			if (offset + size <= page.buffer->getBufferSize()) {
+				page.used = offset + size;
+				return { i, offset };
+			}
+		}
+
+		Page page{};
+		page.buffer = createUnique<VulkanBuffer>(
+			m_context,
+			std::max(size, m_pageSize),
+			1,
+			VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			m_memoryFlags
+		);
+		page.buffer->map();
+		page.used = size;
+
+		frame.pages.push_back(std::move(page));
+		return { frame.pages.size() - 1, 0 };
+	}
+
+	std::future<std::vector<uint8_t>> ReadbackService::readBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer,
+		const VkDeviceSize offset, const VkDeviceSize size,
+		const VkPipelineStageFlags srcStage, const VkAccessFlags srcAccess) {
+
+		auto [pageIndex, pageOffset] = allocate(size);
+		VkBuffer pageBuffer = m_frames[m_frameIndex].pages[pageIndex].buffer->getBuffer();
+
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = buffer;
+		barrier.offset = offset;
+		barrier.size = size;
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			srcStage,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr
+		);
+
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = offset;
+		copyRegion.dstOffset = pageOffset;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(commandBuffer, buffer, pageBuffer, 1, &copyRegion);
+
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		barrier.buffer = pageBuffer;
+		barrier.offset = pageOffset;
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_HOST_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr
+		);
+
+		auto promise = createShared<std::promise<std::vector<uint8_t>>>();
+		std::future<std::vector<uint8_t>> future = promise->get_future();
+
+		m_frames[m_frameIndex].pending.push_back({ pageIndex, pageOffset, size,
+			[promise, size](const uint8_t* data) {
+				promise->set_value(std::vector<uint8_t>(data, data + size));
+			}
+		});
+
+		return future;
+	}
+
+	std::future<ReadbackService::ImageData> ReadbackService::readImage(VkCommandBuffer commandBuffer, VulkanImage& image,
+		const VkPipelineStageFlags srcStage) {
+
+		const VkFormat format = image.getImageFormat();
+		const uint32_t texelSize = getTexelSize(format);
+		if (texelSize == 0) {
+			throw std::runtime_error("Unsupported image format for readback: " + std::to_string(format));
+		}
+
+		const VkExtent2D extent = image.getExtent();
+		const VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * texelSize;
+
+		auto [pageIndex, pageOffset] = allocate(size);
+		VkBuffer pageBuffer = m_frames[m_frameIndex].pages[pageIndex].buffer->getBuffer();
+
+		const VkImageLayout previousLayout = image.getCurrentLayout();
+		image.transitionImageLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, srcStage, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+		VkBufferImageCopy copyRegion{};
+		copyRegion.bufferOffset = pageOffset;
+		copyRegion.bufferRowLength = 0; // tightly packed
+		copyRegion.bufferImageHeight = 0;
+		copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		copyRegion.imageSubresource.mipLevel = 0;
+		copyRegion.imageSubresource.baseArrayLayer = 0;
+		copyRegion.imageSubresource.layerCount = 1;
+		copyRegion.imageOffset = { 0, 0, 0 };
+		copyRegion.imageExtent = { extent.width, extent.height, 1 };
+
+		vkCmdCopyImageToBuffer(commandBuffer, image.getVkImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, pageBuffer, 1, &copyRegion);
+
+		image.transitionImageLayout(commandBuffer, previousLayout, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = pageBuffer;
+		barrier.offset = pageOffset;
+		barrier.size = size;
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_HOST_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr
+		);
+
+		auto promise = createShared<std::promise<ImageData>>();
+		std::future<ImageData> future = promise->get_future();
+
+		m_frames[m_frameIndex].pending.push_back({ pageIndex, pageOffset, size,
+			[promise, extent, format, texelSize, size](const uint8_t* data) {
+				ImageData imageData{};
+				imageData.width = extent.width;
+				imageData.height = extent.height;
+				imageData.format = format;
+				imageData.texelSize = texelSize;
+				imageData.pixels.assign(data, data + size);
+
+				promise->set_value(std::move(imageData));
+			}
+		});
+
+		return future;
+	}
+
+	uint32_t ReadbackService::getTexelSize(const VkFormat format) {
+		switch (format) {
+			case VK_FORMAT_R8_UNORM:
+				return 1;
+			case VK_FORMAT_R8G8B8A8_UNORM:
+			case VK_FORMAT_R8G8B8A8_SRGB:
+			case VK_FORMAT_B8G8R8A8_UNORM:
+			case VK_FORMAT_B8G8R8A8_SRGB:
+			case VK_FORMAT_R32_SFLOAT:
+				return 4;
+			case VK_FORMAT_R16G16B16A16_SFLOAT:
+				return 8;
+			case VK_FORMAT_R32G32B32A32_SFLOAT:
+				return 16;
+			default:
+				return 0;
+		}
+	}
+}
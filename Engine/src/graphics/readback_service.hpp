@@ -0,0 +1,119 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/context/context.hpp"
+#include "graphics/swap_chain.hpp"
+#include "graphics/resources/vk_buffer.hpp"
+#include "graphics/resources/vk_image.hpp"
+
+#include <future>
+
+namespace PXTEngine {
+
+	/**
+	 * @brief Copies GPU buffers and images back to the CPU without stalling.
+	 *
+	 * A request records a copy into the command buffer of the current frame, towards a
+	 * host-visible staging ring owned by that frame in flight, and returns a future.
+	 * The future is resolved the next time the same frame index begins, once the frame timeline
+	 * has reached the value of the frame that recorded the copy (already the case after
+	 * Renderer::beginFrame), so the data arrives MAX_FRAMES_IN_FLIGHT frames later and the CPU
+	 * never waits for the GPU.
+	 *
+	 * The futures must not be waited on from the render thread before they are resolved,
+	 * poll them with isReady() instead.
+	 */
+	class ReadbackService {
+	public:
+		static constexpr VkDeviceSize DEFAULT_PAGE_SIZE = 4 * 1024 * 1024;
+
+		struct ImageData {
+			uint32_t width = 0;
+			uint32_t height = 0;
+			VkFormat format = VK_FORMAT_UNDEFINED;
+			uint32_t texelSize = 0; // bytes per texel, rows are tightly packed
+			std::vector<uint8_t> pixels;
+		};
+
+		ReadbackService(Context& context, VkDeviceSize pageSize = DEFAULT_PAGE_SIZE);
+		~ReadbackService();
+
+		ReadbackService(const ReadbackService&) = delete;
+		ReadbackService& operator=(const ReadbackService&) = delete;
+
+		/**
+		 * @brief Resolves the requests recorded the last time frameIndex was used and makes
+		 * frameIndex the active frame.
+		 *
+		 * Must be called once per frame, after Renderer::beginFrame and before any request for
+		 * that frame.
+		 */
+		void beginFrame(uint32_t frameIndex);
+
+		/**
+		 * @brief Records a copy of a buffer range. The buffer needs VK_BUFFER_USAGE_TRANSFER_SRC_BIT.
+		 *
+		 * @param srcStage Stage of the last write of the range.
+		 * @param srcAccess Access of the last write of the range.
+		 */
+		std::future<std::vector<uint8_t>> readBuffer(VkCommandBuffer commandBuffer, VkBuffer buffer,
+			VkDeviceSize offset, VkDeviceSize size,
+			VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+			VkAccessFlags srcAccess = VK_ACCESS_MEMORY_WRITE_BIT);
+
+		/**
+		 * @brief Records a copy of the first mip and layer of a color image. The image needs
+		 * VK_IMAGE_USAGE_TRANSFER_SRC_BIT, it is returned to its current layout afterwards.
+		 *
+		 * @param srcStage Stage of the last write of the image.
+		 * @throws std::runtime_error If the image format is not supported.
+		 */
+		std::future<ImageData> readImage(VkCommandBuffer commandBuffer, VulkanImage& image,
+			VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+
+		/**
+		 * @brief Returns the size of a texel of the formats that can be read back, 0 otherwise.
+		 */
+		static uint32_t getTexelSize(VkFormat format);
+
+		template<typename T>
+		static bool isReady(const std::future<T>& future) {
+			return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+
+	private:
+		struct Page {
+			Unique<VulkanBuffer> buffer;
+			VkDeviceSize used = 0;
+		};
+
+		struct PendingRequest {
+			size_t pageIndex;
+			VkDeviceSize offset;
+			VkDeviceSize size;
+			std::function<void(const uint8_t* data)> resolve;
+		};
+
+		struct FrameReadbacks {
+			std::vector<Page> pages;
+			std::vector<PendingRequest> pending;
+			uint64_t timelineValue = 0; // the frame timeline value signaled once the copies are done
+		};
+
+		/**
+		 * @brief Reserves size bytes in the ring of the active frame, adding a page if needed.
+		 *
+		 * @return The page index and the offset in it.
+		 */
+		std::pair<size_t, VkDeviceSize> allocate(VkDeviceSize size);
+
+		void resolve(FrameReadbacks& frame);
+
+		Context& m_context;
+		VkDeviceSize m_pageSize;
+		VkMemoryPropertyFlags m_memoryFlags;
+
+		std::vector<FrameReadbacks> m_frames{ SwapChain::MAX_FRAMES_IN_FLIGHT };
+		uint32_t m_frameIndex = 0;
+	};
+}
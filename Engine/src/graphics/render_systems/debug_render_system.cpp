@@ -19,16 +19,15 @@ namespace PXTEngine {
         float blinnPhongSpecularShininess = 1.0f;
     };
 
-    DebugRenderSystem::DebugRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, TextureRegistry& textureRegistry, VkRenderPass renderPass, DescriptorSetLayout& globalSetLayout)
-		: m_context(context), m_descriptorAllocator(descriptorAllocator), m_textureRegistry(textureRegistry),
+    DebugRenderSystem::DebugRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, ResourceManager& resourceManager, TextureRegistry& textureRegistry, VkRenderPass renderPass, DescriptorSetLayout& globalSetLayout)
+		: m_context(context), m_descriptorAllocator(descriptorAllocator), m_resourceManager(resourceManager), m_textureRegistry(textureRegistry),
 		m_renderPassHandle(renderPass) {
         createPipelineLayout(globalSetLayout);
-        createPipelines();
+        m_pipelineSolid = createPipeline(VK_POLYGON_MODE_FILL);
+        m_pipelineWireframe = createPipeline(VK_POLYGON_MODE_LINE);
     }
 
-    DebugRenderSystem::~DebugRenderSystem() {
-        vkDestroyPipelineLayout(m_context.getDevice(), m_pipelineLayout, nullptr);
-    }
+    DebugRenderSystem::~DebugRenderSystem() = default;
 
     void DebugRenderSystem::createPipelineLayout(DescriptorSetLayout& globalSetLayout) {
         VkPushConstantRange pushConstantRange{};
@@ -48,19 +47,18 @@ namespace PXTEngine {
         pipelineLayoutInfo.pushConstantRangeCount = 1;
         pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create pipeline layout!");
-        }
+        m_pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
     }
 
-    void DebugRenderSystem::createPipelines(bool useCompiledSpirvFiles) {
+    Unique<Pipeline> DebugRenderSystem::createPipeline(VkPolygonMode polygonMode, bool useCompiledSpirvFiles) const {
         PXT_ASSERT(m_pipelineLayout != nullptr, "Cannot create pipeline before pipelineLayout");
 
-        // Default Solid Pipeline
+        // solid or wireframe
         RasterizationPipelineConfigInfo pipelineConfig{};
         Pipeline::defaultPipelineConfigInfo(pipelineConfig);
-        pipelineConfig.renderPass = m_renderPassHandle;;
+        pipelineConfig.renderPass = m_renderPassHandle;
         pipelineConfig.pipelineLayout = m_pipelineLayout;
+        pipelineConfig.rasterizationInfo.polygonMode = polygonMode;
 
         const std::string baseShaderPath = useCompiledSpirvFiles ? SPV_SHADERS_PATH : SHADERS_PATH;
         const std::string filenameSuffix = useCompiledSpirvFiles ? ".spv" : "";
@@ -70,20 +68,11 @@ namespace PXTEngine {
             shaderFilePaths.push_back(baseShaderPath + filePath + filenameSuffix);
         };
 
-        m_pipelineSolid = createUnique<Pipeline>(
+        return createUnique<Pipeline>(
             m_context,
             shaderFilePaths,
             pipelineConfig
         );
-
-		// Wireframe Pipeline
-		pipelineConfig.rasterizationInfo.polygonMode = VK_POLYGON_MODE_LINE;
-
-		m_pipelineWireframe = createUnique<Pipeline>(
-			m_context,
-			shaderFilePaths,
-			pipelineConfig
-		);
     }
 
     void DebugRenderSystem::render(FrameInfo& frameInfo) {
@@ -112,8 +101,9 @@ namespace PXTEngine {
 
             const auto&[transform, meshComponent, materialComponent] = view.get<TransformComponent, MeshComponent, MaterialComponent>(entity);
 
-			auto material = materialComponent.material;
-            auto vulkanMesh = std::static_pointer_cast<VulkanMesh>(meshComponent.mesh);
+			const Material* material = m_resourceManager.resolve(materialComponent.material);
+            auto* vulkanMesh = static_cast<VulkanMesh*>(m_resourceManager.resolve(meshComponent.getRenderMesh()));
+            if (material == nullptr || vulkanMesh == nullptr) continue;
 
             DebugPushConstantData push{};
             push.modelMatrix = transform.mat4();
@@ -156,8 +146,26 @@ namespace PXTEngine {
 		ImGui::EndDisabled();
     }
 
-    void DebugRenderSystem::reloadShaders() {
-        PXT_INFO("Reloading shaders...");
-        createPipelines(false);
+    void DebugRenderSystem::registerShaders(ShaderReloader& shaderReloader) {
+        std::vector<std::filesystem::path> sourceFiles;
+        for (const auto& filePath : m_shaderFilePaths) {
+            sourceFiles.push_back(SHADERS_PATH + filePath);
+        }
+
+        // both pipelines come from the same shaders, they are swapped together
+        shaderReloader.add("Debug", sourceFiles, [this] {
+            return ShaderReloader::Reload{
+                [this] {
+                    std::vector<Unique<Pipeline>> pipelines;
+                    pipelines.push_back(createPipeline(VK_POLYGON_MODE_FILL, false));
+                    pipelines.push_back(createPipeline(VK_POLYGON_MODE_LINE, false));
+                    return pipelines;
+                },
+                [this](std::vector<Unique<Pipeline>>& pipelines) {
+                    std::swap(m_pipelineSolid, pipelines[0]);
+                    std::swap(m_pipelineWireframe, pipelines[1]);
+                }
+            };
+        });
     }
 }
\ No newline at end of file
@@ -2,11 +2,13 @@
 
 #include "core/pch.hpp"
 #include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
 #include "graphics/swap_chain.hpp"
 #include "graphics/context/context.hpp"
 #include "graphics/frame_info.hpp"
 #include "graphics/descriptors/descriptors.hpp"
 #include "graphics/resources/texture_registry.hpp"
+#include "resources/resource_manager.hpp"
 #include "scene/scene.hpp"
 
 namespace PXTEngine {
@@ -17,7 +19,7 @@ namespace PXTEngine {
 
     class DebugRenderSystem {
     public:
-        DebugRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, TextureRegistry& textureRegistry, VkRenderPass renderPass, DescriptorSetLayout& globalSetLayout);
+        DebugRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, ResourceManager& resourceManager, TextureRegistry& textureRegistry, VkRenderPass renderPass, DescriptorSetLayout& globalSetLayout);
         ~DebugRenderSystem();
 
         DebugRenderSystem(const DebugRenderSystem&) = delete;
@@ -25,13 +27,14 @@ namespace PXTEngine {
 
         void render(FrameInfo& frameInfo);
         void updateUi();
-		void reloadShaders();
+		void registerShaders(ShaderReloader& shaderReloader);
 
     private:
         void createPipelineLayout(DescriptorSetLayout& globalSetLayout);
-        void createPipelines(bool useCompiledSpirvFiles = true);
+        Unique<Pipeline> createPipeline(VkPolygonMode polygonMode, bool useCompiledSpirvFiles = true) const;
         
         Context& m_context;
+		ResourceManager& m_resourceManager;
 		TextureRegistry& m_textureRegistry;
 
         VkRenderPass m_renderPassHandle;
@@ -15,8 +15,9 @@ namespace PXTEngine {
         VkBool32 isSpatialEnabled;
     };
 
-    DenoiserRenderSystem::DenoiserRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, VkExtent2D swapChainExtent)
-        : m_context(context), m_descriptorAllocator(descriptorAllocator), m_extent(swapChainExtent) {
+    DenoiserRenderSystem::DenoiserRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, VkExtent2D swapChainExtent, AsyncComputeQueue* asyncComputeQueue)
+        : m_context(context), m_descriptorAllocator(descriptorAllocator), m_asyncComputeQueue(asyncComputeQueue),
+          m_extent(swapChainExtent), m_denoiseTimer(context) {
 
         createImages(swapChainExtent);
 
@@ -24,20 +25,21 @@ namespace PXTEngine {
         createTemporalFilterDescriptorSet();
         createSpatialFilterDescriptorSet(); // For low-pass or bilateral filter
 
+        // the async path always denoises its own copy of the frame
+        if (isAsync()) {
+            writeDescriptorSets(getNoisyImageInfo());
+        }
+
         createAccumulationPipelineLayout();
         createTemporalFilterPipelineLayout();
         createSpatialFilterPipelineLayout();
 
-        createAccumulationPipeline();
-        createTemporalFilterPipeline();
-        createSpatialFilterPipeline();
+        m_accumulationPipeline = createAccumulationPipeline();
+        m_temporalFilterPipeline = createTemporalFilterPipeline();
+        m_spatialFilterPipeline = createSpatialFilterPipeline();
     }
 
-    DenoiserRenderSystem::~DenoiserRenderSystem() {
-        vkDestroyPipelineLayout(m_context.getDevice(), m_accumulationPipelineLayout, nullptr);
-        vkDestroyPipelineLayout(m_context.getDevice(), m_temporalFilterPipelineLayout, nullptr);
-        vkDestroyPipelineLayout(m_context.getDevice(), m_spatialFilterPipelineLayout, nullptr);
-    }
+    DenoiserRenderSystem::~DenoiserRenderSystem() = default;
 
     void DenoiserRenderSystem::createImages(VkExtent2D extent) {
 		// imagecreateinfo for accumulation, history, and temporary output images
@@ -107,6 +109,14 @@ namespace PXTEngine {
             createImageView(imageViewCreateInfo)
             .setImageSampler(m_imageSamplerNearest);
 
+        // On the async path the images below are also copied from and to by the graphics queue
+        const std::vector<uint32_t> queueFamilies = isAsync() ? m_context.getAsyncComputeQueueFamilies() : std::vector<uint32_t>{};
+        if (!queueFamilies.empty()) {
+            imageCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            imageCreateInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+            imageCreateInfo.pQueueFamilyIndices = queueFamilies.data();
+        }
+
         // Create a history buffer for temporal filtering.
         // This buffer stores the final denoised output of the PREVIOUS frame,
         // and will store the final denoised output of the CURRENT frame.
@@ -122,6 +132,22 @@ namespace PXTEngine {
         m_temporalHistoryImage->
              createImageView(imageViewCreateInfo)
             .setImageSampler(m_imageSamplerNearest);
+
+        if (!isAsync()) return;
+
+        // The copy of the traced frame the async denoise reads, sampled like the scene image
+        imageCreateInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+        m_noisyImage = createUnique<VulkanImage>(
+            m_context,
+            imageCreateInfo,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+        imageViewCreateInfo.image = m_noisyImage->getVkImage();
+
+        m_noisyImage->
+             createImageView(imageViewCreateInfo)
+            .setImageSampler(m_imageSamplerNearest);
     }
 
     void DenoiserRenderSystem::createAccumulationDescriptorSet() {
@@ -184,9 +210,7 @@ namespace PXTEngine {
         pipelineLayoutInfo.pushConstantRangeCount = 1;
         pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_accumulationPipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create accumulation pipeline layout!");
-        }
+        m_accumulationPipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
     }
 
     void DenoiserRenderSystem::createTemporalFilterPipelineLayout() {
@@ -206,9 +230,7 @@ namespace PXTEngine {
         pipelineLayoutInfo.pushConstantRangeCount = 1;
         pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_temporalFilterPipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create temporal filter pipeline layout!");
-        }
+        m_temporalFilterPipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
     }
 
     void DenoiserRenderSystem::createSpatialFilterPipelineLayout() {
@@ -228,12 +250,10 @@ namespace PXTEngine {
         pipelineLayoutInfo.pushConstantRangeCount = 1;
         pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_spatialFilterPipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create spatial filter pipeline layout!");
-        }
+        m_spatialFilterPipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
     }
 
-    void DenoiserRenderSystem::createAccumulationPipeline(bool useCompiledSpirvFiles) {
+    Unique<Pipeline> DenoiserRenderSystem::createAccumulationPipeline(bool useCompiledSpirvFiles) const {
         PXT_ASSERT(m_accumulationPipelineLayout != nullptr, "Cannot create accumulation pipeline before pipelineLayout");
 
         ComputePipelineConfigInfo pipelineConfig{};
@@ -244,14 +264,14 @@ namespace PXTEngine {
 
         std::string shaderFilePath = baseShaderPath + m_accumulationShaderPath + filenameSuffix;
 
-        m_accumulationPipeline = createUnique<Pipeline>(
+        return createUnique<Pipeline>(
             m_context,
             shaderFilePath,
             pipelineConfig
         );
     }
 
-    void DenoiserRenderSystem::createTemporalFilterPipeline(bool useCompiledSpirvFiles) {
+    Unique<Pipeline> DenoiserRenderSystem::createTemporalFilterPipeline(bool useCompiledSpirvFiles) const {
         PXT_ASSERT(m_temporalFilterPipelineLayout != nullptr, "Cannot create temporal filter pipeline before pipelineLayout");
 
         ComputePipelineConfigInfo pipelineConfig{};
@@ -262,14 +282,14 @@ namespace PXTEngine {
 
         std::string shaderFilePath = baseShaderPath + m_temporalShaderPath + filenameSuffix;
 
-        m_temporalFilterPipeline = createUnique<Pipeline>(
+        return createUnique<Pipeline>(
             m_context,
             shaderFilePath,
             pipelineConfig
         );
     }
 
-    void DenoiserRenderSystem::createSpatialFilterPipeline(bool useCompiledSpirvFiles) {
+    Unique<Pipeline> DenoiserRenderSystem::createSpatialFilterPipeline(bool useCompiledSpirvFiles) const {
         PXT_ASSERT(m_spatialFilterPipelineLayout != nullptr, "Cannot create spatial filter pipeline before pipelineLayout");
 
         ComputePipelineConfigInfo pipelineConfig{};
@@ -280,7 +300,7 @@ namespace PXTEngine {
 
         std::string shaderFilePath = baseShaderPath + m_spatialShaderPath + filenameSuffix;
 
-        m_spatialFilterPipeline = createUnique<Pipeline>(
+        return createUnique<Pipeline>(
             m_context,
             shaderFilePath,
             pipelineConfig
@@ -288,15 +308,140 @@ namespace PXTEngine {
     }
 
     void DenoiserRenderSystem::denoise(FrameInfo& frameInfo, Shared<VulkanImage> sceneImage) {
-        VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
-
 		VkDescriptorImageInfo newFrameImageInfo = sceneImage->getImageInfo();
 		newFrameImageInfo.sampler = m_imageSamplerNearest; // Use nearest sampler for denoising
 
-        VkDescriptorImageInfo accumulationImageInfo;
-		VkDescriptorImageInfo temporalHistoryImageInfo;
-		VkDescriptorImageInfo tempTemporalOutputImageInfo;
+        writeDescriptorSets(newFrameImageInfo);
+        recordPasses(frameInfo.commandBuffer);
+
+		// Copy the denoised output to the scene image
+		copyDenoisedIntoSceneImage(frameInfo.commandBuffer, sceneImage);
+    }
+
+    std::optional<SemaphoreWait> DenoiserRenderSystem::swapDenoisedImage(FrameInfo& frameInfo, Shared<VulkanImage> sceneImage) {
+        PXT_ASSERT(isAsync(), "The denoiser has no async compute queue");
+
+        VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+
+        // the previous denoise reads the noisy image and writes the history image
+        std::optional<SemaphoreWait> wait;
+        if (m_denoiseValue > 0) {
+            wait = m_asyncComputeQueue->getWait(m_denoiseValue, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        }
+
+        // the scene image was made readable by the fragment shaders after the trace
+        sceneImage->transitionImageLayout(
+            commandBuffer,
+            VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT
+        );
+        m_noisyImage->transitionImageLayout(
+            commandBuffer,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT
+        );
+        copyImage(commandBuffer, *sceneImage, *m_noisyImage);
+
+        // an older output would lag behind the camera, the frame stays noisy instead
+        if (m_denoisedFrame && *m_denoisedFrame + 1 == m_frameCount) {
+            m_temporalHistoryImage->transitionImageLayout(
+                commandBuffer,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT
+            );
+            sceneImage->transitionImageLayout(
+                commandBuffer,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT
+            );
+            copyImage(commandBuffer, *m_temporalHistoryImage, *sceneImage);
+        }
+
+        m_isDenoisePending = true;
+        return wait;
+    }
+
+    void DenoiserRenderSystem::submitDenoise(FrameInfo& frameInfo) {
+        if (!m_isDenoisePending) return;
+        m_isDenoisePending = false;
+
+        // the denoise submitted the last time this frame index was used has been waited on
+        // by AsyncComputeQueue::beginFrame
+        if (auto interval = m_denoiseTimer.getInterval(frameInfo.frameIndex)) {
+            m_lastDenoiseInterval = interval;
+        }
+
+        VkCommandBuffer commandBuffer = m_asyncComputeQueue->begin(frameInfo.frameIndex);
+        m_denoiseTimer.begin(commandBuffer, frameInfo.frameIndex);
+
+        // the layouts are tracked on the host, the copy into the noisy image is recorded in the frame
+        m_noisyImage->transitionImageLayout(
+            commandBuffer,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+        );
+
+        recordPasses(commandBuffer);
 
+        m_denoiseTimer.end(commandBuffer, frameInfo.frameIndex);
+
+        // the copy of the noisy image is one of the last commands of the frame, the whole frame is waited on
+        const SemaphoreWait frameWait{
+            m_context.getFrameTimeline().getSemaphore(),
+            VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            frameInfo.timelineValue
+        };
+        m_denoiseValue = m_asyncComputeQueue->submit(frameInfo.frameIndex, { frameWait });
+        m_denoisedFrame = m_frameCount;
+    }
+
+    VkDescriptorImageInfo DenoiserRenderSystem::getNoisyImageInfo() {
+        // the layout it is sampled in by the passes, it is still undefined when the sets are written
+        VkDescriptorImageInfo imageInfo = m_noisyImage->getImageInfo();
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        return imageInfo;
+    }
+
+    void DenoiserRenderSystem::writeDescriptorSets(const VkDescriptorImageInfo& newFrameImageInfo) {
+        // the layouts the passes use the images in, see recordPasses
+        auto getImageInfo = [](VulkanImage& image, const VkImageLayout layout, const bool useSampler) {
+            VkDescriptorImageInfo imageInfo = image.getImageInfo(useSampler);
+            imageInfo.imageLayout = layout;
+            return imageInfo;
+        };
+
+        VkDescriptorImageInfo accumulationStorageInfo = getImageInfo(*m_accumulationImage, VK_IMAGE_LAYOUT_GENERAL, false);
+        VkDescriptorImageInfo accumulationSampledInfo = getImageInfo(*m_accumulationImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true);
+        VkDescriptorImageInfo temporalHistoryStorageInfo = getImageInfo(*m_temporalHistoryImage, VK_IMAGE_LAYOUT_GENERAL, false);
+        VkDescriptorImageInfo temporalHistorySampledInfo = getImageInfo(*m_temporalHistoryImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true);
+        VkDescriptorImageInfo tempTemporalOutputStorageInfo = getImageInfo(*m_tempTemporalOutputImage, VK_IMAGE_LAYOUT_GENERAL, false);
+        VkDescriptorImageInfo tempTemporalOutputSampledInfo = getImageInfo(*m_tempTemporalOutputImage, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, true);
+
+        DescriptorWriter(m_context, *m_accumulationDescriptorSetLayout)
+            .writeImage(0, &newFrameImageInfo) // New noisy frame (sampled)
+            .writeImage(1, &accumulationStorageInfo) // Accumulation buffer (storage)
+            .updateSet(m_accumulationDescriptorSet);
+
+        DescriptorWriter(m_context, *m_temporalFilterDescriptorSetLayout)
+            .writeImage(0, &accumulationSampledInfo) // Accumulation (sampled)
+            .writeImage(1, &temporalHistorySampledInfo) // History (sampled)
+            .writeImage(2, &newFrameImageInfo) // New noisy frame (sampled)
+            .writeImage(3, &tempTemporalOutputStorageInfo) // Temporal output (storage)
+            .updateSet(m_temporalFilterDescriptorSet);
+
+        DescriptorWriter(m_context, *m_spatialFilterDescriptorSetLayout)
+            .writeImage(0, &tempTemporalOutputSampledInfo) // Temporal output (sampled)
+            .writeImage(1, &newFrameImageInfo) // New noisy frame (sampled, for bilateral guidance)
+            .writeImage(2, &temporalHistoryStorageInfo) // History buffer (storage, final output)
+            .updateSet(m_spatialFilterDescriptorSet);
+    }
+
+    void DenoiserRenderSystem::recordPasses(VkCommandBuffer commandBuffer) {
         // Calculate work group dimensions
 		const uint32_t workGroupSize = 16;
         const uint32_t workGroupCountX = (m_extent.width + workGroupSize - 1) / workGroupSize;
@@ -325,13 +470,6 @@ namespace PXTEngine {
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
         );
 
-        accumulationImageInfo = m_accumulationImage->getImageInfo(false); // Storage image info
-
-        DescriptorWriter(m_context, *m_accumulationDescriptorSetLayout)
-            .writeImage(0, &newFrameImageInfo) // New noisy frame (sampled)
-            .writeImage(1, &accumulationImageInfo) // Accumulation buffer (storage)
-            .updateSet(m_accumulationDescriptorSet);
-
         m_accumulationPipeline->bind(commandBuffer);
         vkCmdBindDescriptorSets(
             commandBuffer,
@@ -375,17 +513,6 @@ namespace PXTEngine {
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
         );
 
-        accumulationImageInfo = m_accumulationImage->getImageInfo(); // Sampled image info
-        temporalHistoryImageInfo = m_temporalHistoryImage->getImageInfo(); // Sampled image info
-        tempTemporalOutputImageInfo = m_tempTemporalOutputImage->getImageInfo(false); // Storage image info
-
-        DescriptorWriter(m_context, *m_temporalFilterDescriptorSetLayout)
-            .writeImage(0, &accumulationImageInfo) // Accumulation (sampled)
-            .writeImage(1, &temporalHistoryImageInfo) // History (sampled)
-            .writeImage(2, &newFrameImageInfo) // New noisy frame (sampled)
-            .writeImage(3, &tempTemporalOutputImageInfo) // Temporal output (storage)
-            .updateSet(m_temporalFilterDescriptorSet);
-
         m_temporalFilterPipeline->bind(commandBuffer);
         vkCmdBindDescriptorSets(
             commandBuffer,
@@ -422,15 +549,6 @@ namespace PXTEngine {
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
         );
 
-        tempTemporalOutputImageInfo = m_tempTemporalOutputImage->getImageInfo(); // Sampled image info
-        temporalHistoryImageInfo = m_temporalHistoryImage->getImageInfo(false);
-
-        DescriptorWriter(m_context, *m_spatialFilterDescriptorSetLayout)
-            .writeImage(0, &tempTemporalOutputImageInfo) // Temporal output (sampled)
-            .writeImage(1, &newFrameImageInfo) // New noisy frame (sampled, for bilateral guidance)
-            .writeImage(2, &temporalHistoryImageInfo) // History buffer (storage, final output)
-            .updateSet(m_spatialFilterDescriptorSet);
-
         m_spatialFilterPipeline->bind(commandBuffer);
         vkCmdBindDescriptorSets(
             commandBuffer,
@@ -448,11 +566,9 @@ namespace PXTEngine {
         );
 
         vkCmdDispatch(commandBuffer, workGroupCountX, workGroupCountY, 1);
-
-		// Copy the denoised output to the scene image
-		copyDenoisedIntoSceneImage(commandBuffer, sceneImage);
     }
 
+
     void DenoiserRenderSystem::update(GlobalUbo& ubo) {
 		m_frameCount = ubo.frameCount;
 
@@ -501,6 +617,10 @@ namespace PXTEngine {
 		);
 
 		// Copy the denoised image to the scene image
+		copyImage(commandBuffer, *m_temporalHistoryImage, *sceneImage);
+    }
+
+    void DenoiserRenderSystem::copyImage(VkCommandBuffer commandBuffer, VulkanImage& source, VulkanImage& destination) const {
 		VkImageCopy copyRegion{};
 		copyRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		copyRegion.srcSubresource.mipLevel = 0;
@@ -517,9 +637,9 @@ namespace PXTEngine {
 		copyRegion.extent.depth = 1;
 		vkCmdCopyImage(
 			commandBuffer,
-			m_temporalHistoryImage->getVkImage(),
+			source.getVkImage(),
 			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-			sceneImage->getVkImage(),
+			destination.getVkImage(),
 			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 			1, &copyRegion
 		);
@@ -528,11 +648,23 @@ namespace PXTEngine {
     void DenoiserRenderSystem::updateImages(VkExtent2D swapChainExtent) {
         m_extent = swapChainExtent;
         createImages(swapChainExtent);
+
+        // the output of the last denoise went away with the old images
+        m_denoisedFrame.reset();
+        m_isDenoisePending = false;
+        if (isAsync()) {
+            writeDescriptorSets(getNoisyImageInfo());
+        }
     }
 
-    void DenoiserRenderSystem::reloadShaders() {
-		createAccumulationPipeline(false);
-		createTemporalFilterPipeline(false);
-		createSpatialFilterPipeline(false);
-	}
+    void DenoiserRenderSystem::registerShaders(ShaderReloader& shaderReloader) {
+        const std::string shaderDirectory = SHADERS_PATH + "raytracing/denoising/";
+
+        shaderReloader.addPipeline("Denoiser accumulation", { shaderDirectory + m_accumulationShaderPath },
+            [this] { return createAccumulationPipeline(false); }, m_accumulationPipeline);
+        shaderReloader.addPipeline("Denoiser temporal filter", { shaderDirectory + m_temporalShaderPath },
+            [this] { return createTemporalFilterPipeline(false); }, m_temporalFilterPipeline);
+        shaderReloader.addPipeline("Denoiser spatial filter", { shaderDirectory + m_spatialShaderPath },
+            [this] { return createSpatialFilterPipeline(false); }, m_spatialFilterPipeline);
+    }
 } 
\ No newline at end of file
@@ -2,17 +2,32 @@
 
 #include "core/pch.hpp"
 #include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
 #include "graphics/context/context.hpp"
 #include "graphics/frame_info.hpp"
 #include "graphics/descriptors/descriptors.hpp"
 #include "graphics/resources/texture_registry.hpp"
 #include "graphics/resources/vk_image.hpp"
+#include "graphics/async_compute_queue.hpp"
+#include "graphics/gpu_timer.hpp"
 
 namespace PXTEngine {
 
+    /**
+     * @class DenoiserRenderSystem
+     *
+     * @brief Denoises the path traced image with an accumulation, a temporal and a spatial pass.
+     *
+     * Without an async compute queue the passes are recorded in the frame command buffer after
+     * the trace and their output is copied back into the scene image. With one, they run on the
+     * compute queue overlapping the next frame: the frame copies its traced image out of the
+     * scene image (so that the next trace can overwrite it) and replaces it with the output of
+     * the previous frame's denoise, then the denoise of the frame is submitted once the frame
+     * itself is. The viewport shows the denoised image one frame late.
+     */
     class DenoiserRenderSystem {
     public:
-        DenoiserRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, VkExtent2D swapChainExtent);
+        DenoiserRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, VkExtent2D swapChainExtent, AsyncComputeQueue* asyncComputeQueue = nullptr);
         ~DenoiserRenderSystem();
 
         DenoiserRenderSystem(const DenoiserRenderSystem&) = delete;
@@ -21,11 +36,31 @@ namespace PXTEngine {
         // The main function to run the denoising pipeline
         void denoise(FrameInfo& frameInfo, Shared<VulkanImage> sceneImage);
 
+        bool isAsync() const { return m_asyncComputeQueue != nullptr; }
+
+        /**
+         * @brief Async path, recorded in the frame command buffer after the trace: copies the
+         * traced image for submitDenoise() and puts the output of the previous frame's denoise
+         * in the scene image, if that frame was denoised.
+         *
+         * @return The wait on the previous denoise the frame submission needs, if any.
+         */
+        std::optional<SemaphoreWait> swapDenoisedImage(FrameInfo& frameInfo, Shared<VulkanImage> sceneImage);
+
+        /**
+         * @brief Async path: submits the denoise of the image copied by swapDenoisedImage()
+         * to the compute queue. Must be called after the frame has been submitted, it waits on it.
+         */
+        void submitDenoise(FrameInfo& frameInfo);
+
+        // the GPU time of the last async denoise timed, std::nullopt on the graphics queue
+        const std::optional<GpuTimer::Interval>& getLastDenoiseInterval() const { return m_lastDenoiseInterval; }
+
 		void update(GlobalUbo& ubo);
         void updateUi();
 
         void updateImages(VkExtent2D swapChainExtent);
-        void reloadShaders();
+        void registerShaders(ShaderReloader& shaderReloader);
 
     private:
         // Helper methods for pipeline setup
@@ -34,19 +69,26 @@ namespace PXTEngine {
         void createTemporalFilterPipelineLayout();
         void createSpatialFilterPipelineLayout();
 
-        void createAccumulationPipeline(bool useCompiledSpirvFiles = true);
-        void createTemporalFilterPipeline(bool useCompiledSpirvFiles = true);
-        void createSpatialFilterPipeline(bool useCompiledSpirvFiles = true);
+        Unique<Pipeline> createAccumulationPipeline(bool useCompiledSpirvFiles = true) const;
+        Unique<Pipeline> createTemporalFilterPipeline(bool useCompiledSpirvFiles = true) const;
+        Unique<Pipeline> createSpatialFilterPipeline(bool useCompiledSpirvFiles = true) const;
 
         // Helper methods for descriptor sets
         void createAccumulationDescriptorSet();
         void createTemporalFilterDescriptorSet();
         void createSpatialFilterDescriptorSet();
 
+        // points the passes to a new noisy frame
+        void writeDescriptorSets(const VkDescriptorImageInfo& newFrameImageInfo);
+        VkDescriptorImageInfo getNoisyImageInfo();
+        void recordPasses(VkCommandBuffer commandBuffer);
+
+        void copyImage(VkCommandBuffer commandBuffer, VulkanImage& source, VulkanImage& destination) const;
         void copyDenoisedIntoSceneImage(VkCommandBuffer commandBuffer, Shared<VulkanImage> sceneImage);
 
         Context& m_context;
         Shared<DescriptorAllocatorGrowable> m_descriptorAllocator;
+        AsyncComputeQueue* m_asyncComputeQueue;
 
         VkExtent2D m_extent;
 
@@ -75,6 +117,15 @@ namespace PXTEngine {
         Unique<VulkanImage> m_temporalHistoryImage; // For temporal filtering
         Unique<VulkanImage> m_tempTemporalOutputImage;
 
+        // async path: the traced frame being denoised, the trace of the next frame writes the scene image
+        Unique<VulkanImage> m_noisyImage;
+        uint64_t m_denoiseValue = 0;        // compute timeline value of the last denoise submitted
+        std::optional<uint32_t> m_denoisedFrame; // its frame count, the next frame shows it
+        bool m_isDenoisePending = false;    // swapped but not submitted yet
+
+        GpuTimer m_denoiseTimer;
+        std::optional<GpuTimer::Interval> m_lastDenoiseInterval;
+
 		// Sampler for images (with nearest filtering)
 		VkSampler m_imageSamplerNearest;
 
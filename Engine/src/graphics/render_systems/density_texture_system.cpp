@@ -1,11 +1,14 @@
 #include "graphics/render_systems/density_texture_system.hpp"
 
+#include "application.hpp"
+
 namespace PXTEngine {
 
     // Push constants to control noise generation in the shader
     struct DensityPushConstants {
         float noiseFrequency;
         float worleyExponent;
+        uint32_t brickOffsetZ;
     };
 
     // buffer holdig the majorant max
@@ -16,12 +19,22 @@ namespace PXTEngine {
     DensityTextureRenderSystem::DensityTextureRenderSystem(
         Context& context,
         Shared<DescriptorAllocatorGrowable> descriptorAllocator,
+        ReadbackService& readbackService,
         VkExtent3D densityTextureExtent,
-        VkExtent3D majorantGridExtent)
+        VkExtent3D majorantGridExtent,
+        bool useAsyncCompute)
         : m_context(context),
         m_descriptorAllocator(descriptorAllocator),
+        m_readbackService(readbackService),
         m_densityTextureExtent(densityTextureExtent),
-        m_majorantGridExtent(majorantGridExtent) {
+        m_majorantGridExtent(majorantGridExtent),
+        m_useAsyncCompute(useAsyncCompute),
+        m_volumeReadStage(useAsyncCompute ? VK_PIPELINE_STAGE_ALL_COMMANDS_BIT : VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR),
+        m_generationTimer(context) {
+
+        // a volume is written again at most one frame after it stopped being the front one:
+        // the CPU has then waited for the last frame sampling it, no semaphore is needed
+        static_assert(SwapChain::MAX_FRAMES_IN_FLIGHT <= 2, "The back volume may still be read by a frame in flight");
 
         // The workgroup size in the shader is fixed (e.g., 8x8x8).
         // The density texture dimensions must be a multiple of the majorant grid dimensions.
@@ -29,26 +42,26 @@ namespace PXTEngine {
         PXT_ASSERT(m_densityTextureExtent.height % m_majorantGridExtent.height == 0, "Height mismatch");
         PXT_ASSERT(m_densityTextureExtent.depth % m_majorantGridExtent.depth == 0, "Depth mismatch");
 
-        createImages();
-        createGlobalMajorantBuffer();
-        createDescriptorSets();
+        createDescriptorSetLayouts();
 
-        createGenerationPipelineLayout();
-        createGenerationPipeline();
+        for (DensityVolume& volume : m_volumes) {
+            createImages(volume);
+            createGlobalMajorantBuffer(volume);
+            createDescriptorSets(volume);
+        }
 
-		createGlobalMajorantPipelineLayout();
-		createGlobalMajorantPipeline();
+        createGenerationPipelineLayout();
+        m_generationPipeline = createGenerationPipeline();
     }
 
     DensityTextureRenderSystem::~DensityTextureRenderSystem() {
-        vkDestroyPipelineLayout(m_context.getDevice(), m_generationPipelineLayout, nullptr);
-		vkDestroyPipelineLayout(m_context.getDevice(), m_globalMajorantPipelineLayout, nullptr);
-
-        vkDestroyImageView(m_context.getDevice(), m_densitySliceImageView, nullptr);
-        vkDestroyImageView(m_context.getDevice(), m_majorantGridSliceImageView, nullptr);
+        for (DensityVolume& volume : m_volumes) {
+            vkDestroyImageView(m_context.getDevice(), volume.densitySliceImageView, nullptr);
+            vkDestroyImageView(m_context.getDevice(), volume.majorantGridSliceImageView, nullptr);
+        }
     }
 
-    void DensityTextureRenderSystem::createImages() {
+    void DensityTextureRenderSystem::createImages(DensityVolume& volume) {
         // Create info for the 3D density texture
         VkImageCreateInfo densityImageInfo{};
         densityImageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -63,7 +76,15 @@ namespace PXTEngine {
         densityImageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         densityImageInfo.flags = VK_IMAGE_CREATE_2D_VIEW_COMPATIBLE_BIT_EXT; // to view slices for debug
 
-        m_densityTexture = createUnique<VulkanImage>(
+        // written by the compute queue, sampled by the graphics queue
+        const std::vector<uint32_t> queueFamilies = m_useAsyncCompute ? m_context.getAsyncComputeQueueFamilies() : std::vector<uint32_t>{};
+        if (!queueFamilies.empty()) {
+            densityImageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+            densityImageInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+            densityImageInfo.pQueueFamilyIndices = queueFamilies.data();
+        }
+
+        volume.densityTexture = createUnique<VulkanImage>(
             m_context,
             densityImageInfo,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
@@ -79,18 +100,18 @@ namespace PXTEngine {
         imageViewCreateInfo.subresourceRange.baseArrayLayer = 0;
         imageViewCreateInfo.subresourceRange.layerCount = 1;
 
-        m_densityTexture->createImageView(imageViewCreateInfo);
+        volume.densityTexture->createImageView(imageViewCreateInfo);
 
         // Create info for the 3D majorant grid texture
         VkImageCreateInfo majorantImageInfo = densityImageInfo;
         majorantImageInfo.extent = m_majorantGridExtent;
 
-        m_majorantGrid = createUnique<VulkanImage>(
+        volume.majorantGrid = createUnique<VulkanImage>(
             m_context,
             majorantImageInfo,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
         );
-        m_majorantGrid->createImageView(imageViewCreateInfo);
+        volume.majorantGrid->createImageView(imageViewCreateInfo);
 
 		VkSamplerCreateInfo samplerInfo{};
 		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
@@ -102,52 +123,104 @@ namespace PXTEngine {
 		samplerInfo.anisotropyEnable = VK_FALSE;
 		samplerInfo.maxAnisotropy = 1.0f;
 		samplerInfo.unnormalizedCoordinates = VK_FALSE;
-		
-		m_densityTexture->createSampler(samplerInfo);
-		m_majorantGrid->createSampler(samplerInfo);
 
-        createSliceImageViews(&m_densitySliceImageView, &m_majorantGridSliceImageView);
+		volume.densityTexture->createSampler(samplerInfo);
+		volume.majorantGrid->createSampler(samplerInfo);
+
+        createSliceImageViews(volume, &volume.densitySliceImageView, &volume.majorantGridSliceImageView);
     }
 
-    void DensityTextureRenderSystem::createGlobalMajorantBuffer() {
+    void DensityTextureRenderSystem::createGlobalMajorantBuffer(DensityVolume& volume) {
 		GlobalMajorantBuffer globalMajorantData{};
 		globalMajorantData.globalMajorantFloatBits = 0;
-        
-        m_globalMajorantBuffer = createUnique<VulkanBuffer>(
+
+        volume.globalMajorantBuffer = createUnique<VulkanBuffer>(
 			m_context,
 			sizeof(GlobalMajorantBuffer),
             1,
-			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT // we need to see it from the cpu
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, // we need to see it from the cpu
+            1,
+            m_useAsyncCompute ? m_context.getAsyncComputeQueueFamilies() : std::vector<uint32_t>{}
 		);
 
-		m_globalMajorantBuffer->map();
-		m_globalMajorantBuffer->writeToBuffer(&globalMajorantData);
-		m_globalMajorantBuffer->unmap();
+		volume.globalMajorantBuffer->map();
+		volume.globalMajorantBuffer->writeToBuffer(&globalMajorantData);
+		volume.globalMajorantBuffer->unmap();
     }
 
-    void DensityTextureRenderSystem::resetGlobalMajorantBuffer() {
-        GlobalMajorantBuffer globalMajorantData{};
-        globalMajorantData.globalMajorantFloatBits = 0;
+    void DensityTextureRenderSystem::resetGlobalMajorantBuffer(VkCommandBuffer commandBuffer, DensityVolume& volume) {
+        // the buffer may still be read by the frames in flight (it was the front volume),
+        // so it is cleared on the GPU, after them, instead of being written from the host.
+        // It was last written by the atomics of the previous generation, the clear comes after them too
+        VkBufferMemoryBarrier bufferBarrier{};
+        bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        bufferBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        bufferBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        bufferBarrier.buffer = volume.globalMajorantBuffer->getBuffer();
+        bufferBarrier.offset = 0;
+        bufferBarrier.size = VK_WHOLE_SIZE;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            m_volumeReadStage | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            0, nullptr,
+            1, &bufferBarrier,
+            0, nullptr
+        );
+
+        vkCmdFillBuffer(commandBuffer, volume.globalMajorantBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
 
-        m_globalMajorantBuffer->map();
-        m_globalMajorantBuffer->writeToBuffer(&globalMajorantData);
-        m_globalMajorantBuffer->unmap();
+        bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        bufferBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            0, nullptr,
+            1, &bufferBarrier,
+            0, nullptr
+        );
     }
 
-    void DensityTextureRenderSystem::createDescriptorSets() {
+    void DensityTextureRenderSystem::createDescriptorSetLayouts() {
         m_descriptorSetLayout = DescriptorSetLayout::Builder(m_context)
             .addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT) // Density Texture Output
 			.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT) // Majorant Grid Output
 			.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT) // Global Majorant Buffer
             .build();
 
-        m_descriptorAllocator->allocate(m_descriptorSetLayout->getDescriptorSetLayout(), m_descriptorSet);
+		// Layout for sampling the generated textures in shaders
+		m_samplingDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT |
+              VK_SHADER_STAGE_RAYGEN_BIT_KHR |
+              VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR)
+            .addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT |
+                VK_SHADER_STAGE_RAYGEN_BIT_KHR |
+                VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR)
+            .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_RAYGEN_BIT_KHR |
+                VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR)
+			.build();
+
+        // Layout for sampling the generated textures within ImGui
+        m_imGuiDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
+            .build();
+    }
+
+    void DensityTextureRenderSystem::createDescriptorSets(DensityVolume& volume) {
+        m_descriptorAllocator->allocate(m_descriptorSetLayout->getDescriptorSetLayout(), volume.generationDescriptorSet);
 
         // Update descriptor set immediately since the images don't change
-        VkDescriptorImageInfo densityImageInfo = m_densityTexture->getImageInfo(false);
-        VkDescriptorImageInfo majorantImageInfo = m_majorantGrid->getImageInfo(false);
-		VkDescriptorBufferInfo globalMajorantBufferInfo = m_globalMajorantBuffer->descriptorInfo();
+        VkDescriptorImageInfo densityImageInfo = volume.densityTexture->getImageInfo(false);
+        VkDescriptorImageInfo majorantImageInfo = volume.majorantGrid->getImageInfo(false);
+		VkDescriptorBufferInfo globalMajorantBufferInfo = volume.globalMajorantBuffer->descriptorInfo();
 
         // TODO: manage this automatically, with the method provided by VulkanImage abstraction
         densityImageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
@@ -157,57 +230,41 @@ namespace PXTEngine {
             .writeImage(0, &densityImageInfo)
             .writeImage(1, &majorantImageInfo)
 			.writeBuffer(2, &globalMajorantBufferInfo)
-            .updateSet(m_descriptorSet);
+            .updateSet(volume.generationDescriptorSet);
 
 		// Create descriptor sets for sampling the generated textures in shaders
-		m_samplingDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
-			.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT |
-              VK_SHADER_STAGE_RAYGEN_BIT_KHR | 
-              VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR)
-            .addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT |
-                VK_SHADER_STAGE_RAYGEN_BIT_KHR |
-                VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR)
-            .addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_RAYGEN_BIT_KHR |
-                VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR)
-			.build();
-
-		m_descriptorAllocator->allocate(m_samplingDescriptorSetLayout->getDescriptorSetLayout(), m_samplingDescriptorSet);
+		m_descriptorAllocator->allocate(m_samplingDescriptorSetLayout->getDescriptorSetLayout(), volume.samplingDescriptorSet);
 
         // TODO: manage this automatically, with the method provided by VulkanImage abstraction
         // Update descriptor set immediately since the images don't change
-        densityImageInfo = m_densityTexture->getImageInfo();
+        densityImageInfo = volume.densityTexture->getImageInfo();
         densityImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        majorantImageInfo = m_majorantGrid->getImageInfo();
+        majorantImageInfo = volume.majorantGrid->getImageInfo();
         majorantImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
 		DescriptorWriter(m_context, *m_samplingDescriptorSetLayout)
 			.writeImage(0, &densityImageInfo)
             .writeImage(1, &majorantImageInfo)
 			.writeBuffer(2, &globalMajorantBufferInfo)
-			.updateSet(m_samplingDescriptorSet);
-
-        // Create descriptor sets for sampling the generated textures within ImGui
-        m_imGuiDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
-            .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
-            .build();
+			.updateSet(volume.samplingDescriptorSet);
 
         // DENSITY TEXTURE IMGUI
-        densityImageInfo.imageView = m_densitySliceImageView;
+        densityImageInfo.imageView = volume.densitySliceImageView;
 
-        m_descriptorAllocator->allocate(m_imGuiDescriptorSetLayout->getDescriptorSetLayout(), m_imGuiDensityDescriptorSet);
+        m_descriptorAllocator->allocate(m_imGuiDescriptorSetLayout->getDescriptorSetLayout(), volume.imGuiDensityDescriptorSet);
 
         DescriptorWriter(m_context, *m_imGuiDescriptorSetLayout)
             .writeImage(0, &densityImageInfo)
-            .updateSet(m_imGuiDensityDescriptorSet);
+            .updateSet(volume.imGuiDensityDescriptorSet);
 
         // MAJORANT GRID TEXTURE IMGUI
-        majorantImageInfo.imageView = m_majorantGridSliceImageView;
+        majorantImageInfo.imageView = volume.majorantGridSliceImageView;
 
-        m_descriptorAllocator->allocate(m_imGuiDescriptorSetLayout->getDescriptorSetLayout(), m_imGuiMajorantDescriptorSet);
+        m_descriptorAllocator->allocate(m_imGuiDescriptorSetLayout->getDescriptorSetLayout(), volume.imGuiMajorantDescriptorSet);
 
         DescriptorWriter(m_context, *m_imGuiDescriptorSetLayout)
             .writeImage(0, &majorantImageInfo)
-            .updateSet(m_imGuiMajorantDescriptorSet);
+            .updateSet(volume.imGuiMajorantDescriptorSet);
     }
 
     void DensityTextureRenderSystem::createGenerationPipelineLayout() {
@@ -225,12 +282,10 @@ namespace PXTEngine {
         pipelineLayoutInfo.pushConstantRangeCount = 1;
         pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_generationPipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create density texture pipeline layout!");
-        }
+        m_generationPipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
     }
 
-    void DensityTextureRenderSystem::createGenerationPipeline(bool useCompiledSpirvFiles) {
+    Unique<Pipeline> DensityTextureRenderSystem::createGenerationPipeline(bool useCompiledSpirvFiles) const {
         PXT_ASSERT(m_generationPipelineLayout != nullptr, "Cannot create pipeline before pipeline layout");
 
         ComputePipelineConfigInfo pipelineConfig{};
@@ -240,51 +295,72 @@ namespace PXTEngine {
         const std::string filenameSuffix = useCompiledSpirvFiles ? ".spv" : "";
         std::string shaderFilePath = baseShaderPath + m_generationShaderPath + filenameSuffix;
 
-        m_generationPipeline = createUnique<Pipeline>(m_context, shaderFilePath, pipelineConfig);
+        return createUnique<Pipeline>(m_context, shaderFilePath, pipelineConfig);
     }
 
-    void DensityTextureRenderSystem::createGlobalMajorantPipelineLayout() {
-        std::vector<VkDescriptorSetLayout> descriptorSetLayouts{ m_descriptorSetLayout->getDescriptorSetLayout() };
+    uint32_t DensityTextureRenderSystem::computeSlabsThisFrame() {
+        const uint32_t remainingSlabs = m_majorantGridExtent.depth - m_nextSlab;
 
-        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
-        pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
-        pipelineLayoutInfo.pushConstantRangeCount = 0;
-        pipelineLayoutInfo.pPushConstantRanges = nullptr;
-
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_globalMajorantPipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create global majorant pipeline layout!");
+        // the first volume is generated at once, there is nothing else to show meanwhile
+        if (!m_hasValidVolume) {
+            return remainingSlabs;
         }
+
+        // without a measure yet (or timestamps) go one slab at a time
+        const uint32_t slabs = m_msPerSlab > 0.0f
+            ? std::clamp(static_cast<uint32_t>(m_generationBudgetMs / m_msPerSlab), 1u, remainingSlabs)
+            : 1;
+
+        // a replay generates the slabs of the recorded session, whatever its own timings
+        const uint32_t pinnedSlabs = Application::get().getInputRecorder().pinAdaptiveValue(
+            InputRecorder::AdaptiveValue::DensitySlabCount, slabs);
+        return std::min(pinnedSlabs, remainingSlabs);
     }
 
-    void DensityTextureRenderSystem::createGlobalMajorantPipeline(bool useCompiledSpirvFiles) {
-        PXT_ASSERT(m_globalMajorantPipelineLayout != nullptr, "Cannot create global majorant pipeline before pipeline layout");
+    bool DensityTextureRenderSystem::generate(VkCommandBuffer commandBuffer, const uint32_t frameIndex) {
+        // update the cost of a slab with the last measure taken with this frame index
+        // (its timeline value, graphics or async compute, has already been reached)
+        m_lastGenerationInterval = m_generationTimer.getInterval(frameIndex);
+        if (m_lastGenerationInterval && m_timedSlabs[frameIndex] > 0) {
+            const float msPerSlab = m_lastGenerationInterval->getElapsedMs() / static_cast<float>(m_timedSlabs[frameIndex]);
+            m_msPerSlab = m_msPerSlab > 0.0f ? glm::mix(m_msPerSlab, msPerSlab, 0.25f) : msPerSlab;
+        }
+        m_timedSlabs[frameIndex] = 0;
 
-        ComputePipelineConfigInfo pipelineConfig{};
-        pipelineConfig.pipelineLayout = m_globalMajorantPipelineLayout;
+        DensityVolume& backVolume = m_volumes[1 - m_frontIndex];
 
-        const std::string baseShaderPath = useCompiledSpirvFiles ? SPV_SHADERS_PATH : SHADERS_PATH;
-        const std::string filenameSuffix = useCompiledSpirvFiles ? ".spv" : "";
-        std::string shaderFilePath = baseShaderPath + m_globalMajorantShaderPath + filenameSuffix;
+        // a parameter changed: (re)start from the first brick, the bricks already generated
+        // with the old parameters are simply overwritten
+        if (m_needsRegeneration) {
+            m_needsRegeneration = false;
+            m_isGenerating = true;
+            m_nextSlab = 0;
+            m_generationNoiseFrequency = static_cast<float>(m_noiseFrequency);
+            m_generationWorleyExponent = m_worleyExponent;
 
-        m_globalMajorantPipeline = createUnique<Pipeline>(m_context, shaderFilePath, pipelineConfig);
-    }
+            resetGlobalMajorantBuffer(commandBuffer, backVolume);
+        }
 
-    void DensityTextureRenderSystem::generate(VkCommandBuffer commandBuffer) {
-        // Transition images to GENERAL layout for storage image access
-        m_densityTexture->transitionImageLayout(
-            commandBuffer,
-            VK_IMAGE_LAYOUT_GENERAL,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
-        );
-        m_majorantGrid->transitionImageLayout(
-            commandBuffer,
-            VK_IMAGE_LAYOUT_GENERAL,
-            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
-        );
+        // Transition images to GENERAL layout for storage image access,
+        // they stay in GENERAL until every brick has been generated
+        if (backVolume.densityTexture->getCurrentLayout() != VK_IMAGE_LAYOUT_GENERAL) {
+            backVolume.densityTexture->transitionImageLayout(
+                commandBuffer,
+                VK_IMAGE_LAYOUT_GENERAL,
+                m_volumeReadStage,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+            );
+            backVolume.majorantGrid->transitionImageLayout(
+                commandBuffer,
+                VK_IMAGE_LAYOUT_GENERAL,
+                m_volumeReadStage,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+            );
+        }
+
+        const uint32_t slabCount = computeSlabsThisFrame();
+
+        m_generationTimer.begin(commandBuffer, frameIndex);
 
         // Bind pipeline and descriptor sets
         m_generationPipeline->bind(commandBuffer);
@@ -292,14 +368,15 @@ namespace PXTEngine {
             commandBuffer,
             VK_PIPELINE_BIND_POINT_COMPUTE,
             m_generationPipelineLayout,
-            0, 1, &m_descriptorSet,
+            0, 1, &backVolume.generationDescriptorSet,
             0, nullptr
         );
 
         // Push constants to control the noise
         DensityPushConstants pushConstants{};
-        pushConstants.noiseFrequency = static_cast<float>(m_noiseFrequency); // Higher value = more detail
-        pushConstants.worleyExponent = m_worleyExponent;   // How much the cell-like structure influences the shape
+        pushConstants.noiseFrequency = m_generationNoiseFrequency; // Higher value = more detail
+        pushConstants.worleyExponent = m_generationWorleyExponent; // How much the cell-like structure influences the shape
+        pushConstants.brickOffsetZ = m_nextSlab;
 
         vkCmdPushConstants(
             commandBuffer,
@@ -309,57 +386,46 @@ namespace PXTEngine {
             &pushConstants
         );
 
-        // Dispatch compute shaders. One workgroup per majorant grid cell.
+        // Dispatch compute shaders. One workgroup per brick (majorant grid cell),
+        // only for the slabs of bricks that fit in this frame.
         vkCmdDispatch(
             commandBuffer,
             m_majorantGridExtent.width,
             m_majorantGridExtent.height,
-            m_majorantGridExtent.depth
+            slabCount
         );
 
-		findMaxDensity(commandBuffer);
+        m_generationTimer.end(commandBuffer, frameIndex);
+        m_timedSlabs[frameIndex] = slabCount;
+
+        m_nextSlab += slabCount;
+
+        if (m_nextSlab == m_majorantGridExtent.depth) {
+            completeGeneration(commandBuffer);
+            return true;
+        }
+
+        return false;
+    }
+
+    void DensityTextureRenderSystem::completeGeneration(VkCommandBuffer commandBuffer) {
+        DensityVolume& backVolume = m_volumes[1 - m_frontIndex];
 
         // TODO: move this into a separate function with the ability to specify
         // which stage to wait for (dstStage), could be RT or FRAGMENT depending on
         // RT enabled or not.
         // Transition images to SHADER READ ONLY OPTIMAL layout
-        m_densityTexture->transitionImageLayout(
+        backVolume.densityTexture->transitionImageLayout(
             commandBuffer,
             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR
+            m_volumeReadStage
         );
-        m_majorantGrid->transitionImageLayout(
+        backVolume.majorantGrid->transitionImageLayout(
             commandBuffer,
             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR
-        );
-
-        m_needsRegeneration = false;
-		m_hasRigeneratedThisFrame = true;
-    }
-
-    void DensityTextureRenderSystem::findMaxDensity(VkCommandBuffer commandBuffer) {
-		// reset to zero before finding max
-        resetGlobalMajorantBuffer();
-
-        // Bind pipeline and descriptor sets
-        m_globalMajorantPipeline->bind(commandBuffer);
-        vkCmdBindDescriptorSets(
-            commandBuffer,
-            VK_PIPELINE_BIND_POINT_COMPUTE,
-            m_globalMajorantPipelineLayout,
-            0, 1, &m_descriptorSet,
-            0, nullptr
-        );
-
-        // Dispatch compute shaders. One workgroup per majorant grid cell.
-        vkCmdDispatch(
-            commandBuffer,
-            m_majorantGridExtent.width,
-            m_majorantGridExtent.height,
-            m_majorantGridExtent.depth
+            m_volumeReadStage
         );
 
         // memory barrier
@@ -367,46 +433,69 @@ namespace PXTEngine {
         memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
         // Source: What the GPU did before the barrier
         memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT; // The shader wrote to the buffer
-        // Destination: What the CPU will do after the barrier
-        memoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;    // The host will read the buffer
+        // Destination: the ray tracing shaders will read the global majorant
+        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
         // Record the barrier command
         vkCmdPipelineBarrier(
             commandBuffer,
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // Stage where writing happened
-            VK_PIPELINE_STAGE_HOST_BIT,           // Stage where reading will happen
+            m_volumeReadStage,
             0,
             1, &memoryBarrier,
             0, nullptr,
             0, nullptr
         );
-    }
 
-    void DensityTextureRenderSystem::reloadShaders() {
-        PXT_INFO("Reloading shaders...");
-        createGenerationPipeline(false);
+        // the commands reading the new front volume are recorded after the barriers above
+        // (or wait for the compute submission), so it can be used starting from this frame
+        m_frontIndex = 1 - m_frontIndex;
+        m_isGenerating = false;
+        m_hasValidVolume = true;
     }
 
-    void DensityTextureRenderSystem::postFrameUpdate(VkFence frameFence) {
-        if (!m_hasRigeneratedThisFrame) return;
+    void DensityTextureRenderSystem::readBackGlobalMajorant(VkCommandBuffer commandBuffer) {
+        // the global majorant is only shown in the ui, it is read back without waiting for the GPU.
+        // The readback service resolves the copies with the frame timeline, so the copy is
+        // recorded on the graphics queue even when the generation runs on the compute one
+        m_globalMajorantReadback = m_readbackService.readBuffer(
+            commandBuffer,
+            m_volumes[m_frontIndex].globalMajorantBuffer->getBuffer(),
+            0,
+            sizeof(GlobalMajorantBuffer),
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_ACCESS_SHADER_WRITE_BIT
+        );
+    }
 
-		// synchronize with the frame fence to ensure the GPU has finished
-        vkWaitForFences(m_context.getDevice(), 1, &frameFence, VK_TRUE, UINT64_MAX);
+    void DensityTextureRenderSystem::registerShaders(ShaderReloader& shaderReloader) {
+        // a generation in progress finishes its remaining slabs with the new pipeline
+        shaderReloader.addPipeline("Density generation", { SHADERS_PATH + m_generationShaderPath },
+            [this] { return createGenerationPipeline(false); }, m_generationPipeline);
+    }
 
-		// read back the global majorant value
-        m_globalMajorantBuffer->map();
-        uint32_t globalMajorantFloatBits = *((uint32_t*)m_globalMajorantBuffer->getMappedMemory());
-        // we need to reinterpret the bits as flaot (see the density shader code)
-        m_globalMajorant = std::bit_cast<float>(globalMajorantFloatBits);
+    void DensityTextureRenderSystem::postFrameUpdate() {
+        if (!ReadbackService::isReady(m_globalMajorantReadback)) return;
 
-        m_globalMajorantBuffer->unmap();
+        GlobalMajorantBuffer globalMajorantData{};
+        std::vector<uint8_t> data = m_globalMajorantReadback.get();
+        std::memcpy(&globalMajorantData, data.data(), sizeof(GlobalMajorantBuffer));
 
-		m_hasRigeneratedThisFrame = false;
+        // we need to reinterpret the bits as flaot (see the density shader code)
+        m_globalMajorant = std::bit_cast<float>(globalMajorantData.globalMajorantFloatBits);
     }
 
     void DensityTextureRenderSystem::updateUi() {
         if (ImGui::CollapsingHeader("Volume Noise Settings")) {
             ImGui::Text("Global majorant value: %.2f", m_globalMajorant);
+            ImGui::Text("Generation queue: %s", m_useAsyncCompute ? "async compute" : "graphics");
+
+            if (m_isGenerating) {
+                const float progress = static_cast<float>(m_nextSlab) / static_cast<float>(m_majorantGridExtent.depth);
+                ImGui::ProgressBar(progress, ImVec2(-1.0f, 0.0f), "Regenerating...");
+            }
+
+            ImGui::DragFloat("Generation Budget (ms)", &m_generationBudgetMs, 0.05f, 0.1f, 16.0f);
 
             if (ImGui::SliderInt("Noise Frequency", &m_noiseFrequency, 0, 32)) {
                 m_needsRegeneration = true;
@@ -432,26 +521,28 @@ namespace PXTEngine {
     }
 
     void DensityTextureRenderSystem::showNoiseTextures() {
+        const DensityVolume& frontVolume = m_volumes[m_frontIndex];
+
         // Remove window padding so images butt up against window edges
         ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
 
         ImVec2 windowSize(200, 200);
 
 		// Density Texture
-        ImTextureID noiseTexture = (ImTextureID)m_imGuiDensityDescriptorSet;
+        ImTextureID noiseTexture = (ImTextureID)frontVolume.imGuiDensityDescriptorSet;
         ImGui::Image(noiseTexture, windowSize);
 
         // Move to the same line (to the right of the previous image)
         ImGui::SameLine();
 
 		// Majorant Grid Texture
-        ImTextureID majorantTexture = (ImTextureID)m_imGuiMajorantDescriptorSet;
+        ImTextureID majorantTexture = (ImTextureID)frontVolume.imGuiMajorantDescriptorSet;
         ImGui::Image(majorantTexture, windowSize);
 
         ImGui::PopStyleVar();
     }
 
-    void DensityTextureRenderSystem::createSliceImageViews(VkImageView* densitySliceImageView, VkImageView* majorantSliceImageView) {
+    void DensityTextureRenderSystem::createSliceImageViews(DensityVolume& volume, VkImageView* densitySliceImageView, VkImageView* majorantSliceImageView) {
         // create slice image view for imgui
         VkImageViewCreateInfo viewInfo{};
         viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -464,49 +555,48 @@ namespace PXTEngine {
         viewInfo.subresourceRange.baseArrayLayer = m_densitySliceIndex; // which depth slice
         viewInfo.subresourceRange.layerCount = 1;
 
-        viewInfo.image = m_densityTexture->getVkImage();
+        viewInfo.image = volume.densityTexture->getVkImage();
         *densitySliceImageView = m_context.createImageView(viewInfo);
 
-        viewInfo.image = m_majorantGrid->getVkImage();
+        viewInfo.image = volume.majorantGrid->getVkImage();
         viewInfo.subresourceRange.baseArrayLayer = m_densitySliceIndex / m_majorantGridExtent.depth; // for majorant grid
         *majorantSliceImageView = m_context.createImageView(viewInfo);
     }
 
     void DensityTextureRenderSystem::updateSliceImageViews() {
-        // create slice image view for imgui
-		VkImageView densitySliceImageView, majorantGridSliceImageView;
-		createSliceImageViews(&densitySliceImageView, &majorantGridSliceImageView);
+        // we need to wait for the device to finish
+        vkDeviceWaitIdle(m_context.getDevice());
 
-        if (m_densitySliceImageView != VK_NULL_HANDLE && m_majorantGridSliceImageView != VK_NULL_HANDLE) {
-            // we need to wait for the device to finish
-            vkDeviceWaitIdle(m_context.getDevice());
+        for (DensityVolume& volume : m_volumes) {
+            // create slice image view for imgui
+            VkImageView densitySliceImageView, majorantGridSliceImageView;
+            createSliceImageViews(volume, &densitySliceImageView, &majorantGridSliceImageView);
 
             // then update the descriptor sets for imgui
-            VkDescriptorImageInfo densityImageInfo = m_densityTexture->getImageInfo();
+            VkDescriptorImageInfo densityImageInfo = volume.densityTexture->getImageInfo();
             densityImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            VkDescriptorImageInfo majorantImageInfo = m_majorantGrid->getImageInfo();
+            VkDescriptorImageInfo majorantImageInfo = volume.majorantGrid->getImageInfo();
             majorantImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
             densityImageInfo.imageView = densitySliceImageView;
 
             DescriptorWriter(m_context, *m_imGuiDescriptorSetLayout)
                 .writeImage(0, &densityImageInfo)
-                .updateSet(m_imGuiDensityDescriptorSet);
+                .updateSet(volume.imGuiDensityDescriptorSet);
 
             // MAJORANT GRID TEXTURE IMGUI
             majorantImageInfo.imageView = majorantGridSliceImageView;
 
             DescriptorWriter(m_context, *m_imGuiDescriptorSetLayout)
                 .writeImage(0, &majorantImageInfo)
-                .updateSet(m_imGuiMajorantDescriptorSet);
+                .updateSet(volume.imGuiMajorantDescriptorSet);
 
-            // then destroy the old ones
-            vkDestroyImageView(m_context.getDevice(), m_densitySliceImageView, nullptr);
-            vkDestroyImageView(m_context.getDevice(), m_majorantGridSliceImageView, nullptr);
-        }
+            // then destroy the old ones and keep the new ones
+            vkDestroyImageView(m_context.getDevice(), volume.densitySliceImageView, nullptr);
+            vkDestroyImageView(m_context.getDevice(), volume.majorantGridSliceImageView, nullptr);
 
-        // then assign the new ones regardless
-        m_densitySliceImageView = densitySliceImageView;
-        m_majorantGridSliceImageView = majorantGridSliceImageView;
+            volume.densitySliceImageView = densitySliceImageView;
+            volume.majorantGridSliceImageView = majorantGridSliceImageView;
+        }
     }
-}
\ No newline at end of file
+}
@@ -2,96 +2,165 @@
 
 #include "core/pch.hpp"
 #include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
 #include "graphics/context/context.hpp"
 #include "graphics/descriptors/descriptors.hpp"
 #include "graphics/resources/texture_registry.hpp"
 #include "graphics/resources/vk_image.hpp"
+#include "graphics/gpu_timer.hpp"
+#include "graphics/readback_service.hpp"
 #include <graphics/resources/vk_buffer.hpp>
 
 namespace PXTEngine {
 
+    /**
+     * @class DensityTextureRenderSystem
+     * @brief Generates the procedural density volume used by the volumetric path tracer,
+     * together with its majorant grid and global majorant.
+     *
+     * The volume is made of bricks (one per majorant grid cell) and is regenerated a few
+     * slabs of bricks per frame, within a GPU time budget, so tweaking the noise does not
+     * stall the frame. Two copies of the volume are kept: the front one is sampled while
+     * the back one is being generated, and they are swapped once every brick is done.
+     *
+     * With async compute the generation is recorded into the compute queue's command buffer
+     * and runs in the background of the frames; only the frame swapping the volumes waits for
+     * it, through the timeline of the async compute queue.
+     */
     class DensityTextureRenderSystem {
     public:
+        // GPU time per frame spent on regeneration, the first generation ignores it
+        static constexpr float DEFAULT_GENERATION_BUDGET_MS = 1.0f;
+
         DensityTextureRenderSystem(
             Context& context,
             Shared<DescriptorAllocatorGrowable> descriptorAllocator,
+            ReadbackService& readbackService,
             VkExtent3D densityTextureExtent,
-            VkExtent3D majorantGridExtent);
+            VkExtent3D majorantGridExtent,
+            bool useAsyncCompute = false);
         ~DensityTextureRenderSystem();
 
         DensityTextureRenderSystem(const DensityTextureRenderSystem&) = delete;
         DensityTextureRenderSystem& operator=(const DensityTextureRenderSystem&) = delete;
 
-        // Executes the compute shader to generate the textures
-        void generate(VkCommandBuffer commandBuffer);
-
-        // Getters for the generated textures
-        const VulkanImage& getDensityTexture() const { return *m_densityTexture; }
-        const VulkanImage& getMajorantGrid() const { return *m_majorantGrid; }
-        const VkDescriptorSet getSamplingDensitySet() const { return m_samplingDescriptorSet; }
+        /**
+         * @brief Generates the next slabs of bricks of the back volume, swapping it with the front one when complete.
+         *
+         * @param commandBuffer The async compute command buffer if the system uses async compute,
+         * the frame's graphics command buffer otherwise.
+         * @return Whether the volumes were swapped: the graphics work of this frame reads the
+         * new front volume and must wait for the generation (when recorded on the compute queue).
+         */
+        bool generate(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+        // Reads back the global majorant of the front volume for the ui, after a swap (on the graphics queue)
+        void readBackGlobalMajorant(VkCommandBuffer commandBuffer);
+
+        // the stages of the graphics queue reading the volumes, waiting on the async generation
+        static constexpr VkPipelineStageFlags VOLUME_READ_STAGES =
+            VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+        // Getters for the generated textures (the front volume)
+        const VulkanImage& getDensityTexture() const { return *m_volumes[m_frontIndex].densityTexture; }
+        const VulkanImage& getMajorantGrid() const { return *m_volumes[m_frontIndex].majorantGrid; }
+        const VkDescriptorSet getSamplingDensitySet() const { return m_volumes[m_frontIndex].samplingDescriptorSet; }
         const Shared<DescriptorSetLayout> getSamplingDensitySetLayout() const { return m_samplingDescriptorSetLayout; }
 
-        bool needsRegeneration() const { return m_needsRegeneration; }
+        bool needsRegeneration() const { return m_needsRegeneration || m_isGenerating; }
+        bool usesAsyncCompute() const { return m_useAsyncCompute; }
+
+        // the timestamps of the last measured generation, std::nullopt when not generating
+        const std::optional<GpuTimer::Interval>& getLastGenerationInterval() const { return m_lastGenerationInterval; }
         
-        void reloadShaders();
-        void postFrameUpdate(VkFence frameFence);
+        void registerShaders(ShaderReloader& shaderReloader);
+        void postFrameUpdate();
 
         void updateUi();
         void showNoiseTextures();
 
     private:
-        void createImages();
-		void createGlobalMajorantBuffer();
-        void resetGlobalMajorantBuffer();
-        void createDescriptorSets();
+        // One copy of the generated data, with everything needed to write, sample and show it
+        struct DensityVolume {
+            Unique<VulkanImage> densityTexture;
+            Unique<VulkanImage> majorantGrid;
+            Unique<VulkanBuffer> globalMajorantBuffer;
+
+            VkImageView densitySliceImageView = VK_NULL_HANDLE;
+            VkImageView majorantGridSliceImageView = VK_NULL_HANDLE;
+
+            VkDescriptorSet generationDescriptorSet = VK_NULL_HANDLE;
+            VkDescriptorSet samplingDescriptorSet = VK_NULL_HANDLE;
+            VkDescriptorSet imGuiDensityDescriptorSet = VK_NULL_HANDLE;
+            VkDescriptorSet imGuiMajorantDescriptorSet = VK_NULL_HANDLE;
+        };
+
+        void createImages(DensityVolume& volume);
+		void createGlobalMajorantBuffer(DensityVolume& volume);
+        void resetGlobalMajorantBuffer(VkCommandBuffer commandBuffer, DensityVolume& volume);
+        void createDescriptorSetLayouts();
+        void createDescriptorSets(DensityVolume& volume);
 
         void createGenerationPipelineLayout();
-        void createGenerationPipeline(bool useCompiledSpirvFiles = true);
-
-        void createGlobalMajorantPipelineLayout();
-        void createGlobalMajorantPipeline(bool useCompiledSpirvFiles = true);
+        Unique<Pipeline> createGenerationPipeline(bool useCompiledSpirvFiles = true) const;
 
-        void createSliceImageViews(VkImageView* densitySliceImageView, VkImageView* majorantSliceImageView);
+        void createSliceImageViews(DensityVolume& volume, VkImageView* densitySliceImageView, VkImageView* majorantSliceImageView);
         void updateSliceImageViews();
 
-        void findMaxDensity(VkCommandBuffer commandBuffer);
+        /**
+         * @brief Returns how many slabs of bricks fit in the generation budget, using the
+         * measured GPU time of the previous slabs.
+         */
+        uint32_t computeSlabsThisFrame();
+
+        // Makes the back volume readable and swaps it with the front one
+        void completeGeneration(VkCommandBuffer commandBuffer);
 
         Context& m_context;
         Shared<DescriptorAllocatorGrowable> m_descriptorAllocator;
+        ReadbackService& m_readbackService;
 
         VkExtent3D m_densityTextureExtent;
         VkExtent3D m_majorantGridExtent;
 
-        Unique<VulkanImage> m_densityTexture;
-        Unique<VulkanImage> m_majorantGrid;
-        VkImageView m_densitySliceImageView;
-        VkImageView m_majorantGridSliceImageView;
+        // the volumes are written on the compute queue and read on the graphics one, so the
+        // barriers of the generation can only wait for (or make the writes available to) the
+        // stages of the compute queue; the rest is done by the semaphore
+        bool m_useAsyncCompute;
+        VkPipelineStageFlags m_volumeReadStage;
+
+        std::array<DensityVolume, 2> m_volumes;
+        uint32_t m_frontIndex = 0;
 
         Unique<DescriptorSetLayout> m_descriptorSetLayout;
 		Shared<DescriptorSetLayout> m_samplingDescriptorSetLayout;
         Shared<DescriptorSetLayout> m_imGuiDescriptorSetLayout;
-		VkDescriptorSet m_samplingDescriptorSet = VK_NULL_HANDLE;
-        VkDescriptorSet m_imGuiMajorantDescriptorSet = VK_NULL_HANDLE;
-        VkDescriptorSet m_imGuiDensityDescriptorSet = VK_NULL_HANDLE;
-        VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
 
         VkPipelineLayout m_generationPipelineLayout;
         Unique<Pipeline> m_generationPipeline;
-        VkPipelineLayout m_globalMajorantPipelineLayout;
-        Unique<Pipeline> m_globalMajorantPipeline;
 
-		Unique<VulkanBuffer> m_globalMajorantBuffer;
+        GpuTimer m_generationTimer;
+        std::array<uint32_t, SwapChain::MAX_FRAMES_IN_FLIGHT> m_timedSlabs{}; // slabs measured by the timer, per frame index
+        float m_msPerSlab = 0.0f; // smoothed GPU time of one slab, 0 until measured
+        float m_generationBudgetMs = DEFAULT_GENERATION_BUDGET_MS;
+        std::optional<GpuTimer::Interval> m_lastGenerationInterval;
 
 		float m_globalMajorant = 0.0f;
+        std::future<std::vector<uint8_t>> m_globalMajorantReadback;
 
         int m_noiseFrequency = 3;
         float m_worleyExponent = 2.0f;
 		int m_densitySliceIndex = 0; // For viewing a specific slice in the UI
         bool m_needsRegeneration = true;
-		bool m_hasRigeneratedThisFrame = false;
+
+        // state of the generation in progress (on the back volume)
+        bool m_isGenerating = false;
+        bool m_hasValidVolume = false; // false until the first generation is complete
+        uint32_t m_nextSlab = 0;
+        float m_generationNoiseFrequency = 0.0f;
+        float m_generationWorleyExponent = 0.0f;
 
         const std::string m_generationShaderPath = "density_texture.comp";
-		const std::string m_globalMajorantShaderPath = "global_majorant.comp";
     };
 
 }
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include "graphics/render_systems/master_render_system.hpp"
 
 #include "utils/vk_enum_str.h"
+#include "application.hpp"
 
 namespace PXTEngine {
 	MasterRenderSystem::MasterRenderSystem(Context& context, Renderer& renderer, 
 			Shared<DescriptorAllocatorGrowable> descriptorAllocator, 
+			ResourceManager& resourceManager,
 			TextureRegistry& textureRegistry, MaterialRegistry& materialRegistry, 
 			BLASRegistry& blasRegistry,
 			Shared<DescriptorSetLayout> globalSetLayout,
@@ -12,6 +14,7 @@ namespace PXTEngine {
 		:	m_context(context), 
 			m_renderer(renderer),
 			m_descriptorAllocator(std::move(descriptorAllocator)),
+			m_resourceManager(resourceManager),
 			m_textureRegistry(textureRegistry),
 		    m_materialRegistry(materialRegistry),
 			m_blasRegistry(blasRegistry),
@@ -40,6 +43,7 @@ namespace PXTEngine {
 		createSceneImage();
 		createOffscreenDepthResources();
 		createOffscreenFrameBuffer();
+		createFrameDescriptorAllocator();
 		createRenderSystems();
 		
 		createDescriptorSetsImGui();
@@ -153,7 +157,8 @@ namespace PXTEngine {
 		sceneImageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | // to be writable in a renderpass
 							   VK_IMAGE_USAGE_SAMPLED_BIT |			 // to be readable in a shader
 							   VK_IMAGE_USAGE_STORAGE_BIT |			 // to be writable for raytracing shaders
-							   VK_IMAGE_USAGE_TRANSFER_DST_BIT;		 // to copy to it later (denoised image)
+							   VK_IMAGE_USAGE_TRANSFER_DST_BIT |	 // to copy to it later (denoised image)
+							   VK_IMAGE_USAGE_TRANSFER_SRC_BIT;		 // to read it back (captures)
 		sceneImageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 		sceneImageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
@@ -272,13 +277,66 @@ namespace PXTEngine {
 		);
 	}
 
+	void MasterRenderSystem::createFrameDescriptorAllocator() {
+		// per frame we only need a handful of sets (tlas, emitters, volumes),
+		// pools grow on demand if more are requested
+		std::vector<PoolSizeRatio> ratios = {
+			{VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, 1.0f},
+			{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4.0f},
+			{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.0f},
+			{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f},
+		};
+
+		m_frameDescriptorAllocator = createShared<DescriptorAllocatorTransient>(m_context, 16, ratios);
+	}
+
 	void MasterRenderSystem::createRenderSystems() {
+		m_readbackService = createUnique<ReadbackService>(m_context);
+		m_frameCapture = createUnique<FrameCapture>(*m_readbackService);
+
+		if (m_context.hasAsyncCompute()) {
+			m_asyncComputeQueue = createUnique<AsyncComputeQueue>(m_context);
+		}
+
+		m_shaderReloader = createUnique<ShaderReloader>(m_context, m_asyncComputeQueue.get());
+
+		m_gpuScene = createUnique<GpuScene>(
+			m_context,
+			m_descriptorAllocator,
+			m_resourceManager,
+			m_materialRegistry,
+			m_blasRegistry,
+			m_textureRegistry
+		);
+
 		m_pointLightSystem = createUnique<PointLightSystem>(
 			m_context,
 			m_offscreenRenderPass->getHandle(),
 			m_globalSetLayout->getDescriptorSetLayout()
 		);
 
+		m_uiRenderSystem = createUnique<UiRenderSystem>(
+			m_context,
+			m_renderer.getSwapChainRenderPass()
+		);
+
+		m_skinningSystem = createUnique<SkinningSystem>(
+			m_context,
+			m_resourceManager,
+			m_blasRegistry
+		);
+
+		m_gpuScene->registerShaders(*m_shaderReloader);
+		m_pointLightSystem->registerShaders(*m_shaderReloader);
+		m_skinningSystem->registerShaders(*m_shaderReloader);
+
+		// the render path systems (pipelines, sbt, the density volume generation...) are left
+		// to createPendingRenderSystems, so the first frame only waits for the ones above
+	}
+
+	void MasterRenderSystem::createRasterRenderSystems() {
+		const auto startTime = std::chrono::steady_clock::now();
+
 		m_shadowMapRenderSystem = createUnique<ShadowMapRenderSystem>(
 			m_context,
 			m_descriptorAllocator,
@@ -289,24 +347,23 @@ namespace PXTEngine {
 			m_context,
 			m_descriptorAllocator,
 			m_textureRegistry,
+			m_materialRegistry,
+			*m_gpuScene,
+			m_environment,
 			*m_globalSetLayout,
 			m_offscreenRenderPass->getHandle(),
-			m_shadowMapRenderSystem->getShadowMapImageInfo()
+			*m_shadowMapRenderSystem
 		);
 
 		m_debugRenderSystem = createUnique<DebugRenderSystem>(
 			m_context,
 			m_descriptorAllocator,
+			m_resourceManager,
 			m_textureRegistry,
 			m_offscreenRenderPass->getHandle(),
 			*m_globalSetLayout
 		);
 
-		m_uiRenderSystem = createUnique<UiRenderSystem>(
-			m_context,
-			m_renderer.getSwapChainRenderPass()
-		);
-
 		m_skyboxRenderSystem = createUnique<SkyboxRenderSystem>(
 			m_context,
 			m_environment,
@@ -314,114 +371,182 @@ namespace PXTEngine {
 			m_offscreenRenderPass->getHandle()
 		);
 
+		m_shadowMapRenderSystem->registerShaders(*m_shaderReloader);
+		m_materialRenderSystem->registerShaders(*m_shaderReloader);
+		m_debugRenderSystem->registerShaders(*m_shaderReloader);
+		m_skyboxRenderSystem->registerShaders(*m_shaderReloader);
+
+		const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+		PXT_INFO("Rasterization render systems created in {:.1f} ms", elapsed.count());
+	}
+
+	void MasterRenderSystem::createRayTracingRenderSystems() {
+		const auto startTime = std::chrono::steady_clock::now();
+
+		// created with the current extent and scene image, the resizes before don't concern them
 		m_denoiserRenderSystem = createUnique<DenoiserRenderSystem>(
 			m_context,
 			m_descriptorAllocator,
-			m_renderer.getSwapChainExtent()
+			m_renderer.getSwapChainExtent(),
+			m_asyncComputeQueue.get()
 		);
 
 		m_densityTextureSystem = createUnique<DensityTextureRenderSystem>(
 			m_context,
 			m_descriptorAllocator,
+			*m_readbackService,
 			VkExtent3D{256, 256, 256},
-			VkExtent3D{ 32, 32, 32 }
+			VkExtent3D{ 32, 32, 32 },
+			m_asyncComputeQueue != nullptr
 		);
 
 		m_rayTracingRenderSystem = createUnique<RayTracingRenderSystem>(
 			m_context,
 			m_descriptorAllocator,
+			m_frameDescriptorAllocator,
 			m_textureRegistry,
 			m_materialRegistry,
-			m_blasRegistry,
+			*m_gpuScene,
 			m_environment,
 			*m_globalSetLayout,
 			m_sceneImage,
 			*m_densityTextureSystem
 		);
-	}
 
-	void MasterRenderSystem::reloadShaders() {
-		// wait for the device to be idle before reloading shaders
-		vkDeviceWaitIdle(m_context.getDevice());
+		m_denoiserRenderSystem->registerShaders(*m_shaderReloader);
+		m_densityTextureSystem->registerShaders(*m_shaderReloader);
+		m_rayTracingRenderSystem->registerShaders(*m_shaderReloader);
+
+		const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+		PXT_INFO("Raytracing render systems created in {:.1f} ms", elapsed.count());
+	}
 
-		PXT_INFO("Reloading shaders in MasterRenderSystem...");
+	void MasterRenderSystem::createPendingRenderSystems() {
+		// only the active render path is created, the other one waits for the user to switch to it
+		if (isRenderPathReady()) return;
 
-		// reload shaders in all render systems
 		if (m_isRaytracingEnabled) {
-			m_rayTracingRenderSystem->reloadShaders();
-			m_denoiserRenderSystem->reloadShaders();
+			createRayTracingRenderSystems();
 		} else {
-			m_materialRenderSystem->reloadShaders();
-			m_debugRenderSystem->reloadShaders();
-			m_skyboxRenderSystem->reloadShaders();
-			m_pointLightSystem->reloadShaders();
-			m_shadowMapRenderSystem->reloadShaders();
+			createRasterRenderSystems();
 		}
-		m_densityTextureSystem->reloadShaders();
+	}
 
-		PXT_INFO("Shaders reloaded successfully.");
+	bool MasterRenderSystem::isRenderPathReady() const {
+		return m_isRaytracingEnabled ? m_rayTracingRenderSystem != nullptr : m_materialRenderSystem != nullptr;
 	}
 
 	void MasterRenderSystem::onUpdate(FrameInfo& frameInfo, GlobalUbo& ubo) {
+		PXT_ALLOCATION_SCOPE("Renderer");
+
+		// the frame's timeline value was waited in Renderer::beginFrame, so the descriptor
+		// sets allocated the last time this frame index was recorded can be recycled
+		m_frameDescriptorAllocator->beginFrame(frameInfo.frameIndex);
+		m_readbackService->beginFrame(frameInfo.frameIndex);
+		if (m_asyncComputeQueue) m_asyncComputeQueue->beginFrame(frameInfo.frameIndex);
+
+		// swap in the pipelines rebuilt since the last frame, nothing has been recorded with them yet
+		m_shaderReloader->update();
+
 		// check if viewport size has changed, if so recreate resources
 		VkExtent2D swapChainExtent = m_renderer.getSwapChainExtent();
 		if (swapChainExtent.width != m_lastFrameSwapChainExtent.width ||
 			swapChainExtent.height != m_lastFrameSwapChainExtent.height) {
 			recreateViewportResources();
 
-			// update scene image for raytracing
-			m_rayTracingRenderSystem->updateSceneImage(m_sceneImage);
+			if (m_rayTracingRenderSystem) {
+				// update scene image for raytracing
+				m_rayTracingRenderSystem->updateSceneImage(m_sceneImage);
 
-			// update the denoiser's images with new extent
-			m_denoiserRenderSystem->updateImages(swapChainExtent);
+				// update the denoiser's images with new extent
+				m_denoiserRenderSystem->updateImages(swapChainExtent);
+			}
 
 			m_lastFrameSwapChainExtent = swapChainExtent;
 		}
 
-		// check if the user asked for the shaders to be reloaded
-		if (m_isReloadShadersButtonPressed) {
-			reloadShaders();
-
-			m_isReloadShadersButtonPressed = false;
-		}
-		
 		// update ubo buffer
 		ubo.projection = frameInfo.camera.getProjectionMatrix();
 		ubo.view = frameInfo.camera.getViewMatrix();
 		ubo.inverseView = frameInfo.camera.getInverseViewMatrix();
 
+		// deform the skinned meshes before anything reads their vertices or BLASes
+		m_skinningSystem->update(frameInfo, m_isRaytracingEnabled);
+
+		// upload the entities that changed to the scene buffer, read by both render paths
+		m_gpuScene->update(frameInfo, m_isRaytracingEnabled);
+
 		// update light values into ubo
 		m_pointLightSystem->update(frameInfo, ubo);
 
 		// update shadow map
-		m_shadowMapRenderSystem->update(frameInfo, ubo);
+		if (m_shadowMapRenderSystem) {
+			m_shadowMapRenderSystem->update(frameInfo, ubo);
+		}
+
+		if (m_materialRenderSystem) {
+			m_materialRenderSystem->update(ubo);
+		}
 
 		// update material descriptor set
 		m_materialRegistry.updateDescriptorSet(frameInfo.frameIndex);
 
 		// update raytracing scene
-		if (m_isRaytracingEnabled) {
+		if (m_isRaytracingEnabled && m_rayTracingRenderSystem) {
 			m_denoiserRenderSystem->update(ubo);
 			m_rayTracingRenderSystem->update(frameInfo);
 		}
 	}
 
 	void MasterRenderSystem::doRenderPasses(FrameInfo& frameInfo) {
+		PXT_ALLOCATION_SCOPE("Renderer");
+
 		// begin new frame imgui
 		m_uiRenderSystem->beginBuildingUi(frameInfo.scene);
 
-		if (m_densityTextureSystem->needsRegeneration()) {
-			m_densityTextureSystem->generate(frameInfo.commandBuffer);
+		if (m_densityTextureSystem && m_densityTextureSystem->needsRegeneration()) {
+			bool isVolumeSwapped = false;
+
+			if (m_asyncComputeQueue) {
+				// the generation runs in the background, the frame only waits for it
+				// when it is going to sample the newly generated volume
+				VkCommandBuffer computeCommandBuffer = m_asyncComputeQueue->begin(frameInfo.frameIndex);
+				isVolumeSwapped = m_densityTextureSystem->generate(computeCommandBuffer, frameInfo.frameIndex);
+
+				const uint64_t generationValue = m_asyncComputeQueue->submit(frameInfo.frameIndex);
+				if (isVolumeSwapped) {
+					m_renderer.addWaitSemaphore(m_asyncComputeQueue->getWait(generationValue, DensityTextureRenderSystem::VOLUME_READ_STAGES));
+				}
+			} else {
+				isVolumeSwapped = m_densityTextureSystem->generate(frameInfo.commandBuffer, frameInfo.frameIndex);
+			}
+
+			if (isVolumeSwapped) {
+				m_densityTextureSystem->readBackGlobalMajorant(frameInfo.commandBuffer);
+			}
 		}
 
+		// the ui below may switch the render path, the frame is recorded with the current one
+		const bool isRenderPathReady = this->isRenderPathReady();
+
 		// render to offscreen main render pass
-		if (m_isRaytracingEnabled) {
+		if (!isRenderPathReady) {
+			// nothing to render yet, the viewport shows a placeholder until postFrameUpdate creates the systems
+		} else if (m_isRaytracingEnabled) {
 			m_rayTracingRenderSystem->render(frameInfo, m_renderer);
 
 			// transition the scene image to shader_read_only_optimal layout for denoiser sampling
 			m_rayTracingRenderSystem->transitionImageToShaderReadOnlyOptimal(frameInfo, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR);
 
-			if (m_isDenoisingEnabled) {
+			if (m_isDenoisingEnabled && m_denoiserRenderSystem->isAsync()) {
+				// the frame is denoised in the background after it is submitted, and shows the
+				// output of the previous frame's denoise instead
+				if (auto denoiseWait = m_denoiserRenderSystem->swapDenoisedImage(frameInfo, m_sceneImage)) {
+					m_renderer.addWaitSemaphore(*denoiseWait);
+				}
+
+				m_rayTracingRenderSystem->transitionImageToShaderReadOnlyOptimal(frameInfo, VK_PIPELINE_STAGE_TRANSFER_BIT);
+			} else if (m_isDenoisingEnabled) {
 				m_denoiserRenderSystem->denoise(
 					frameInfo,
 					m_sceneImage
@@ -440,9 +565,7 @@ namespace PXTEngine {
 
 			m_renderer.endRenderPass(frameInfo.commandBuffer);*/
 		} else {
-			// render shadow cube map
-			// the render function of the shadow map render system will
-			// do how many passes it needs to do (6 in this case - 1 point light)
+			// render the shadow atlas tiles due this frame, and the table the lighting samples them with
 			m_shadowMapRenderSystem->render(frameInfo, m_renderer);
 
 			//begin offscreen render pass
@@ -464,6 +587,12 @@ namespace PXTEngine {
 			m_renderer.endRenderPass(frameInfo.commandBuffer, *m_offscreenRenderPass, *m_offscreenFb);
 		}
 
+		// the scene image is complete, read it back if a capture is requested
+		// (a capture requested before the first render waits for it)
+		if (isRenderPathReady) {
+			m_frameCapture->update(frameInfo.commandBuffer, *m_sceneImage, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+		}
+
 		// update scene ui
 		this->updateUi();
 
@@ -477,7 +606,16 @@ namespace PXTEngine {
 	}
 
 	void MasterRenderSystem::postFrameUpdate(FrameInfo& frameInfo) {
-		m_densityTextureSystem->postFrameUpdate(frameInfo.frameFence);
+		PXT_ALLOCATION_SCOPE("Renderer");
+
+		if (m_densityTextureSystem) m_densityTextureSystem->postFrameUpdate();
+
+		// the frame has been submitted, the denoise of its traced image can wait on it
+		if (m_denoiserRenderSystem) m_denoiserRenderSystem->submitDenoise(frameInfo);
+
+		// the frame with the placeholder has been presented, creating the systems now makes the
+		// wait visible instead of delaying the first frame (or freezing the last one on a switch)
+		createPendingRenderSystems();
 	}
 
 	void MasterRenderSystem::createDescriptorSetsImGui() {
@@ -538,6 +676,20 @@ namespace PXTEngine {
 		ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.0f, 0.0f));
 		ImGui::Begin("Viewport");
 
+		if (!isRenderPathReady()) {
+			// the scene image has not been rendered to yet
+			const char* placeholder = m_isRaytracingEnabled ? "Initializing raytracing..." : "Initializing rasterization...";
+			const ImVec2 windowSize = ImGui::GetContentRegionAvail();
+			const ImVec2 textSize = ImGui::CalcTextSize(placeholder);
+
+			ImGui::SetCursorPos(ImVec2((windowSize.x - textSize.x) * 0.5f, (windowSize.y + textSize.y) * 0.5f));
+			ImGui::TextUnformatted(placeholder);
+
+			ImGui::End();
+			ImGui::PopStyleVar();
+			return;
+		}
+
 		// we see the size of the window and we make the image fit the window with an aspect ratio
 		ImVec2 windowSize = ImGui::GetContentRegionAvail();
 		m_sceneImageExtentInWindow = getImageSizeWithAspectRatioForImGuiWindow(
@@ -565,13 +717,11 @@ namespace PXTEngine {
 		ImGui::Begin("Raytracing Renderer");
 		ImGui::Checkbox("Enable Raytracing", &m_isRaytracingEnabled);
 
-		ImGui::TextColored(ImVec4(0.8, 0.6, 0.1, 1.0),
-			"If changes were made to the %s shaders\n(prior of switching render type), you need to reload them!",
-			m_isRaytracingEnabled ? "Raytracing" : "Rasterization");
-
 		ImGui::Dummy(ImVec2(0.0f, 10.0f));
 
-		if (m_isRaytracingEnabled) {
+		if (m_isRaytracingEnabled && !m_rayTracingRenderSystem) {
+			ImGui::Text("Initializing...");
+		} else if (m_isRaytracingEnabled) {
 			m_rayTracingRenderSystem->updateUi();
 
 			ImGui::Begin("Denoiser Settings");
@@ -587,22 +737,73 @@ namespace PXTEngine {
 
 		ImGui::Begin("Debug Renderer");
 
-		m_isReloadShadersButtonPressed = (ImGui::Button("Reload Shaders", ImVec2(150, 0)));
+		m_shaderReloader->updateUi();
+		ImGui::Separator();
+
+		ImGui::Text("Scene objects: %u (%u uploaded)", m_gpuScene->getObjectCount(), m_gpuScene->getUploadedObjectCount());
+		if (m_materialRenderSystem) {
+			ImGui::Text("Material shader variants: %u", m_materialRenderSystem->getVariantCount());
+		} else {
+			ImGui::Text("Material shader variants: not created (rasterization not used yet)");
+		}
+		updateAsyncComputeUi();
 
 		ImGui::Checkbox("Enable Debug", &m_isDebugEnabled);
 
 		if (m_isDebugEnabled) {
 			ImGui::Text("Debug Renderer is enabled");
-			m_debugRenderSystem->updateUi();
-			m_densityTextureSystem->updateUi();
+			if (m_debugRenderSystem) m_debugRenderSystem->updateUi();
+			if (m_densityTextureSystem) m_densityTextureSystem->updateUi();
 		}
 		else {
 			ImGui::Text("Debug Renderer is disabled");
 		}
 		ImGui::End();
 
-		if (!m_isRaytracingEnabled) {
+		ImGui::Begin("Capture");
+		m_frameCapture->updateUi();
+		ImGui::End();
+
+		ImGui::Begin("Input Recording");
+		Application::get().getInputRecorder().updateUi();
+		ImGui::End();
+
+		ImGui::Begin("Allocations");
+		AllocationTracker::updateUi();
+		ImGui::Separator();
+		FrameArena::updateUi();
+		ImGui::End();
+
+		if (!m_isRaytracingEnabled && m_shadowMapRenderSystem) {
 			m_shadowMapRenderSystem->updateUi();
 		}
 	}
+
+	void MasterRenderSystem::updateAsyncComputeUi() {
+		ImGui::Text("Async compute: %s", m_asyncComputeQueue ? "enabled" : "not available (graphics queue)");
+
+		if (!m_densityTextureSystem) return;
+
+		// the denoise of a frame runs alongside the trace of the next one
+		const auto& denoiseInterval = m_denoiserRenderSystem->getLastDenoiseInterval();
+		if (m_isRaytracingEnabled && m_isDenoisingEnabled && denoiseInterval) {
+			ImGui::Text("Denoise: %.2f ms", denoiseInterval->getElapsedMs());
+
+			const auto& traceInterval = m_rayTracingRenderSystem->getLastTraceInterval();
+			if (traceInterval) {
+				ImGui::Text("Overlap with the next ray dispatch: %.2f ms", denoiseInterval->getOverlapMs(*traceInterval));
+			}
+		}
+
+		const auto& generationInterval = m_densityTextureSystem->getLastGenerationInterval();
+		if (!m_densityTextureSystem->needsRegeneration() || !generationInterval) return;
+
+		ImGui::Text("Volume generation: %.2f ms", generationInterval->getElapsedMs());
+
+		// both measures come from the same (previous) frame, the timestamps share the device time domain
+		const auto& traceInterval = m_rayTracingRenderSystem->getLastTraceInterval();
+		if (m_isRaytracingEnabled && traceInterval) {
+			ImGui::Text("Overlap with the ray dispatch: %.2f ms", generationInterval->getOverlapMs(*traceInterval));
+		}
+	}
 }
\ No newline at end of file
@@ -8,6 +8,12 @@
 #include "graphics/resources/texture_registry.hpp"
 #include "graphics/resources/material_registry.hpp"
 #include "graphics/resources/blas_registry.hpp"
+#include "resources/resource_manager.hpp"
+#include "graphics/readback_service.hpp"
+#include "graphics/frame_capture.hpp"
+#include "graphics/gpu_scene.hpp"
+#include "graphics/async_compute_queue.hpp"
+#include "graphics/shader_reloader.hpp"
 
 #include "graphics/render_systems/material_render_system.hpp"
 #include "graphics/render_systems/shadow_map_render_system.hpp"
@@ -18,6 +24,7 @@
 #include "graphics/render_systems/raytracing_render_system.hpp"
 #include "graphics/render_systems/denoiser_render_system.hpp"
 #include "graphics/render_systems/density_texture_system.hpp"
+#include "graphics/render_systems/skinning_system.hpp"
 #include "graphics/render_pass.hpp"
 #include "graphics/frame_buffer.hpp"
 
@@ -30,6 +37,7 @@ namespace PXTEngine {
 	public:
 		MasterRenderSystem(Context& context, Renderer& renderer, 
 						   Shared<DescriptorAllocatorGrowable> descriptorAllocator,
+						   ResourceManager& resourceManager,
 						   TextureRegistry& textureRegistry,
 						   MaterialRegistry& materialRegistry,
 						   BLASRegistry& blasRegistry,
@@ -47,15 +55,23 @@ namespace PXTEngine {
 		void doRenderPasses(FrameInfo& frameInfo);
 		void postFrameUpdate(FrameInfo& frameInfo);
 
+		// whether the systems of the active render path exist, the frames show a placeholder until then
+		bool isRenderPathReady() const;
+
 	private:
 		void recreateViewportResources();
 		void createRenderPass();
 		void createSceneImage();
 		void createOffscreenDepthResources();
 		void createOffscreenFrameBuffer();
+		void createFrameDescriptorAllocator();
 		void createRenderSystems();
 
-		void reloadShaders();
+		// the render systems used by only one of the render paths are created once a frame
+		// needing them has been shown, until then that frame displays a placeholder
+		void createRasterRenderSystems();
+		void createRayTracingRenderSystems();
+		void createPendingRenderSystems();
 
 		void createDescriptorSetsImGui();
 		void updateImguiDescriptorSet();
@@ -63,30 +79,53 @@ namespace PXTEngine {
 		ImVec2 getImageSizeWithAspectRatioForImGuiWindow(ImVec2 windowSize, float aspectRatio);
 		void updateSceneUi();
 		void updateUi();
+		void updateAsyncComputeUi();
 
 		Context& m_context;
 		Renderer& m_renderer;
+		ResourceManager& m_resourceManager;
 		TextureRegistry& m_textureRegistry;
 		MaterialRegistry& m_materialRegistry;
 		BLASRegistry& m_blasRegistry;
 
 		Shared<DescriptorAllocatorGrowable> m_descriptorAllocator;
 
+		// descriptor sets that only live for one frame, reset every frame in onUpdate
+		Shared<DescriptorAllocatorTransient> m_frameDescriptorAllocator;
+
 		Shared<DescriptorSetLayout> m_globalSetLayout{};
 
 		Shared<Environment> m_environment;
 
 		std::array<Unique<VulkanBuffer>, SwapChain::MAX_FRAMES_IN_FLIGHT> m_uboBuffers;
 
-		Unique<MaterialRenderSystem> m_materialRenderSystem = nullptr;
+		// declared before the render systems, which hold references to it
+		Unique<ReadbackService> m_readbackService = nullptr;
+		Unique<FrameCapture> m_frameCapture = nullptr;
+		Unique<GpuScene> m_gpuScene = nullptr;
+
+		// null when the device has no dedicated compute family, the compute work is then
+		// recorded into the frame's command buffer
+		Unique<AsyncComputeQueue> m_asyncComputeQueue = nullptr;
+
 		Unique<PointLightSystem> m_pointLightSystem = nullptr;
-		Unique<ShadowMapRenderSystem> m_shadowMapRenderSystem = nullptr;
 		Unique<UiRenderSystem> m_uiRenderSystem = nullptr;
+		Unique<SkinningSystem> m_skinningSystem = nullptr;
+
+		// rasterization only, null until createRasterRenderSystems
+		Unique<ShadowMapRenderSystem> m_shadowMapRenderSystem = nullptr;
+		Unique<MaterialRenderSystem> m_materialRenderSystem = nullptr;
 		Unique<DebugRenderSystem> m_debugRenderSystem = nullptr;
 		Unique<SkyboxRenderSystem> m_skyboxRenderSystem = nullptr;
-		Unique<RayTracingRenderSystem> m_rayTracingRenderSystem = nullptr;
+
+		// raytracing only, null until createRayTracingRenderSystems
 		Unique<DenoiserRenderSystem> m_denoiserRenderSystem = nullptr;
 		Unique<DensityTextureRenderSystem> m_densityTextureSystem = nullptr;
+		Unique<RayTracingRenderSystem> m_rayTracingRenderSystem = nullptr;
+
+		// declared after the render systems so that it is destroyed first: its workers may be
+		// building their pipelines
+		Unique<ShaderReloader> m_shaderReloader = nullptr;
 
 		Unique<RenderPass> m_offscreenRenderPass;
 		Unique<FrameBuffer> m_offscreenFb;
@@ -103,7 +142,6 @@ namespace PXTEngine {
 
 		bool m_isDebugEnabled = false;
 		bool m_isRaytracingEnabled = true;
-		bool m_isReloadShadersButtonPressed = false;
 		bool m_isDenoisingEnabled = true;
 	};
 }
\ No newline at end of file
@@ -1,52 +1,129 @@
 #include "graphics/render_systems/material_render_system.hpp"
 
 #include "graphics/resources/vk_mesh.hpp"
+#include "graphics/resources/vk_skybox.hpp"
+#include "graphics/ibl_baker.hpp"
 #include "scene/ecs/entity.hpp"
 
 namespace PXTEngine {
 
+    // the object data and its material are read from the scene and material buffers
     struct MaterialPushConstantData {
-        glm::mat4 modelMatrix{1.f};
-        glm::mat4 normalMatrix{1.f};
-        glm::vec4 color{1.f};
-        float specularIntensity = 0.0f;
-        float shininess = 1.0f;
-        int textureIndex = 0;
-        int normalMapIndex = 1;
-        int ambientOcclusionMapIndex = 0;
-        int metallicMapIndex = 0;
-		int roughnessMapIndex = 0;
-		float tilingFactor = 1.0f;
+        uint32_t objectIndex = 0;
+    };
+
+    struct MaterialDraw {
+        MaterialFeatureKey features;
+        uint32_t objectIndex;
+        VulkanMesh* mesh;
     };
 
     MaterialRenderSystem::MaterialRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator,
-    	TextureRegistry& textureRegistry, DescriptorSetLayout& globalSetLayout,
-    	VkRenderPass renderPass, VkDescriptorImageInfo shadowMapImageInfo)
+    	TextureRegistry& textureRegistry, MaterialRegistry& materialRegistry, GpuScene& gpuScene,
+    	Shared<Environment> environment, DescriptorSetLayout& globalSetLayout,
+    	VkRenderPass renderPass, ShadowMapRenderSystem& shadowMapRenderSystem)
         : m_context(context),
         m_descriptorAllocator(descriptorAllocator),
         m_textureRegistry(textureRegistry),
-        m_renderPassHandle(renderPass)
+        m_materialRegistry(materialRegistry),
+        m_gpuScene(gpuScene),
+        m_environment(environment),
+        m_renderPassHandle(renderPass),
+        m_shadowMapRenderSystem(shadowMapRenderSystem)
     {
-		createDescriptorSets(shadowMapImageInfo);
+        m_brdfLut = IBLBaker(m_context).createBRDFLUT();
+
+		createDescriptorSets();
         createPipelineLayout(globalSetLayout);
-        createPipeline();
+
+        // the precompiled variant, the others are compiled when a material needs them
+        getPipeline(MATERIAL_FEATURE_ALL);
     }
 
-    MaterialRenderSystem::~MaterialRenderSystem() {
-        vkDestroyPipelineLayout(m_context.getDevice(), m_pipelineLayout, nullptr);
+    MaterialRenderSystem::~MaterialRenderSystem() = default;
+
+    void MaterialRenderSystem::createDescriptorSets() {
+        // ENVIRONMENT LIGHTING DESCRIPTOR SET
+        m_environmentDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
+            .addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
+            .addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
+            .build();
+
+        m_descriptorAllocator->allocate(m_environmentDescriptorSetLayout->getDescriptorSetLayout(), m_environmentDescriptorSet);
+
+        writeEnvironmentDescriptorSet();
     }
 
-    void MaterialRenderSystem::createDescriptorSets(VkDescriptorImageInfo shadowMapImageInfo) {
-        // SHADOW MAP DESCRIPTOR SET
-		m_shadowMapDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
-			.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
-			.build();
+    void MaterialRenderSystem::createBlackPrefilteredMap() {
+        m_blackPrefilteredMap = createUnique<CubeMap>(
+            m_context,
+            1,
+            VK_FORMAT_R8G8B8A8_UNORM,
+            VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
+        );
+
+        constexpr VkDeviceSize faceImageSize = 4;
+        const std::array<uint8_t, faceImageSize * 6> pixels{};
+
+        VulkanBuffer stagingBuffer(
+            m_context,
+            pixels.size(),
+            1, // instance count
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        );
+        stagingBuffer.map();
+        stagingBuffer.writeToBuffer((void*) pixels.data(), pixels.size());
 
-		m_descriptorAllocator->allocate(m_shadowMapDescriptorSetLayout->getDescriptorSetLayout(), m_shadowMapDescriptorSet);
+        VkImageSubresourceRange subresourceRange{};
+        subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        subresourceRange.baseMipLevel = 0;
+        subresourceRange.levelCount = 1;
+        subresourceRange.baseArrayLayer = 0;
+        subresourceRange.layerCount = 6;
 
-		DescriptorWriter(m_context, *m_shadowMapDescriptorSetLayout)
-			.writeImage(0, &shadowMapImageInfo)
-			.updateSet(m_shadowMapDescriptorSet);
+        m_blackPrefilteredMap->transitionImageLayoutSingleTimeCmd(
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            subresourceRange
+        );
+
+        m_context.copyBufferToImage(stagingBuffer.getBuffer(), m_blackPrefilteredMap->getVkImage(), 1, 1, 6);
+
+        m_blackPrefilteredMap->transitionImageLayoutSingleTimeCmd(
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            subresourceRange
+        );
+    }
+
+    void MaterialRenderSystem::writeEnvironmentDescriptorSet() {
+        // keeps the skybox alive as long as the set points to its prefiltered map
+        m_boundSkybox = m_environment->getSkybox();
+
+        // the irradiance comes from the global ubo, here we only need the specular part
+        VkDescriptorImageInfo prefilteredImageInfo{};
+        if (m_boundSkybox) {
+            prefilteredImageInfo = std::static_pointer_cast<VulkanSkybox>(m_boundSkybox)->getPrefilteredImageInfo();
+        } else {
+            // without a skybox the environment has no specular reflections
+            if (!m_blackPrefilteredMap) {
+                createBlackPrefilteredMap();
+            }
+
+            prefilteredImageInfo.sampler = m_blackPrefilteredMap->getImageSampler();
+            prefilteredImageInfo.imageView = m_blackPrefilteredMap->getImageView();
+            prefilteredImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+
+        VkDescriptorImageInfo brdfLutImageInfo = m_brdfLut->getImageInfo();
+
+        DescriptorWriter(m_context, *m_environmentDescriptorSetLayout)
+            .writeImage(0, &prefilteredImageInfo)
+            .writeImage(1, &brdfLutImageInfo)
+            .updateSet(m_environmentDescriptorSet);
     }
 
     void MaterialRenderSystem::createPipelineLayout(DescriptorSetLayout& globalSetLayout) {
@@ -58,7 +135,10 @@ namespace PXTEngine {
         std::vector<VkDescriptorSetLayout> descriptorSetLayouts{
             globalSetLayout.getDescriptorSetLayout(),
             m_textureRegistry.getDescriptorSetLayout(),
-            m_shadowMapDescriptorSetLayout->getDescriptorSetLayout()
+            m_shadowMapRenderSystem.getLightingSetLayout().getDescriptorSetLayout(),
+            m_environmentDescriptorSetLayout->getDescriptorSetLayout(),
+            m_gpuScene.getDescriptorSetLayout(),
+            m_materialRegistry.getDescriptorSetLayout()
         };
 
         VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
@@ -68,12 +148,10 @@ namespace PXTEngine {
         pipelineLayoutInfo.pushConstantRangeCount = 1;
         pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create pipeline layout!");
-        }
+        m_pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
     }
 
-    void MaterialRenderSystem::createPipeline(bool useCompiledSpirvFiles) {
+    Unique<Pipeline> MaterialRenderSystem::createPipeline(const MaterialFeatureKey features, bool useCompiledSpirvFiles) const {
         PXT_ASSERT(m_pipelineLayout != nullptr, "Cannot create pipeline before pipelineLayout");
 
         RasterizationPipelineConfigInfo pipelineConfig{};
@@ -81,6 +159,9 @@ namespace PXTEngine {
         pipelineConfig.renderPass = m_renderPassHandle;
         pipelineConfig.pipelineLayout = m_pipelineLayout;
 
+        // only the variant with every feature is precompiled, it needs no defines
+        useCompiledSpirvFiles = useCompiledSpirvFiles && features == MATERIAL_FEATURE_ALL;
+
         const std::string baseShaderPath = useCompiledSpirvFiles ? SPV_SHADERS_PATH : SHADERS_PATH;
         const std::string filenameSuffix = useCompiledSpirvFiles ? ".spv" : "";
 
@@ -89,17 +170,71 @@ namespace PXTEngine {
             shaderFilePaths.push_back(baseShaderPath + filePath + filenameSuffix);
 		};
 
-        m_pipeline = createUnique<Pipeline>(
+        std::vector<std::pair<std::string, std::string>> definitions;
+        if (!useCompiledSpirvFiles) {
+            definitions = getMaterialFeatureDefinitions(features);
+        }
+
+        return createUnique<Pipeline>(
             m_context,
             shaderFilePaths,
-            pipelineConfig
+            pipelineConfig,
+            definitions
         );
     }
 
+    Pipeline& MaterialRenderSystem::getPipeline(const MaterialFeatureKey features) {
+        auto [it, isNew] = m_pipelines.try_emplace(features, nullptr);
+        if (isNew) {
+            PXT_INFO("Compiling material shader variant {:#x}", features);
+            it->second = createPipeline(features, m_useCompiledSpirvFiles);
+        }
+        return *it->second;
+    }
+
+    void MaterialRenderSystem::update(const GlobalUbo& ubo) {
+        m_hasPointLights = ubo.numLights > 0;
+    }
+
     void MaterialRenderSystem::render(FrameInfo& frameInfo) {
-        m_pipeline->bind(frameInfo.commandBuffer);
+        // the packets were brought up to date by the gpu scene this frame
+        FrameVector<MaterialDraw> draws;
+
+        if (m_environment->getSkybox() != m_boundSkybox) {
+            // the frames in flight may still be sampling the previous prefiltered map
+            m_context.getFrameTimeline().waitIdle();
+            writeEnvironmentDescriptorSet();
+        }
 
-        std::array<VkDescriptorSet, 3> descriptorSets = { frameInfo.globalDescriptorSet, m_textureRegistry.getDescriptorSet(), m_shadowMapDescriptorSet};
+        // the lighting features are the same for every draw of the frame, the table of the
+        // shadow atlas was written by the shadow pass recorded before
+        MaterialFeatureKey lightingFeatures = 0;
+        if (m_hasPointLights) {
+            lightingFeatures |= MATERIAL_FEATURE_POINT_LIGHTS;
+            if (m_shadowMapRenderSystem.getPublishedLightCount() > 0) lightingFeatures |= MATERIAL_FEATURE_SHADOWS;
+        }
+
+        auto view = frameInfo.scene.getEntitiesWith<RenderPacketComponent, MaterialComponent>();
+        for (auto entity : view) {
+            const auto& packet = view.get<RenderPacketComponent>(entity);
+            if (packet.objectIndex == RenderPacketComponent::INVALID_INDEX) continue;
+
+            draws.push_back({ packet.materialFeatures | lightingFeatures, packet.objectIndex, static_cast<VulkanMesh*>(packet.mesh) });
+        }
+
+        // one pipeline bind per variant, the draws of a mesh are kept together inside it
+        std::sort(draws.begin(), draws.end(), [](const MaterialDraw& a, const MaterialDraw& b) {
+            return a.features != b.features ? a.features < b.features : a.mesh < b.mesh;
+        });
+
+        std::array<VkDescriptorSet, 6> descriptorSets = {
+            frameInfo.globalDescriptorSet,
+            m_textureRegistry.getDescriptorSet(),
+            m_shadowMapRenderSystem.getLightingDescriptorSet(frameInfo.frameIndex),
+            m_environmentDescriptorSet,
+            m_gpuScene.getDescriptorSet(),
+            m_materialRegistry.getDescriptorSet(frameInfo.frameIndex)
+        };
 
         vkCmdBindDescriptorSets(
             frameInfo.commandBuffer,
@@ -112,26 +247,18 @@ namespace PXTEngine {
             nullptr
         );
 
-        auto view = frameInfo.scene.getEntitiesWith<TransformComponent, MeshComponent, MaterialComponent>();
-        for (auto entity : view) {
-
-            const auto&[transform, meshComponent, materialComponent] = view.get<TransformComponent, MeshComponent, MaterialComponent>(entity);
+        // the descriptor sets stay bound across the variants, they share the pipeline layout
+        constexpr MaterialFeatureKey noVariant = std::numeric_limits<MaterialFeatureKey>::max();
+        MaterialFeatureKey boundFeatures = noVariant;
 
-			auto material = materialComponent.material;
-            auto vulkanMesh = std::static_pointer_cast<VulkanMesh>(meshComponent.mesh);
+        for (const MaterialDraw& draw : draws) {
+            if (draw.features != boundFeatures) {
+                getPipeline(draw.features).bind(frameInfo.commandBuffer);
+                boundFeatures = draw.features;
+            }
 
             MaterialPushConstantData push{};
-            push.modelMatrix = transform.mat4();
-            push.normalMatrix = transform.normalMatrix();
-            push.color = material->getAlbedoColor() * glm::vec4(materialComponent.tint, 1.0f);
-            push.specularIntensity = material->getBlinnPhongSpecularIntensity();
-            push.shininess = material->getBlinnPhongSpecularShininess();
-            push.textureIndex = m_textureRegistry.getIndex(material->getAlbedoMap()->id);
-            push.normalMapIndex = m_textureRegistry.getIndex(material->getNormalMap()->id);
-			//push.metallicMapIndex = m_textureRegistry.getIndex(material->getMetallicMap()->id);
-			//push.roughnessMapIndex = m_textureRegistry.getIndex(material->getRoughnessMap()->id);
-            push.ambientOcclusionMapIndex = m_textureRegistry.getIndex(material->getAmbientOcclusionMap()->id);
-            push.tilingFactor = materialComponent.tilingFactor;
+            push.objectIndex = draw.objectIndex;
 
             vkCmdPushConstants(
                 frameInfo.commandBuffer,
@@ -141,14 +268,41 @@ namespace PXTEngine {
                 sizeof(MaterialPushConstantData),
                 &push);
             
-            vulkanMesh->bind(frameInfo.commandBuffer);
-            vulkanMesh->draw(frameInfo.commandBuffer);
-
+            draw.mesh->bind(frameInfo.commandBuffer);
+            draw.mesh->draw(frameInfo.commandBuffer);
         }
     }
 
-    void MaterialRenderSystem::reloadShaders() {
-        PXT_INFO("Reloading shaders...");
-		createPipeline(false);
+    void MaterialRenderSystem::registerShaders(ShaderReloader& shaderReloader) {
+        std::vector<std::filesystem::path> sourceFiles;
+        for (const auto& filePath : m_shaderFilePaths) {
+            sourceFiles.push_back(SHADERS_PATH + filePath);
+        }
+
+        shaderReloader.add("Material", sourceFiles, [this] {
+            // every variant is compiled from source from now on, the ones compiled so far are
+            // rebuilt in the background, the ones needed meanwhile are compiled on first use
+            m_useCompiledSpirvFiles = false;
+
+            std::vector<MaterialFeatureKey> variants;
+            for (const auto& [features, pipeline] : m_pipelines) {
+                variants.push_back(features);
+            }
+
+            return ShaderReloader::Reload{
+                [this, variants] {
+                    std::vector<Unique<Pipeline>> pipelines;
+                    for (const MaterialFeatureKey features : variants) {
+                        pipelines.push_back(createPipeline(features, false));
+                    }
+                    return pipelines;
+                },
+                [this, variants](std::vector<Unique<Pipeline>>& pipelines) {
+                    for (size_t i = 0; i < variants.size(); i++) {
+                        std::swap(m_pipelines[variants[i]], pipelines[i]);
+                    }
+                }
+            };
+        });
     }
 }
\ No newline at end of file
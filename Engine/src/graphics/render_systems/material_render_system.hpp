@@ -2,42 +2,93 @@
 
 #include "core/pch.hpp"
 #include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
 #include "graphics/swap_chain.hpp"
 #include "graphics/context/context.hpp"
 #include "graphics/frame_info.hpp"
 #include "graphics/descriptors/descriptors.hpp"
 #include "graphics/resources/texture_registry.hpp"
+#include "graphics/resources/material_registry.hpp"
+#include "graphics/gpu_scene.hpp"
+#include "graphics/resources/cube_map.hpp"
+#include "graphics/material_shader_variants.hpp"
+#include "graphics/render_systems/shadow_map_render_system.hpp"
 #include "scene/scene.hpp"
+#include "scene/environment.hpp"
 
 namespace PXTEngine {
 
+    /**
+     * @class MaterialRenderSystem
+     *
+     * @brief Draws the entities with a material in the raster path.
+     *
+     * material_shader.frag is compiled in one variant per MaterialFeatureKey, so that a material
+     * only pays for the maps it has, and the frames without lights or shadows for neither. The variants are compiled from source the first time a
+     * material needs them and cached, the draws are sorted by variant to bind each pipeline once.
+     */
     class MaterialRenderSystem {
     public:
-        MaterialRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, TextureRegistry& textureRegistry, DescriptorSetLayout& globalSetLayout, VkRenderPass renderPass, VkDescriptorImageInfo shadowMapImageInfo);
+        MaterialRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, TextureRegistry& textureRegistry, MaterialRegistry& materialRegistry, GpuScene& gpuScene, Shared<Environment> environment, DescriptorSetLayout& globalSetLayout, VkRenderPass renderPass, ShadowMapRenderSystem& shadowMapRenderSystem);
         ~MaterialRenderSystem();
 
         MaterialRenderSystem(const MaterialRenderSystem&) = delete;
         MaterialRenderSystem& operator=(const MaterialRenderSystem&) = delete;
 
+        /**
+         * @brief Records whether the frame has point lights, the light loop is compiled out of
+         * the variants of the frames without.
+         */
+        void update(const GlobalUbo& ubo);
+
+        /**
+         * @brief Draws the entities, must be recorded after the shadow atlas of the frame.
+         */
         void render(FrameInfo& frameInfo);
-        void reloadShaders();
+        void registerShaders(ShaderReloader& shaderReloader);
+
+        // the shader variants compiled so far, for the ui
+        uint32_t getVariantCount() const { return static_cast<uint32_t>(m_pipelines.size()); }
 
     private:
-        void createDescriptorSets(VkDescriptorImageInfo shadowMapImageInfo);
+        void createDescriptorSets();
+        void createBlackPrefilteredMap();
+
+        /**
+         * @brief Points the environment set to the prefiltered map of the current skybox, or
+         * to a black cube map when the environment has none.
+         */
+        void writeEnvironmentDescriptorSet();
         void createPipelineLayout(DescriptorSetLayout& globalSetLayout);
-        void createPipeline(bool useCompiledSpirvFiles = true);
+        Unique<Pipeline> createPipeline(MaterialFeatureKey features, bool useCompiledSpirvFiles) const;
+
+        /**
+         * @brief The pipeline of a shader variant, compiled on first use.
+         */
+        Pipeline& getPipeline(MaterialFeatureKey features);
         
         Context& m_context;
         TextureRegistry& m_textureRegistry;
+        MaterialRegistry& m_materialRegistry;
+        GpuScene& m_gpuScene;
 
 		VkRenderPass m_renderPassHandle;
-        Unique<Pipeline> m_pipeline;
+        std::unordered_map<MaterialFeatureKey, Unique<Pipeline>> m_pipelines;
         VkPipelineLayout m_pipelineLayout;
+        bool m_useCompiledSpirvFiles = true;
+        bool m_hasPointLights = true;
 
 		Shared<DescriptorAllocatorGrowable> m_descriptorAllocator;
 
-        Unique<DescriptorSetLayout> m_shadowMapDescriptorSetLayout{};
-        VkDescriptorSet m_shadowMapDescriptorSet{};
+        // owns the shadow atlas set, its light to tile table changes every frame
+        ShadowMapRenderSystem& m_shadowMapRenderSystem;
+
+        Shared<Environment> m_environment;
+        Unique<VulkanImage> m_brdfLut;
+        Unique<DescriptorSetLayout> m_environmentDescriptorSetLayout{};
+        VkDescriptorSet m_environmentDescriptorSet{};
+        Shared<Skybox> m_boundSkybox;
+        Unique<CubeMap> m_blackPrefilteredMap;
 
         std::array<const std::string, 2> m_shaderFilePaths = {
             "material_shader.vert",
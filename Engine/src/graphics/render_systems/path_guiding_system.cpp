@@ -0,0 +1,292 @@
+#include "graphics/render_systems/path_guiding_system.hpp"
+#include "graphics/raytracing_scene_data.hpp"
+#include "scene/ecs/component.hpp"
+
+namespace PXTEngine {
+
+	// GuidingGridSSBO in path_guiding.glsl
+	struct alignas(16) GuidingGridData {
+		glm::vec4 origin;      // xyz: min corner of the grid in world space
+		glm::vec4 invCellSize; // xyz: cells per world unit
+	};
+
+	// Push in path_guiding_training.comp
+	struct GuidingTrainingPushConstantData {
+		float estimateDecay;
+	};
+
+	PathGuidingSystem::PathGuidingSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator)
+		: m_context(context),
+		m_descriptorAllocator(descriptorAllocator) {
+		createBuffers();
+		createDescriptorSet();
+		createPipelineLayout();
+		m_trainingPipeline = createTrainingPipeline();
+	}
+
+	PathGuidingSystem::~PathGuidingSystem() = default;
+
+	void PathGuidingSystem::createBuffers() {
+		// only ever written on the GPU: cleared by the resets, splatted by the path tracer, trained
+		auto createBuffer = [this](const VkDeviceSize instanceSize, const uint32_t instanceCount) {
+			return createUnique<VulkanBuffer>(
+				m_context,
+				instanceSize,
+				instanceCount,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+			);
+		};
+
+		m_gridBuffer = createBuffer(sizeof(GuidingGridData), 1);
+		m_splatBuffer = createBuffer(sizeof(uint32_t), CELL_COUNT * BIN_COUNT);
+		m_sampleCountBuffer = createBuffer(sizeof(uint32_t), CELL_COUNT);
+		m_estimateBuffer = createBuffer(sizeof(float), CELL_COUNT * BIN_COUNT);
+		m_cdfBuffer = createBuffer(sizeof(float), CELL_COUNT * BIN_COUNT);
+		m_cellBuffer = createBuffer(sizeof(glm::vec2), CELL_COUNT);
+	}
+
+	void PathGuidingSystem::createDescriptorSet() {
+		// the path tracer samples and splats, the training pass reads the splats and writes the rest
+		constexpr VkShaderStageFlags stages = VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR |
+			VK_SHADER_STAGE_COMPUTE_BIT;
+
+		m_descriptorSetLayout = DescriptorSetLayout::Builder(m_context)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages) // grid
+			.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages) // splats
+			.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages) // sample counts
+			.addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages) // estimates
+			.addBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages) // cdfs
+			.addBinding(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, stages) // cells
+			.build();
+
+		m_descriptorAllocator->allocate(m_descriptorSetLayout->getDescriptorSetLayout(), m_descriptorSet);
+
+		VkDescriptorBufferInfo gridInfo = m_gridBuffer->descriptorInfo();
+		VkDescriptorBufferInfo splatInfo = m_splatBuffer->descriptorInfo();
+		VkDescriptorBufferInfo sampleCountInfo = m_sampleCountBuffer->descriptorInfo();
+		VkDescriptorBufferInfo estimateInfo = m_estimateBuffer->descriptorInfo();
+		VkDescriptorBufferInfo cdfInfo = m_cdfBuffer->descriptorInfo();
+		VkDescriptorBufferInfo cellInfo = m_cellBuffer->descriptorInfo();
+
+		DescriptorWriter(m_context, *m_descriptorSetLayout)
+			.writeBuffer(0, &gridInfo)
+			.writeBuffer(1, &splatInfo)
+			.writeBuffer(2, &sampleCountInfo)
+			.writeBuffer(3, &estimateInfo)
+			.writeBuffer(4, &cdfInfo)
+			.writeBuffer(5, &cellInfo)
+			.updateSet(m_descriptorSet);
+	}
+
+	void PathGuidingSystem::createPipelineLayout() {
+		std::vector<VkDescriptorSetLayout> descriptorSetLayouts{ m_descriptorSetLayout->getDescriptorSetLayout() };
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size());
+		pipelineLayoutInfo.pSetLayouts = descriptorSetLayouts.data();
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(GuidingTrainingPushConstantData);
+
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		m_pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
+	}
+
+	Unique<Pipeline> PathGuidingSystem::createTrainingPipeline(bool useCompiledSpirvFiles) const {
+		PXT_ASSERT(m_pipelineLayout != nullptr, "Cannot create pipeline before pipeline layout");
+
+		ComputePipelineConfigInfo pipelineConfig{};
+		pipelineConfig.pipelineLayout = m_pipelineLayout;
+
+		const std::string baseShaderPath = useCompiledSpirvFiles ? SPV_SHADERS_PATH : SHADERS_PATH + "raytracing/guiding/";
+		const std::string filenameSuffix = useCompiledSpirvFiles ? ".spv" : "";
+		std::string shaderFilePath = baseShaderPath + m_trainingShaderPath + filenameSuffix;
+
+		return createUnique<Pipeline>(m_context, shaderFilePath, pipelineConfig);
+	}
+
+	void PathGuidingSystem::update(FrameInfo& frameInfo, const uint32_t objectCount, const bool hasObjectsChanged) {
+		bool isStructuralChange = m_needsReset || objectCount != m_objectCount;
+
+		// the bounds only change with the uploads, they aren't gathered on the other frames
+		glm::vec3 boundsMin{ 0.0f };
+		glm::vec3 boundsMax{ 0.0f };
+		if (isStructuralChange || hasObjectsChanged) {
+			computeSceneBounds(frameInfo, boundsMin, boundsMax);
+			isStructuralChange = isStructuralChange || !isGridFitting(boundsMin, boundsMax);
+		}
+
+		// the light found before the change may now be blocked, or come from elsewhere
+		if (isStructuralChange) {
+			reset(frameInfo.commandBuffer, boundsMin, boundsMax);
+			m_objectCount = objectCount;
+			m_needsReset = false;
+		}
+
+		if (!m_isEnabled) return;
+
+		// moved objects change the light of their surroundings, the older paths weigh less
+		train(frameInfo.commandBuffer, hasObjectsChanged && !isStructuralChange ? MOVED_OBJECTS_DECAY : 1.0f);
+		m_trainedFrames++;
+	}
+
+	void PathGuidingSystem::computeSceneBounds(FrameInfo& frameInfo, glm::vec3& boundsMin, glm::vec3& boundsMax) const {
+		// the grid covers the bounding spheres of the rendered objects, the
+		// vertices out of it (e.g. on the sky dome) go to the closest cells
+		boundsMin = glm::vec3{ std::numeric_limits<float>::max() };
+		boundsMax = glm::vec3{ std::numeric_limits<float>::lowest() };
+
+		auto view = frameInfo.scene.getEntitiesWith<RenderPacketComponent>();
+		for (auto entity : view) {
+			const auto& packet = view.get<RenderPacketComponent>(entity);
+			if (packet.mesh == nullptr || packet.objectIndex == RenderPacketComponent::INVALID_INDEX) continue;
+
+			const glm::vec4 sphere = RayTracingSceneData::transformBoundingSphere(packet.mesh->getBoundingSphere(), packet.objectToWorld);
+			boundsMin = glm::min(boundsMin, glm::vec3(sphere) - sphere.w);
+			boundsMax = glm::max(boundsMax, glm::vec3(sphere) + sphere.w);
+		}
+
+		if (boundsMin.x > boundsMax.x) {
+			boundsMin = glm::vec3(-1.0f);
+			boundsMax = glm::vec3(1.0f);
+		}
+	}
+
+	bool PathGuidingSystem::isGridFitting(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const {
+		const glm::vec3 gridExtent = m_gridMax - m_gridMin;
+		const float tolerance = std::max({ gridExtent.x, gridExtent.y, gridExtent.z }) * BOUNDS_CHANGE_TOLERANCE;
+
+		const glm::vec3 minOffset = glm::abs(boundsMin - m_gridMin);
+		const glm::vec3 maxOffset = glm::abs(boundsMax - m_gridMax);
+
+		return std::max({ minOffset.x, minOffset.y, minOffset.z, maxOffset.x, maxOffset.y, maxOffset.z }) <= tolerance;
+	}
+
+	void PathGuidingSystem::reset(VkCommandBuffer commandBuffer, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+		m_gridMin = boundsMin;
+		m_gridMax = boundsMax;
+		m_trainedFrames = 0;
+
+		const glm::vec3 extent = glm::max(boundsMax - boundsMin, glm::vec3(0.001f));
+
+		GuidingGridData gridData{};
+		gridData.origin = glm::vec4(boundsMin, 0.0f);
+		gridData.invCellSize = glm::vec4(static_cast<float>(GRID_RESOLUTION) / extent, 0.0f);
+
+		// after the previous frames have traced and trained with the buffers
+		VkMemoryBarrier memoryBarrier{};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0,
+			1, &memoryBarrier,
+			0, nullptr,
+			0, nullptr
+		);
+
+		vkCmdUpdateBuffer(commandBuffer, m_gridBuffer->getBuffer(), 0, sizeof(GuidingGridData), &gridData);
+		vkCmdFillBuffer(commandBuffer, m_splatBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+		vkCmdFillBuffer(commandBuffer, m_sampleCountBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+		vkCmdFillBuffer(commandBuffer, m_estimateBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+		vkCmdFillBuffer(commandBuffer, m_cdfBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+		// a cell with no estimate is never sampled, the cdfs don't need to be valid
+		vkCmdFillBuffer(commandBuffer, m_cellBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+
+		memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0,
+			1, &memoryBarrier,
+			0, nullptr,
+			0, nullptr
+		);
+	}
+
+	void PathGuidingSystem::train(VkCommandBuffer commandBuffer, const float estimateDecay) {
+		// the splats of the previous frame's trace (recorded before on the same queue)
+		VkMemoryBarrier memoryBarrier{};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0,
+			1, &memoryBarrier,
+			0, nullptr,
+			0, nullptr
+		);
+
+		m_trainingPipeline->bind(commandBuffer);
+		vkCmdBindDescriptorSets(
+			commandBuffer,
+			VK_PIPELINE_BIND_POINT_COMPUTE,
+			m_pipelineLayout,
+			0, 1, &m_descriptorSet,
+			0, nullptr
+		);
+
+		GuidingTrainingPushConstantData push{};
+		push.estimateDecay = estimateDecay;
+
+		vkCmdPushConstants(
+			commandBuffer,
+			m_pipelineLayout,
+			VK_SHADER_STAGE_COMPUTE_BIT,
+			0,
+			sizeof(GuidingTrainingPushConstantData),
+			&push
+		);
+
+		// one workgroup per cell, one invocation per bin
+		vkCmdDispatch(commandBuffer, CELL_COUNT, 1, 1);
+
+		// the cdfs sampled and the splats cleared for this frame's trace
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+			0,
+			1, &memoryBarrier,
+			0, nullptr,
+			0, nullptr
+		);
+	}
+
+	void PathGuidingSystem::registerShaders(ShaderReloader& shaderReloader) {
+		shaderReloader.addPipeline("Path guiding training", { SHADERS_PATH + "raytracing/guiding/" + m_trainingShaderPath },
+			[this] { return createTrainingPipeline(false); }, m_trainingPipeline);
+	}
+
+	void PathGuidingSystem::updateUi() {
+		ImGui::Checkbox("Enable Path Guiding", &m_isEnabled);
+
+		if (m_isEnabled) {
+			ImGui::SliderFloat("Guiding Probability", &m_guidingProbability, 0.05f, 0.95f, "%.2f", ImGuiSliderFlags_AlwaysClamp);
+		}
+
+		ImGui::Text("Frames trained: %u", m_trainedFrames);
+		ImGui::Text("Grid bounds: (%.1f, %.1f, %.1f) to (%.1f, %.1f, %.1f)",
+			m_gridMin.x, m_gridMin.y, m_gridMin.z, m_gridMax.x, m_gridMax.y, m_gridMax.z);
+
+		if (ImGui::Button("Reset Path Guiding")) {
+			m_needsReset = true;
+		}
+	}
+}
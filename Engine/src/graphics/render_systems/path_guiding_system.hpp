@@ -0,0 +1,111 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
+#include "graphics/context/context.hpp"
+#include "graphics/frame_info.hpp"
+#include "graphics/descriptors/descriptors.hpp"
+#include "graphics/resources/vk_buffer.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @class PathGuidingSystem
+	 *
+	 * @brief Learns from the traced paths where the light reaching the surfaces of the scene
+	 * comes from, so that the path tracer can send its paths there.
+	 *
+	 * The scene bounds are divided in a grid of cells, each with a histogram of the incident
+	 * radiance over directional bins of equal solid angle (see raytracing/common/path_guiding.glsl).
+	 * The path tracer splats the radiance found by its paths at their first surface vertices;
+	 * before the next trace, the training pass (path_guiding_training.comp) folds the splats
+	 * into the estimates and rebuilds the cdf of every cell. The closest hit shader then
+	 * samples either the distribution of the cell or the BSDF (one-sample MIS), in the cells
+	 * that have recorded enough vertices.
+	 *
+	 * The estimates keep accumulating while the scene stays the same. When objects only move,
+	 * the estimates are aged so that the new light paths take over progressively. When the scene
+	 * changes structurally (objects added or removed, or bounds changing a lot) the grid is
+	 * fitted to the new bounds and everything learned is dropped.
+	 */
+	class PathGuidingSystem {
+	public:
+		// must match path_guiding.glsl
+		static constexpr uint32_t GRID_RESOLUTION = 16;
+		static constexpr uint32_t CELL_COUNT = GRID_RESOLUTION * GRID_RESOLUTION * GRID_RESOLUTION;
+		static constexpr uint32_t BIN_COUNT = 16 * 8; // phi * cos theta bins
+
+		// the share of the estimates kept on the frames objects moved
+		static constexpr float MOVED_OBJECTS_DECAY = 0.8f;
+		// the bounds moving by more than this share of the grid size refit the grid
+		static constexpr float BOUNDS_CHANGE_TOLERANCE = 0.25f;
+
+		PathGuidingSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator);
+		~PathGuidingSystem();
+
+		PathGuidingSystem(const PathGuidingSystem&) = delete;
+		PathGuidingSystem& operator=(const PathGuidingSystem&) = delete;
+
+		/**
+		 * @brief Drops the distribution if the scene changed structurally, then records the
+		 * training on the splats of the previous frame, aging the estimates if objects moved.
+		 * Must be recorded before the trace of the frame.
+		 *
+		 * @param frameInfo The frame information, the scene bounds are taken from its render packets.
+		 * @param objectCount The number of objects of the scene.
+		 * @param hasObjectsChanged Whether objects of the scene were uploaded (added, moved or changed) this frame.
+		 */
+		void update(FrameInfo& frameInfo, uint32_t objectCount, bool hasObjectsChanged);
+
+		void registerShaders(ShaderReloader& shaderReloader);
+		void updateUi();
+
+		// pushed to the path tracer, 0 when guiding is off: the paths neither sample nor record
+		float getGuidingProbability() const { return m_isEnabled ? m_guidingProbability : 0.0f; }
+
+		VkDescriptorSet getDescriptorSet() const { return m_descriptorSet; }
+		VkDescriptorSetLayout getDescriptorSetLayout() const { return m_descriptorSetLayout->getDescriptorSetLayout(); }
+
+	private:
+		void createBuffers();
+		void createDescriptorSet();
+		void createPipelineLayout();
+		Unique<Pipeline> createTrainingPipeline(bool useCompiledSpirvFiles = true) const;
+
+		// the bounding box of the bounding spheres of the rendered objects
+		void computeSceneBounds(FrameInfo& frameInfo, glm::vec3& boundsMin, glm::vec3& boundsMax) const;
+		bool isGridFitting(const glm::vec3& boundsMin, const glm::vec3& boundsMax) const;
+
+		// fits the grid to the bounds of the scene and clears everything learned
+		void reset(VkCommandBuffer commandBuffer, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+		void train(VkCommandBuffer commandBuffer, float estimateDecay);
+
+		Context& m_context;
+		Shared<DescriptorAllocatorGrowable> m_descriptorAllocator;
+
+		// the bindings of path_guiding.glsl, in order
+		Unique<VulkanBuffer> m_gridBuffer;
+		Unique<VulkanBuffer> m_splatBuffer;
+		Unique<VulkanBuffer> m_sampleCountBuffer;
+		Unique<VulkanBuffer> m_estimateBuffer;
+		Unique<VulkanBuffer> m_cdfBuffer;
+		Unique<VulkanBuffer> m_cellBuffer;
+
+		Unique<DescriptorSetLayout> m_descriptorSetLayout;
+		VkDescriptorSet m_descriptorSet = VK_NULL_HANDLE;
+
+		VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+		Unique<Pipeline> m_trainingPipeline;
+
+		bool m_isEnabled = true;
+		float m_guidingProbability = 0.5f;
+		bool m_needsReset = true;
+		uint32_t m_objectCount = 0;   // at the last reset
+		uint32_t m_trainedFrames = 0; // since the last reset
+		glm::vec3 m_gridMin{ 0.0f };
+		glm::vec3 m_gridMax{ 0.0f };
+
+		const std::string m_trainingShaderPath = "path_guiding_training.comp";
+	};
+}
@@ -13,12 +13,10 @@ namespace PXTEngine {
     PointLightSystem::PointLightSystem(Context& context, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout) :
 		m_context(context), m_renderPass(renderPass) {
         createPipelineLayout(globalSetLayout);
-        createPipeline(renderPass);
+        m_pipeline = createPipeline();
     }
 
-    PointLightSystem::~PointLightSystem() {
-        vkDestroyPipelineLayout(m_context.getDevice(), m_pipelineLayout, nullptr);
-    }
+    PointLightSystem::~PointLightSystem() = default;
 
     void PointLightSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout) {
         VkPushConstantRange pushConstantRange{};
@@ -36,14 +34,12 @@ namespace PXTEngine {
         pipelineLayoutInfo.pushConstantRangeCount = 1;
         pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create pipeline layout!");
-        }
+        m_pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
     }
 
 
 
-    void PointLightSystem::createPipeline(bool useCompiledSpirvFiles) {
+    Unique<Pipeline> PointLightSystem::createPipeline(bool useCompiledSpirvFiles) const {
         PXT_ASSERT(m_pipelineLayout != nullptr, "Cannot create pipeline before pipelineLayout");
 
         RasterizationPipelineConfigInfo pipelineConfig{};
@@ -65,7 +61,7 @@ namespace PXTEngine {
             shaderFilePaths.push_back(baseShaderPath + filePath + filenameSuffix);
         };
 
-		m_pipeline = createUnique<Pipeline>(
+		return createUnique<Pipeline>(
 			m_context,
             shaderFilePaths,
 			pipelineConfig
@@ -73,6 +69,8 @@ namespace PXTEngine {
     }
 
     void PointLightSystem::update(FrameInfo& frameInfo, GlobalUbo& ubo) {
+        PXT_ALLOCATION_SCOPE("PointLightSystem");
+
         int lightIndex = 0;
 
         auto view = frameInfo.scene.getEntitiesWith<PointLightComponent, ColorComponent, TransformComponent>();
@@ -91,9 +89,11 @@ namespace PXTEngine {
     }
 
     void PointLightSystem::render(FrameInfo& frameInfo) {
+        PXT_ALLOCATION_SCOPE("PointLightSystem");
+
         // sort lights by distance to camera
         //TODO: WE SHOULD DO THIS FOR EVERY TRANSPARENT OBJECT or use order independent transparency
-        std::map<float, entt::entity> sorted;
+        FrameVector<std::pair<float, entt::entity>> sorted;
 
         auto view = frameInfo.scene.getEntitiesWith<PointLightComponent, ColorComponent, TransformComponent>();
         for (auto entity : view) {
@@ -108,8 +108,11 @@ namespace PXTEngine {
             // dot product to get distance squared, less expensive than sqrt
             float distanceSq = glm::dot(lightToCamera, lightToCamera);
 
-            sorted[distanceSq] = entity;
+            sorted.emplace_back(distanceSq, entity);
         }
+
+        // back to front
+        std::ranges::sort(sorted, std::ranges::greater{}, &std::pair<float, entt::entity>::first);
         
         m_pipeline->bind(frameInfo.commandBuffer);
 
@@ -124,7 +127,7 @@ namespace PXTEngine {
             nullptr
         );
 
-        for (auto& [_, entity] : std::ranges::reverse_view(sorted))
+        for (auto& [_, entity] : sorted)
         {
             const auto&[light, color, transform] = view.get<PointLightComponent, ColorComponent, TransformComponent>(entity);
 
@@ -145,8 +148,12 @@ namespace PXTEngine {
             vkCmdDraw(frameInfo.commandBuffer, 6, 1, 0, 0);
         }
     }
-    void PointLightSystem::reloadShaders() {
-        PXT_INFO("Reloading shaders...");
-		createPipeline(false);
+    void PointLightSystem::registerShaders(ShaderReloader& shaderReloader) {
+        std::vector<std::filesystem::path> sourceFiles;
+        for (const auto& filePath : m_shaderFilePaths) {
+            sourceFiles.push_back(SHADERS_PATH + filePath);
+        }
+
+        shaderReloader.addPipeline("Point light", sourceFiles, [this] { return createPipeline(false); }, m_pipeline);
     }
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "core/pch.hpp"
 #include "scene/camera.hpp"
 #include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
 #include "graphics/swap_chain.hpp"
 #include "graphics/context/context.hpp"
 #include "graphics/frame_info.hpp"
@@ -20,11 +21,11 @@ namespace PXTEngine {
 
         void update(FrameInfo& frameInfo, GlobalUbo& ubo);
         void render(FrameInfo& frameInfo);
-		void reloadShaders();
+		void registerShaders(ShaderReloader& shaderReloader);
 
     private:
         void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
-        void createPipeline(bool useCompiledSpirvFiles = true);  
+        Unique<Pipeline> createPipeline(bool useCompiledSpirvFiles = true) const;
         
         Context& m_context;
 
@@ -1,5 +1,7 @@
 #include "graphics/render_systems/raytracing_render_system.hpp"
 
+#include "application.hpp"
+
 namespace PXTEngine {
 	struct  alignas(16)RayTracingPushConstantData {
 		uint32_t noiseType = 0;
@@ -9,20 +11,24 @@ namespace PXTEngine {
 									    // different blue noise textures every frame
 
 		uint32_t blueNoiseDebugIndex = 0; // Index of the blue noise texture to use in case selectSingleTextures is true
+		uint32_t samplesPerPixel = 1;
+		float guidingProbability = 0.0f; // 0 when path guiding is off
 	};
 
 	RayTracingRenderSystem::RayTracingRenderSystem(
 		Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator,
+		Shared<DescriptorAllocatorTransient> frameDescriptorAllocator,
 		TextureRegistry& textureRegistry, MaterialRegistry& materialRegistry,
-		BLASRegistry& blasRegistry, Shared<Environment> environment,
+		GpuScene& gpuScene, Shared<Environment> environment,
 		DescriptorSetLayout& globalSetLayout, Shared<VulkanImage> sceneImage,
 		DensityTextureRenderSystem& densityTextureSystem)
 		: m_context(context),
 		m_textureRegistry(textureRegistry),
 		m_materialRegistry(materialRegistry),
-		m_blasRegistry(blasRegistry),
+		m_gpuScene(gpuScene),
 		m_environment(environment),
 		m_descriptorAllocator(descriptorAllocator),
+		m_frameDescriptorAllocator(frameDescriptorAllocator),
 		m_sceneImage(sceneImage),
 		m_densityTextureSystem(densityTextureSystem)
 	{
@@ -31,13 +37,11 @@ namespace PXTEngine {
 		createDescriptorSets();
 		defineShaderGroups();
 		createPipelineLayout(globalSetLayout);
-		createPipeline(false); // TODO: understand why glslLangVaalidator cannot compile this
+		m_pipeline = createPipeline(false); // TODO: understand why glslLangVaalidator cannot compile this
 		createShaderBindingTable();
 	}
 
-	RayTracingRenderSystem::~RayTracingRenderSystem() {
-		vkDestroyPipelineLayout(m_context.getDevice(), m_pipelineLayout, nullptr);
-	}
+	RayTracingRenderSystem::~RayTracingRenderSystem() = default;
 
 
 	void RayTracingRenderSystem::createDescriptorSets() {
@@ -124,11 +128,12 @@ namespace PXTEngine {
 			m_storageImageDescriptorSetLayout->getDescriptorSetLayout(),
 			m_materialRegistry.getDescriptorSetLayout(),
 			m_skybox->getDescriptorSetLayout(),
-			m_rtSceneManager.getMeshInstanceDescriptorSetLayout(),
+			m_gpuScene.getDescriptorSetLayout(),
 			m_rtSceneManager.getEmittersDescriptorSetLayout(),
 			m_rtSceneManager.getVolumeDescriptorSetLayout(),
 			m_blueNoiseDescriptorSetLayout->getDescriptorSetLayout(),
-			m_densityTextureSystem.getSamplingDensitySetLayout()->getDescriptorSetLayout()
+			m_densityTextureSystem.getSamplingDensitySetLayout()->getDescriptorSetLayout(),
+			m_pathGuiding.getDescriptorSetLayout()
 		};
 
 		VkPushConstantRange pushConstantRange{};
@@ -143,12 +148,10 @@ namespace PXTEngine {
 		pipelineLayoutInfo.pushConstantRangeCount = 1; 
 		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-		if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
-			throw std::runtime_error("failed to create raytracingRenderSystem pipeline layout!");
-		}
+		m_pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
 	}
 
-	void RayTracingRenderSystem::createPipeline(bool useCompiledSpirvFiles) {
+	Unique<Pipeline> RayTracingRenderSystem::createPipeline(bool useCompiledSpirvFiles) const {
 		RayTracingPipelineConfigInfo pipelineConfig{};
 		pipelineConfig.shaderGroups = m_shaderGroups;
 		pipelineConfig.pipelineLayout = m_pipelineLayout;
@@ -163,7 +166,7 @@ namespace PXTEngine {
 			}
 		}
 
-		m_pipeline = createUnique<Pipeline>(
+		return createUnique<Pipeline>(
 			m_context,
 			pipelineConfig
 		);
@@ -346,9 +349,33 @@ namespace PXTEngine {
 		}
 	}
 	
+	void RayTracingRenderSystem::updateSamplesPerPixel(FrameInfo& frameInfo) {
+		// update the cost of a sample with the last measure taken with this frame index
+		// (its timeline value has already been reached)
+		m_lastTraceInterval = m_traceTimer.getInterval(frameInfo.frameIndex);
+		if (m_lastTraceInterval && m_timedSamples[frameInfo.frameIndex] > 0) {
+			m_sampleBudget.addMeasure(m_lastTraceInterval->getElapsedMs(), m_timedSamples[frameInfo.frameIndex]);
+		}
+
+		const glm::mat4 viewProjection = frameInfo.camera.getProjectionMatrix() * frameInfo.camera.getViewMatrix();
+		const bool isCameraStill = viewProjection == m_lastViewProjection;
+		m_lastViewProjection = viewProjection;
+
+		// a replay traces the sample counts of the recorded session, whatever its own timings
+		m_samplesPerPixel = Application::get().getInputRecorder().pinAdaptiveValue(
+			InputRecorder::AdaptiveValue::SamplesPerPixel,
+			m_sampleBudget.computeSamplesPerPixel(isCameraStill)
+		);
+	}
+
 	void RayTracingRenderSystem::update(FrameInfo& frameInfo) {
 		m_rtSceneManager.createTLAS(frameInfo);
 
+		// trains on the paths of the last frame, or starts over if objects were added or removed this frame
+		m_pathGuiding.update(frameInfo, m_gpuScene.getObjectCount(), m_gpuScene.getUploadedObjectCount() > 0);
+
+		updateSamplesPerPixel(frameInfo);
+
 		m_sceneImage->transitionImageLayout(
 			frameInfo.commandBuffer,
 			VK_IMAGE_LAYOUT_GENERAL,
@@ -362,18 +389,19 @@ namespace PXTEngine {
 	void RayTracingRenderSystem::render(FrameInfo& frameInfo, Renderer& renderer) {
 		m_pipeline->bind(frameInfo.commandBuffer);
 
-		std::array<VkDescriptorSet, 11> descriptorSets = { 
+		std::array<VkDescriptorSet, 12> descriptorSets = { 
 			frameInfo.globalDescriptorSet, 
 			m_rtSceneManager.getTLASDescriptorSet(frameInfo.frameIndex), 
 			m_textureRegistry.getDescriptorSet(),
 			m_storageImageDescriptorSet,
 			m_materialRegistry.getDescriptorSet(frameInfo.frameIndex),
 			m_skybox->getDescriptorSet(),
-			m_rtSceneManager.getMeshInstanceDescriptorSet(frameInfo.frameIndex),
+			m_gpuScene.getDescriptorSet(),
 			m_rtSceneManager.getEmittersDescriptorSet(frameInfo.frameIndex),
 			m_rtSceneManager.getVolumeDescriptorSet(frameInfo.frameIndex),
 			m_blueNoiseDescriptorSet,
-			m_densityTextureSystem.getSamplingDensitySet()
+			m_densityTextureSystem.getSamplingDensitySet(),
+			m_pathGuiding.getDescriptorSet()
 		};
 	
 		vkCmdBindDescriptorSets(
@@ -394,6 +422,8 @@ namespace PXTEngine {
 		pushConstants.blueNoiseTextureSize = BLUE_NOISE_TEXTURE_SIZE;
 		pushConstants.selectSingleTextures = m_selectSingleBlueNoiseTextures;
 		pushConstants.blueNoiseDebugIndex = m_blueNoiseDebugIndex;
+		pushConstants.samplesPerPixel = m_samplesPerPixel;
+		pushConstants.guidingProbability = m_pathGuiding.getGuidingProbability();
 
 		vkCmdPushConstants(
 			frameInfo.commandBuffer,
@@ -404,6 +434,10 @@ namespace PXTEngine {
 			&pushConstants
 		);
 
+		// the start timestamp waits for the work recorded before (e.g. density generation),
+		// so that only the dispatch is measured
+		m_traceTimer.begin(frameInfo.commandBuffer, frameInfo.frameIndex, 0, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
 		vkCmdTraceRaysKHR(
 			frameInfo.commandBuffer,
 			&m_raygenRegion,
@@ -414,6 +448,9 @@ namespace PXTEngine {
 			renderer.getSwapChainExtent().height,
 			1
 		);
+
+		m_traceTimer.end(frameInfo.commandBuffer, frameInfo.frameIndex, 0, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR);
+		m_timedSamples[frameInfo.frameIndex] = m_samplesPerPixel;
 	}
 
 	void RayTracingRenderSystem::transitionImageToShaderReadOnlyOptimal(FrameInfo& frameInfo, VkPipelineStageFlagBits lastStage) {
@@ -426,14 +463,72 @@ namespace PXTEngine {
 		);
 	}
 
-	void RayTracingRenderSystem::reloadShaders() {
-		PXT_INFO("Reloading shaders...");
+	void RayTracingRenderSystem::registerShaders(ShaderReloader& shaderReloader) {
+		std::vector<std::filesystem::path> sourceFiles;
+		for (const auto& group : m_shaderGroups) {
+			for (const auto& stage : group.stages) {
+				sourceFiles.push_back(SHADERS_PATH + "raytracing/" + stage.second);
+			}
+		}
 
-		createPipeline(false);
-		createShaderBindingTable();
+		shaderReloader.add("Raytracing", sourceFiles, [this, &shaderReloader] {
+			return ShaderReloader::Reload{
+				[this] {
+					std::vector<Unique<Pipeline>> pipelines;
+					pipelines.push_back(createPipeline(false));
+					return pipelines;
+				},
+				[this, &shaderReloader](std::vector<Unique<Pipeline>>& pipelines) {
+					std::swap(m_pipeline, pipelines[0]);
+
+					// the group handles belong to the pipeline, the frames in flight keep tracing with the old table
+					shaderReloader.retire(std::move(m_sbtBuffer));
+					createShaderBindingTable();
+				}
+			};
+		});
+
+		m_pathGuiding.registerShaders(shaderReloader);
 	}
 
 	void RayTracingRenderSystem::updateUi() {
+		SampleBudgetController::Settings& budget = m_sampleBudget.getSettings();
+
+		ImGui::SeparatorText("Samples Per Pixel");
+
+		bool isBudgetMode = budget.mode == SampleBudgetController::Mode::Budget;
+		if (ImGui::Checkbox("Fit GPU Time Budget", &isBudgetMode)) {
+			budget.mode = isBudgetMode ? SampleBudgetController::Mode::Budget : SampleBudgetController::Mode::Fixed;
+		}
+
+		if (isBudgetMode) {
+			ImGui::DragFloat("Budget (ms)", &budget.budgetMs, 0.1f, 0.5f, 100.0f, "%.1f", ImGuiSliderFlags_AlwaysClamp);
+			ImGui::Checkbox("Accumulate While Camera Is Still", &budget.isIdleAccumulationEnabled);
+			if (budget.isIdleAccumulationEnabled) {
+				ImGui::DragFloat("Idle Budget (ms)", &budget.idleBudgetMs, 0.1f, 0.5f, 200.0f, "%.1f", ImGuiSliderFlags_AlwaysClamp);
+			}
+		} else {
+			ImGui::SliderInt("Samples", reinterpret_cast<int*>(&budget.fixedSamplesPerPixel), 1,
+				static_cast<int>(SampleBudgetController::MAX_SAMPLES_PER_PIXEL));
+		}
+
+		ImGui::Text("Samples: %u%s, dispatch: %.2f ms (%.2f ms per sample)",
+			m_samplesPerPixel, m_sampleBudget.isIdle() ? " (idle)" : "",
+			m_sampleBudget.getLastMeasureMs(), m_sampleBudget.getMsPerSample());
+
+		ImGui::SeparatorText("Path Guiding");
+
+		m_pathGuiding.updateUi();
+
+		ImGui::SeparatorText("Volume Brick Atlas");
+
+		const VolumeBrickAtlas::Stats atlasStats = m_rtSceneManager.getBrickAtlas().getStats();
+		ImGui::Text("Grids: %u, bricks: %u (%u empty)", atlasStats.gridCount, atlasStats.brickCount, atlasStats.emptyBrickCount);
+		ImGui::Text("Stored bricks: %u / %u slots (%.2f MB)", atlasStats.storedBrickCount, atlasStats.capacity,
+			static_cast<double>(atlasStats.memorySize) / (1024.0 * 1024.0));
+
+		ImGui::SeparatorText("Noise");
+
 		ImGui::InputInt("Noise Type (0 -> white, 1 -> blue noise)", reinterpret_cast<int*>(&m_noiseType));
 		if (m_noiseType == 1) {
 			ImGui::Text("Blue Noise is currently only used in jitter\nand still doesn't work properly (most probably)");
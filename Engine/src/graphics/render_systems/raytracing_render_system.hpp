@@ -2,6 +2,7 @@
 
 #include "core/pch.hpp"
 #include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
 #include "graphics/swap_chain.hpp"
 #include "graphics/frame_info.hpp"
 #include "graphics/descriptors/descriptors.hpp"
@@ -10,7 +11,10 @@
 #include "graphics/resources/vk_skybox.hpp"
 #include "graphics/render_systems/raytracing_scene_manager_system.hpp"
 #include "graphics/render_systems/density_texture_system.hpp"
+#include "graphics/render_systems/path_guiding_system.hpp"
 #include "graphics/renderer.hpp"
+#include "graphics/gpu_timer.hpp"
+#include "graphics/sample_budget_controller.hpp"
 #include "scene/scene.hpp"
 #include "scene/environment.hpp"
 
@@ -18,7 +22,7 @@ namespace PXTEngine {
 
     class RayTracingRenderSystem {
     public:
-        RayTracingRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, TextureRegistry& textureRegistry, MaterialRegistry& materialRegistry, BLASRegistry& blasRegistry, Shared<Environment> environment, DescriptorSetLayout& globalSetLayout, Shared<VulkanImage> sceneImage, DensityTextureRenderSystem& densityTextureSystem);
+        RayTracingRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, Shared<DescriptorAllocatorTransient> frameDescriptorAllocator, TextureRegistry& textureRegistry, MaterialRegistry& materialRegistry, GpuScene& gpuScene, Shared<Environment> environment, DescriptorSetLayout& globalSetLayout, Shared<VulkanImage> sceneImage, DensityTextureRenderSystem& densityTextureSystem);
         ~RayTracingRenderSystem();
 
         RayTracingRenderSystem(const RayTracingRenderSystem&) = delete;
@@ -27,32 +31,43 @@ namespace PXTEngine {
         void update(FrameInfo& frameInfo);
         void render(FrameInfo& frameInfo, Renderer& renderer);
 		void transitionImageToShaderReadOnlyOptimal(FrameInfo& frameInfo, VkPipelineStageFlagBits lastStage);
-		void reloadShaders();
+		void registerShaders(ShaderReloader& shaderReloader);
 
 		void updateUi();
 
         void updateSceneImage(Shared<VulkanImage> sceneImage);
 
+		// the timestamps of the last measured dispatch, to compare with the async compute work
+		const std::optional<GpuTimer::Interval>& getLastTraceInterval() const { return m_lastTraceInterval; }
+
     private:
 		void createDescriptorSets();
 		void defineShaderGroups();
         void createPipelineLayout(DescriptorSetLayout& setLayout);
-        void createPipeline(bool useCompiledSpirvFiles = true);
+        Unique<Pipeline> createPipeline(bool useCompiledSpirvFiles = true) const;
 		void createShaderBindingTable();
 
 		void retrieveBlueNoiseTextureIndeces();
 
+		/**
+		 * @brief Chooses the samples per pixel of this frame from the GPU time of the previous
+		 * dispatches and from whether the camera moved.
+		 */
+		void updateSamplesPerPixel(FrameInfo& frameInfo);
+
         Context& m_context;
         TextureRegistry& m_textureRegistry;
 		MaterialRegistry& m_materialRegistry;
-		BLASRegistry& m_blasRegistry; // used only to initialize tlasBuildSystem
+		GpuScene& m_gpuScene; // used only to initialize the scene manager
 		Shared<Environment> m_environment = nullptr;
 		Shared<VulkanSkybox> m_skybox = nullptr;
         
         Shared<DescriptorAllocatorGrowable> m_descriptorAllocator = nullptr;
+        Shared<DescriptorAllocatorTransient> m_frameDescriptorAllocator = nullptr;
         
-        RayTracingSceneManagerSystem m_rtSceneManager{m_context, m_materialRegistry, m_blasRegistry, m_textureRegistry, m_descriptorAllocator};
+        RayTracingSceneManagerSystem m_rtSceneManager{m_context, m_gpuScene, m_frameDescriptorAllocator};
 		DensityTextureRenderSystem& m_densityTextureSystem;
+		PathGuidingSystem m_pathGuiding{m_context, m_descriptorAllocator};
 
         Unique<Pipeline> m_pipeline;
         VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
@@ -73,6 +88,14 @@ namespace PXTEngine {
 		Unique<DescriptorSetLayout> m_blueNoiseDescriptorSetLayout = nullptr;
 		Unique<VulkanBuffer> m_blueNoiseIndecesBuffer = nullptr;
 
+		// Samples per pixel, adapted to the GPU time budget
+		GpuTimer m_traceTimer{m_context};
+		std::array<uint32_t, SwapChain::MAX_FRAMES_IN_FLIGHT> m_timedSamples{}; // samples measured by the timer, per frame index
+		SampleBudgetController m_sampleBudget{};
+		std::optional<GpuTimer::Interval> m_lastTraceInterval;
+		uint32_t m_samplesPerPixel = 1;
+		glm::mat4 m_lastViewProjection{0.0f};
+
 		// Ui variables
 		uint32_t m_noiseType = 0; // 0 for white noise, 1 for blue noise
 		uint32_t m_blueNoiseTextureIndeces[BLUE_NOISE_TEXTURE_COUNT]; // Indices of the blue noise textures in the texture registry
@@ -4,17 +4,13 @@
 #include "scene/ecs/entity.hpp"
 
 namespace PXTEngine {
-	RayTracingSceneManagerSystem::RayTracingSceneManagerSystem(Context& context, MaterialRegistry& materialRegistry, 
-		BLASRegistry& blasRegistry, TextureRegistry& textureRegistry, Shared<DescriptorAllocatorGrowable> allocator)
+	RayTracingSceneManagerSystem::RayTracingSceneManagerSystem(Context& context, GpuScene& gpuScene,
+		Shared<DescriptorAllocatorTransient> frameAllocator)
 		: m_context(context), 
-		m_materialRegistry(materialRegistry),
-		m_blasRegistry(blasRegistry), 
-		m_textureRegistry(textureRegistry),
-		m_descriptorAllocator(allocator) {
-		createTLASDescriptorSets();
-		createMeshInstanceDescriptorSets();
-		createEmittersDescriptorSets();
-		createVolumesDescriptorSets();
+		m_gpuScene(gpuScene),
+		m_frameDescriptorAllocator(std::move(frameAllocator)),
+		m_brickAtlas(context) {
+		createDescriptorSetLayouts();
 	}
 
 	RayTracingSceneManagerSystem::~RayTracingSceneManagerSystem() {
@@ -27,140 +23,42 @@ namespace PXTEngine {
 
 
 	void RayTracingSceneManagerSystem::createTLAS(FrameInfo& frameInfo) {
+		PXT_ALLOCATION_SCOPE("RayTracingScene");
+
 		int frameIndex = frameInfo.frameIndex;
 
 		VkAccelerationStructureKHR newTlas = VK_NULL_HANDLE;
 
-		//  Create a acceleration structure instance vector 
-		std::vector<VkAccelerationStructureInstanceKHR> instances;
-	
-		//  Get all BLAS and components from entities that have transform & mesh components 
-		auto view = frameInfo.scene.getEntitiesWith<TransformComponent, MeshComponent>();
-
-		m_emitters.clear();
-		m_volumes.clear();
-		m_meshInstanceData.clear();
-
-		uint32_t instanceIndex = 0;
-		uint32_t volumeIndex = 0; // for now just iterative increase
-		for (auto entityHandle : view) {
-			Entity entity(entityHandle, &frameInfo.scene);
-
-			if (!entity.hasAny<MaterialComponent, VolumeComponent>()) continue;
-
-
-			const auto& [transformComponent, meshComponent] = view.get<TransformComponent, MeshComponent>(entityHandle);
-			
-			auto mesh = meshComponent.mesh;
-
-			Shared<BLAS> blas = m_blasRegistry.getOrCreateBLAS(mesh);
-
-			VkAccelerationStructureDeviceAddressInfoKHR addressInfo{};
-			addressInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR;
-			addressInfo.accelerationStructure = blas->handle;
-			VkDeviceAddress blasAddress = blas->buffer->getDeviceAddress();
-
-			// convert glm::mat4 to VkTransformMatrixKHR
-			VkTransformMatrixKHR transformMatrix = glmToVkTransformMatrix(transformComponent.mat4());
-
-			// Define the instance
-			VkAccelerationStructureInstanceKHR instance{};
-			instance.transform = transformMatrix;
-
-			auto vkMesh = static_pointer_cast<VulkanMesh>(mesh);
-
-			constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
-
-			MeshInstanceData meshInstanceData{};
-			meshInstanceData.vertexBufferAddress = vkMesh->getVertexBufferDeviceAddress();
-			meshInstanceData.indexBufferAddress = vkMesh->getIndexBufferDeviceAddress();
-			meshInstanceData.materialIndex = invalidIndex;
-			meshInstanceData.emitterIndex = invalidIndex;
-			meshInstanceData.volumeIndex = invalidIndex;
-		
-			instance.mask = 0xFF;
-
-			// Add material properties to the instance data
-			if (entity.has<MaterialComponent>()) {
-				auto& materialComponent = entity.get<MaterialComponent>();
-
-				meshInstanceData.materialIndex = m_materialRegistry.getIndex(materialComponent.material->id);
-				meshInstanceData.textureTintColor = glm::vec4(materialComponent.tint, 1.0f);
-				meshInstanceData.textureTilingFactor = materialComponent.tilingFactor;
-
-				// register entities with emissive materials
-				if (materialComponent.material->isEmissive()) {
-					meshInstanceData.emitterIndex = static_cast<uint32_t>(m_emitters.size());
+		// the scene was walked by GpuScene::update earlier in the frame
+		RayTracingSceneData& sceneData = m_gpuScene.getSceneData();
 
-					EmitterData emitterData{};
-					emitterData.instanceIndex = instanceIndex;
-					emitterData.numberOfFaces = vkMesh->getIndexCount() / 3;
-					m_emitters.push_back(emitterData);
-				}
-		
-			}
-			
-			// Add volume properties to the instance data
-			if (entity.has<VolumeComponent>()) {
-				VolumeComponent::Volume volume = entity.get<VolumeComponent>().volume;
-				
-				meshInstanceData.volumeIndex = volumeIndex++;
-				
-				uint32_t densityTextureId = invalidIndex;
-				uint32_t detailTextureId = invalidIndex;
-
-				if (volume.densityTexture.get() != nullptr) {
-					densityTextureId = m_textureRegistry.getIndex(volume.densityTexture->id);
-				}
-
-				if (volume.detailTexture.get() != nullptr) {
-					detailTextureId = m_textureRegistry.getIndex(volume.detailTexture->id);
-				}
-
-				m_volumes.push_back(
-					VolumeData{
-						.absorption = volume.absorption,
-						.scattering = volume.scattering,
-						.phaseFunctionG = volume.phaseFunctionG,
-						.densityTextureId = densityTextureId,
-						.detailTextureId = detailTextureId,
-						.instanceIndex = instanceIndex
-					}
-				);
-			}
-			
-
-			// TODO: may be passed as mat4x3 in the shader for memory bandwidth optimization
-			glm::mat4 transform = transformComponent.mat4();
-
-			meshInstanceData.objectToWorldMatrix = transform;
-			meshInstanceData.worldToObjectMatrix = glm::inverse(transform);
-
-			m_meshInstanceData.push_back(meshInstanceData);
-
-
-			// we can get it in the shader via InstanceCustomIndexKHR
-			instance.instanceCustomIndex = instanceIndex++; // Unique index for each instance
-
-			instance.instanceShaderBindingTableRecordOffset = 0; // this is 0 for every instance for now
-			                                                     // it is the offset in the SBT hit region
-			                                                     // (which hit shader the instance should use)
-			instance.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR; // Example flags
-			instance.accelerationStructureReference = blasAddress;
-
-			instances.push_back(instance);
+		// the grids of removed volumes are dropped, the new ones are uploaded
+		for (const auto& [index, grid] : sceneData.volumeGrids) {
+			m_brickAtlas.acquire(grid);
 		}
+		m_brickAtlas.releaseUnused();
+		m_brickAtlas.flush(frameInfo.commandBuffer, frameInfo.frameIndex);
+
+		// the brick table offsets are only known after the flush
+		for (const auto& [index, grid] : sceneData.volumeGrids) {
+			const VolumeBrickAtlas::Allocation& allocation = m_brickAtlas.getAllocation(grid->id);
+			sceneData.volumes[index].densityGrid = glm::uvec4(grid->getResolution(), allocation.indirectionOffset);
+			sceneData.volumes[index].densityMajorant = allocation.majorant;
+		}
+
+		const std::vector<VkAccelerationStructureInstanceKHR>& instances = sceneData.instances;
 
 		//TODO: maybe move from here?
-		updateMeshInstanceDescriptorSets(frameInfo.frameIndex);
 		updateEmittersDescriptorSets(frameInfo.frameIndex);
 		updateVolumesDescriptorSets(frameInfo.frameIndex);
 
 		// Upload Instance Data 
+		// the build is recorded in the frame command buffer after the BLAS refits of the skinning,
+		// its buffers are kept until this frame index is recorded again
 		uint32_t instanceCount = static_cast<uint32_t>(instances.size());
 		VkDeviceSize instanceDataSize = sizeof(VkAccelerationStructureInstanceKHR) * instanceCount;
-		Unique<VulkanBuffer> instanceBuffer;
-		Unique<VulkanBuffer> stagingBuffer;
+		Unique<VulkanBuffer>& instanceBuffer = m_instanceBuffers[frameIndex];
+		Unique<VulkanBuffer>& stagingBuffer = m_instanceStagingBuffers[frameIndex];
 
 		// Create staging buffer
 		stagingBuffer = createUnique<VulkanBuffer>(
@@ -185,8 +83,12 @@ namespace PXTEngine {
 			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
 		);
 
+		VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+
 		// Copy instance data to GPU
-		m_context.copyBuffer(stagingBuffer->getBuffer(), instanceBuffer->getBuffer(), instanceDataSize);
+		VkBufferCopy copyRegion{};
+		copyRegion.size = instanceDataSize;
+		vkCmdCopyBuffer(commandBuffer, stagingBuffer->getBuffer(), instanceBuffer->getBuffer(), 1, &copyRegion);
 
 		// Query Build Sizes
 		VkDeviceAddress instanceBufferAddr = instanceBuffer->getDeviceAddress();
@@ -221,8 +123,11 @@ namespace PXTEngine {
 			&m_buildSizeInfo);
 
 
+		// the TLAS of the last time this frame index was recorded lives in the buffer replaced below
+		destroyTLAS(frameIndex);
+
 		// 4. Allocate BLAS Buffer and Scratch Buffer
-		m_tlasBuffer = createUnique<VulkanBuffer>(
+		m_tlasBuffers[frameIndex] = createUnique<VulkanBuffer>(
 			m_context, 
 			m_buildSizeInfo.accelerationStructureSize,
 			1,
@@ -230,7 +135,8 @@ namespace PXTEngine {
 			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
 		);
 
-		Unique<VulkanBuffer> scratchBuffer = createUnique<VulkanBuffer>(
+		Unique<VulkanBuffer>& scratchBuffer = m_scratchBuffers[frameIndex];
+		scratchBuffer = createUnique<VulkanBuffer>(
 			m_context,
 			m_buildSizeInfo.buildScratchSize,
 			1,
@@ -243,7 +149,7 @@ namespace PXTEngine {
 		//  5. Create TLAS Object 
 		VkAccelerationStructureCreateInfoKHR m_createInfo{};
 		m_createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
-		m_createInfo.buffer = m_tlasBuffer->getBuffer();
+		m_createInfo.buffer = m_tlasBuffers[frameIndex]->getBuffer();
 		m_createInfo.offset = 0;
 		m_createInfo.size = m_buildSizeInfo.accelerationStructureSize;
 		m_createInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
@@ -253,9 +159,23 @@ namespace PXTEngine {
 			throw std::runtime_error("Failed to create top-level acceleration structure!");
 		}
 
-		//  6. Build TLAS Command 
-		VkCommandBuffer commandBuffer = m_context.beginSingleTimeCommands();
+		// Add a barrier to ensure BLAS refits are complete and instance buffer write is complete
+		VkMemoryBarrier memoryBarrier = {};
+		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR; // Instance buffer copy + BLAS builds
+		memoryBarrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR; // TLAS build reads instance buffer & BLASes
 
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, // Source stages
+			VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,                                 // Destination stage
+			0, // Dependency flags
+			1, &memoryBarrier, // Memory barriers
+			0, nullptr, // Buffer memory barriers
+			0, nullptr  // Image memory barriers
+		);
+
+		//  6. Build TLAS Command 
 		// Update build info with destination and scratch
 		buildInfo.dstAccelerationStructure = newTlas;
 		buildInfo.scratchData.deviceAddress = scratchBufferAddr;
@@ -276,62 +196,47 @@ namespace PXTEngine {
 			&pBuildRangeInfos // ppBuildRangeInfos
 		);
 
-		// Add a barrier to ensure BLAS builds are complete and instance buffer write is complete
-		VkMemoryBarrier memoryBarrier = {};
-		memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-		memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR; // Instance buffer copy + BLAS builds
-		memoryBarrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR; // TLAS build reads instance buffer & BLASes
+		// the trace of this frame reads the TLAS
+		memoryBarrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+		memoryBarrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
 
 		vkCmdPipelineBarrier(
 			commandBuffer,
-			VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, // Source stages
-			VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,                                 // Destination stage
-			0, // Dependency flags
-			1, &memoryBarrier, // Memory barriers
-			0, nullptr, // Buffer memory barriers
-			0, nullptr  // Image memory barriers
+			VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+			0,
+			1, &memoryBarrier,
+			0, nullptr,
+			0, nullptr
 		);
 
-		m_context.endSingleTimeCommands(commandBuffer); // Submits and waits
-
-		//  Cleanup 
-		// Destroy the scratch buffer (it's only needed during build) and other buffers like
-		// instance buffer or staging buffer. we can potentially keep the instance buffer for reuse.
-		// Buffers will be deleted after end of this function cause they are Unique.
-
 		// Update descriptor set for TLAS
 		updateTLASDescriptorSets(frameInfo.frameIndex, newTlas);
 	}
 
-	VkTransformMatrixKHR RayTracingSceneManagerSystem::glmToVkTransformMatrix(const glm::mat4& glmMatrix) {
-		VkTransformMatrixKHR vkMatrix;
-
-		// GLM matrices are column-major, VkTransformMatrixKHR is row-major.
-		// We need to transpose the 3x4 part and assign.
-		// The last row of a 4x4 homogeneous matrix (0,0,0,1) is omitted.
-
-		// vkMatrix.matrix[row][column]
-		// glmMatrix[column][row] (due to column-major order)
-
-		for (int row = 0; row < 3; ++row) {
-			for (int col = 0; col < 4; ++col) {
-				vkMatrix.matrix[row][col] = glmMatrix[col][row];
-			}
-		}
-
-		return vkMatrix;
-	}
+	void RayTracingSceneManagerSystem::createDescriptorSetLayouts() {
+		// the layouts are needed for the raytracing pipeline layout, the sets instead
+		// are allocated every frame from the transient allocator
 
-	void RayTracingSceneManagerSystem::createTLASDescriptorSets() {
 		// TLAS DESCRIPTOR SET LAYOUT
-		// needed for raytracing pipeline layout
 		m_tlasDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
 			.addBinding(0, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR)
 			.build();
 
-		for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-			m_descriptorAllocator->allocate(m_tlasDescriptorSetLayout->getDescriptorSetLayout(), m_tlasDescriptorSets[i]);
-		}
+		// EMITTERS DESCRIPTOR SET LAYOUT
+		m_emittersDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR |
+				VK_SHADER_STAGE_RAYGEN_BIT_KHR,
+				1)
+			.build();
+
+		// VOLUMES DESCRIPTOR SET LAYOUT
+		m_volumesDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, 1)
+			.addBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, 1)
+			.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, 1)
+			.build();
 	}
 
 	void RayTracingSceneManagerSystem::updateTLASDescriptorSets(int frameIndex, VkAccelerationStructureKHR& newTlas) {
@@ -345,6 +250,8 @@ namespace PXTEngine {
 		tlasInfo.accelerationStructureCount = 1;
 		tlasInfo.pAccelerationStructures = &m_tlases[frameIndex];
 
+		m_frameDescriptorAllocator->allocate(m_tlasDescriptorSetLayout->getDescriptorSetLayout(), m_tlasDescriptorSets[frameIndex]);
+
 		DescriptorWriter(m_context, *m_tlasDescriptorSetLayout)
 			.writeTLAS(0, tlasInfo)
 			.updateSet(m_tlasDescriptorSets[frameIndex]);
@@ -358,74 +265,9 @@ namespace PXTEngine {
 	}
 
 
-	void RayTracingSceneManagerSystem::createMeshInstanceDescriptorSets() {
-		m_meshInstanceDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
-			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-				VK_SHADER_STAGE_FRAGMENT_BIT |
-				VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR |
-				VK_SHADER_STAGE_RAYGEN_BIT_KHR,
-				1)
-			.build();
-
-		for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-			m_descriptorAllocator->allocate(
-				m_meshInstanceDescriptorSetLayout->getDescriptorSetLayout(),
-				m_meshInstanceDescriptorSets[i]
-			);
-		}
-	}
-
-	void RayTracingSceneManagerSystem::updateMeshInstanceDescriptorSets(int frameIndex) {
-		VkDeviceSize bufferSize = sizeof(MeshInstanceData) * m_meshInstanceData.size();
-
-		if (bufferSize == 0) return;
-
-		Unique<VulkanBuffer> stagingBuffer = createUnique<VulkanBuffer>(
-			m_context,
-			bufferSize,
-			1,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-		);
-		stagingBuffer->map();
-		stagingBuffer->writeToBuffer(m_meshInstanceData.data(), bufferSize);
-		stagingBuffer->unmap();
-
-		m_meshInstanceBuffers[frameIndex] = createUnique<VulkanBuffer>(
-			m_context,
-			bufferSize,
-			1,
-			VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
-		);
-
-		m_context.copyBuffer(stagingBuffer->getBuffer(), m_meshInstanceBuffers[frameIndex]->getBuffer(), bufferSize);
-
-		auto bufferInfo = m_meshInstanceBuffers[frameIndex]->descriptorInfo();
-
-		DescriptorWriter(m_context, *m_meshInstanceDescriptorSetLayout)
-			.writeBuffer(0, &bufferInfo)
-			.updateSet(m_meshInstanceDescriptorSets[frameIndex]);
-	}
-
-	void RayTracingSceneManagerSystem::createEmittersDescriptorSets() {
-		m_emittersDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
-			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
-				VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR |
-				VK_SHADER_STAGE_RAYGEN_BIT_KHR,
-				1)
-			.build();
-
-		for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-			m_descriptorAllocator->allocate(
-				m_emittersDescriptorSetLayout->getDescriptorSetLayout(),
-				m_emittersDescriptorSets[i]
-			);
-		}
-	}
-
 	void RayTracingSceneManagerSystem::updateEmittersDescriptorSets(int frameIndex) {
-		uint32_t emitterCount = static_cast<uint32_t>(m_emitters.size());
+		const std::vector<EmitterData>& emitters = m_gpuScene.getSceneData().emitters;
+		uint32_t emitterCount = static_cast<uint32_t>(emitters.size());
 
 		VkDeviceSize emitterDataSize = sizeof(EmitterData) * emitterCount;
 		VkDeviceSize bufferSize = emitterDataSize + sizeof(emitterCount);
@@ -439,7 +281,7 @@ namespace PXTEngine {
 		);
 		stagingBuffer->map();
 		stagingBuffer->writeToBuffer((void*) &emitterCount, sizeof(emitterCount));
-		stagingBuffer->writeToBuffer(m_emitters.data(), emitterDataSize, sizeof(emitterCount));
+		stagingBuffer->writeToBuffer((void*) emitters.data(), emitterDataSize, sizeof(emitterCount));
 		stagingBuffer->unmap();
 
 		m_emittersBuffers[frameIndex] = createUnique<VulkanBuffer>(
@@ -454,28 +296,21 @@ namespace PXTEngine {
 
 		auto bufferInfo = m_emittersBuffers[frameIndex]->descriptorInfo();
 
+		m_frameDescriptorAllocator->allocate(m_emittersDescriptorSetLayout->getDescriptorSetLayout(), m_emittersDescriptorSets[frameIndex]);
+
 		DescriptorWriter(m_context, *m_emittersDescriptorSetLayout)
 			.writeBuffer(0, &bufferInfo)
 			.updateSet(m_emittersDescriptorSets[frameIndex]);
 	}
 
-	void RayTracingSceneManagerSystem::createVolumesDescriptorSets() {
-		m_volumesDescriptorSetLayout = DescriptorSetLayout::Builder(m_context)
-			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_RAYGEN_BIT_KHR | VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR, 1)
-			.build();
-
-		for (int i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-			m_descriptorAllocator->allocate(
-				m_volumesDescriptorSetLayout->getDescriptorSetLayout(),
-				m_volumesDescriptorSets[i]
-			);
-		}
-	}
-
 	void RayTracingSceneManagerSystem::updateVolumesDescriptorSets(int frameIndex) {
-		VkDeviceSize bufferSize = sizeof(VolumeData) * m_volumes.size();
+		std::vector<VolumeData>& volumes = m_gpuScene.getSceneData().volumes;
 
-		if (bufferSize == 0) return;
+		// the set is allocated fresh every frame so it must always be written,
+		// upload a single zeroed entry when there are no volumes
+		if (volumes.empty()) volumes.emplace_back();
+
+		VkDeviceSize bufferSize = sizeof(VolumeData) * volumes.size();
 
 		Unique<VulkanBuffer> stagingBuffer = createUnique<VulkanBuffer>(
 			m_context,
@@ -486,7 +321,7 @@ namespace PXTEngine {
 		);
 
 		stagingBuffer->map();
-		stagingBuffer->writeToBuffer(m_volumes.data(), bufferSize);
+		stagingBuffer->writeToBuffer(volumes.data(), bufferSize);
 		stagingBuffer->unmap();
 
 		m_volumesBuffers[frameIndex] = createUnique<VulkanBuffer>(
@@ -500,8 +335,14 @@ namespace PXTEngine {
 		m_context.copyBuffer(stagingBuffer->getBuffer(), m_volumesBuffers[frameIndex]->getBuffer(), bufferSize);
 
 		auto bufferInfo = m_volumesBuffers[frameIndex]->descriptorInfo();
+		auto atlasInfo = m_brickAtlas.getAtlasImageInfo();
+		auto brickTableInfo = m_brickAtlas.getIndirectionBufferInfo();
+		m_frameDescriptorAllocator->allocate(m_volumesDescriptorSetLayout->getDescriptorSetLayout(), m_volumesDescriptorSets[frameIndex]);
+
 		DescriptorWriter(m_context, *m_volumesDescriptorSetLayout)
 			.writeBuffer(0, &bufferInfo)
+			.writeImage(1, &atlasInfo)
+			.writeBuffer(2, &brickTableInfo)
 			.updateSet(m_volumesDescriptorSets[frameIndex]);
 	}
 }
\ No newline at end of file
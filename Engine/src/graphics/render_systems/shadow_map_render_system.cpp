@@ -3,42 +3,73 @@
 #include "scene/ecs/entity.hpp"
 #include "graphics/resources/vk_mesh.hpp"
 
+#include <bit>
+
 namespace PXTEngine {
 
     struct ShadowMapPushConstantData {
-		// it will be modified to translate the object to the light position (i think so?)
         glm::mat4 modelMatrix{ 1.f };
-		// it will be modified to render the different faces
-		glm::mat4 cubeFaceView{ 1.f };
+		// the face view, translated to the light position
+		glm::mat4 lightFaceView{ 1.f };
     };
 
 	struct ShadowUbo {
 		glm::mat4 projection{ 1.f };
-		// this is a matrix that translates model coordinates to light coordinates
-		glm::mat4 lightOriginModel{ 1.f };
-		PointLight pointLights[MAX_LIGHTS];
-		int numLights;
 	};
 
+	/**
+	 * @brief The tiles of a light, matches the ShadowLight struct in lighting/shadow_map.glsl.
+	 */
+	struct ShadowLightData {
+		glm::vec4 faceRects[6]{}; // .xy = uv offset of the face tile in the atlas, .zw = uv size
+		glm::vec4 position{ 0.0f }; // .xyz = the position the tiles were rendered from
+		glm::vec4 params{ 0.0f };   // .x = 1 if the light is shadowed, .y = size of a texel at distance 1
+	};
+
+	struct ShadowLightingTable {
+		glm::mat4 faceViewProjections[6];
+		ShadowLightData lights[MAX_LIGHTS];
+	};
+
+	namespace {
+		/**
+		 * @brief Whether a sphere, relative to the light, may be seen by a cube face: in front
+		 * of it and inside its four side planes (at 45 degrees from the face axis).
+		 */
+		bool isSphereInCubeFace(const uint32_t face, const glm::vec3& center, const float radius) {
+			const uint32_t axis = face / 2;
+			const float depth = face % 2 == 0 ? center[axis] : -center[axis];
+			if (depth < -radius) return false;
+
+			for (uint32_t side = 1; side < 3; side++) {
+				if (std::abs(center[(axis + side) % 3]) - depth > radius * glm::root_two<float>()) return false;
+			}
+			return true;
+		}
+	}
+
     ShadowMapRenderSystem::ShadowMapRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, DescriptorSetLayout& setLayout)
 		: m_context(context),
 		  m_descriptorAllocator(std::move(descriptorAllocator)) {
 		createUniformBuffers();
 		createDescriptorSets(setLayout);
 		createRenderPass();
-        createOffscreenFrameBuffers();
+        createOffscreenFrameBuffer();
+		createLightingDescriptorSets();
         createPipelineLayout(setLayout);
-        createPipeline();
+        m_pipeline = createPipeline();
 
 		// for debug purposes
-		createDebugDescriptorSets();
+		createDebugDescriptorSet();
     }
 
-    ShadowMapRenderSystem::~ShadowMapRenderSystem() {
-        vkDestroyPipelineLayout(m_context.getDevice(), m_pipelineLayout, nullptr);
-    }
+    ShadowMapRenderSystem::~ShadowMapRenderSystem() = default;
 
 	void ShadowMapRenderSystem::createUniformBuffers() {
+		// the projection is the same for every face of every light
+		ShadowUbo uboOffscreen{};
+		uboOffscreen.projection = glm::perspective(glm::pi<float>() / 2.0f, 1.0f, zNear, zFar);
+
 		// Create uniform buffer for each frame in flight
 		for (size_t i = 0; i < m_lightUniformBuffers.size(); i++) {
 			m_lightUniformBuffers[i] = createUnique<VulkanBuffer>(
@@ -50,6 +81,19 @@ namespace PXTEngine {
 			);
 
 			m_lightUniformBuffers[i]->map();
+			m_lightUniformBuffers[i]->writeToBuffer(&uboOffscreen, sizeof(ShadowUbo), 0);
+		}
+
+		for (size_t i = 0; i < m_lightingTableBuffers.size(); i++) {
+			m_lightingTableBuffers[i] = createUnique<VulkanBuffer>(
+				m_context,
+				sizeof(ShadowLightingTable),
+				1,
+				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+			);
+
+			m_lightingTableBuffers[i]->map();
 		}
 	}
 
@@ -74,21 +118,22 @@ namespace PXTEngine {
 		bool isDepthFormatValid = m_context.getSupportedDepthFormat(&m_offscreenDepthFormat);
 		PXT_ASSERT(isDepthFormatValid, "No depth format available");
 
-		// Color attachment
+		// Color attachment: the tiles not rendered this frame are kept, the rendered ones
+		// are cleared one by one in render()
 		osAttachments[0].format = m_offscreenColorFormat;
 		osAttachments[0].samples = VK_SAMPLE_COUNT_1_BIT;
-		osAttachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		osAttachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
 		osAttachments[0].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 		osAttachments[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		osAttachments[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		osAttachments[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		osAttachments[0].initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 		osAttachments[0].finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-		// Depth attachment
+		// Depth attachment: only needed while a tile is rendered
 		osAttachments[1].format = m_offscreenDepthFormat;
 		osAttachments[1].samples = VK_SAMPLE_COUNT_1_BIT;
-		osAttachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		osAttachments[1].storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		osAttachments[1].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		osAttachments[1].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		osAttachments[1].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		osAttachments[1].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		osAttachments[1].initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
@@ -108,12 +153,33 @@ namespace PXTEngine {
 		subpass.pColorAttachments = &colorReference;
 		subpass.pDepthStencilAttachment = &depthReference;
 
+		// the atlas is kept from frame to frame: the tiles are only rendered once the frames
+		// before have done sampling them, and sampled once rendered
+		std::array<VkSubpassDependency, 2> dependencies{};
+
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+		dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
 		VkRenderPassCreateInfo renderPassCreateInfo = {};
 		renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
 		renderPassCreateInfo.attachmentCount = 2;
 		renderPassCreateInfo.pAttachments = osAttachments;
 		renderPassCreateInfo.subpassCount = 1;
 		renderPassCreateInfo.pSubpasses = &subpass;
+		renderPassCreateInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassCreateInfo.pDependencies = dependencies.data();
 
 		m_renderPass = createUnique<RenderPass>(
 			m_context,
@@ -124,35 +190,73 @@ namespace PXTEngine {
 		);
     }
 
-	void ShadowMapRenderSystem::createOffscreenFrameBuffers() {
-		// For shadow mapping here we need 6 framebuffers, one for each face of the cube map
-		// The class will handle this for us. It will create image views for each face, which
-		// we can use to then create the framebuffers for this class
-		m_shadowCubeMap = createShared<CubeMap>(
-			m_context, 
-			m_shadowMapSize, 
-			m_offscreenColorFormat,
-			VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
+	void ShadowMapRenderSystem::createOffscreenFrameBuffer() {
+		// The atlas: a single 2D image for the cube faces of all the lights, stores the distance to the light
+		VkImageCreateInfo atlasInfo{};
+		atlasInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		atlasInfo.imageType = VK_IMAGE_TYPE_2D;
+		atlasInfo.format = m_offscreenColorFormat;
+		atlasInfo.extent = { ATLAS_SIZE, ATLAS_SIZE, 1 };
+		atlasInfo.mipLevels = 1;
+		atlasInfo.arrayLayers = 1;
+		atlasInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		atlasInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		atlasInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		atlasInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		atlasInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		m_atlasImage = createShared<VulkanImage>(m_context, atlasInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		// the render pass loads it, the tiles not rendered yet are never sampled (see writeLightingTable)
+		m_atlasImage->transitionImageLayoutSingleTimeCmd(
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT
 		);
 
-		// ------------- Create framebuffers for each face of the cube map -------------
-
-		// The color attachment is the cube map image view (we have 6, one for each framebuffer).
-		// While the depth stencil is the same for all framebuffers. We will create the latter now
-		// and then copy the cube face image views to the framebuffer color attachments
-
-		// Depth stencil attachment
+		VkImageViewCreateInfo atlasViewInfo{};
+		atlasViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		atlasViewInfo.image = m_atlasImage->getVkImage();
+		atlasViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		atlasViewInfo.format = m_offscreenColorFormat;
+		atlasViewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		atlasViewInfo.subresourceRange.baseMipLevel = 0;
+		atlasViewInfo.subresourceRange.levelCount = 1;
+		atlasViewInfo.subresourceRange.baseArrayLayer = 0;
+		atlasViewInfo.subresourceRange.layerCount = 1;
+
+		m_atlasImage->createImageView(atlasViewInfo);
+
+		// the shaders filter themselves (PCF), the samples are clamped inside the tiles
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.anisotropyEnable = VK_FALSE;
+		samplerInfo.maxAnisotropy = 1.0f;
+		samplerInfo.unnormalizedCoordinates = VK_FALSE;
+		samplerInfo.compareEnable = VK_FALSE;
+		samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.minLod = 0.0f;
+		samplerInfo.maxLod = 0.0f;
+
+		m_atlasImage->createSampler(samplerInfo);
+
+		// Depth stencil attachment, as large as the atlas: the tiles are rendered one after the other
 		VkImageCreateInfo imageCreateInfo = {};
 		imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
 		imageCreateInfo.format = m_offscreenDepthFormat;
-		imageCreateInfo.extent = { m_shadowMapSize, m_shadowMapSize, 1 };
+		imageCreateInfo.extent = { ATLAS_SIZE, ATLAS_SIZE, 1 };
 		imageCreateInfo.mipLevels = 1;
 		imageCreateInfo.arrayLayers = 1;
 		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
-		// Image of the framebuffer is blit source
-		imageCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+		imageCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
 		imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
@@ -164,7 +268,6 @@ namespace PXTEngine {
 		subresourceRange.levelCount = 1;
 		subresourceRange.layerCount = 1;
 
-		// TODO: verify source and destination access masks
 		m_depthStencilImageFb->transitionImageLayoutSingleTimeCmd(
 			VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
 			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
@@ -189,8 +292,8 @@ namespace PXTEngine {
 
 		m_depthStencilImageFb->createImageView(depthStencilViewInfo);
 
-		// Create framebuffers for each face of the cube map
 		VkImageView attachments[2]{};
+		attachments[0] = m_atlasImage->getImageView();
 		attachments[1] = m_depthStencilImageFb->getImageView();
 
 		VkFramebufferCreateInfo fbufCreateInfo = {};
@@ -198,35 +301,36 @@ namespace PXTEngine {
 		fbufCreateInfo.renderPass = m_renderPass->getHandle();
 		fbufCreateInfo.attachmentCount = 2;
 		fbufCreateInfo.pAttachments = attachments;
-		fbufCreateInfo.width = m_shadowMapSize;
-		fbufCreateInfo.height = m_shadowMapSize;
+		fbufCreateInfo.width = ATLAS_SIZE;
+		fbufCreateInfo.height = ATLAS_SIZE;
 		fbufCreateInfo.layers = 1;
 
-		for (uint32_t i = 0; i < 6; i++)
-		{
-			attachments[0] = m_shadowCubeMap->getFaceImageView(i);
-			
-			m_cubeFramebuffers[i] = createUnique<FrameBuffer>(
-				m_context,
-				fbufCreateInfo,
-				"ShadowMapRenderSystem Framebuffer for Cube Face " + std::to_string(i),
-				m_shadowCubeMap,
-				m_depthStencilImageFb
-			);
-		}
+		m_atlasFramebuffer = createUnique<FrameBuffer>(
+			m_context,
+			fbufCreateInfo,
+			"ShadowMapRenderSystem Atlas Framebuffer",
+			m_atlasImage,
+			m_depthStencilImageFb
+		);
+	}
+
+	void ShadowMapRenderSystem::createLightingDescriptorSets() {
+		m_lightingSetLayout = DescriptorSetLayout::Builder(m_context)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
+			.addBinding(1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+			.build();
 
-		// -----------------------------------------------------------------------------
+		VkDescriptorImageInfo atlasInfo = m_atlasImage->getImageInfo();
 
-		// Create image descriptor info for shadow map
-		m_shadowMapDescriptorInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		m_shadowMapDescriptorInfo.imageView = m_shadowCubeMap->getImageView();
-		m_shadowMapDescriptorInfo.sampler = m_shadowCubeMap->getImageSampler();
+		for (int i = 0; i < m_lightingDescriptorSets.size(); i++) {
+			auto tableInfo = m_lightingTableBuffers[i]->descriptorInfo();
 
-		// Create image descriptor info for debug view
-		for (uint16_t i = 0; i < 6; i++) {
-			m_debugImageDescriptorInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			m_debugImageDescriptorInfos[i].imageView = m_shadowCubeMap->getFaceImageView(i);
-			m_debugImageDescriptorInfos[i].sampler = m_shadowCubeMap->getImageSampler();
+			m_descriptorAllocator->allocate(m_lightingSetLayout->getDescriptorSetLayout(), m_lightingDescriptorSets[i]);
+
+			DescriptorWriter(m_context, *m_lightingSetLayout)
+				.writeImage(0, &atlasInfo)
+				.writeBuffer(1, &tableInfo)
+				.updateSet(m_lightingDescriptorSets[i]);
 		}
 	}
 
@@ -245,12 +349,10 @@ namespace PXTEngine {
         pipelineLayoutInfo.pushConstantRangeCount = 1;
         pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create pipeline layout for shadow render system!");
-        }
+        m_pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
     }
 
-    void ShadowMapRenderSystem::createPipeline(bool useCompiledSpirvFiles) {
+    Unique<Pipeline> ShadowMapRenderSystem::createPipeline(bool useCompiledSpirvFiles) const {
 		PXT_ASSERT(m_pipelineLayout != nullptr, "Cannot create pipeline before pipelineLayout");
 
         RasterizationPipelineConfigInfo pipelineConfig{};
@@ -269,7 +371,7 @@ namespace PXTEngine {
 			shaderFilePaths.push_back(baseShaderPath + filePath + filenameSuffix);
 		};
 
-        m_pipeline = createUnique<Pipeline>(
+        return createUnique<Pipeline>(
             m_context,
 			shaderFilePaths,
             pipelineConfig
@@ -277,77 +379,368 @@ namespace PXTEngine {
     }
 
 	void ShadowMapRenderSystem::update(FrameInfo& frameInfo, GlobalUbo& ubo) {
-		// Get the light position from the scene and set the other ubo values for offscreen rendering
-		glm::vec4 lightPos = ubo.pointLights[0].position;
+		m_frameCount++;
 
-		ShadowUbo uboOffscreen{};
-		// to set the projection (square depth map)
-		uboOffscreen.projection = glm::perspective(glm::pi<float>() / 2.0f, 1.0f, zNear, zFar);
-		// this will create a translation matrix to translate the model vertices by the light position
-		uboOffscreen.lightOriginModel = glm::translate(glm::mat4(1.0f), glm::vec3(-lightPos.x, -lightPos.y, -lightPos.z));
-		uboOffscreen.numLights = ubo.numLights;
+		for (int i = 0; i < MAX_LIGHTS; i++) {
+			ShadowedLight& light = m_lights[i];
+
+			// the lights are identified by their index: a light taking the place of another one
+			// is seen as the previous one moving, which renders its tiles again
+			if (i >= ubo.numLights) {
+				freeTiles(light);
+				light.importance = 0.0f;
+				continue;
+			}
+
+			light.position = glm::vec3(ubo.pointLights[i].position);
+		}
+
+		updateTiles(ubo);
+	}
 
-		// set the light position and color
+	uint32_t ShadowMapRenderSystem::getDesiredTileSize(const ShadowedLight& light) const {
+		const float importance = std::clamp(light.importance, 0.0f, 1.0f);
+		const float tileSize = std::max(importance * static_cast<float>(MAX_TILE_SIZE), static_cast<float>(MIN_TILE_SIZE));
+
+		return std::bit_floor(static_cast<uint32_t>(tileSize));
+	}
+
+	void ShadowMapRenderSystem::updateTiles(const GlobalUbo& ubo) {
+		const glm::vec3 cameraPosition = glm::vec3(ubo.inverseView[3]);
+		// 1 / tan(fov / 2): how large an object at distance 1 looks, relative to half the screen height
+		const float projectionScale = std::abs(ubo.projection[1][1]);
+
+		std::vector<uint32_t> lightOrder;
 		for (int i = 0; i < ubo.numLights; i++) {
-			uboOffscreen.pointLights[i].position = ubo.pointLights[i].position;
-			uboOffscreen.pointLights[i].color = ubo.pointLights[i].color;
+			ShadowedLight& light = m_lights[i];
+			const PointLight& pointLight = ubo.pointLights[i];
+
+			// the distance at which the light gets too dim to cast a visible shadow
+			const float intensity = pointLight.color.w * std::max({ pointLight.color.r, pointLight.color.g, pointLight.color.b });
+			const float radius = std::min(std::sqrt(std::max(intensity, 0.0f) / MIN_IRRADIANCE), zFar);
+
+			// the projected size of the sphere of influence, the whole screen when the camera is in it
+			const float distance = glm::length(light.position - cameraPosition);
+			light.importance = distance <= radius
+				? 1.0f
+				: std::min(radius / std::sqrt(distance * distance - radius * radius) * projectionScale, 1.0f);
+
+			lightOrder.push_back(i);
 		}
 
-		m_lightUniformBuffers[frameInfo.frameIndex]->writeToBuffer(&uboOffscreen, sizeof(ShadowUbo), 0);
-		m_lightUniformBuffers[frameInfo.frameIndex]->flush();
+		std::stable_sort(lightOrder.begin(), lightOrder.end(), [this](uint32_t a, uint32_t b) {
+			return m_lights[a].importance > m_lights[b].importance;
+		});
+
+		m_stats.shadowedLightCount = 0;
+		m_stats.unshadowedLightCount = 0;
+
+		for (size_t order = 0; order < lightOrder.size(); order++) {
+			ShadowedLight& light = m_lights[lightOrder[order]];
+			const uint32_t desiredTileSize = getDesiredTileSize(light);
+
+			if (light.hasTiles()) {
+				// some hysteresis, a light at the edge of two sizes doesn't keep switching
+				const float wantedTexels = light.importance * static_cast<float>(MAX_TILE_SIZE);
+				const bool isTooLarge = light.tileSize > MIN_TILE_SIZE && wantedTexels < 0.75f * static_cast<float>(light.tileSize);
+				const bool isTooSmall = desiredTileSize > light.tileSize && wantedTexels >= 2.5f * static_cast<float>(light.tileSize);
+
+				if (isTooLarge) {
+					// when the atlas is too full to keep both, the freed tiles always make room for the smaller ones
+					if (!reallocateTiles(light, desiredTileSize)) {
+						freeTiles(light);
+						allocateTiles(light, desiredTileSize);
+					}
+				} else if (isTooSmall) {
+					// the old tiles are kept until the larger ones are found, the light stays shadowed meanwhile
+					reallocateTiles(light, desiredTileSize);
+				}
+			} else {
+				// take the largest tiles left, evicting the least important lights when the atlas is full
+				while (true) {
+					bool isAllocated = false;
+					for (uint32_t tileSize = desiredTileSize; tileSize >= MIN_TILE_SIZE && !isAllocated; tileSize /= 2) {
+						isAllocated = allocateTiles(light, tileSize);
+					}
+					if (isAllocated) break;
+
+					auto victim = std::find_if(lightOrder.rbegin(), lightOrder.rend() - order - 1,
+						[this](uint32_t i) { return m_lights[i].hasTiles(); });
+					if (victim == lightOrder.rend() - order - 1) break;
+
+					freeTiles(m_lights[*victim]);
+				}
+			}
+
+			if (light.hasTiles()) {
+				m_stats.shadowedLightCount++;
+			} else {
+				m_stats.unshadowedLightCount++;
+			}
+		}
 	}
 
-    void ShadowMapRenderSystem::render(FrameInfo& frameInfo, Renderer& renderer) {
-        m_pipeline->bind(frameInfo.commandBuffer);
-
-        vkCmdBindDescriptorSets(
-            frameInfo.commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            m_pipelineLayout,
-            0,
-            1,
-            &m_lightDescriptorSets[frameInfo.frameIndex],
-            0,
-            nullptr
-        );
+	bool ShadowMapRenderSystem::allocateTiles(ShadowedLight& light, const uint32_t tileSize) {
+		std::array<ShadowAtlas::Tile, 6> tiles{};
 
-		// get all the entities with a transform and model component (for later)
-        auto view = frameInfo.scene.getEntitiesWith<TransformComponent, MeshComponent>();
+		for (uint32_t face = 0; face < 6; face++) {
+			tiles[face] = m_atlas.allocate(tileSize);
 
-		// Loop through each face of the cube map and render the scene from that perspective
-		// we need one render pass per face of the cube map, each time we modify the view matrix
+			if (!tiles[face].isValid()) {
+				for (uint32_t allocated = 0; allocated < face; allocated++) {
+					m_atlas.free(tiles[allocated]);
+				}
+				return false;
+			}
+		}
+
+		light.tiles = tiles;
+		light.tileSize = tileSize;
+		light.isRendered = false;
+		return true;
+	}
+
+	bool ShadowMapRenderSystem::reallocateTiles(ShadowedLight& light, const uint32_t tileSize) {
+		const std::array<ShadowAtlas::Tile, 6> oldTiles = light.tiles;
+		const uint32_t oldTileSize = light.tileSize;
+		const bool wasRendered = light.isRendered;
+
+		if (!allocateTiles(light, tileSize)) return false;
+
+		if (wasRendered) {
+			// the shadows published until the new tiles are rendered
+			freePreviousTiles(light);
+			light.previousTiles = oldTiles;
+			light.previousTileSize = oldTileSize;
+		} else {
+			// never rendered, the previous tiles (if any) are still the ones published
+			for (const ShadowAtlas::Tile& tile : oldTiles) {
+				m_atlas.free(tile);
+			}
+		}
+
+		return true;
+	}
+
+	void ShadowMapRenderSystem::freeTiles(ShadowedLight& light) {
+		for (ShadowAtlas::Tile& tile : light.tiles) {
+			m_atlas.free(tile);
+			tile = {};
+		}
+
+		light.tileSize = 0;
+		light.isRendered = false;
+
+		freePreviousTiles(light);
+	}
+
+	void ShadowMapRenderSystem::freePreviousTiles(ShadowedLight& light) {
+		if (!light.hasPreviousTiles()) return;
+
+		for (ShadowAtlas::Tile& tile : light.previousTiles) {
+			m_atlas.free(tile);
+			tile = {};
+		}
+
+		light.previousTileSize = 0;
+	}
+
+	void ShadowMapRenderSystem::selectLightsToRender() {
+		m_lightsToRender.clear();
+
+		std::vector<uint32_t> candidates;
+		for (uint32_t i = 0; i < MAX_LIGHTS; i++) {
+			const ShadowedLight& light = m_lights[i];
+			if (!light.hasTiles()) continue;
+
+			if (!light.isRendered || light.position != light.renderedPosition ||
+				m_frameCount - light.renderedFrame >= static_cast<uint64_t>(m_refreshInterval)) {
+				candidates.push_back(i);
+			}
+		}
+
+		// the new and moved lights first, by importance, then the ones refreshed the longest time ago
+		std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+			const ShadowedLight& lightA = m_lights[a];
+			const ShadowedLight& lightB = m_lights[b];
+
+			const bool isUrgentA = !lightA.isRendered || lightA.position != lightA.renderedPosition;
+			const bool isUrgentB = !lightB.isRendered || lightB.position != lightB.renderedPosition;
+			if (isUrgentA != isUrgentB) return isUrgentA;
+			if (isUrgentA) return lightA.importance > lightB.importance;
+
+			return lightA.renderedFrame < lightB.renderedFrame;
+		});
+
+		uint64_t texelCount = 0;
+		for (const uint32_t i : candidates) {
+			const uint64_t lightTexelCount = 6ull * m_lights[i].tileSize * m_lights[i].tileSize;
+
+			// a smaller light may still fit in what is left of the budget
+			if (!m_lightsToRender.empty() && texelCount + lightTexelCount > static_cast<uint64_t>(m_texelBudget)) continue;
+
+			m_lightsToRender.push_back(i);
+			texelCount += lightTexelCount;
+		}
+
+		m_stats.renderedLightCount = static_cast<uint32_t>(m_lightsToRender.size());
+		m_stats.renderedTexelCount = texelCount;
+	}
+
+	void ShadowMapRenderSystem::writeLightingTable(int frameIndex) {
+		ShadowLightingTable table{};
+
+		const glm::mat4 projection = glm::perspective(glm::pi<float>() / 2.0f, 1.0f, zNear, zFar);
 		for (uint32_t face = 0; face < 6; face++) {
+			table.faceViewProjections[face] = projection * getFaceViewMatrix(face);
+		}
 
-			renderer.beginRenderPass(frameInfo.commandBuffer, *m_renderPass, this->getCubeFaceFramebuffer(face), this->getExtent());
+		m_publishedLightCount = 0;
 
-			ShadowMapPushConstantData push{};
-			push.cubeFaceView = this->getFaceViewMatrix(face);
+		const float atlasSize = static_cast<float>(ATLAS_SIZE);
+		for (uint32_t i = 0; i < MAX_LIGHTS; i++) {
+			const ShadowedLight& light = m_lights[i];
 
-			for (auto entity : view) {
+			// the tiles never rendered hold someone else's shadows (or nothing at all),
+			// a reallocated light keeps its previous tiles until then (renderedPosition is still theirs)
+			if (!light.hasTiles()) continue;
+
+			const bool isPublishingPrevious = !light.isRendered;
+			if (isPublishingPrevious && !light.hasPreviousTiles()) continue;
+
+			const std::array<ShadowAtlas::Tile, 6>& tiles = isPublishingPrevious ? light.previousTiles : light.tiles;
+			const uint32_t tileSize = isPublishingPrevious ? light.previousTileSize : light.tileSize;
+
+			ShadowLightData& data = table.lights[i];
+			for (uint32_t face = 0; face < 6; face++) {
+				const ShadowAtlas::Tile& tile = tiles[face];
+				data.faceRects[face] = glm::vec4(tile.x, tile.y, tile.size, tile.size) / atlasSize;
+			}
+			data.position = glm::vec4(light.renderedPosition, 1.0f);
+			data.params = glm::vec4(1.0f, 2.0f / static_cast<float>(tileSize), 0.0f, 0.0f);
+			m_publishedLightCount++;
+		}
+
+		m_lightingTableBuffers[frameIndex]->writeToBuffer(&table, sizeof(ShadowLightingTable), 0);
+		m_lightingTableBuffers[frameIndex]->flush();
+	}
 
-				const auto& [transform, meshComponent] = view.get<TransformComponent, MeshComponent>(entity);
+    void ShadowMapRenderSystem::render(FrameInfo& frameInfo, Renderer& renderer) {
+		// chosen here rather than in update(), the tiles are only rendered on the rasterization path
+		selectLightsToRender();
 
-				push.modelMatrix = transform.mat4();
+		if (!m_lightsToRender.empty()) {
+			renderer.beginRenderPass(frameInfo.commandBuffer, *m_renderPass, *m_atlasFramebuffer, { ATLAS_SIZE, ATLAS_SIZE });
 
-				vkCmdPushConstants(
-					frameInfo.commandBuffer,
-					m_pipelineLayout,
-					VK_SHADER_STAGE_VERTEX_BIT,
-					0,
-					sizeof(ShadowMapPushConstantData),
-					&push);
+			m_pipeline->bind(frameInfo.commandBuffer);
 
-				auto vulkanModel = std::static_pointer_cast<VulkanMesh>(meshComponent.mesh);
+			vkCmdBindDescriptorSets(
+				frameInfo.commandBuffer,
+				VK_PIPELINE_BIND_POINT_GRAPHICS,
+				m_pipelineLayout,
+				0,
+				1,
+				&m_lightDescriptorSets[frameInfo.frameIndex],
+				0,
+				nullptr
+			);
 
-				vulkanModel->bind(frameInfo.commandBuffer);
-				vulkanModel->draw(frameInfo.commandBuffer);
+			// every entity with a mesh has a packet, brought up to date by the gpu scene this frame
+			auto view = frameInfo.scene.getEntitiesWith<RenderPacketComponent>();
+
+			struct ShadowCaster {
+				VulkanMesh* mesh;
+				const glm::mat4* objectToWorld;
+				glm::vec3 center; // of the bounding sphere, relative to the light
+				float radius;
+			};
+			std::vector<ShadowCaster> casters;
+
+			for (const uint32_t lightIndex : m_lightsToRender) {
+				ShadowedLight& light = m_lights[lightIndex];
+				const glm::mat4 lightTranslation = glm::translate(glm::mat4(1.0f), -light.position);
+
+				// the objects past the far plane can't cast shadows in the tiles
+				casters.clear();
+				for (auto entity : view) {
+					const auto& packet = view.get<RenderPacketComponent>(entity);
+
+					auto* vulkanModel = static_cast<VulkanMesh*>(packet.mesh);
+					if (vulkanModel == nullptr) continue;
+
+					const glm::vec4 boundingSphere = vulkanModel->getBoundingSphere();
+					const glm::mat4& objectToWorld = packet.objectToWorld;
+					const float scale = std::max({ glm::length(glm::vec3(objectToWorld[0])), glm::length(glm::vec3(objectToWorld[1])),
+						glm::length(glm::vec3(objectToWorld[2])) });
+
+					const glm::vec3 center = glm::vec3(objectToWorld * glm::vec4(glm::vec3(boundingSphere), 1.0f)) - light.position;
+					const float radius = boundingSphere.w * scale;
+					if (glm::length(center) - radius > zFar) continue;
+
+					casters.push_back({ vulkanModel, &objectToWorld, center, radius });
+				}
+
+				for (uint32_t face = 0; face < 6; face++) {
+					const ShadowAtlas::Tile& tile = light.tiles[face];
+
+					VkViewport viewport{};
+					viewport.x = static_cast<float>(tile.x);
+					viewport.y = static_cast<float>(tile.y);
+					viewport.width = static_cast<float>(tile.size);
+					viewport.height = static_cast<float>(tile.size);
+					viewport.minDepth = 0.0f;
+					viewport.maxDepth = 1.0f;
+					VkRect2D scissor{ { static_cast<int32_t>(tile.x), static_cast<int32_t>(tile.y) }, { tile.size, tile.size } };
+					vkCmdSetViewport(frameInfo.commandBuffer, 0, 1, &viewport);
+					vkCmdSetScissor(frameInfo.commandBuffer, 0, 1, &scissor);
+
+					// nothing drawn means nothing in between: as far as it gets
+					std::array<VkClearAttachment, 2> clearAttachments{};
+					clearAttachments[0].aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+					clearAttachments[0].colorAttachment = 0;
+					clearAttachments[0].clearValue.color = { { std::numeric_limits<float>::max(), 0.0f, 0.0f, 0.0f } };
+					clearAttachments[1].aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+					clearAttachments[1].clearValue.depthStencil = { 1.0f, 0 };
+
+					VkClearRect clearRect{ scissor, 0, 1 };
+					vkCmdClearAttachments(frameInfo.commandBuffer, static_cast<uint32_t>(clearAttachments.size()), clearAttachments.data(), 1, &clearRect);
+
+					ShadowMapPushConstantData push{};
+					push.lightFaceView = getFaceViewMatrix(face) * lightTranslation;
+
+					for (const ShadowCaster& caster : casters) {
+						if (!isSphereInCubeFace(face, caster.center, caster.radius)) continue;
+
+						push.modelMatrix = *caster.objectToWorld;
+
+						vkCmdPushConstants(
+							frameInfo.commandBuffer,
+							m_pipelineLayout,
+							VK_SHADER_STAGE_VERTEX_BIT,
+							0,
+							sizeof(ShadowMapPushConstantData),
+							&push);
+
+						caster.mesh->bind(frameInfo.commandBuffer);
+						caster.mesh->draw(frameInfo.commandBuffer);
+					}
+				}
+
+				light.renderedPosition = light.position;
+				light.renderedFrame = m_frameCount;
+				light.isRendered = true;
+
+				// the table of this frame publishes the new tiles
+				freePreviousTiles(light);
 			}
 
-			renderer.endRenderPass(frameInfo.commandBuffer, *m_renderPass, this->getCubeFaceFramebuffer(face));
+			renderer.endRenderPass(frameInfo.commandBuffer, *m_renderPass, *m_atlasFramebuffer);
 		}
+
+		writeLightingTable(frameInfo.frameIndex);
     }
 
-	glm::mat4 ShadowMapRenderSystem::getFaceViewMatrix(uint32_t faceIndex) {
+	glm::mat4 ShadowMapRenderSystem::getFaceViewMatrix(uint32_t faceIndex) const {
 		glm::mat4 viewMatrix = glm::mat4(1.0f);
 		switch (faceIndex)
 		{
@@ -376,69 +769,64 @@ namespace PXTEngine {
 		return viewMatrix;
 	}
 
-	void ShadowMapRenderSystem::createDebugDescriptorSets() {
+	void ShadowMapRenderSystem::createDebugDescriptorSet() {
 		Unique<DescriptorSetLayout> debugSetLayout = DescriptorSetLayout::Builder(m_context)
 			.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT)
 			.build();
 
-		// Create descriptor set for each face of the cube map
-		for (int i = 0; i < m_debugImageDescriptorInfos.size(); i++) {
-			m_descriptorAllocator->allocate(debugSetLayout->getDescriptorSetLayout(), m_shadowMapDebugDescriptorSets[i]);
-			DescriptorWriter(m_context, *debugSetLayout)
-				.writeImage(0, &m_debugImageDescriptorInfos[i])
-				.updateSet(m_shadowMapDebugDescriptorSets[i]);
-		}
+		VkDescriptorImageInfo atlasInfo = m_atlasImage->getImageInfo();
+
+		m_descriptorAllocator->allocate(debugSetLayout->getDescriptorSetLayout(), m_atlasDebugDescriptorSet);
+		DescriptorWriter(m_context, *debugSetLayout)
+			.writeImage(0, &atlasInfo)
+			.updateSet(m_atlasDebugDescriptorSet);
 	}
 
 	void ShadowMapRenderSystem::updateUi() {
-		updateShadowCubeMapDebugWindow();
+		updateShadowAtlasDebugWindow();
 	}
 
-	void ShadowMapRenderSystem::reloadShaders() {
-		PXT_INFO("Reloading shaders...");
-		createPipeline(false);
+	void ShadowMapRenderSystem::registerShaders(ShaderReloader& shaderReloader) {
+		std::vector<std::filesystem::path> sourceFiles;
+		for (const auto& filePath : m_shaderFilePaths) {
+			sourceFiles.push_back(SHADERS_PATH + filePath);
+		}
+
+		shaderReloader.addPipeline("Shadow map", sourceFiles, [this] { return createPipeline(false); }, m_pipeline);
 	}
 
-	void ShadowMapRenderSystem::updateShadowCubeMapDebugWindow() {
-		ImTextureID cube_posx = (ImTextureID)m_shadowMapDebugDescriptorSets[0];
-		ImTextureID cube_negx = (ImTextureID)m_shadowMapDebugDescriptorSets[1];
-		ImTextureID cube_posy = (ImTextureID)m_shadowMapDebugDescriptorSets[3]; // swap negative and positive y because vulkan :)
-		ImTextureID cube_negy = (ImTextureID)m_shadowMapDebugDescriptorSets[2];
-		ImTextureID cube_posz = (ImTextureID)m_shadowMapDebugDescriptorSets[4];
-		ImTextureID cube_negz = (ImTextureID)m_shadowMapDebugDescriptorSets[5];
-
-		/* Render the shadow cube map textures flat out in this format (with y mirrored):
-		//       +----+
-				 | +Y |
-			+----+----+----+----+
-			| -X | +Z | +X | -Z |
-			+----+----+----+----+
-				 | -Y |
-				 +----+
-		*/
-
-		ImGui::Begin("Shadow Cube Map Debug");
-
-		ImVec2 faceSize = ImVec2(128, 128);
-		float spacing = ImGui::GetStyle().ItemSpacing.x;
-		float totalMiddleRowWidth = faceSize.x * 4 + spacing * 3;
-		float offsetToCenter = (ImGui::GetContentRegionAvail().x - totalMiddleRowWidth) * 0.5f;
-
-		// Row 1: Centered +Y
-		ImGui::SetCursorPosX(offsetToCenter + faceSize.x + spacing);  // Center it over 4 middle-row faces
-		ImGui::Image(cube_posy, faceSize, ImVec2(0, 1), ImVec2(1, 0));
-
-		// Row 2: -X +Z +X -Z
-		ImGui::SetCursorPosX(offsetToCenter); // Align middle row
-		ImGui::Image(cube_negx, faceSize, ImVec2(0, 1), ImVec2(1, 0)); ImGui::SameLine();
-		ImGui::Image(cube_posz, faceSize, ImVec2(0, 1), ImVec2(1, 0)); ImGui::SameLine();
-		ImGui::Image(cube_posx, faceSize, ImVec2(0, 1), ImVec2(1, 0)); ImGui::SameLine();
-		ImGui::Image(cube_negz, faceSize, ImVec2(0, 1), ImVec2(1, 0));
-
-		// Row 3: Centered -Y
-		ImGui::SetCursorPosX(offsetToCenter + faceSize.x + spacing);  // Same X as +Y
-		ImGui::Image(cube_negy, faceSize, ImVec2(0, 1), ImVec2(1, 0));
+	void ShadowMapRenderSystem::updateShadowAtlasDebugWindow() {
+		ImGui::Begin("Shadow Atlas Debug");
+
+		ImGui::Text("Shadowed lights: %u", m_stats.shadowedLightCount);
+		if (m_stats.unshadowedLightCount > 0) {
+			ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.0f, 1.0f), "Lights left unshadowed (atlas full): %u", m_stats.unshadowedLightCount);
+		}
+		ImGui::Text("Atlas used: %.1f%%", 100.0 * static_cast<double>(m_atlas.getUsedTexelCount()) / (static_cast<double>(ATLAS_SIZE) * ATLAS_SIZE));
+		ImGui::Text("Rendered this frame: %u lights, %.2f M texels", m_stats.renderedLightCount, static_cast<double>(m_stats.renderedTexelCount) / 1e6);
+
+		ImGui::DragInt("Texel budget", &m_texelBudget, 16384.0f, 6 * MIN_TILE_SIZE * MIN_TILE_SIZE, ATLAS_SIZE * ATLAS_SIZE);
+		ImGui::SliderInt("Refresh interval", &m_refreshInterval, 1, 60);
+
+		if (ImGui::TreeNode("Lights")) {
+			for (uint32_t i = 0; i < MAX_LIGHTS; i++) {
+				const ShadowedLight& light = m_lights[i];
+				if (light.importance <= 0.0f) continue;
+
+				if (light.hasTiles()) {
+					ImGui::Text("Light %u: %ux%u tiles, importance %.2f, rendered %llu frames ago", i, light.tileSize, light.tileSize,
+						light.importance, static_cast<unsigned long long>(m_frameCount - light.renderedFrame));
+				} else {
+					ImGui::Text("Light %u: unshadowed, importance %.2f", i, light.importance);
+				}
+			}
+			ImGui::TreePop();
+		}
+
+		// the tiles are stored with y going down, like the framebuffer
+		const float previewSize = std::min(ImGui::GetContentRegionAvail().x, 512.0f);
+		ImGui::Image((ImTextureID)m_atlasDebugDescriptorSet, ImVec2(previewSize, previewSize));
 
 		ImGui::End();
 	}
-}
\ No newline at end of file
+}
@@ -2,16 +2,39 @@
 
 #include "core/pch.hpp"
 #include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
+#include "graphics/shadow_atlas.hpp"
 #include "graphics/renderer.hpp"
 #include "graphics/swap_chain.hpp"
 #include "graphics/context/context.hpp"
 #include "graphics/frame_info.hpp"
 #include "graphics/resources/vk_buffer.hpp"
-#include "graphics/resources/cube_map.hpp"
+#include "graphics/resources/vk_image.hpp"
 #include "graphics/descriptors/descriptors.hpp"
 #include "graphics/render_pass.hpp"
 
 namespace PXTEngine {
+
+    /**
+     * @class ShadowMapRenderSystem
+     *
+     * @brief Renders the point light shadows in a shadow atlas shared by all the lights.
+     *
+     * Every shadowed light gets six tiles of the atlas, one per cube face, all of the same size.
+     * The size follows the importance of the light on screen (how large its area of influence
+     * looks from the camera): the most important lights are given their tiles first and
+     * the less important ones shrink, down to the minimum tile size, or are left unshadowed
+     * when the atlas is full.
+     *
+     * The tiles are not rendered every frame: a light is rendered when it gets new tiles or
+     * moves, and otherwise at most every refresh interval frames. The lights due are rendered
+     * in that order until the per-frame texel budget is spent (at least one light per frame),
+     * so the cost of the shadows doesn't grow with the number of lights.
+     *
+     * The lighting shaders find the tiles of a light in the table of the lighting descriptor
+     * set (see lighting/shadow_map.glsl), which also has the position each light was last
+     * rendered from: a light waiting for its turn keeps the shadows of where it was.
+     */
     class ShadowMapRenderSystem {
     public:
         ShadowMapRenderSystem(Context& context, Shared<DescriptorAllocatorGrowable> descriptorAllocator, DescriptorSetLayout& setLayout);
@@ -23,33 +46,92 @@ namespace PXTEngine {
 		void update(FrameInfo& frameInfo, GlobalUbo& ubo);
         void render(FrameInfo& frameInfo, Renderer& renderer);
         void updateUi();
-		void reloadShaders();
+		void registerShaders(ShaderReloader& shaderReloader);
+
+		/**
+		 * @brief The layout of the set the lighting shaders sample the shadows with:
+		 * binding 0 is the atlas, binding 1 the light to tile table.
+		 */
+		DescriptorSetLayout& getLightingSetLayout() const { return *m_lightingSetLayout; }
+		VkDescriptorSet getLightingDescriptorSet(int frameIndex) const { return m_lightingDescriptorSets[frameIndex]; }
 
-		FrameBuffer& getCubeFaceFramebuffer(uint32_t face_index) const { return *m_cubeFramebuffers[face_index]; }
-		VkExtent2D getExtent() const { return { m_shadowMapSize, m_shadowMapSize }; }
-		VkDescriptorImageInfo getShadowMapImageInfo() const { return m_shadowMapDescriptorInfo; }
-        std::array<VkDescriptorImageInfo, 6> getDebugShadowMapImageInfos() const { return m_debugImageDescriptorInfos; }
+		// the lights with shadows in the lighting table of the last frame rendered
+		uint32_t getPublishedLightCount() const { return m_publishedLightCount; }
 
     private:
+		/**
+		 * @brief The shadow state of a light of the global ubo, by index.
+		 */
+		struct ShadowedLight {
+			std::array<ShadowAtlas::Tile, 6> tiles{}; // one per cube face, invalid if unshadowed
+			uint32_t tileSize = 0;
+			float importance = 0.0f;
+
+			glm::vec3 position{ 0.0f };         // this frame
+			glm::vec3 renderedPosition{ 0.0f }; // the one the tiles were last rendered from
+			uint64_t renderedFrame = 0;
+			bool isRendered = false; // false until the tiles have been rendered once
+
+			// the rendered tiles replaced by a reallocation, published until the new ones are rendered
+			std::array<ShadowAtlas::Tile, 6> previousTiles{};
+			uint32_t previousTileSize = 0;
+
+			bool hasTiles() const { return tiles[0].isValid(); }
+			bool hasPreviousTiles() const { return previousTiles[0].isValid(); }
+		};
+
+		struct Stats {
+			uint32_t shadowedLightCount = 0;
+			uint32_t unshadowedLightCount = 0; // lights left out because the atlas is full
+			uint32_t renderedLightCount = 0;   // this frame
+			uint64_t renderedTexelCount = 0;   // this frame
+		};
+
         void createUniformBuffers();
 		void createDescriptorSets(DescriptorSetLayout& setLayout);
         void createRenderPass();
-        void createOffscreenFrameBuffers();
+        void createOffscreenFrameBuffer();
+		void createLightingDescriptorSets();
         void createPipelineLayout(DescriptorSetLayout& setLayout);
-        void createPipeline(bool useCompiledSpirvFiles = true);
+        Unique<Pipeline> createPipeline(bool useCompiledSpirvFiles = true) const;
+
+        void createDebugDescriptorSet();
+        void updateShadowAtlasDebugWindow();
+
+		/**
+		 * @brief The tile size the light is worth, from the size of its area of influence on screen.
+		 */
+		uint32_t getDesiredTileSize(const ShadowedLight& light) const;
 
-        void createDebugDescriptorSets();
-        void updateShadowCubeMapDebugWindow();
+		void updateTiles(const GlobalUbo& ubo);
+		bool allocateTiles(ShadowedLight& light, uint32_t tileSize);
+		// allocates tiles of another size, keeping the old ones until the new ones are rendered
+		bool reallocateTiles(ShadowedLight& light, uint32_t tileSize);
+		void freeTiles(ShadowedLight& light);
+		void freePreviousTiles(ShadowedLight& light);
+		void selectLightsToRender();
+		void writeLightingTable(int frameIndex);
 
-        glm::mat4 getFaceViewMatrix(uint32_t faceIndex);
-        
-        const uint32_t m_shadowMapSize{ 4096 };
+        glm::mat4 getFaceViewMatrix(uint32_t faceIndex) const;
+
+		static constexpr uint32_t ATLAS_SIZE = 4096;
+		static constexpr uint32_t MAX_TILE_SIZE = 1024;
+		static constexpr uint32_t MIN_TILE_SIZE = 128;
+
+		// the light irradiance below which a surface is considered out of reach of the light,
+		// bounds the area of influence used for the importance
+		static constexpr float MIN_IRRADIANCE = 0.01f;
 
 		// Defines the depth range used for the shadow maps
         // This should be kept as small as possible for precision
 		float zNear{ 0.1f };
         float zFar{ 50.0f };
 
+		// the texels rendered per frame, rounded up to the light that goes over it
+		int m_texelBudget = 6 * MAX_TILE_SIZE * MAX_TILE_SIZE;
+		// a light that doesn't move is rendered again after this many frames, to catch the objects moving
+		int m_refreshInterval = 8;
+
         Context& m_context;
 
 		Shared<DescriptorAllocatorGrowable> m_descriptorAllocator;
@@ -57,15 +139,23 @@ namespace PXTEngine {
         std::array<Unique<VulkanBuffer>, SwapChain::MAX_FRAMES_IN_FLIGHT> m_lightUniformBuffers;
         std::array<VkDescriptorSet, SwapChain::MAX_FRAMES_IN_FLIGHT> m_lightDescriptorSets;
 
-        Shared<CubeMap> m_shadowCubeMap;
-		VkDescriptorImageInfo m_shadowMapDescriptorInfo{ VK_NULL_HANDLE };
-		std::array<VkDescriptorImageInfo, 6> m_debugImageDescriptorInfos;
-		std::array<VkDescriptorSet, 6> m_shadowMapDebugDescriptorSets;
+		ShadowAtlas m_atlas{ ATLAS_SIZE, MIN_TILE_SIZE };
+		std::array<ShadowedLight, MAX_LIGHTS> m_lights{};
+		std::vector<uint32_t> m_lightsToRender;
+		uint64_t m_frameCount = 0;
+		uint32_t m_publishedLightCount = 0;
+		Stats m_stats{};
+
+		// the atlas as seen by the lighting shaders, with the table of the frame
+		Unique<DescriptorSetLayout> m_lightingSetLayout;
+        std::array<Unique<VulkanBuffer>, SwapChain::MAX_FRAMES_IN_FLIGHT> m_lightingTableBuffers;
+		std::array<VkDescriptorSet, SwapChain::MAX_FRAMES_IN_FLIGHT> m_lightingDescriptorSets;
+
+		Shared<VulkanImage> m_atlasImage;
+		VkDescriptorSet m_atlasDebugDescriptorSet{ VK_NULL_HANDLE };
 
 		Unique<RenderPass> m_renderPass = nullptr;
-		// The framebuffer used for the offscreen render pass. They are created from the 
-		// shadowCubeMap image views (see createOffscreenFrameBuffers)
-        std::array<Unique<FrameBuffer>, 6> m_cubeFramebuffers;
+		Unique<FrameBuffer> m_atlasFramebuffer;
 		Shared<VulkanImage> m_depthStencilImageFb;
         VkFormat m_offscreenDepthFormat{ VK_FORMAT_UNDEFINED };
 		VkFormat m_offscreenColorFormat{ VK_FORMAT_R32_SFLOAT };
@@ -78,4 +168,4 @@ namespace PXTEngine {
             "cube_shadow_map_creation.frag"
         };
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,256 @@
+#include "graphics/render_systems/skinning_system.hpp"
+
+#include "scene/ecs/component.hpp"
+#include "scene/ecs/entity.hpp"
+
+namespace PXTEngine {
+
+    // must match the local size of the skinning shader
+    static constexpr uint32_t SKINNING_WORKGROUP_SIZE = 64;
+
+    struct SkinningPushConstants {
+        VkDeviceAddress bindPoseVertices;
+        VkDeviceAddress skinWeights;
+        VkDeviceAddress skinningMatrices;
+        VkDeviceAddress deformedVertices;
+        uint32_t vertexCount;
+    };
+
+    SkinningSystem::SkinningSystem(Context& context, ResourceManager& resourceManager, BLASRegistry& blasRegistry)
+        : m_context(context), m_resourceManager(resourceManager), m_blasRegistry(blasRegistry) {
+        createPipelineLayout();
+        m_pipeline = createPipeline();
+    }
+
+    SkinningSystem::~SkinningSystem() {
+        for (auto& [id, instance] : m_instances) {
+            retireInstance(std::move(instance));
+        }
+
+        // the renderer is destroyed after the device is idle
+        for (RetiredInstance& retired : m_retiredInstances) {
+            m_blasRegistry.remove(retired.instance.deformedMesh->id);
+        }
+    }
+
+    void SkinningSystem::createPipelineLayout() {
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(SkinningPushConstants);
+
+        // every buffer is accessed through its device address, no descriptor sets needed
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 0;
+        pipelineLayoutInfo.pSetLayouts = nullptr;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+        m_pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
+    }
+
+    Unique<Pipeline> SkinningSystem::createPipeline(bool useCompiledSpirvFiles) const {
+        PXT_ASSERT(m_pipelineLayout != nullptr, "Cannot create pipeline before pipeline layout");
+
+        ComputePipelineConfigInfo pipelineConfig{};
+        pipelineConfig.pipelineLayout = m_pipelineLayout;
+
+        const std::string baseShaderPath = useCompiledSpirvFiles ? SPV_SHADERS_PATH : SHADERS_PATH;
+        const std::string filenameSuffix = useCompiledSpirvFiles ? ".spv" : "";
+        std::string shaderFilePath = baseShaderPath + m_shaderPath + filenameSuffix;
+
+        return createUnique<Pipeline>(m_context, shaderFilePath, pipelineConfig);
+    }
+
+    void SkinningSystem::registerShaders(ShaderReloader& shaderReloader) {
+        shaderReloader.addPipeline("Skinning", { SHADERS_PATH + m_shaderPath }, [this] { return createPipeline(false); }, m_pipeline);
+    }
+
+    SkinningSystem::SkinnedInstance& SkinningSystem::getOrCreateInstance(const UUID& entityId,
+        const ResourceHandle<Mesh> skinnedMeshHandle, const uint32_t jointCount) {
+
+        auto it = m_instances.find(entityId);
+        if (it != m_instances.end()) {
+            SkinnedInstance& instance = it->second;
+
+            if (instance.skinnedMeshHandle == skinnedMeshHandle && instance.jointsBuffers[0]->getInstanceCount() == jointCount) {
+                return instance;
+            }
+
+            // the mesh or the skeleton of the entity changed, the old resources may still be in use
+            retireInstance(std::move(instance));
+            m_instances.erase(it);
+        }
+
+        SkinnedInstance instance{};
+        instance.skinnedMeshHandle = skinnedMeshHandle;
+        instance.skinnedMesh = std::static_pointer_cast<VulkanMesh>(m_resourceManager.getShared(skinnedMeshHandle));
+        instance.deformedMesh = createShared<VulkanMesh>(m_context, *instance.skinnedMesh);
+        instance.deformedMeshHandle = m_resourceManager.acquire<Mesh>(instance.deformedMesh);
+
+        for (Unique<VulkanBuffer>& jointsBuffer : instance.jointsBuffers) {
+            jointsBuffer = createUnique<VulkanBuffer>(
+                m_context,
+                sizeof(glm::mat4),
+                jointCount,
+                VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+            );
+            jointsBuffer->map();
+        }
+
+        return m_instances.emplace(entityId, std::move(instance)).first->second;
+    }
+
+    void SkinningSystem::retireInstance(SkinnedInstance&& instance) {
+        // the handle held by the mesh component becomes stale
+        m_resourceManager.release(instance.deformedMeshHandle);
+
+        const uint64_t timelineValue = m_context.getFrameTimeline().getNextValue();
+        m_retiredInstances.push_back({ timelineValue, std::move(instance) });
+    }
+
+    void SkinningSystem::destroyRetiredInstances() {
+        TimelineSemaphore& frameTimeline = m_context.getFrameTimeline();
+
+        // retired in increasing timeline order, stop at the first one still in use
+        size_t count = 0;
+        while (count < m_retiredInstances.size() && frameTimeline.isComplete(m_retiredInstances[count].timelineValue)) {
+            m_blasRegistry.remove(m_retiredInstances[count].instance.deformedMesh->id);
+            count++;
+        }
+
+        m_retiredInstances.erase(m_retiredInstances.begin(), m_retiredInstances.begin() + count);
+    }
+
+    void SkinningSystem::releaseUnusedInstances() {
+        FrameVector<UUID> unusedInstances;
+        for (auto& [id, instance] : m_instances) {
+            if (!instance.isUsed) {
+                unusedInstances.push_back(id);
+            }
+            instance.isUsed = false;
+        }
+
+        // the deformed meshes and their BLASes may be in use by the frames in flight
+        for (const UUID& id : unusedInstances) {
+            retireInstance(std::move(m_instances.at(id)));
+            m_instances.erase(id);
+        }
+    }
+
+    void SkinningSystem::update(FrameInfo& frameInfo, bool isRaytracingEnabled) {
+        FrameVector<SkinnedInstance*> instancesToSkin;
+
+        auto view = frameInfo.scene.getEntitiesWith<SkinnedMeshComponent, MeshComponent>();
+        for (auto entityHandle : view) {
+            auto [skinnedComponent, meshComponent] = view.get<SkinnedMeshComponent, MeshComponent>(entityHandle);
+
+            auto* skinnedMesh = static_cast<VulkanMesh*>(m_resourceManager.resolve(meshComponent.mesh));
+            if (skinnedMesh == nullptr || !skinnedMesh->isSkinned() || skinnedComponent.skinningMatrices.empty()) {
+                meshComponent.deformedMesh = {};
+                continue;
+            }
+
+            Entity entity(entityHandle, &frameInfo.scene);
+            const uint32_t jointCount = static_cast<uint32_t>(skinnedComponent.skinningMatrices.size());
+
+            SkinnedInstance& instance = getOrCreateInstance(entity.getUUID(), meshComponent.mesh, jointCount);
+            instance.isUsed = true;
+            // the buffer of this frame index was last read by the frame waited in Renderer::beginFrame
+            instance.jointsBuffers[frameInfo.frameIndex]->writeToBuffer(skinnedComponent.skinningMatrices.data());
+
+            if (isRaytracingEnabled && instance.blas == nullptr) {
+                Shared<Mesh> deformedMesh = instance.deformedMesh;
+                instance.blas = m_blasRegistry.getOrCreateUpdatableBLAS(deformedMesh);
+            }
+
+            meshComponent.deformedMesh = instance.deformedMeshHandle;
+            instancesToSkin.push_back(&instance);
+        }
+
+        releaseUnusedInstances();
+        destroyRetiredInstances();
+
+        if (instancesToSkin.empty()) return;
+
+        VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+
+        // the frames submitted before may still be reading the deformed vertices and the BLASes
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+            VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr
+        );
+
+        m_pipeline->bind(commandBuffer);
+
+        for (SkinnedInstance* instance : instancesToSkin) {
+            SkinningPushConstants push{};
+            push.bindPoseVertices = instance->skinnedMesh->getVertexBufferDeviceAddress();
+            push.skinWeights = instance->skinnedMesh->getSkinWeightsBufferDeviceAddress();
+            push.skinningMatrices = instance->jointsBuffers[frameInfo.frameIndex]->getDeviceAddress();
+            push.deformedVertices = instance->deformedMesh->getVertexBufferDeviceAddress();
+            push.vertexCount = instance->skinnedMesh->getVertexCount();
+
+            vkCmdPushConstants(
+                commandBuffer,
+                m_pipelineLayout,
+                VK_SHADER_STAGE_COMPUTE_BIT,
+                0, sizeof(SkinningPushConstants),
+                &push
+            );
+
+            vkCmdDispatch(commandBuffer, (push.vertexCount + SKINNING_WORKGROUP_SIZE - 1) / SKINNING_WORKGROUP_SIZE, 1, 1);
+        }
+
+        // the deformed vertices are read by the raster passes, the closest hit shaders and the refits
+        barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+            VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+            0,
+            1, &barrier,
+            0, nullptr,
+            0, nullptr
+        );
+
+        if (isRaytracingEnabled) {
+            // refitting keeps the topology of the first build, much cheaper than a rebuild
+            for (SkinnedInstance* instance : instancesToSkin) {
+                m_blasRegistry.refitBLAS(commandBuffer, *instance->blas);
+            }
+
+            barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+            barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+
+            vkCmdPipelineBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR |
+                VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+                0,
+                1, &barrier,
+                0, nullptr,
+                0, nullptr
+            );
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
+#include "graphics/context/context.hpp"
+#include "graphics/frame_info.hpp"
+#include "graphics/swap_chain.hpp"
+#include "graphics/resources/vk_buffer.hpp"
+#include "graphics/resources/vk_mesh.hpp"
+#include "graphics/resources/blas_registry.hpp"
+#include "resources/resource_manager.hpp"
+#include "scene/scene.hpp"
+
+namespace PXTEngine {
+
+    /**
+     * @class SkinningSystem
+     * @brief Deforms the skinned meshes of the scene on the GPU.
+     *
+     * Every entity with a SkinnedMeshComponent gets its own deformed copy of the mesh
+     * (MeshComponent::deformedMesh, acquired in the resource manager for as long as the
+     * entity is skinned), which the raster and ray tracing passes use instead of
+     * the shared bind pose mesh. Each frame a compute pass skins the vertices with the joint
+     * matrices evaluated by the scene, then, when ray tracing is enabled, the BLAS of each
+     * deformed mesh is refitted instead of being rebuilt.
+     */
+    class SkinningSystem {
+    public:
+        SkinningSystem(Context& context, ResourceManager& resourceManager, BLASRegistry& blasRegistry);
+        ~SkinningSystem();
+
+        SkinningSystem(const SkinningSystem&) = delete;
+        SkinningSystem& operator=(const SkinningSystem&) = delete;
+
+        /**
+         * @brief Skins all the animated meshes of the scene and refits their BLASes.
+         * The work is recorded in the frame command buffer, so it must be called before
+         * the TLAS build and the passes reading the deformed meshes are recorded.
+         *
+         * @param frameInfo The frame information.
+         * @param isRaytracingEnabled Whether the BLASes of the deformed meshes are needed.
+         */
+        void update(FrameInfo& frameInfo, bool isRaytracingEnabled);
+
+        void registerShaders(ShaderReloader& shaderReloader);
+
+    private:
+        struct SkinnedInstance {
+            ResourceHandle<Mesh> skinnedMeshHandle;
+            Shared<VulkanMesh> skinnedMesh;     // bind pose and skin weights
+            ResourceHandle<Mesh> deformedMeshHandle;
+            Shared<VulkanMesh> deformedMesh;    // output of the skinning pass
+            // skinning matrices, written by the CPU every frame: one buffer per frame in flight
+            std::array<Unique<VulkanBuffer>, SwapChain::MAX_FRAMES_IN_FLIGHT> jointsBuffers;
+            Shared<BLAS> blas = nullptr;        // only when ray tracing is enabled
+            bool isUsed = true;
+        };
+
+        void createPipelineLayout();
+        Unique<Pipeline> createPipeline(bool useCompiledSpirvFiles = true) const;
+
+        struct RetiredInstance {
+            uint64_t timelineValue; // the frame timeline value of the last frame that may use it
+            SkinnedInstance instance;
+        };
+
+        SkinnedInstance& getOrCreateInstance(const UUID& entityId, ResourceHandle<Mesh> skinnedMeshHandle, uint32_t jointCount);
+
+        /**
+         * @brief Releases the handle of the deformed mesh right away, the GPU resources are
+         * destroyed once the frames in flight (and the frame being recorded) are complete.
+         */
+        void retireInstance(SkinnedInstance&& instance);
+        void destroyRetiredInstances();
+        void releaseUnusedInstances();
+
+        Context& m_context;
+        ResourceManager& m_resourceManager;
+        BLASRegistry& m_blasRegistry;
+
+        Unique<Pipeline> m_pipeline;
+        VkPipelineLayout m_pipelineLayout;
+
+        std::unordered_map<UUID, SkinnedInstance> m_instances;
+        std::vector<RetiredInstance> m_retiredInstances; // in retirement order
+
+        const std::string m_shaderPath = "skinning.comp";
+    };
+}
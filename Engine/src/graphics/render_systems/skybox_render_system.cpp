@@ -16,12 +16,10 @@ namespace PXTEngine {
 		m_skybox = std::static_pointer_cast<VulkanSkybox>(environment->getSkybox());
 
         createPipelineLayout(globalSetLayout);
-        createPipeline();
+        m_pipeline = createPipeline();
     }
 
-    SkyboxRenderSystem::~SkyboxRenderSystem() {
-        vkDestroyPipelineLayout(m_context.getDevice(), m_pipelineLayout, nullptr);
-    }
+    SkyboxRenderSystem::~SkyboxRenderSystem() = default;
 
     void SkyboxRenderSystem::createPipelineLayout(DescriptorSetLayout& globalSetLayout) {
         std::vector<VkDescriptorSetLayout> descriptorSetLayouts{
@@ -36,12 +34,10 @@ namespace PXTEngine {
         pipelineLayoutInfo.pushConstantRangeCount = 0; // No push constants for skybox
         pipelineLayoutInfo.pPushConstantRanges = nullptr;
 
-        if (vkCreatePipelineLayout(m_context.getDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
-            throw std::runtime_error("failed to create skybox pipeline layout!");
-        }
+        m_pipelineLayout = m_context.createPipelineLayout(pipelineLayoutInfo);
     }
 
-    void SkyboxRenderSystem::createPipeline(bool useCompiledSpirvFiles) {
+    Unique<Pipeline> SkyboxRenderSystem::createPipeline(bool useCompiledSpirvFiles) const {
         PXT_ASSERT(m_pipelineLayout != nullptr, "Cannot create skybox pipeline before pipelineLayout");
 
         RasterizationPipelineConfigInfo pipelineConfig{};
@@ -70,11 +66,11 @@ namespace PXTEngine {
             shaderFilePaths.push_back(baseShaderPath + filePath + filenameSuffix);
         };
 
-        m_pipeline = createUnique<Pipeline>(
+        return createUnique<Pipeline>(
             m_context,
             shaderFilePaths,
             pipelineConfig
-        ); 
+        );
     }
 
     void SkyboxRenderSystem::render(FrameInfo& frameInfo) {
@@ -97,9 +93,13 @@ namespace PXTEngine {
         vkCmdDraw(frameInfo.commandBuffer, 36, 1, 0, 0);
     }
 
-    void SkyboxRenderSystem::reloadShaders() {
-        PXT_INFO("Reloading shaders...");
-        createPipeline(false);
+    void SkyboxRenderSystem::registerShaders(ShaderReloader& shaderReloader) {
+        std::vector<std::filesystem::path> sourceFiles;
+        for (const auto& filePath : m_shaderFilePaths) {
+            sourceFiles.push_back(SHADERS_PATH + filePath);
+        }
+
+        shaderReloader.addPipeline("Skybox", sourceFiles, [this] { return createPipeline(false); }, m_pipeline);
     }
 
 } 
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "core/pch.hpp"
 #include "graphics/context/context.hpp"
 #include "graphics/pipeline.hpp"
+#include "graphics/shader_reloader.hpp"
 #include "graphics/resources/vk_skybox.hpp"
 #include "graphics/descriptors/descriptors.hpp"
 #include "graphics/frame_info.hpp"
@@ -26,11 +27,11 @@ namespace PXTEngine {
         SkyboxRenderSystem& operator=(const SkyboxRenderSystem&) = delete;
 
         void render(FrameInfo& frameInfo);
-        void reloadShaders();
+        void registerShaders(ShaderReloader& shaderReloader);
 
     private:
         void createPipelineLayout(DescriptorSetLayout& globalSetLayout);
-        void createPipeline(bool useCompiledSpirvFiles = true);
+        Unique<Pipeline> createPipeline(bool useCompiledSpirvFiles = true) const;
 
         Context& m_context;
         Shared<VulkanSkybox> m_skybox;
@@ -140,6 +140,8 @@ namespace PXTEngine {
 	}
 
 	void UiRenderSystem::render(FrameInfo& frameInfo) {
+		PXT_ALLOCATION_SCOPE("UI");
+
 		buildUi(frameInfo.scene);
 
 		ImGui::Render();
@@ -147,10 +149,19 @@ namespace PXTEngine {
 	}
 
 	void UiRenderSystem::beginBuildingUi(Scene& scene) {
+		PXT_ALLOCATION_SCOPE("UI");
+
 		ImGui_ImplVulkan_NewFrame();
 		ImGui_ImplGlfw_NewFrame();
+
+		// while replaying, the recorded mouse input replaces the live one
+		InputRecorder& inputRecorder = Application::get().getInputRecorder();
+		inputRecorder.applyUiInput();
+
 		ImGui::NewFrame();
 
+		inputRecorder.captureUiInput();
+
 		// MAIN MENU BAR (might become a method itself in the future)
 		if (ImGui::BeginMainMenuBar()) {
 			if (ImGui::BeginMenu("File")) {
@@ -267,9 +278,10 @@ namespace PXTEngine {
 
 		// MaterialComponent
 		RegisterComponent<MaterialComponent>("MaterialComponent", [](auto& c) {
-			if (c.material) {
-				ImGui::Text("Material: %s", c.material->alias.c_str());
-				c.material->drawMaterialUi();
+			Material* material = Application::get().getResourceManager().resolve(c.material);
+			if (material) {
+				ImGui::Text("Material: %s", material->alias.c_str());
+				material->drawMaterialUi();
 			}
 			else {
 				ImGui::Text("No Material assigned");
@@ -295,7 +307,8 @@ namespace PXTEngine {
 
 		// MeshComponent
 		RegisterComponent<MeshComponent>("MeshComponent", [](MeshComponent& c) {
-			ImGui::Text("Mesh name: %s", c.mesh->alias.c_str());
+			const Mesh* mesh = Application::get().getResourceManager().resolve(c.mesh);
+			ImGui::Text("Mesh name: %s", mesh ? mesh->alias.c_str() : "invalid handle");
 		});
 
 		// ScriptComponent
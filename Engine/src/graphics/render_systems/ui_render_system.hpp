@@ -61,7 +61,14 @@ namespace PXTEngine {
 					if (entity.has<T>()) {
 						T& component = entity.get<T>();
 						if (ImGui::TreeNodeEx(name.c_str(), ImGuiTreeNodeFlags_DefaultOpen)) {
+							ImGui::BeginGroup();
 							uiFunction(component);
+							ImGui::EndGroup();
+
+							// the edits are made in place, notify the scene (e.g. the render packets)
+							if (ImGui::IsItemEdited()) {
+								entity.patch<T>();
+							}
 
 							ImGui::TreePop();
 						}
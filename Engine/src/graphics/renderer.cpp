@@ -3,6 +3,8 @@
 namespace PXTEngine {
 
     Renderer::Renderer(Window& window, Context& context) : m_window{window}, m_context{context} {
+        PXT_STARTUP_PHASE("Create swap chain");
+
         recreateSwapChain();
         createCommandBuffers();
     }
@@ -95,7 +97,8 @@ namespace PXTEngine {
             throw std::runtime_error("failed to record command buffer!");
         }
 
-        auto result = m_swapChain->submitCommandBuffers(&commandBuffer, &m_currentImageIndex);
+        auto result = m_swapChain->submitCommandBuffers(&commandBuffer, &m_currentImageIndex, m_waitSemaphores);
+        m_waitSemaphores.clear();
 
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_window.isWindowResized()) {
             m_window.resetWindowResizedFlag();
@@ -108,6 +111,12 @@ namespace PXTEngine {
         m_currentFrameIndex = (m_currentFrameIndex + 1) % SwapChain::MAX_FRAMES_IN_FLIGHT;
     }
 
+    void Renderer::addWaitSemaphore(const SemaphoreWait& wait) {
+        PXT_ASSERT(m_isFrameStarted, "Can't add a wait semaphore while frame is not in progress.");
+
+        m_waitSemaphores.push_back(wait);
+    }
+
     void Renderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer) {
         PXT_ASSERT(m_isFrameStarted, "Can't begin render pass when frame is not in progress.");
         PXT_ASSERT(commandBuffer == getCurrentCommandBuffer(), "Can't begin render pass on command buffer from a different frame.");
@@ -42,8 +42,7 @@ namespace PXTEngine {
          */
         VkRenderPass getSwapChainRenderPass() const { return m_swapChain->getRenderPass(); }
 
-        VkFence getSwapChainInFlightFence(uint32_t frameIndex) const { return m_swapChain->getInFlightFence(frameIndex); }
-		VkFence getSwapChainCurrentFrameFence() const { return m_swapChain->getCurrentFrameFence(); }
+        uint64_t getSwapChainFrameTimelineValue(uint32_t frameIndex) const { return m_swapChain->getFrameTimelineValue(frameIndex); }
 		VkSemaphore getSwapChainImageAvailableSemaphore() const { return m_swapChain->getImageAvailableSemaphore(); }
 		VkSemaphore getSwapChainRenderFinishedSemaphore(uint32_t imageIndex) const {
 			return m_swapChain->getRenderFinishedSemaphore(imageIndex);
@@ -122,6 +121,15 @@ namespace PXTEngine {
          */
         void endFrame();
 
+        /**
+         * @brief Makes the submission of the frame in progress wait on a semaphore, e.g. the
+         * timeline of the async compute queue. The wait only applies to the current frame.
+         *
+         * @param wait The semaphore, the stages of the frame that must wait for it and, for a
+         * timeline semaphore, the value to wait for. It must be signaled by a submission made before endFrame().
+         */
+        void addWaitSemaphore(const SemaphoreWait& wait);
+
         /**
          * @brief Begins the swap chain render pass.
          * 
@@ -186,6 +194,9 @@ namespace PXTEngine {
         Unique<SwapChain> m_swapChain;
         std::vector<VkCommandBuffer> m_commandBuffers;
 
+        // extra semaphores the frame in progress waits on, cleared at every endFrame
+        std::vector<SemaphoreWait> m_waitSemaphores;
+
         uint32_t m_currentImageIndex;
         int m_currentFrameIndex = 0;
         bool m_isFrameStarted = false;
@@ -13,7 +13,26 @@ namespace PXTEngine {
 		}
 	}
     
-    Shared<BLAS> BLASRegistry::getOrCreateBLAS(Shared<Mesh>& mesh) {
+    Shared<BLAS> BLASRegistry::getOrCreateBLAS(const Shared<Mesh>& mesh) {
+        return getOrCreateBLAS(mesh, false);
+    }
+
+    Shared<BLAS> BLASRegistry::getOrCreateUpdatableBLAS(const Shared<Mesh>& mesh) {
+        return getOrCreateBLAS(mesh, true);
+    }
+
+    void BLASRegistry::remove(const UUID& meshId) {
+        auto it = m_blasRegistry.find(meshId);
+        if (it == m_blasRegistry.end()) return;
+
+        if (it->second->handle != VK_NULL_HANDLE) {
+            vkDestroyAccelerationStructureKHR(m_context.getDevice(), it->second->handle, nullptr);
+        }
+
+        m_blasRegistry.erase(it);
+    }
+
+    Shared<BLAS> BLASRegistry::getOrCreateBLAS(const Shared<Mesh>& mesh, bool allowUpdate) {
         VulkanMesh* vkMesh_ptr = dynamic_cast<VulkanMesh*>(mesh.get());
 		if (!vkMesh_ptr) {
 			PXT_ERROR("Failed to cast Mesh to VulkanMesh");
@@ -28,7 +47,7 @@ namespace PXTEngine {
 			return it->second;
 		}
         
-        Shared<BLAS> newBlas = createBLAS(vkMesh);
+        Shared<BLAS> newBlas = createBLAS(vkMesh, allowUpdate);
 
 		// Store the new BLAS in the registry
 		m_blasRegistry[vkMesh.id] = newBlas;
@@ -61,7 +80,9 @@ namespace PXTEngine {
         return geometry;
     }
 
-    Shared<BLAS> BLASRegistry::createBLAS(VulkanMesh& mesh) {
+    Shared<BLAS> BLASRegistry::createBLAS(VulkanMesh& mesh, bool allowUpdate) {
+        PXT_STARTUP_PHASE("Build BLAS");
+
         Shared<BLAS> newBlas = createShared<BLAS>();
         VkDevice device = m_context.getDevice();
 
@@ -76,6 +97,9 @@ namespace PXTEngine {
         buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
         buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
         buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+        if (allowUpdate) {
+            buildInfo.flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
+        }
         buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
         buildInfo.geometryCount = static_cast<uint32_t>(geometries.size());
         buildInfo.pGeometries = geometries.data();
@@ -87,6 +111,7 @@ namespace PXTEngine {
             ? (mesh.getIndexCount() / 3)
             : (mesh.getVertexCount() / 3);
         std::vector<uint32_t> maxPrimitiveCounts = { numTriangles };
+        newBlas->primitiveCount = numTriangles;
 
         newBlas->buildSizes = {};
         newBlas->buildSizes.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR;
@@ -110,6 +135,15 @@ namespace PXTEngine {
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
         );
 
+        // refits happen every frame, their scratch buffer is kept with the BLAS
+        if (allowUpdate) {
+            newBlas->updateScratchBuffer = createUnique<VulkanBuffer>(
+                m_context, newBlas->buildSizes.updateScratchSize, 1,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+            );
+        }
+
         // BUILD BLAS HANDLE
         VkAccelerationStructureCreateInfoKHR createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR;
@@ -175,4 +209,27 @@ namespace PXTEngine {
 
         return newBlas;
     }
+
+    void BLASRegistry::refitBLAS(VkCommandBuffer commandBuffer, BLAS& blas) {
+        PXT_ASSERT(blas.updateScratchBuffer != nullptr, "Only BLASes created with getOrCreateUpdatableBLAS can be refitted");
+
+        // the geometry points to the same vertex buffer, only its content has changed
+        VkAccelerationStructureBuildGeometryInfoKHR buildInfo{};
+        buildInfo.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
+        buildInfo.type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR;
+        buildInfo.flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR |
+                          VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
+        buildInfo.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+        buildInfo.srcAccelerationStructure = blas.handle;
+        buildInfo.dstAccelerationStructure = blas.handle;
+        buildInfo.geometryCount = 1;
+        buildInfo.pGeometries = &blas.geometry;
+        buildInfo.scratchData.deviceAddress = blas.updateScratchBuffer->getDeviceAddress();
+
+        VkAccelerationStructureBuildRangeInfoKHR buildRangeInfo{};
+        buildRangeInfo.primitiveCount = blas.primitiveCount;
+        const VkAccelerationStructureBuildRangeInfoKHR* pBuildRangeInfo = &buildRangeInfo;
+
+        vkCmdBuildAccelerationStructuresKHR(commandBuffer, 1, &buildInfo, &pBuildRangeInfo);
+    }
 }
\ No newline at end of file
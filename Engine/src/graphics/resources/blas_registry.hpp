@@ -11,6 +11,10 @@ namespace PXTEngine {
 		VkAccelerationStructureBuildSizesInfoKHR buildSizes;
 		VkAccelerationStructureGeometryKHR geometry;
 		Unique<VulkanBuffer> buffer;
+		uint32_t primitiveCount = 0;
+
+		// only for BLASes built with ALLOW_UPDATE (deformed meshes), reused by every refit
+		Unique<VulkanBuffer> updateScratchBuffer;
 
 		bool operator==(const BLAS& other) const {
 			return handle == other.handle;
@@ -24,10 +28,31 @@ namespace PXTEngine {
 		BLASRegistry(const BLASRegistry&) = delete;
 		BLASRegistry& operator=(const BLASRegistry&) = delete;
 
-		Shared<BLAS> getOrCreateBLAS(Shared<Mesh>& mesh);
+		Shared<BLAS> getOrCreateBLAS(const Shared<Mesh>& mesh);
+
+		/**
+		 * @brief Same as getOrCreateBLAS, but the BLAS is built to be refitted when the
+		 * vertices of the mesh move (e.g. the deformed copy of a skinned mesh).
+		 */
+		Shared<BLAS> getOrCreateUpdatableBLAS(const Shared<Mesh>& mesh);
+
+		/**
+		 * @brief Records the refit of an updatable BLAS to the current vertices of its mesh.
+		 * The caller is responsible for the barriers around it.
+		 *
+		 * @param commandBuffer The command buffer to record to.
+		 * @param blas A BLAS created with getOrCreateUpdatableBLAS.
+		 */
+		void refitBLAS(VkCommandBuffer commandBuffer, BLAS& blas);
+
+		/**
+		 * @brief Destroys the BLAS of a mesh, it must not be in use by the GPU.
+		 */
+		void remove(const UUID& meshId);
 	private:
+		Shared<BLAS> getOrCreateBLAS(const Shared<Mesh>& mesh, bool allowUpdate);
 		VkAccelerationStructureGeometryKHR getAccelerationStructureGeometry(VulkanMesh& mesh);
-		Shared<BLAS> createBLAS(VulkanMesh& mesh);
+		Shared<BLAS> createBLAS(VulkanMesh& mesh, bool allowUpdate);
 
 		Context& m_context;
 		std::unordered_map<UUID, Shared<BLAS>> m_blasRegistry;
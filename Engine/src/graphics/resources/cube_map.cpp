@@ -2,9 +2,10 @@
 
 
 namespace PXTEngine {
-	CubeMap::CubeMap(Context& context, const uint32_t size, const VkFormat format, const VkImageUsageFlags usageFlags)
+	CubeMap::CubeMap(Context& context, const uint32_t size, const VkFormat format, const VkImageUsageFlags usageFlags,
+		const uint32_t mipLevels)
 		: VulkanImage(context, {}, Buffer()), m_imageFormat(format), m_usageFlags(usageFlags),
-		  m_size(size) {
+		  m_size(size), m_mipLevels(mipLevels) {
 		for (int i = 0; i < 6; i++) {
 			m_cubeFaceViews[i] = VK_NULL_HANDLE;
 		}
@@ -27,7 +28,7 @@ namespace PXTEngine {
 		imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
 		imageCreateInfo.format = m_imageFormat;
 		imageCreateInfo.extent = { m_size, m_size, 1 };
-		imageCreateInfo.mipLevels = 1;
+		imageCreateInfo.mipLevels = m_mipLevels;
 		imageCreateInfo.arrayLayers = 6;
 		imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 		imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
@@ -50,7 +51,7 @@ namespace PXTEngine {
 								VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
 		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
 		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = 1.0; 
+		viewInfo.subresourceRange.levelCount = m_mipLevels;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = 6;
 		viewInfo.image = m_vkImage;
@@ -60,6 +61,7 @@ namespace PXTEngine {
 
 		// now we create the image views for each face of the cube map
 		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.subresourceRange.levelCount = 1;
 		viewInfo.subresourceRange.layerCount = 1;
 		viewInfo.image = m_vkImage;
 
@@ -83,7 +85,7 @@ namespace PXTEngine {
 		sampler.maxAnisotropy = 1.0f;
 		sampler.compareOp = VK_COMPARE_OP_NEVER;
 		sampler.minLod = 0.0f;
-		sampler.maxLod = 1.0f;
+		sampler.maxLod = static_cast<float>(m_mipLevels);
 		sampler.borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE;
 
 		m_sampler = m_context.createSampler(sampler);
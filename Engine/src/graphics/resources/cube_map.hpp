@@ -10,14 +10,19 @@ namespace PXTEngine {
 		CubeMap(Context& context, 
 				uint32_t size, 
 				VkFormat format,
-				VkImageUsageFlags usageFlags);
+				VkImageUsageFlags usageFlags,
+				uint32_t mipLevels = 1);
 
 		~CubeMap() override;
 
 		VkImageView getFaceImageView(uint32_t faceIndex) const { return m_cubeFaceViews[faceIndex]; }
 
+		uint32_t getSize() const { return m_size; }
+		uint32_t getMipLevels() const { return m_mipLevels; }
+
 	private:
 		uint32_t m_size; // Size of the cube map faces
+		uint32_t m_mipLevels; // the face views only cover the base level
 
 		void createImage();
 		void createImageViews();
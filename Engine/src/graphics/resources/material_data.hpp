@@ -0,0 +1,80 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "resources/types/material.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @struct MaterialData
+	 *
+	 * @brief This struct is the GPU-side representation of a material's properties. 
+	 * It is designed to be tightly packed and uploaded to a Shader Storage Buffer Object (SSBO).
+	 *
+	 * @note The alignas(16) specifier is crucial. It ensures that the struct's size is a multiple
+	 * of 16 bytes, matching the std430 layout rules for SSBOs in GLSL. This prevents memory 
+	 * alignment issues on the GPU when accessing an array of these structs.
+	 */
+	struct alignas(16) MaterialData {
+		glm::vec4 albedoColor;
+		glm::vec4 emissiveColor;
+		int albedoMapIndex;
+		int normalMapIndex;
+		int ambientOcclusionMapIndex;
+		float metallic;
+		int metallicMapIndex;
+		float roughness;
+		int roughnessMapIndex;
+		int emissiveMapIndex;
+		float transmission;
+		float ior;
+		float blinnPhongSpecularIntensity;
+		float blinnPhongSpecularShininess;
+	};
+
+	/**
+	 * @brief Converts a Material object into its corresponding GPU-ready MaterialData structure.
+	 *
+	 * The texture maps are turned into bindless indices by getTextureIndex, a callable taking
+	 * the ResourceId of an image (TextureRegistry::getIndex in the engine). It is a template
+	 * so that the packing can be measured without a texture registry (see benchmarks/).
+	 *
+	 * @param material The material to pack.
+	 * @param getTextureIndex Callable returning the texture index of an image id.
+	 *
+	 * @return A MaterialData struct containing data for GPU usage.
+	 */
+	template<typename TextureIndexFn>
+	MaterialData packMaterialData(const Material& material, TextureIndexFn&& getTextureIndex) {
+		constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+		MaterialData data;
+		data.albedoColor = material.getAlbedoColor();
+		data.emissiveColor = material.getEmissiveColor();
+		data.albedoMapIndex = getTextureIndex(material.getAlbedoMap()->id);
+		data.normalMapIndex = getTextureIndex(material.getNormalMap()->id);
+		data.ambientOcclusionMapIndex = getTextureIndex(material.getAmbientOcclusionMap()->id);
+		data.metallic = material.getMetallic();
+
+		data.metallicMapIndex = invalidIndex;
+		if (material.getMetallicMap()) {
+			data.metallicMapIndex = getTextureIndex(material.getMetallicMap()->id);
+		}
+
+		data.roughness = material.getRoughness();
+
+		data.roughnessMapIndex = invalidIndex;
+		if (material.getRoughnessMap()) {
+			data.roughnessMapIndex = getTextureIndex(material.getRoughnessMap()->id);
+		}
+
+		data.emissiveMapIndex = getTextureIndex(material.getEmissiveMap()->id);
+		data.transmission = material.getTransmission();
+		data.ior = material.getIndexOfRefraction();
+
+		data.blinnPhongSpecularIntensity = material.getBlinnPhongSpecularIntensity();
+		data.blinnPhongSpecularShininess = material.getBlinnPhongSpecularShininess();
+
+		return data;
+	}
+}
@@ -51,35 +51,50 @@ namespace PXTEngine {
 	}
 
 	void MaterialRegistry::updateDescriptorSet(int frameIndex) {
-		std::vector<MaterialData> materialsData;
-		for (const auto& material : m_materials) {
-			materialsData.push_back(getMaterialData(material));
+		FrameMaterialBuffer& frame = m_frameBuffers[frameIndex];
+		const auto materialCount = static_cast<uint32_t>(m_materials.size());
+
+		if (materialCount > frame.capacity || !frame.buffer) {
+			reallocateFrameBuffer(frameIndex, materialCount);
 		}
 
-		VkDeviceSize bufferSize = sizeof(MaterialData) * materialsData.size();
+		frame.uploadedVersions.resize(materialCount, NOT_UPLOADED);
 
-		Unique<VulkanBuffer> stagingBuffer = createUnique<VulkanBuffer>(
-			m_context,
-			bufferSize,
-			1,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-		);
-		stagingBuffer->map();
-		stagingBuffer->writeToBuffer(materialsData.data(), bufferSize);
-		stagingBuffer->unmap();
+		// The buffer is host coherent and only read by the GPU while this frame
+		// is in flight, so stale entries can be overwritten in place.
+		for (uint32_t i = 0; i < materialCount; i++) {
+			const uint32_t version = m_materials[i]->getVersion();
+			if (frame.uploadedVersions[i] == version) continue;
 
-		m_materialsGpuBuffers[frameIndex] = createUnique<VulkanBuffer>(
+			MaterialData data = getMaterialData(m_materials[i]);
+			frame.buffer->writeToIndex(&data, static_cast<int>(i));
+			frame.uploadedVersions[i] = version;
+		}
+	}
+
+	void MaterialRegistry::reallocateFrameBuffer(int frameIndex, uint32_t minCapacity) {
+		FrameMaterialBuffer& frame = m_frameBuffers[frameIndex];
+
+		uint32_t capacity = std::max(frame.capacity, INITIAL_CAPACITY);
+		while (capacity < minCapacity) {
+			capacity *= 2;
+		}
+
+		// the old buffer belongs to this frame, whose previous submission has
+		// already completed (its frame timeline value was waited on in beginFrame)
+		frame.buffer = createUnique<VulkanBuffer>(
 			m_context,
-			bufferSize,
-			1,
-			VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+			sizeof(MaterialData),
+			capacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
 		);
+		frame.buffer->map();
+		frame.capacity = capacity;
 
-		m_context.copyBuffer(stagingBuffer->getBuffer(), m_materialsGpuBuffers[frameIndex]->getBuffer(), bufferSize);
+		frame.uploadedVersions.assign(frame.uploadedVersions.size(), NOT_UPLOADED);
 
-		auto bufferInfo = m_materialsGpuBuffers[frameIndex]->descriptorInfo();
+		auto bufferInfo = frame.buffer->descriptorInfo();
 
 		DescriptorWriter(m_context, *m_materialDescriptorSetLayout)
 			.writeBuffer(0, &bufferInfo)
@@ -87,36 +102,8 @@ namespace PXTEngine {
 	}
 
 	MaterialData MaterialRegistry::getMaterialData(Shared<Material> material) {
-
-		constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
-
-		MaterialData data;
-		data.albedoColor = material->getAlbedoColor();
-		data.emissiveColor = material->getEmissiveColor();
-		data.albedoMapIndex = m_textureRegistry.getIndex(material->getAlbedoMap()->id);
-		data.normalMapIndex = m_textureRegistry.getIndex(material->getNormalMap()->id);
-		data.ambientOcclusionMapIndex = m_textureRegistry.getIndex(material->getAmbientOcclusionMap()->id);
-		data.metallic = material->getMetallic();
-
-		data.metallicMapIndex = invalidIndex;
-		if (material->getMetallicMap()) {
-			data.metallicMapIndex = m_textureRegistry.getIndex(material->getMetallicMap()->id);
-		}
-		
-		data.roughness = material->getRoughness();
-
-		data.roughnessMapIndex = invalidIndex;
-		if (material->getRoughnessMap()) {
-			data.roughnessMapIndex = m_textureRegistry.getIndex(material->getRoughnessMap()->id);
-		}
-		
-		data.emissiveMapIndex = m_textureRegistry.getIndex(material->getEmissiveMap()->id);
-		data.transmission = material->getTransmission();
-		data.ior = material->getIndexOfRefraction();
-		
-		data.blinnPhongSpecularIntensity = material->getBlinnPhongSpecularIntensity();
-		data.blinnPhongSpecularShininess = material->getBlinnPhongSpecularShininess();
-	
-		return data;
+		return packMaterialData(*material, [this](const ResourceId& id) {
+			return m_textureRegistry.getIndex(id);
+		});
 	}
 }
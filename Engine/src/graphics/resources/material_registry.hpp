@@ -3,6 +3,7 @@
 #include "core/pch.hpp"
 #include "resources/resource.hpp"
 #include "resources/types/material.hpp"
+#include "graphics/resources/material_data.hpp"
 #include "graphics/descriptors/descriptors.hpp"
 #include "graphics/resources/vk_buffer.hpp"
 #include "graphics/resources/texture_registry.hpp"
@@ -10,33 +11,6 @@
 
 namespace PXTEngine {
 
-	/**
-	 * @struct MaterialData
-	 *
-	 * @brief This struct is the GPU-side representation of a material's properties. 
-	 * It is designed to be tightly packed and uploaded to a Shader Storage Buffer Object (SSBO).
-	 *
-	 * @note The alignas(16) specifier is crucial. It ensures that the struct's size is a multiple
-	 * of 16 bytes, matching the std430 layout rules for SSBOs in GLSL. This prevents memory 
-	 * alignment issues on the GPU when accessing an array of these structs.
-	 */
-	struct alignas(16) MaterialData {
-		glm::vec4 albedoColor;
-		glm::vec4 emissiveColor;
-		int albedoMapIndex;
-		int normalMapIndex;
-		int ambientOcclusionMapIndex;
-		float metallic;
-		int metallicMapIndex;
-		float roughness;
-		int roughnessMapIndex;
-		int emissiveMapIndex;
-		float transmission;
-		float ior;
-		float blinnPhongSpecularIntensity;
-		float blinnPhongSpecularShininess;
-	};
-
 	/**
 	 * @class MaterialRegistry
 	 *
@@ -46,6 +20,9 @@ namespace PXTEngine {
 	 */
 	class MaterialRegistry {
 	public:
+		static constexpr uint32_t INITIAL_CAPACITY = 32;
+		static constexpr uint32_t NOT_UPLOADED = std::numeric_limits<uint32_t>::max();
+
 		MaterialRegistry(Context& context, TextureRegistry& textureRegistry);
 
 		/**
@@ -88,16 +65,40 @@ namespace PXTEngine {
 		VkDescriptorSetLayout getDescriptorSetLayout();
 
 		/**
-		 * @brief Creates the descriptor set and GPU buffer for the registered materials.
-		 *
-		 * This method prepares the material data for use in shaders by uploading it to GPU memory
-		 * and writing it into a Vulkan descriptor set.
+		 * @brief Creates the descriptor set layout and allocates one descriptor set
+		 * per frame in flight for the registered materials.
 		 */
 		void createDescriptorSets();
 
+		/**
+		 * @brief Brings the material buffer of the frame frameIndex up to date.
+		 *
+		 * Every frame in flight owns a persistently mapped material buffer. Only the materials
+		 * whose version changed since the last time this frame's buffer was written are
+		 * re-packed and copied. The buffer grows geometrically when materials are added and the
+		 * descriptor set is rewritten only when the buffer is reallocated.
+		 *
+		 * @param frameIndex The index of the frame in flight being recorded.
+		 */
 		void updateDescriptorSet(int frameIndex);
 
 	private:
+		/**
+		 * @brief Material buffer owned by a single frame in flight.
+		 */
+		struct FrameMaterialBuffer {
+			Unique<VulkanBuffer> buffer = nullptr;
+			uint32_t capacity = 0;
+			// material version last written in the buffer, per material index
+			std::vector<uint32_t> uploadedVersions;
+		};
+
+		/**
+		 * @brief (Re)creates the buffer of a frame so that it can hold at least minCapacity materials,
+		 * and points the frame descriptor set to it. All the entries are marked as stale.
+		 */
+		void reallocateFrameBuffer(int frameIndex, uint32_t minCapacity);
+
 		/**
 		 * @brief Converts a Material object into its corresponding GPU-ready MaterialData structure.
 		 *
@@ -114,7 +115,7 @@ namespace PXTEngine {
 		std::vector<Shared<Material>> m_materials;
 		std::unordered_map<ResourceId, uint32_t> m_idToIndex;
 
-		std::vector<Unique<VulkanBuffer>> m_materialsGpuBuffers{ SwapChain::MAX_FRAMES_IN_FLIGHT };
+		std::vector<FrameMaterialBuffer> m_frameBuffers{ SwapChain::MAX_FRAMES_IN_FLIGHT };
 		std::vector<VkDescriptorSet> m_materialDescriptorSets{ SwapChain::MAX_FRAMES_IN_FLIGHT };
 		Shared<DescriptorSetLayout> m_materialDescriptorSetLayout = nullptr;
 	};
@@ -179,8 +179,7 @@ namespace PXTEngine {
 		samplerInfo.minLod = 0.0f;
 		samplerInfo.maxLod = 0.0f;
 
-		if (vkCreateSampler(m_context.getDevice(), &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) {
-			throw std::runtime_error("failed to create texture sampler!");
-		}
+		// textures with the same settings share the same sampler
+		m_sampler = m_context.createSampler(samplerInfo);
 	}
 }
\ No newline at end of file
@@ -14,7 +14,8 @@ namespace PXTEngine {
         uint32_t instanceCount,
         VkBufferUsageFlags usageFlags,
         VkMemoryPropertyFlags memoryPropertyFlags,
-        VkDeviceSize minOffsetAlignment)
+        VkDeviceSize minOffsetAlignment,
+        const std::vector<uint32_t>& queueFamilies)
         : m_context{context},
           m_instanceSize{instanceSize},
           m_instanceCount{instanceCount},
@@ -22,7 +23,7 @@ namespace PXTEngine {
           m_memoryPropertyFlags{memoryPropertyFlags} {
         m_alignmentSize = getAlignment(instanceSize, minOffsetAlignment);
         m_bufferSize = m_alignmentSize * instanceCount;
-        context.createBuffer(m_bufferSize, usageFlags, memoryPropertyFlags, m_buffer, m_memory);
+        context.createBuffer(m_bufferSize, usageFlags, memoryPropertyFlags, m_buffer, m_memory, queueFamilies);
     }
 
     VulkanBuffer::~VulkanBuffer() {
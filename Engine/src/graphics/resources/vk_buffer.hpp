@@ -24,9 +24,12 @@ namespace PXTEngine {
          * @param usageFlags Vulkan buffer usage flags.
          * @param memoryPropertyFlags Vulkan memory property flags.
          * @param minOffsetAlignment Minimum offset alignment for the buffer.
+         * @param queueFamilies The queue families accessing the buffer concurrently, exclusive if empty
+         *                      (see Context::getAsyncComputeQueueFamilies).
          */
         VulkanBuffer(Context& context, VkDeviceSize instanceSize, uint32_t instanceCount, VkBufferUsageFlags usageFlags,
-               VkMemoryPropertyFlags memoryPropertyFlags, VkDeviceSize minOffsetAlignment = 1);
+               VkMemoryPropertyFlags memoryPropertyFlags, VkDeviceSize minOffsetAlignment = 1,
+               const std::vector<uint32_t>& queueFamilies = {});
 
         /**
          * @brief Destructor for the Buffer class.
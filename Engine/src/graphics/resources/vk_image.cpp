@@ -15,6 +15,8 @@ namespace PXTEngine {
 
 	VulkanImage::VulkanImage(Context& context, const VkImageCreateInfo& imageInfo, VkMemoryPropertyFlags memoryFlags)
 	: VulkanImage(context, ImageInfo(imageInfo.extent.width, imageInfo.extent.height, 4), Buffer()) {
+		m_imageFormat = imageInfo.format;
+
 		// create the image and allocate memory for it
 		m_context.createImageWithInfo(imageInfo, memoryFlags, m_vkImage, m_imageMemory);
 	}
@@ -24,12 +26,7 @@ namespace PXTEngine {
 			vkDestroyImageView(m_context.getDevice(), m_imageView, nullptr);
 		}
 
-		// TODO: Samplers should be a separate resource, not tied to the image.
-		// because then if the image is destroyed, the sampler is also destroyed and
-		// could be still used/destroyed_twice in other images.
-		if (m_sampler != VK_NULL_HANDLE) {
-			vkDestroySampler(m_context.getDevice(), m_sampler, nullptr);
-		}
+		// samplers are shared between images and owned by the context sampler cache
 
 		vkDestroyImage(m_context.getDevice(), m_vkImage, nullptr);
 		vkFreeMemory(m_context.getDevice(), m_imageMemory, nullptr);
@@ -47,10 +44,6 @@ namespace PXTEngine {
 	}
 
 	VulkanImage& VulkanImage::createSampler(const VkSamplerCreateInfo& samplerInfo) {
-		if (m_sampler != VK_NULL_HANDLE) {
-			vkDestroySampler(m_context.getDevice(), m_sampler, nullptr);
-		}
-
 		m_sampler = m_context.createSampler(samplerInfo);
 
 		return *this;
@@ -166,7 +166,7 @@ namespace PXTEngine {
 		VkImage m_vkImage; // the raw image pixels
 		VkDeviceMemory m_imageMemory; // the memory occupied by the image
 		VkImageView m_imageView; // an abstraction to view the same raw image in different "ways"
-		VkSampler m_sampler; // an abstraction (and tool) to help fragment shader pick the right color and
+		VkSampler m_sampler = VK_NULL_HANDLE; // an abstraction (and tool) to help fragment shader pick the right color and
 									// apply useful transformations (e.g. bilinear filtering, anisotropic filtering etc.)
 
 		VkImageLayout m_currentLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -5,17 +5,53 @@
 namespace PXTEngine {
 
     Unique<VulkanMesh> VulkanMesh::create(std::vector<Mesh::Vertex>& vertices, 
-        std::vector<uint32_t>& indices) {
+        std::vector<uint32_t>& indices, const std::vector<Mesh::SkinWeights>& skinWeights) {
         Context& context = Application::get().getContext();
 
-        return createUnique<VulkanMesh>(context, vertices, indices);
+        return createUnique<VulkanMesh>(context, vertices, indices, skinWeights);
     }
 
     VulkanMesh::VulkanMesh(Context& context, std::vector<Mesh::Vertex>& vertices, 
-        std::vector<uint32_t>& indices)
+        std::vector<uint32_t>& indices, const std::vector<Mesh::SkinWeights>& skinWeights)
         : m_context(context) {
+        m_boundingSphere = computeBoundingSphere(vertices);
+
         createVertexBuffers(vertices);
         createIndexBuffers(indices);
+
+        if (!skinWeights.empty()) {
+            createSkinWeightsBuffer(skinWeights);
+        }
+    }
+
+    VulkanMesh::VulkanMesh(Context& context, const VulkanMesh& skinnedMesh)
+        : m_context(context),
+        m_tilingFactor(skinnedMesh.m_tilingFactor),
+        m_vertexCount(skinnedMesh.m_vertexCount),
+        m_hasIndexBuffer(skinnedMesh.m_hasIndexBuffer),
+        m_indexBuffer(skinnedMesh.m_indexBuffer),
+        m_indexCount(skinnedMesh.m_indexCount) {
+
+        // the bounds of the bind pose, the joints are expected to stay close to it
+        m_boundingSphere = skinnedMesh.m_boundingSphere;
+
+        m_vertexBuffer = createUnique<VulkanBuffer>(
+            m_context,
+            sizeof(Mesh::Vertex),
+            m_vertexCount,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT  |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |                           // written by the skinning pass
+            VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR, // to create and refit BLASes
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+
+        // start from the bind pose, so the first BLAS build has a sensible topology to refit
+        m_context.copyBuffer(
+            skinnedMesh.m_vertexBuffer->getBuffer(),
+            m_vertexBuffer->getBuffer(),
+            sizeof(Mesh::Vertex) * m_vertexCount
+        );
     }
 
     VulkanMesh::~VulkanMesh() = default;
@@ -46,6 +82,7 @@ namespace PXTEngine {
             m_vertexCount, 
             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
             VK_BUFFER_USAGE_TRANSFER_DST_BIT  |
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT  |                                   // to create deformed copies
             VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |                           // to create BLASes
             VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR, // to create BLASes
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
@@ -74,7 +111,7 @@ namespace PXTEngine {
         stagingBuffer.map();
         stagingBuffer.writeToBuffer((void*)indices.data());
 
-        m_indexBuffer = createUnique<VulkanBuffer>(
+        m_indexBuffer = createShared<VulkanBuffer>(
             m_context, 
             indexSize, 
             m_indexCount, 
@@ -88,6 +125,35 @@ namespace PXTEngine {
         m_context.copyBuffer(stagingBuffer.getBuffer(), m_indexBuffer->getBuffer(), bufferSize);
     }
 
+    void VulkanMesh::createSkinWeightsBuffer(const std::vector<Mesh::SkinWeights>& skinWeights) {
+        PXT_ASSERT(skinWeights.size() == m_vertexCount, "Skin weights count must match the vertex count");
+
+        uint32_t skinWeightsSize = sizeof(skinWeights[0]);
+        VkDeviceSize bufferSize = skinWeightsSize * m_vertexCount;
+
+        VulkanBuffer stagingBuffer{
+            m_context,
+            skinWeightsSize,
+            m_vertexCount,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        };
+
+        stagingBuffer.map();
+        stagingBuffer.writeToBuffer((void*)skinWeights.data());
+
+        m_skinWeightsBuffer = createUnique<VulkanBuffer>(
+            m_context,
+            skinWeightsSize,
+            m_vertexCount,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, // read by the skinning pass
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        );
+
+        m_context.copyBuffer(stagingBuffer.getBuffer(), m_skinWeightsBuffer->getBuffer(), bufferSize);
+    }
+
     void VulkanMesh::draw(VkCommandBuffer commandBuffer) {
         if (m_hasIndexBuffer) {
             vkCmdDrawIndexed(commandBuffer, m_indexCount, 1, 0, 0, 0);
@@ -30,9 +30,21 @@ namespace PXTEngine {
          */
         static std::vector<VkVertexInputAttributeDescription> getVertexAttributeDescriptionOnlyPositon();
 
-        static Unique<VulkanMesh> create(std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices);
+        static Unique<VulkanMesh> create(std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices,
+            const std::vector<Mesh::SkinWeights>& skinWeights = {});
 
-        VulkanMesh(Context& context, std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices);
+        VulkanMesh(Context& context, std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices,
+            const std::vector<Mesh::SkinWeights>& skinWeights = {});
+
+        /**
+         * @brief Creates the deformed copy of a skinned mesh for one instance.
+         * The vertex buffer starts with the bind pose and is written by the skinning pass,
+         * the index buffer is shared with the skinned mesh.
+         *
+         * @param context The Vulkan context.
+         * @param skinnedMesh The mesh the vertices are skinned from.
+         */
+        VulkanMesh(Context& context, const VulkanMesh& skinnedMesh);
 
         ~VulkanMesh() override;
 
@@ -69,6 +81,14 @@ namespace PXTEngine {
             return m_indexBuffer->getDeviceAddress();
         }
 
+        bool isSkinned() const {
+            return m_skinWeightsBuffer != nullptr;
+        }
+
+        VkDeviceAddress getSkinWeightsBufferDeviceAddress() const {
+            return m_skinWeightsBuffer->getDeviceAddress();
+        }
+
         Type getType() const override {
             return Type::Mesh;
         }
@@ -84,6 +104,11 @@ namespace PXTEngine {
          */
         void createIndexBuffers(std::vector<uint32_t>& indices);
 
+        /**
+         * @brief Creates and allocates the skin weights buffer, read by the skinning pass.
+         */
+        void createSkinWeightsBuffer(const std::vector<Mesh::SkinWeights>& skinWeights);
+
         Context& m_context;
 
 		float m_tilingFactor = 1.0f;
@@ -92,7 +117,9 @@ namespace PXTEngine {
         uint32_t m_vertexCount;
 
         bool m_hasIndexBuffer = false;
-        Unique<VulkanBuffer> m_indexBuffer;
+        Shared<VulkanBuffer> m_indexBuffer; // shared with the deformed copies of skinned meshes
         uint32_t m_indexCount;
+
+        Unique<VulkanBuffer> m_skinWeightsBuffer; // only for skinned meshes
     };
 }
@@ -107,6 +107,8 @@ namespace PXTEngine
 	VulkanShader::VulkanShader(Context& context, const std::string_view& fileName,
 		const std::vector<std::pair<std::string, std::string>>& definitions)
 		: m_context(context) {
+		PXT_STARTUP_PHASE("Compile shader");
+
 		const auto cwd = get_cwd();
 		const std::string fileLocation = cwd + "/" + std::string(fileName.data());
 
@@ -173,7 +175,7 @@ namespace PXTEngine
 	std::vector<char> VulkanShader::readFile(const std::string_view& fileName) {
 		std::ifstream fileStream(fileName.data(), std::ios::binary | std::ios::in | std::ios::ate);
 		if (!fileStream.is_open())
-			PXT_FATAL("Could not open file.");
+			throw std::runtime_error("Could not open file: " + std::string(fileName));
 
 		std::streamsize size = fileStream.tellg();
 		if (size <= 0)
@@ -185,6 +187,8 @@ namespace PXTEngine
 		if (!fileStream.read(data.data(), size))
 			throw std::runtime_error("Failed to read file: " + std::string(fileName));
 
+		StartupProfiler::recordRead(static_cast<uint64_t>(size));
+
 		return data;
 	}
 
@@ -192,7 +196,7 @@ namespace PXTEngine
 		std::string buffer;
 		std::ifstream fileStream(fileName.data());
 		if (!fileStream.is_open())
-			PXT_FATAL("Could not open file.");
+			throw std::runtime_error("Could not open file: " + std::string(fileName));
 
 		std::string temp;
 		while (getline(fileStream, temp))
@@ -200,19 +204,21 @@ namespace PXTEngine
 
 		fileStream >> buffer;
 		fileStream.close();
+
+		StartupProfiler::recordRead(buffer.size());
 		return buffer;
 	}
 
 	// The shader compilation implementation below was taken from google/shaderc itself
 	// It implements include support for GLSL
 	// https://github.com/google/shaderc
+	// The compilation errors are thrown with the compiler's message, so that a shader
+	// reloaded at runtime can keep its previous version (see ShaderReloader)
 	std::string VulkanShader::preprocessShader(const std::string_view& fileName, const std::string& source, shaderc_shader_kind shaderKind) {
 		auto result = m_compiler.PreprocessGlsl(source, shaderKind, fileName.data(), m_compileOptions);
 		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
 		{
-			shaderc_compilation_status status = result.GetCompilationStatus();
-			PXT_FATAL("{}", result.GetErrorMessage().data());
-			return "";
+			throw std::runtime_error(result.GetErrorMessage());
 		}
 		return { result.cbegin(), result.cend() };
 	}
@@ -222,8 +228,7 @@ namespace PXTEngine
 
 		if (result.GetCompilationStatus() != shaderc_compilation_status_success)
 		{
-			PXT_FATAL("{}", result.GetErrorMessage().data());
-			return "";
+			throw std::runtime_error(result.GetErrorMessage());
 		}
 		return { result.cbegin(), result.cend() };
 	}
@@ -233,8 +238,7 @@ namespace PXTEngine
 
 		if (module.GetCompilationStatus() != shaderc_compilation_status_success)
 		{
-			PXT_FATAL("{}", module.GetErrorMessage().data());
-			return std::vector<uint32_t>();
+			throw std::runtime_error(module.GetErrorMessage());
 		}
 
 		return { module.cbegin(), module.cend() };
@@ -621,6 +625,7 @@ namespace PXTEngine
 				}
 				*input_data = std::vector<char>((std::istreambuf_iterator<char>(*stream)),
 					std::istreambuf_iterator<char>());
+				StartupProfiler::recordRead(input_data->size());
 				return true;
 			};
 
@@ -1,6 +1,7 @@
 #include "graphics/resources/vk_skybox.hpp"
 
 #include "application.hpp"
+#include "graphics/ibl_baker.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -21,12 +22,15 @@ namespace PXTEngine {
 	}
 
 	void VulkanSkybox::loadTextures(const std::array<std::string, 6>& paths) {
+        PXT_STARTUP_PHASE("Load skybox");
+
         VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
 		int width, height, channels;
 		uint8_t* pixels[6] = { nullptr };
 		
         for (int i = 0; i < 6; ++i) {
             pixels[i] = stbi_load(paths[i].c_str(), &width, &height, &channels, STBI_rgb_alpha);
+            StartupProfiler::recordFileRead(paths[i]);
 
             if (!pixels[i]) {
                 // Cleanup previously loaded images before throwing
@@ -57,6 +61,14 @@ namespace PXTEngine {
             }
         }
 
+        // the diffuse part of the environment only needs the low frequencies, project it
+        // while the pixels are still on the CPU instead of reading the cube map back
+        m_irradianceSH = IBL::projectCubeMap(
+            { pixels[0], pixels[1], pixels[2], pixels[3], pixels[4], pixels[5] },
+            m_size,
+            format == VK_FORMAT_R8G8B8A8_SRGB
+        );
+
 		VkDeviceSize faceImageSizes = m_size * m_size * 4;
         VkDeviceSize totalImageSize = faceImageSizes * 6;
 
@@ -112,6 +124,8 @@ namespace PXTEngine {
             VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
             cubemapSubresourceRange
         );
+
+        m_prefilteredMap = IBLBaker(m_context).prefilterSpecular(*m_cubeMap);
 	}
 
     void VulkanSkybox::createDescriptorSet(Shared<DescriptorAllocatorGrowable> descriptorAllocator) {
@@ -138,4 +152,12 @@ namespace PXTEngine {
         return imageInfo;
     }
 
+    VkDescriptorImageInfo VulkanSkybox::getPrefilteredImageInfo() const {
+        VkDescriptorImageInfo imageInfo{};
+        imageInfo.sampler = m_prefilteredMap->getImageSampler();
+        imageInfo.imageView = m_prefilteredMap->getImageView();
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        return imageInfo;
+    }
+
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "core/pch.hpp"
 #include "graphics/resources/cube_map.hpp"
 #include "graphics/descriptors/descriptors.hpp"
+#include "graphics/ibl.hpp"
 #include "scene/skybox.hpp"
 
 namespace PXTEngine {
@@ -21,6 +22,16 @@ namespace PXTEngine {
 		VkDescriptorSet getDescriptorSet() const { return m_skyboxDescriptorSet; }
 		VkDescriptorSetLayout getDescriptorSetLayout() const { return m_skyboxDescriptorSetLayout->getDescriptorSetLayout(); }
 
+		/**
+		 * @brief Get the irradiance of the skybox, projected on spherical harmonics when the faces are loaded.
+		 */
+		const IBL::IrradianceSH& getIrradianceSH() const { return m_irradianceSH; }
+
+		/**
+		 * @brief Get the image info of the GGX prefiltered skybox (one roughness level per mip).
+		 */
+		VkDescriptorImageInfo getPrefilteredImageInfo() const;
+
 	private:
 		void loadTextures(const std::array<std::string, 6>& paths);
 
@@ -28,6 +39,8 @@ namespace PXTEngine {
 		
 		uint32_t m_size = 0;
 		Unique<CubeMap> m_cubeMap;
+		Unique<CubeMap> m_prefilteredMap;
+		IBL::IrradianceSH m_irradianceSH;
 
 		VkDescriptorSet m_skyboxDescriptorSet;
 		Unique<DescriptorSetLayout> m_skyboxDescriptorSetLayout;
@@ -0,0 +1,485 @@
+#include "graphics/resources/volume_brick_atlas.hpp"
+
+namespace PXTEngine {
+
+	namespace {
+		// FNV-1a over the bit patterns of the values
+		size_t hashBrick(const std::vector<float>& values) {
+			uint64_t hash = 14695981039346656037ull;
+			for (const float value : values) {
+				uint32_t bits;
+				std::memcpy(&bits, &value, sizeof(bits));
+				hash ^= bits;
+				hash *= 1099511628211ull;
+			}
+			return static_cast<size_t>(hash);
+		}
+	}
+
+	VolumeBrickAtlas::VolumeBrickAtlas(Context& context) : m_context(context) {
+		m_bricks.resize(INITIAL_CAPACITY);
+
+		// the free slots are popped from the back, so the lowest slots are used first
+		m_freeSlots.reserve(INITIAL_CAPACITY);
+		for (uint32_t slot = INITIAL_CAPACITY; slot > 0; slot--) {
+			m_freeSlots.push_back(slot - 1);
+		}
+
+		// the resources must be valid even if no grid is ever added
+		VkCommandBuffer commandBuffer = m_context.beginSingleTimeCommands();
+		flush(commandBuffer, 0);
+		m_context.endSingleTimeCommands(commandBuffer);
+	}
+
+	const VolumeBrickAtlas::Allocation& VolumeBrickAtlas::acquire(const Shared<DensityGrid>& grid) {
+		PXT_ASSERT(grid != nullptr, "Cannot add a null density grid to the brick atlas");
+
+		if (auto it = m_grids.find(grid->id); it != m_grids.end()) {
+			it->second.isUsed = true;
+			return it->second.allocation;
+		}
+
+		const glm::uvec3 resolution = grid->getResolution();
+		const glm::uvec3 brickGridSize = (resolution + glm::uvec3(BRICK_SIZE - 1)) / BRICK_SIZE;
+
+		GridEntry entry{};
+		entry.allocation.brickGridSize = brickGridSize;
+		entry.bricks.reserve(static_cast<size_t>(brickGridSize.x) * brickGridSize.y * brickGridSize.z);
+
+		for (uint32_t brickZ = 0; brickZ < brickGridSize.z; brickZ++) {
+			for (uint32_t brickY = 0; brickY < brickGridSize.y; brickY++) {
+				for (uint32_t brickX = 0; brickX < brickGridSize.x; brickX++) {
+					const glm::uvec3 origin = glm::uvec3(brickX, brickY, brickZ) * BRICK_SIZE;
+
+					// values outside of the grid (last bricks of each axis) are left to 0
+					std::vector<float> values(BRICK_VALUE_COUNT, 0.0f);
+					float majorant = 0.0f;
+
+					const glm::uvec3 end = glm::min(origin + glm::uvec3(BRICK_SIZE), resolution);
+					for (uint32_t z = origin.z; z < end.z; z++) {
+						for (uint32_t y = origin.y; y < end.y; y++) {
+							for (uint32_t x = origin.x; x < end.x; x++) {
+								const float value = grid->at(x, y, z);
+								values[((z - origin.z) * BRICK_SIZE + (y - origin.y)) * BRICK_SIZE + (x - origin.x)] = value;
+								majorant = std::max(majorant, value);
+							}
+						}
+					}
+
+					if (majorant <= 0.0f) {
+						entry.bricks.push_back({ EMPTY_BRICK, 0.0f });
+						continue;
+					}
+
+					entry.bricks.push_back({ storeBrick(std::move(values)), majorant });
+					entry.allocation.majorant = std::max(entry.allocation.majorant, majorant);
+				}
+			}
+		}
+
+		m_isIndirectionDirty = true;
+
+		return m_grids.emplace(grid->id, std::move(entry)).first->second.allocation;
+	}
+
+	const VolumeBrickAtlas::Allocation& VolumeBrickAtlas::getAllocation(const ResourceId& gridId) const {
+		auto it = m_grids.find(gridId);
+		PXT_ASSERT(it != m_grids.end(), "Density grid not found in the brick atlas");
+
+		return it->second.allocation;
+	}
+
+	void VolumeBrickAtlas::release(const ResourceId& gridId) {
+		auto it = m_grids.find(gridId);
+		if (it == m_grids.end()) return;
+
+		for (const BrickEntry& brick : it->second.bricks) {
+			if (brick.atlasSlot != EMPTY_BRICK) {
+				freeBrick(brick.atlasSlot);
+			}
+		}
+
+		m_grids.erase(it);
+		m_isIndirectionDirty = true;
+	}
+
+	void VolumeBrickAtlas::releaseUnused() {
+		std::vector<ResourceId> unusedGrids;
+		for (auto& [id, entry] : m_grids) {
+			if (!entry.isUsed) {
+				unusedGrids.push_back(id);
+			}
+			entry.isUsed = false;
+		}
+
+		for (const ResourceId& id : unusedGrids) {
+			release(id);
+		}
+	}
+
+	uint32_t VolumeBrickAtlas::storeBrick(std::vector<float>&& values) {
+		const size_t hash = hashBrick(values);
+
+		// deduplicate: the hash only selects the candidates, the values are compared
+		auto [begin, end] = m_slotsByHash.equal_range(hash);
+		for (auto it = begin; it != end; ++it) {
+			Brick& brick = m_bricks[it->second];
+			if (brick.values == values) {
+				brick.refCount++;
+				return it->second;
+			}
+		}
+
+		const uint32_t slot = allocateSlot();
+
+		Brick& brick = m_bricks[slot];
+		brick.values = std::move(values);
+		brick.hash = hash;
+		brick.refCount = 1;
+
+		m_slotsByHash.emplace(hash, slot);
+		m_pendingSlots.push_back(slot);
+
+		return slot;
+	}
+
+	void VolumeBrickAtlas::freeBrick(const uint32_t slot) {
+		Brick& brick = m_bricks[slot];
+		PXT_ASSERT(brick.refCount > 0, "Freeing a brick that is not in use");
+
+		if (--brick.refCount > 0) return;
+
+		auto [begin, end] = m_slotsByHash.equal_range(brick.hash);
+		for (auto it = begin; it != end; ++it) {
+			if (it->second == slot) {
+				m_slotsByHash.erase(it);
+				break;
+			}
+		}
+
+		// a brick freed before the flush has nothing left to upload
+		std::erase(m_pendingSlots, slot);
+
+		brick.values = {};
+		m_freeSlots.push_back(slot);
+	}
+
+	uint32_t VolumeBrickAtlas::allocateSlot() {
+		if (m_freeSlots.empty()) {
+			const uint32_t oldCapacity = static_cast<uint32_t>(m_bricks.size());
+			const uint32_t newCapacity = oldCapacity * 2;
+
+			const uint32_t maxDepth = m_context.getPhysicalDeviceProperties().limits.maxImageDimension3D;
+			if (newCapacity / SLOTS_PER_LAYER * BRICK_SIZE > maxDepth) {
+				throw std::runtime_error("Volume brick atlas is full, cannot store " + std::to_string(newCapacity) + " bricks");
+			}
+
+			m_bricks.resize(newCapacity);
+			for (uint32_t slot = newCapacity; slot > oldCapacity; slot--) {
+				m_freeSlots.push_back(slot - 1);
+			}
+
+			m_needsAtlasRebuild = true;
+		}
+
+		const uint32_t slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+		return slot;
+	}
+
+	void VolumeBrickAtlas::defragment() {
+		const uint32_t oldCapacity = static_cast<uint32_t>(m_bricks.size());
+
+		std::vector<uint32_t> remap(oldCapacity, EMPTY_BRICK);
+		std::vector<Brick> compacted;
+
+		for (uint32_t slot = 0; slot < oldCapacity; slot++) {
+			if (m_bricks[slot].refCount == 0) continue;
+
+			remap[slot] = static_cast<uint32_t>(compacted.size());
+			compacted.push_back(std::move(m_bricks[slot]));
+		}
+
+		const uint32_t storedCount = static_cast<uint32_t>(compacted.size());
+
+		// leave room to grow before the next resize
+		uint32_t newCapacity = INITIAL_CAPACITY;
+		while (newCapacity < storedCount * 2) {
+			newCapacity *= 2;
+		}
+
+		compacted.resize(newCapacity);
+		m_bricks = std::move(compacted);
+
+		m_slotsByHash.clear();
+		for (uint32_t slot = 0; slot < storedCount; slot++) {
+			m_slotsByHash.emplace(m_bricks[slot].hash, slot);
+		}
+
+		m_freeSlots.clear();
+		for (uint32_t slot = newCapacity; slot > storedCount; slot--) {
+			m_freeSlots.push_back(slot - 1);
+		}
+
+		for (auto& [id, entry] : m_grids) {
+			for (BrickEntry& brick : entry.bricks) {
+				if (brick.atlasSlot != EMPTY_BRICK) {
+					brick.atlasSlot = remap[brick.atlasSlot];
+				}
+			}
+		}
+
+		PXT_INFO("Volume brick atlas defragmented: {} bricks, capacity {} -> {}", storedCount, oldCapacity, newCapacity);
+
+		m_pendingSlots.clear();
+		m_needsAtlasRebuild = true;
+		m_isIndirectionDirty = true;
+	}
+
+	bool VolumeBrickAtlas::flush(VkCommandBuffer commandBuffer, const uint32_t frameIndex) {
+		PXT_ASSERT(frameIndex < SwapChain::MAX_FRAMES_IN_FLIGHT, "VolumeBrickAtlas frame index out of range");
+
+		// the frame timeline value of this frame index has been waited on
+		m_retiredResources[frameIndex] = {};
+		m_frameIndex = frameIndex;
+
+		const uint32_t capacity = static_cast<uint32_t>(m_bricks.size());
+		const uint32_t storedCount = capacity - static_cast<uint32_t>(m_freeSlots.size());
+
+		// compact when less than a quarter of the slots is used
+		if (capacity > INITIAL_CAPACITY && storedCount * 4 <= capacity) {
+			defragment();
+		}
+
+		if (!m_needsAtlasRebuild && m_pendingSlots.empty() && !m_isIndirectionDirty) {
+			return false;
+		}
+
+		bool hasResourcesChanged = false;
+
+		if (m_needsAtlasRebuild) {
+			createAtlasImage(commandBuffer);
+
+			// a new atlas is empty, every brick in use has to be uploaded
+			std::vector<uint32_t> usedSlots;
+			for (uint32_t slot = 0; slot < m_bricks.size(); slot++) {
+				if (m_bricks[slot].refCount > 0) {
+					usedSlots.push_back(slot);
+				}
+			}
+			uploadBricks(commandBuffer, usedSlots);
+
+			m_needsAtlasRebuild = false;
+			hasResourcesChanged = true;
+		} else {
+			uploadBricks(commandBuffer, m_pendingSlots);
+		}
+		m_pendingSlots.clear();
+
+		if (m_isIndirectionDirty) {
+			uploadIndirectionTable(commandBuffer);
+
+			m_isIndirectionDirty = false;
+			hasResourcesChanged = true;
+		}
+
+		return hasResourcesChanged;
+	}
+
+	void VolumeBrickAtlas::createAtlasImage(VkCommandBuffer commandBuffer) {
+		const uint32_t layerCount = static_cast<uint32_t>(m_bricks.size()) / SLOTS_PER_LAYER;
+
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_3D;
+		imageInfo.format = VK_FORMAT_R32_SFLOAT;
+		imageInfo.extent = { SLOTS_PER_ROW * BRICK_SIZE, SLOTS_PER_ROW * BRICK_SIZE, layerCount * BRICK_SIZE };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		// the frames in flight may still trace with the previous atlas
+		m_retiredResources[m_frameIndex].atlas = std::move(m_atlas);
+		m_atlas = createUnique<VulkanImage>(m_context, imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
+		viewInfo.format = VK_FORMAT_R32_SFLOAT;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		// bricks are fetched texel by texel, filtering would mix values of unrelated bricks
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.maxAnisotropy = 1.0f;
+
+		m_atlas->createImageView(viewInfo);
+		m_atlas->createSampler(samplerInfo);
+
+		// the atlas may be bound before anything is uploaded to it
+		m_atlas->transitionImageLayout(
+			commandBuffer,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR
+		);
+	}
+
+	void VolumeBrickAtlas::uploadBricks(VkCommandBuffer commandBuffer, const std::vector<uint32_t>& slots) {
+		if (slots.empty()) return;
+
+		constexpr VkDeviceSize brickSize = sizeof(float) * BRICK_VALUE_COUNT;
+
+		Unique<VulkanBuffer>& stagingBuffer = m_retiredResources[m_frameIndex].buffers.emplace_back(createUnique<VulkanBuffer>(
+			m_context,
+			brickSize,
+			static_cast<uint32_t>(slots.size()),
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+		));
+		stagingBuffer->map();
+
+		std::vector<VkBufferImageCopy> regions;
+		regions.reserve(slots.size());
+
+		for (size_t i = 0; i < slots.size(); i++) {
+			const uint32_t slot = slots[i];
+			const VkDeviceSize offset = brickSize * i;
+
+			stagingBuffer->writeToBuffer((void*)m_bricks[slot].values.data(), brickSize, offset);
+
+			VkBufferImageCopy region{};
+			region.bufferOffset = offset;
+			region.bufferRowLength = 0; // tightly packed
+			region.bufferImageHeight = 0;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = 0;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = {
+				static_cast<int32_t>(slot % SLOTS_PER_ROW * BRICK_SIZE),
+				static_cast<int32_t>(slot / SLOTS_PER_ROW % SLOTS_PER_ROW * BRICK_SIZE),
+				static_cast<int32_t>(slot / SLOTS_PER_LAYER * BRICK_SIZE)
+			};
+			region.imageExtent = { BRICK_SIZE, BRICK_SIZE, BRICK_SIZE };
+
+			regions.push_back(region);
+		}
+
+		// after the traces of the frames before, a slot they read may have been freed and reused
+		m_atlas->transitionImageLayout(
+			commandBuffer,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+			VK_PIPELINE_STAGE_TRANSFER_BIT
+		);
+
+		vkCmdCopyBufferToImage(
+			commandBuffer,
+			stagingBuffer->getBuffer(),
+			m_atlas->getVkImage(),
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			static_cast<uint32_t>(regions.size()),
+			regions.data()
+		);
+
+		m_atlas->transitionImageLayout(
+			commandBuffer,
+			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR
+		);
+	}
+
+	void VolumeBrickAtlas::uploadIndirectionTable(VkCommandBuffer commandBuffer) {
+		std::vector<BrickEntry> table;
+
+		for (auto& [id, entry] : m_grids) {
+			entry.allocation.indirectionOffset = static_cast<uint32_t>(table.size());
+			table.insert(table.end(), entry.bricks.begin(), entry.bricks.end());
+		}
+
+		// the buffer must be valid even without grids
+		if (table.empty()) table.push_back({ EMPTY_BRICK, 0.0f });
+
+		const VkDeviceSize bufferSize = sizeof(BrickEntry) * table.size();
+
+		std::vector<Unique<VulkanBuffer>>& retiredBuffers = m_retiredResources[m_frameIndex].buffers;
+
+		Unique<VulkanBuffer>& stagingBuffer = retiredBuffers.emplace_back(createUnique<VulkanBuffer>(
+			m_context,
+			bufferSize,
+			1,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+		));
+
+		stagingBuffer->map();
+		stagingBuffer->writeToBuffer(table.data(), bufferSize);
+		stagingBuffer->unmap();
+
+		// the frames in flight may still read the previous table
+		if (m_indirectionBuffer) retiredBuffers.push_back(std::move(m_indirectionBuffer));
+
+		m_indirectionBuffer = createUnique<VulkanBuffer>(
+			m_context,
+			bufferSize,
+			1,
+			VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+		);
+
+		VkBufferCopy copyRegion{};
+		copyRegion.size = bufferSize;
+		vkCmdCopyBuffer(commandBuffer, stagingBuffer->getBuffer(), m_indirectionBuffer->getBuffer(), 1, &copyRegion);
+
+		VkBufferMemoryBarrier bufferBarrier{};
+		bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		bufferBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.buffer = m_indirectionBuffer->getBuffer();
+		bufferBarrier.offset = 0;
+		bufferBarrier.size = VK_WHOLE_SIZE;
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR,
+			0,
+			0, nullptr,
+			1, &bufferBarrier,
+			0, nullptr
+		);
+	}
+
+	VolumeBrickAtlas::Stats VolumeBrickAtlas::getStats() const {
+		Stats stats{};
+		stats.gridCount = static_cast<uint32_t>(m_grids.size());
+		stats.capacity = static_cast<uint32_t>(m_bricks.size());
+		stats.storedBrickCount = stats.capacity - static_cast<uint32_t>(m_freeSlots.size());
+		stats.memorySize = static_cast<VkDeviceSize>(stats.capacity) * BRICK_VALUE_COUNT * sizeof(float);
+
+		for (const auto& [id, entry] : m_grids) {
+			stats.brickCount += static_cast<uint32_t>(entry.bricks.size());
+			for (const BrickEntry& brick : entry.bricks) {
+				if (brick.atlasSlot == EMPTY_BRICK) stats.emptyBrickCount++;
+			}
+		}
+
+		return stats;
+	}
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/context/context.hpp"
+#include "graphics/resources/vk_buffer.hpp"
+#include "graphics/resources/vk_image.hpp"
+#include "graphics/swap_chain.hpp"
+#include "resources/types/density_grid.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @brief Entry of the brick indirection table, one for every brick of every volume.
+	 * Matches the BrickEntry struct in the shaders.
+	 */
+	struct BrickEntry {
+		uint32_t atlasSlot; // VolumeBrickAtlas::EMPTY_BRICK if all the brick values are 0
+		float majorant;     // maximum density of the brick, the majorant of the delta tracking in it
+	};
+
+	/**
+	 * @class VolumeBrickAtlas
+	 * @brief Stores the density grids of all the volumes as bricks of a shared 3D texture.
+	 *
+	 * Every grid is split in bricks of BRICK_SIZE^3 values:
+	 * - bricks with only zeros are not stored at all
+	 * - bricks with the same values are stored once, no matter which grid they come from
+	 *
+	 * Each grid gets a range of the indirection table, which maps its bricks to the atlas
+	 * slots and stores their majorants (so the majorant grid of a volume is its range of the
+	 * table). The atlas grows by doubling when it runs out of slots and is compacted when
+	 * most of its slots have been freed.
+	 *
+	 * Changes are only applied on the GPU by flush(), which records the uploads in the frame
+	 * command buffer. The bricks are written in place, after the traces of the frames before
+	 * (a slot freed by them may be reused); the atlas texture and the indirection table replaced
+	 * by a flush are kept, with the staging buffers, until its frame index is recorded again.
+	 */
+	class VolumeBrickAtlas {
+	public:
+		static constexpr uint32_t BRICK_SIZE = 8;
+		static constexpr uint32_t BRICK_VALUE_COUNT = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+		static constexpr uint32_t EMPTY_BRICK = std::numeric_limits<uint32_t>::max();
+
+		// slots are laid out in layers of SLOTS_PER_ROW x SLOTS_PER_ROW bricks
+		static constexpr uint32_t SLOTS_PER_ROW = 16;
+		static constexpr uint32_t SLOTS_PER_LAYER = SLOTS_PER_ROW * SLOTS_PER_ROW;
+		static constexpr uint32_t INITIAL_CAPACITY = SLOTS_PER_LAYER * 4;
+
+		/**
+		 * @brief Where the bricks of a grid are, see the Volume struct in the shaders.
+		 */
+		struct Allocation {
+			glm::uvec3 brickGridSize{ 0 };
+			uint32_t indirectionOffset = 0;
+			float majorant = 0.0f;
+		};
+
+		struct Stats {
+			uint32_t gridCount = 0;
+			uint32_t brickCount = 0;        // bricks of all the grids
+			uint32_t emptyBrickCount = 0;   // bricks skipped because empty
+			uint32_t storedBrickCount = 0;  // bricks actually stored in the atlas
+			uint32_t capacity = 0;          // slots of the atlas
+			VkDeviceSize memorySize = 0;    // bytes of the atlas texture
+		};
+
+		VolumeBrickAtlas(Context& context);
+		~VolumeBrickAtlas() = default;
+
+		VolumeBrickAtlas(const VolumeBrickAtlas&) = delete;
+		VolumeBrickAtlas& operator=(const VolumeBrickAtlas&) = delete;
+
+		/**
+		 * @brief Adds a grid to the atlas if not already there, the bricks are uploaded by the next flush().
+		 *
+		 * @return The allocation of the grid, its indirection offset is valid only after flush().
+		 */
+		const Allocation& acquire(const Shared<DensityGrid>& grid);
+
+		/**
+		 * @brief Returns the allocation of a grid already in the atlas.
+		 */
+		const Allocation& getAllocation(const ResourceId& gridId) const;
+
+		/**
+		 * @brief Removes a grid from the atlas, freeing the bricks it does not share with other grids.
+		 */
+		void release(const ResourceId& gridId);
+
+		/**
+		 * @brief Removes all the grids not acquired since the last call to this function.
+		 */
+		void releaseUnused();
+
+		/**
+		 * @brief Records the upload of the pending bricks and of the indirection table, growing
+		 * or compacting the atlas texture if needed. Must be called once per frame, before the trace.
+		 *
+		 * @param commandBuffer The frame command buffer.
+		 * @param frameIndex The frame index, whose previous resources are released.
+		 *
+		 * @return True if the GPU resources have changed (and need to be written again in the descriptor sets).
+		 */
+		bool flush(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+
+		VkDescriptorImageInfo getAtlasImageInfo() { return m_atlas->getImageInfo(); }
+		VkDescriptorBufferInfo getIndirectionBufferInfo() { return m_indirectionBuffer->descriptorInfo(); }
+
+		Stats getStats() const;
+
+	private:
+		struct Brick {
+			std::vector<float> values;
+			size_t hash = 0;
+			uint32_t refCount = 0; // 0 if the slot is free
+		};
+
+		struct GridEntry {
+			Allocation allocation;
+			std::vector<BrickEntry> bricks;
+			bool isUsed = true; // acquired since the last releaseUnused()
+		};
+
+		uint32_t storeBrick(std::vector<float>&& values);
+		void freeBrick(uint32_t slot);
+		uint32_t allocateSlot();
+
+		// moves the bricks in use to the first slots and shrinks the atlas
+		void defragment();
+
+		void createAtlasImage(VkCommandBuffer commandBuffer);
+		void uploadBricks(VkCommandBuffer commandBuffer, const std::vector<uint32_t>& slots);
+		void uploadIndirectionTable(VkCommandBuffer commandBuffer);
+
+		Context& m_context;
+
+		Unique<VulkanImage> m_atlas;
+		Unique<VulkanBuffer> m_indirectionBuffer;
+
+		// the resources a frame replaced or uploaded from, released when its frame index is flushed again
+		struct RetiredResources {
+			std::vector<Unique<VulkanBuffer>> buffers;
+			Unique<VulkanImage> atlas;
+		};
+		std::array<RetiredResources, SwapChain::MAX_FRAMES_IN_FLIGHT> m_retiredResources;
+		uint32_t m_frameIndex = 0; // of the flush being recorded
+
+		std::vector<Brick> m_bricks; // one per slot of the atlas
+		std::vector<uint32_t> m_freeSlots;
+		std::unordered_multimap<size_t, uint32_t> m_slotsByHash;
+
+		std::unordered_map<ResourceId, GridEntry> m_grids;
+
+		std::vector<uint32_t> m_pendingSlots; // slots written since the last flush
+		bool m_needsAtlasRebuild = true;
+		bool m_isIndirectionDirty = true;
+	};
+}
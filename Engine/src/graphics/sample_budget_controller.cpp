@@ -0,0 +1,49 @@
+#include "graphics/sample_budget_controller.hpp"
+
+namespace PXTEngine {
+
+	void SampleBudgetController::addMeasure(const float elapsedMs, const uint32_t samplesPerPixel) {
+		if (samplesPerPixel == 0 || elapsedMs <= 0.0f) return;
+
+		m_lastMeasureMs = elapsedMs;
+
+		// the fixed cost of the dispatch is attributed to the samples, which
+		// overestimates the cost of a sample and keeps the count on the safe side
+		const float msPerSample = elapsedMs / static_cast<float>(samplesPerPixel);
+		m_msPerSample = m_msPerSample > 0.0f ? glm::mix(m_msPerSample, msPerSample, 0.25f) : msPerSample;
+	}
+
+	uint32_t SampleBudgetController::computeSamplesPerPixel(const bool isCameraStill) {
+		// moving again drops the idle budget right away, becoming idle needs a few still frames
+		m_stillFrames = isCameraStill ? m_stillFrames + 1 : 0;
+		m_isIdle = m_settings.isIdleAccumulationEnabled && m_stillFrames > m_settings.stillFramesBeforeIdle;
+
+		if (m_settings.mode == Mode::Fixed) {
+			m_samplesPerPixel = std::clamp(m_settings.fixedSamplesPerPixel, 1u, MAX_SAMPLES_PER_PIXEL);
+			return m_samplesPerPixel;
+		}
+
+		// without a measure yet (or timestamps) stay at the minimum
+		if (m_msPerSample <= 0.0f) {
+			m_samplesPerPixel = 1;
+			return m_samplesPerPixel;
+		}
+
+		const float budgetMs = m_isIdle ? std::max(m_settings.idleBudgetMs, m_settings.budgetMs) : m_settings.budgetMs;
+		const float upperBoundMs = budgetMs * (1.0f + m_settings.hysteresis);
+		const float lowerBoundMs = budgetMs * (1.0f - m_settings.hysteresis);
+
+		const auto fittingSamples = static_cast<uint32_t>(budgetMs / m_msPerSample);
+
+		if (static_cast<float>(m_samplesPerPixel) * m_msPerSample > upperBoundMs) {
+			// over budget: go straight to what fits
+			m_samplesPerPixel = fittingSamples;
+		} else if (static_cast<float>(m_samplesPerPixel + 1) * m_msPerSample < lowerBoundMs) {
+			// well under budget: grow, at most doubling so that a wrong estimate costs one slow frame
+			m_samplesPerPixel = std::min(fittingSamples, m_samplesPerPixel * 2);
+		}
+
+		m_samplesPerPixel = std::clamp(m_samplesPerPixel, 1u, MAX_SAMPLES_PER_PIXEL);
+		return m_samplesPerPixel;
+	}
+}
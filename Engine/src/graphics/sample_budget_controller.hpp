@@ -0,0 +1,74 @@
+#pragma once
+
+#include "core/pch.hpp"
+
+namespace PXTEngine {
+	/**
+	 * @brief Chooses how many samples per pixel the path tracer traces each frame so that the
+	 * ray tracing dispatch fits a GPU time budget.
+	 *
+	 * The cost of one sample is estimated from the GPU timings of the previous dispatches.
+	 * The sample count drops as soon as the budget is exceeded (to keep the display responsive)
+	 * but only grows when the next count fits well below the budget, so that the noise of the
+	 * timings does not make it oscillate between two values.
+	 *
+	 * While the camera is still, a separate (usually much larger) budget can be used so that the
+	 * idle GPU time is spent on accumulation instead.
+	 */
+	class SampleBudgetController {
+	public:
+		static constexpr uint32_t MAX_SAMPLES_PER_PIXEL = 64;
+
+		enum class Mode : uint8_t {
+			Fixed,	// always trace fixedSamplesPerPixel
+			Budget, // fit the budget
+		};
+
+		struct Settings {
+			Mode mode = Mode::Budget;
+			uint32_t fixedSamplesPerPixel = 1;
+
+			float budgetMs = 8.0f;
+
+			// spend more GPU time while the camera does not move
+			bool isIdleAccumulationEnabled = true;
+			float idleBudgetMs = 30.0f;
+			uint32_t stillFramesBeforeIdle = 4; // avoids switching budget between two mouse movements
+
+			// fraction of the budget the sample count must stay within before it changes
+			float hysteresis = 0.15f;
+		};
+
+		/**
+		 * @brief Updates the cost of a sample with the GPU time of a dispatch.
+		 *
+		 * @param elapsedMs The GPU time of the dispatch.
+		 * @param samplesPerPixel The sample count the dispatch was recorded with.
+		 */
+		void addMeasure(float elapsedMs, uint32_t samplesPerPixel);
+
+		/**
+		 * @brief Computes the sample count of the next dispatch.
+		 *
+		 * @param isCameraStill Whether the camera did not move since the previous frame.
+		 * @return The number of samples per pixel, in [1, MAX_SAMPLES_PER_PIXEL].
+		 */
+		uint32_t computeSamplesPerPixel(bool isCameraStill);
+
+		Settings& getSettings() { return m_settings; }
+		uint32_t getSamplesPerPixel() const { return m_samplesPerPixel; }
+		float getMsPerSample() const { return m_msPerSample; }
+		float getLastMeasureMs() const { return m_lastMeasureMs; }
+		bool isIdle() const { return m_isIdle; }
+
+	private:
+		Settings m_settings{};
+
+		uint32_t m_samplesPerPixel = 1;
+		float m_msPerSample = 0.0f; // smoothed GPU time of one sample per pixel, 0 until measured
+		float m_lastMeasureMs = 0.0f;
+
+		uint32_t m_stillFrames = 0;
+		bool m_isIdle = false;
+	};
+}
@@ -0,0 +1,99 @@
+#include "graphics/scene_object_table.hpp"
+
+namespace PXTEngine {
+
+	namespace {
+		// the fields only, the tail padding of the struct is not guaranteed to be copied
+		constexpr size_t SCENE_OBJECT_FIELDS_SIZE = offsetof(SceneObjectData, textureTilingFactor) + sizeof(float);
+	}
+
+	void SceneObjectTable::beginUpdate() {
+		m_updateCount++;
+	}
+
+	uint32_t SceneObjectTable::acquire(const entt::entity entity) {
+		auto [it, isNew] = m_entityToIndex.try_emplace(entity, INVALID_INDEX);
+
+		if (isNew) {
+			if (m_freeSlots.empty()) {
+				it->second = static_cast<uint32_t>(m_objects.size());
+				m_objects.emplace_back();
+				m_slotEntities.push_back(entt::null);
+				m_slotUpdates.push_back(0);
+				m_queuedSlots.push_back(0);
+			} else {
+				it->second = m_freeSlots.back();
+				m_freeSlots.pop_back();
+			}
+			m_slotEntities[it->second] = entity;
+
+			// a new slot is uploaded even if its data happens to match the previous owner
+			queueUpdate(it->second);
+		}
+
+		m_slotUpdates[it->second] = m_updateCount;
+		return it->second;
+	}
+
+	void SceneObjectTable::keep(const uint32_t index) {
+		PXT_ASSERT(index < m_objects.size() && m_slotEntities[index] != entt::null, "Scene object slot not acquired");
+
+		m_slotUpdates[index] = m_updateCount;
+	}
+
+	void SceneObjectTable::set(const uint32_t index, const SceneObjectData& data) {
+		PXT_ASSERT(index < m_objects.size() && m_slotEntities[index] != entt::null, "Scene object slot not acquired");
+
+		if (std::memcmp(&m_objects[index], &data, SCENE_OBJECT_FIELDS_SIZE) == 0) return;
+
+		m_objects[index] = data;
+		queueUpdate(index);
+	}
+
+	void SceneObjectTable::endUpdate() {
+		for (uint32_t index = 0; index < static_cast<uint32_t>(m_slotEntities.size()); index++) {
+			if (m_slotEntities[index] == entt::null || m_slotUpdates[index] == m_updateCount) continue;
+
+			// nothing references the slot anymore, its stale data can stay in the buffer
+			m_entityToIndex.erase(m_slotEntities[index]);
+			m_slotEntities[index] = entt::null;
+			m_freeSlots.push_back(index);
+		}
+	}
+
+	const SceneObjectData* SceneObjectTable::find(const entt::entity entity) const {
+		auto it = m_entityToIndex.find(entity);
+		return it != m_entityToIndex.end() ? &m_objects[it->second] : nullptr;
+	}
+
+	uint32_t SceneObjectTable::getIndex(const entt::entity entity) const {
+		auto it = m_entityToIndex.find(entity);
+		return it != m_entityToIndex.end() ? it->second : INVALID_INDEX;
+	}
+
+	void SceneObjectTable::invalidate() {
+		for (uint32_t index = 0; index < static_cast<uint32_t>(m_slotEntities.size()); index++) {
+			if (m_slotEntities[index] != entt::null) {
+				queueUpdate(index);
+			}
+		}
+	}
+
+	void SceneObjectTable::clearUpdates() {
+		for (const SceneObjectUpdate& update : m_updates) {
+			m_queuedSlots[update.index] = 0;
+		}
+		m_updates.clear();
+	}
+
+	void SceneObjectTable::queueUpdate(const uint32_t index) {
+		// a slot is uploaded once per update list, with its latest data
+		if (m_queuedSlots[index] != 0) {
+			m_updates[m_queuedSlots[index] - 1].data = m_objects[index];
+			return;
+		}
+
+		m_updates.push_back({ index, m_objects[index] });
+		m_queuedSlots[index] = static_cast<uint32_t>(m_updates.size());
+	}
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "core/pch.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @struct SceneObjectData
+	 *
+	 * @brief The GPU-side representation of a rendered entity, one entry of the scene buffer
+	 * shared by the raster pipelines and the ray tracing shaders (SceneObject in
+	 * common/scene_object.glsl). The layout follows the std430 rules.
+	 */
+	struct alignas(16) SceneObjectData {
+		glm::mat4 objectToWorldMatrix;		// offset 0, size 64
+		glm::mat4 worldToObjectMatrix;		// offset 64, size 64
+		glm::vec4 boundingSphere;			// offset 128, size 16 (world space center and radius)
+		glm::vec4 textureTintColor;			// offset 144, size 16
+		VkDeviceAddress vertexBufferAddress;	// offset 160, size 8
+		VkDeviceAddress indexBufferAddress;		// offset 168, size 8
+		uint32_t vertexCount;				// offset 176, size 4
+		uint32_t indexCount;				// offset 180, size 4
+		uint32_t materialIndex;				// offset 184, size 4
+		uint32_t emitterIndex;				// offset 188, size 4
+		uint32_t volumeIndex;				// offset 192, size 4
+		float textureTilingFactor;			// offset 196, size 4
+	};
+
+	static_assert(sizeof(SceneObjectData) == 208, "SceneObjectData must match the std430 layout of SceneObject");
+
+	/**
+	 * @struct SceneObjectUpdate
+	 *
+	 * @brief An entry of the update list scattered into the scene buffer by scene_scatter.comp.
+	 */
+	struct alignas(16) SceneObjectUpdate {
+		uint32_t index;
+		alignas(16) SceneObjectData data;
+	};
+
+	/**
+	 * @class SceneObjectTable
+	 *
+	 * @brief CPU mirror of the scene buffer: gives every rendered entity a stable slot and
+	 * collects the slots whose data changed since they were last uploaded.
+	 *
+	 * Every frame the scene is walked between beginUpdate() and endUpdate(), each rendered
+	 * entity acquires its slot and sets its data, only the entries that differ from the mirror
+	 * end up in the update list. The slots of the entities not set during the walk are released and reused
+	 * by the next entities added, so the table never grows past the largest object count seen.
+	 *
+	 * It does not touch the device, GpuScene uploads the update list.
+	 */
+	class SceneObjectTable {
+	public:
+		static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+		void beginUpdate();
+
+		/**
+		 * @brief Returns the slot of an entity, allocating it the first time, and keeps it
+		 * alive for the current update.
+		 */
+		uint32_t acquire(entt::entity entity);
+
+		/**
+		 * @brief Keeps a slot returned by acquire() alive for the current update, without
+		 * looking up its entity. For the callers caching the slot (see RenderPacketComponent).
+		 */
+		void keep(uint32_t index);
+
+		/**
+		 * @brief Stores the data of a slot, queuing it for upload if it changed.
+		 */
+		void set(uint32_t index, const SceneObjectData& data);
+
+		/**
+		 * @brief Releases the slots of the entities that were not acquired since beginUpdate().
+		 */
+		void endUpdate();
+
+		/**
+		 * @brief The data last set for an entity, nullptr if it has no slot. For a slot
+		 * acquired in the current update and not set yet, it is the data of its previous owner.
+		 */
+		const SceneObjectData* find(entt::entity entity) const;
+
+		/**
+		 * @brief The slot of an entity, INVALID_INDEX if it has none.
+		 */
+		uint32_t getIndex(entt::entity entity) const;
+
+		/**
+		 * @brief Queues every used slot again, e.g. after the scene buffer was reallocated.
+		 */
+		void invalidate();
+
+		std::span<const SceneObjectUpdate> getUpdates() const { return m_updates; }
+		void clearUpdates();
+
+		// slots ever allocated, the size the scene buffer must have
+		uint32_t getSlotCount() const { return static_cast<uint32_t>(m_objects.size()); }
+		uint32_t getObjectCount() const { return static_cast<uint32_t>(m_entityToIndex.size()); }
+
+	private:
+		void queueUpdate(uint32_t index);
+
+		std::vector<SceneObjectData> m_objects;
+		std::vector<entt::entity> m_slotEntities; // entt::null for free slots
+		std::vector<uint32_t> m_slotUpdates; // last update that set the slot
+		std::vector<uint32_t> m_queuedSlots; // position in m_updates + 1, 0 when not queued
+		std::vector<uint32_t> m_freeSlots;
+		std::unordered_map<entt::entity, uint32_t> m_entityToIndex;
+
+		std::vector<SceneObjectUpdate> m_updates;
+		uint32_t m_updateCount = 0;
+	};
+}
@@ -0,0 +1,281 @@
+#include "graphics/shader_reloader.hpp"
+
+namespace PXTEngine {
+
+	ShaderReloader::ShaderReloader(Context& context, AsyncComputeQueue* asyncComputeQueue)
+		: m_context(context), m_asyncComputeQueue(asyncComputeQueue) {
+
+		// a change to a shared include rebuilds most pipelines, the compilations are independent
+		const uint32_t workerCount = std::clamp(std::thread::hardware_concurrency() / 4, 1u, 4u);
+		for (uint32_t i = 0; i < workerCount; i++) {
+			m_workers.emplace_back(&ShaderReloader::workerLoop, this);
+		}
+	}
+
+	ShaderReloader::~ShaderReloader() {
+		// the builds not started are dropped, the running ones are waited for
+		{
+			std::lock_guard lock(m_mutex);
+			m_isStopping = true;
+		}
+		m_jobsCondition.notify_all();
+
+		for (std::thread& worker : m_workers) {
+			worker.join();
+		}
+
+		// the pipelines built and never swapped in were not used by the GPU
+		m_results.clear();
+
+		m_context.getFrameTimeline().waitIdle();
+		if (m_asyncComputeQueue) m_asyncComputeQueue->getTimeline().waitIdle();
+		m_retiredObjects.clear();
+	}
+
+	void ShaderReloader::add(const std::string& name, const std::vector<std::filesystem::path>& sourceFiles, PrepareFunction prepare) {
+		Entry& entry = m_entries.emplace_back();
+		entry.name = name;
+		entry.sourceFiles = sourceFiles;
+		entry.prepare = std::move(prepare);
+
+		watchFiles(entry, findWatchedFiles(sourceFiles));
+	}
+
+	void ShaderReloader::addPipeline(const std::string& name, const std::vector<std::filesystem::path>& sourceFiles,
+		std::function<Unique<Pipeline>()> build, Unique<Pipeline>& pipeline) {
+
+		add(name, sourceFiles, [build = std::move(build), &pipeline]() {
+			return Reload{
+				[build]() {
+					std::vector<Unique<Pipeline>> pipelines;
+					pipelines.push_back(build());
+					return pipelines;
+				},
+				[&pipeline](std::vector<Unique<Pipeline>>& pipelines) {
+					std::swap(pipeline, pipelines[0]);
+				}
+			};
+		});
+	}
+
+	void ShaderReloader::retireObject(Shared<void> object) {
+		// the frame being recorded doesn't use it yet, only the ones already submitted may
+		const uint64_t computeValue = m_asyncComputeQueue ? m_asyncComputeQueue->getTimeline().getSubmittedValue() : 0;
+		m_retiredObjects.push_back({ m_context.getFrameTimeline().getSubmittedValue(), computeValue, std::move(object) });
+	}
+
+	void ShaderReloader::destroyRetiredObjects() {
+		// retired in submission order, the first one still in use is followed by ones in use too
+		while (!m_retiredObjects.empty()) {
+			const RetiredObject& retired = m_retiredObjects.front();
+
+			if (!m_context.getFrameTimeline().isComplete(retired.frameValue)) break;
+			if (m_asyncComputeQueue && !m_asyncComputeQueue->getTimeline().isComplete(retired.computeValue)) break;
+
+			m_retiredObjects.pop_front();
+		}
+	}
+
+	void ShaderReloader::update() {
+		applyResults();
+		destroyRetiredObjects();
+
+		const auto now = std::chrono::steady_clock::now();
+		if (m_isWatching && now - m_lastPollTime >= POLL_INTERVAL) {
+			m_lastPollTime = now;
+			pollFiles();
+		}
+
+		schedule();
+	}
+
+	void ShaderReloader::reloadAll() {
+		for (Entry& entry : m_entries) {
+			entry.isDirty = true;
+		}
+	}
+
+	void ShaderReloader::applyResults() {
+		std::vector<Result> results;
+		{
+			std::lock_guard lock(m_mutex);
+			results.swap(m_results);
+		}
+
+		for (Result& result : results) {
+			Entry& entry = m_entries[result.entry];
+			entry.isBuilding = false;
+
+			// the includes are watched even when the build fails, fixing one of them triggers the next build
+			watchFiles(entry, result.watchedFiles);
+
+			if (!result.error.empty()) {
+				PXT_ERROR("Failed to reload the {} shaders, the previous pipelines are kept:\n{}", entry.name, result.error);
+				entry.error = std::move(result.error);
+				continue;
+			}
+
+			result.apply(result.pipelines);
+			for (Unique<Pipeline>& pipeline : result.pipelines) {
+				retire(std::move(pipeline));
+			}
+
+			entry.error.clear();
+			PXT_INFO("Reloaded the {} shaders in {:.1f} ms", entry.name, result.buildTimeMs);
+		}
+	}
+
+	void ShaderReloader::pollFiles() {
+		std::unordered_set<std::string> changedFiles;
+
+		for (auto& [file, lastWriteTime] : m_fileWriteTimes) {
+			// an editor may be replacing the file, it is checked again next time
+			std::error_code error;
+			const auto writeTime = std::filesystem::last_write_time(file, error);
+			if (error || writeTime == lastWriteTime) continue;
+
+			lastWriteTime = writeTime;
+			changedFiles.insert(file);
+		}
+
+		if (changedFiles.empty()) return;
+
+		for (Entry& entry : m_entries) {
+			for (const std::filesystem::path& file : entry.watchedFiles) {
+				if (changedFiles.contains(file.string())) {
+					entry.isDirty = true;
+					break;
+				}
+			}
+		}
+	}
+
+	void ShaderReloader::schedule() {
+		bool hasJobs = false;
+
+		for (uint32_t i = 0; i < m_entries.size(); i++) {
+			Entry& entry = m_entries[i];
+
+			// changed again while building: rebuilt once the current build is applied
+			if (!entry.isDirty || entry.isBuilding) continue;
+
+			Reload reload = entry.prepare();
+
+			std::lock_guard lock(m_mutex);
+			m_jobs.push_back({ i, entry.sourceFiles, std::move(reload.build), std::move(reload.apply) });
+
+			entry.isDirty = false;
+			entry.isBuilding = true;
+			hasJobs = true;
+		}
+
+		if (hasJobs) m_jobsCondition.notify_all();
+	}
+
+	void ShaderReloader::watchFiles(Entry& entry, const std::vector<WatchedFile>& files) {
+		entry.watchedFiles.clear();
+
+		for (const WatchedFile& file : files) {
+			entry.watchedFiles.push_back(file.path);
+
+			// a file seen for the first time keeps the write time of the version that was compiled,
+			// so that a change made during the build is still noticed
+			m_fileWriteTimes.try_emplace(file.path.string(), file.lastWriteTime);
+		}
+	}
+
+	void ShaderReloader::workerLoop() {
+		while (true) {
+			Job job;
+			{
+				std::unique_lock lock(m_mutex);
+				m_jobsCondition.wait(lock, [this] { return m_isStopping || !m_jobs.empty(); });
+
+				if (m_isStopping) return;
+
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+
+			Result result{ job.entry, std::move(job.apply) };
+
+			// before the build, so that the write times are the ones of the files compiled (or older)
+			result.watchedFiles = findWatchedFiles(job.sourceFiles);
+
+			const auto startTime = std::chrono::steady_clock::now();
+			try {
+				result.pipelines = job.build();
+			} catch (const std::exception& e) {
+				result.pipelines.clear();
+				result.error = e.what();
+			}
+			const std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+			result.buildTimeMs = elapsed.count();
+
+			std::lock_guard lock(m_mutex);
+			m_results.push_back(std::move(result));
+		}
+	}
+
+	std::vector<ShaderReloader::WatchedFile> ShaderReloader::findWatchedFiles(const std::vector<std::filesystem::path>& sourceFiles) {
+		std::vector<WatchedFile> files;
+		std::unordered_set<std::string> visitedFiles;
+		std::vector<std::filesystem::path> pendingFiles(sourceFiles.begin(), sourceFiles.end());
+
+		while (!pendingFiles.empty()) {
+			const std::filesystem::path file = pendingFiles.back().lexically_normal();
+			pendingFiles.pop_back();
+
+			if (!visitedFiles.insert(file.string()).second) continue;
+
+			std::error_code error;
+			const auto writeTime = std::filesystem::last_write_time(file, error);
+			if (error) continue;
+
+			files.push_back({ file, writeTime });
+
+			std::ifstream stream(file);
+			std::string line;
+			while (std::getline(stream, line)) {
+				// the includes are resolved relative to the including file, like the shader compiler does
+				const size_t directive = line.find_first_not_of(" \t");
+				if (directive == std::string::npos || line.compare(directive, 8, "#include") != 0) continue;
+
+				const size_t begin = line.find_first_of("\"<", directive + 8);
+				if (begin == std::string::npos) continue;
+
+				const size_t end = line.find_first_of("\">", begin + 1);
+				if (end == std::string::npos) continue;
+
+				pendingFiles.push_back(file.parent_path() / line.substr(begin + 1, end - begin - 1));
+			}
+		}
+
+		return files;
+	}
+
+	void ShaderReloader::updateUi() {
+		uint32_t buildingCount = 0;
+		for (const Entry& entry : m_entries) {
+			if (entry.isBuilding) buildingCount++;
+		}
+
+		if (ImGui::Button("Reload Shaders", ImVec2(150, 0))) {
+			reloadAll();
+		}
+		ImGui::SameLine();
+		ImGui::Checkbox("Watch shader files", &m_isWatching);
+
+		ImGui::Text("Shader files watched: %u", static_cast<uint32_t>(m_fileWriteTimes.size()));
+		if (buildingCount > 0) {
+			ImGui::Text("Rebuilding %u pipeline groups...", buildingCount);
+		}
+
+		for (const Entry& entry : m_entries) {
+			if (entry.error.empty()) continue;
+
+			ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s shaders failed to compile, the previous version is used:", entry.name.c_str());
+			ImGui::TextWrapped("%s", entry.error.c_str());
+		}
+	}
+}
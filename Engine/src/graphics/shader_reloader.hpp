@@ -0,0 +1,169 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "graphics/context/context.hpp"
+#include "graphics/pipeline.hpp"
+#include "graphics/async_compute_queue.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace PXTEngine {
+
+	/**
+	 * @class ShaderReloader
+	 *
+	 * @brief Rebuilds the pipelines whose shader sources change, without stalling the renderer.
+	 *
+	 * The render systems register their pipelines with the shader sources they are compiled
+	 * from. The sources and the files they #include are polled for changes, and only the
+	 * pipelines depending on a changed file are rebuilt, from source, by a few worker threads.
+	 * The new pipelines are swapped in by update(), at the start of a frame before anything is
+	 * recorded, and the replaced ones are destroyed once the frames (and the async compute
+	 * work) using them are complete. When a shader fails to compile the previous pipeline
+	 * stays in use and the compiler's error is shown in the ui until a build succeeds.
+	 *
+	 * The build functions run on the workers, they must only read what doesn't change after
+	 * the render system is created (pipeline layouts, render passes, shader paths...).
+	 */
+	class ShaderReloader {
+	public:
+		// called on a worker, may throw: the pipelines are then left as they are
+		using BuildFunction = std::function<std::vector<Unique<Pipeline>>()>;
+
+		// called at the frame boundary with the built pipelines, the ones left in the vector
+		// (the replaced ones) are retired
+		using ApplyFunction = std::function<void(std::vector<Unique<Pipeline>>& pipelines)>;
+
+		struct Reload {
+			BuildFunction build;
+			ApplyFunction apply;
+		};
+
+		// called on the main thread when the rebuild is scheduled, to snapshot what the build needs
+		using PrepareFunction = std::function<Reload()>;
+
+		// how often the shader files are checked for changes
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{ 500 };
+
+		ShaderReloader(Context& context, AsyncComputeQueue* asyncComputeQueue);
+		~ShaderReloader();
+
+		ShaderReloader(const ShaderReloader&) = delete;
+		ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+		/**
+		 * @brief Registers a group of pipelines rebuilt together.
+		 *
+		 * @param name Shown in the logs and the ui.
+		 * @param sourceFiles The shader sources the pipelines are compiled from, their includes are found by the reloader.
+		 */
+		void add(const std::string& name, const std::vector<std::filesystem::path>& sourceFiles, PrepareFunction prepare);
+
+		/**
+		 * @brief Registers a single pipeline, replaced in place once rebuilt.
+		 */
+		void addPipeline(const std::string& name, const std::vector<std::filesystem::path>& sourceFiles,
+			std::function<Unique<Pipeline>()> build, Unique<Pipeline>& pipeline);
+
+		/**
+		 * @brief Destroys an object once the GPU work submitted so far is complete.
+		 */
+		template<typename T>
+		void retire(Unique<T> object) {
+			if (object) retireObject(Shared<void>(std::move(object)));
+		}
+
+		/**
+		 * @brief Swaps in the pipelines built since the last call, destroys the retired objects
+		 * the GPU is done with and schedules the rebuilds of the changed shaders.
+		 * To be called at the start of the frame, before any command is recorded.
+		 */
+		void update();
+
+		/**
+		 * @brief Rebuilds every registered pipeline, whether its sources changed or not.
+		 */
+		void reloadAll();
+
+		void updateUi();
+
+	private:
+		struct WatchedFile {
+			std::filesystem::path path;
+			std::filesystem::file_time_type lastWriteTime;
+		};
+
+		struct Entry {
+			std::string name;
+			std::vector<std::filesystem::path> sourceFiles;
+			PrepareFunction prepare;
+
+			// the sources and the files they include, as of the last build
+			std::vector<std::filesystem::path> watchedFiles;
+
+			bool isBuilding = false;
+			bool isDirty = false; // to rebuild, once the current build (if any) is done
+			std::string error; // of the last build, empty when it succeeded
+		};
+
+		struct Job {
+			uint32_t entry;
+			std::vector<std::filesystem::path> sourceFiles;
+			BuildFunction build;
+			ApplyFunction apply;
+		};
+
+		struct Result {
+			uint32_t entry;
+			ApplyFunction apply;
+			std::vector<Unique<Pipeline>> pipelines;
+			std::vector<WatchedFile> watchedFiles;
+			std::string error;
+			float buildTimeMs = 0.0f;
+		};
+
+		struct RetiredObject {
+			uint64_t frameValue;
+			uint64_t computeValue;
+			Shared<void> object;
+		};
+
+		void retireObject(Shared<void> object);
+		void destroyRetiredObjects();
+
+		void applyResults();
+		void pollFiles();
+		void schedule();
+
+		void watchFiles(Entry& entry, const std::vector<WatchedFile>& files);
+
+		void workerLoop();
+
+		/**
+		 * @brief The sources and, recursively, the files they include, with their write times
+		 * taken before they are read.
+		 */
+		static std::vector<WatchedFile> findWatchedFiles(const std::vector<std::filesystem::path>& sourceFiles);
+
+		Context& m_context;
+		AsyncComputeQueue* m_asyncComputeQueue;
+
+		// main thread only
+		std::vector<Entry> m_entries;
+		std::unordered_map<std::string, std::filesystem::file_time_type> m_fileWriteTimes;
+		std::chrono::steady_clock::time_point m_lastPollTime{};
+		bool m_isWatching = true;
+		std::deque<RetiredObject> m_retiredObjects;
+
+		// workers
+		std::vector<std::thread> m_workers;
+		std::mutex m_mutex;
+		std::condition_variable m_jobsCondition;
+		std::deque<Job> m_jobs;
+		std::vector<Result> m_results;
+		bool m_isStopping = false;
+	};
+}
@@ -0,0 +1,107 @@
+#include "graphics/shadow_atlas.hpp"
+
+#include <bit>
+
+namespace PXTEngine {
+
+	ShadowAtlas::ShadowAtlas(const uint32_t size, const uint32_t minTileSize) : m_size(size) {
+		PXT_ASSERT(std::has_single_bit(size) && std::has_single_bit(minTileSize) && minTileSize <= size,
+			"The shadow atlas and tile sizes must be powers of two");
+
+		m_levelCount = static_cast<uint32_t>(std::countr_zero(size / minTileSize)) + 1;
+		m_nodes.resize(getFirstNode(m_levelCount), NodeState::Free);
+	}
+
+	ShadowAtlas::Tile ShadowAtlas::allocate(const uint32_t tileSize) {
+		PXT_ASSERT(std::has_single_bit(tileSize) && tileSize >= getMinTileSize() && tileSize <= m_size,
+			"Invalid shadow atlas tile size");
+
+		const uint32_t level = static_cast<uint32_t>(std::countr_zero(m_size / tileSize));
+
+		const uint32_t node = findFreeNode(0, 0, level);
+		if (node == INVALID_NODE) return {};
+
+		m_nodes[node] = NodeState::Used;
+
+		// the free ancestors are split on the way down (their other children stay free)
+		for (uint32_t parent = node; parent != 0;) {
+			parent = (parent - 1) / 4;
+			m_nodes[parent] = NodeState::Split;
+		}
+
+		m_usedTexelCount += static_cast<uint64_t>(tileSize) * tileSize;
+		return getTile(node, level);
+	}
+
+	void ShadowAtlas::free(const Tile& tile) {
+		if (!tile.isValid()) return;
+
+		PXT_ASSERT(m_nodes[tile.node] == NodeState::Used, "Shadow atlas tile freed twice");
+		m_nodes[tile.node] = NodeState::Free;
+		m_usedTexelCount -= static_cast<uint64_t>(tile.size) * tile.size;
+
+		// merge back the parents whose children are all free
+		for (uint32_t node = tile.node; node != 0;) {
+			const uint32_t parent = (node - 1) / 4;
+			const uint32_t firstChild = 4 * parent + 1;
+
+			for (uint32_t child = firstChild; child < firstChild + 4; child++) {
+				if (m_nodes[child] != NodeState::Free) return;
+			}
+
+			m_nodes[parent] = NodeState::Free;
+			node = parent;
+		}
+	}
+
+	void ShadowAtlas::clear() {
+		std::fill(m_nodes.begin(), m_nodes.end(), NodeState::Free);
+		m_usedTexelCount = 0;
+	}
+
+	uint32_t ShadowAtlas::findFreeNode(const uint32_t node, const uint32_t level, const uint32_t targetLevel) const {
+		const NodeState state = m_nodes[node];
+
+		if (level == targetLevel) return state == NodeState::Free ? node : INVALID_NODE;
+		if (state == NodeState::Used) return INVALID_NODE;
+
+		// a free node is entirely free, its first descendant of the target level is the tile
+		if (state == NodeState::Free) {
+			uint32_t descendant = node;
+			for (uint32_t i = level; i < targetLevel; i++) {
+				descendant = 4 * descendant + 1;
+			}
+			return descendant;
+		}
+
+		// split node: fill the partially used children before breaking a free one
+		const uint32_t firstChild = 4 * node + 1;
+		for (uint32_t child = firstChild; child < firstChild + 4; child++) {
+			if (m_nodes[child] != NodeState::Split) continue;
+
+			const uint32_t found = findFreeNode(child, level + 1, targetLevel);
+			if (found != INVALID_NODE) return found;
+		}
+
+		for (uint32_t child = firstChild; child < firstChild + 4; child++) {
+			if (m_nodes[child] == NodeState::Free) return findFreeNode(child, level + 1, targetLevel);
+		}
+
+		return INVALID_NODE;
+	}
+
+	ShadowAtlas::Tile ShadowAtlas::getTile(const uint32_t node, const uint32_t level) const {
+		// the nodes of a level are in morton order: the even bits of the index are x, the odd ones y
+		const uint32_t index = node - getFirstNode(level);
+
+		uint32_t x = 0;
+		uint32_t y = 0;
+		for (uint32_t bit = 0; bit < level; bit++) {
+			x |= ((index >> (2 * bit)) & 1u) << bit;
+			y |= ((index >> (2 * bit + 1)) & 1u) << bit;
+		}
+
+		const uint32_t tileSize = m_size >> level;
+		return Tile{ node, x * tileSize, y * tileSize, tileSize };
+	}
+}
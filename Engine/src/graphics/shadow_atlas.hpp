@@ -0,0 +1,71 @@
+#pragma once
+
+#include "core/pch.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @class ShadowAtlas
+	 *
+	 * @brief Hands out square tiles of a shadow map atlas, sized in powers of two.
+	 *
+	 * The atlas is a quadtree: a node is either free, used by a tile or split in four
+	 * children. A tile is taken from the first free node of its size, searching the nodes
+	 * already split first so that the large free nodes are kept whole as long as possible.
+	 * Freeing a tile merges its node back with its siblings when they are all free.
+	 *
+	 * Only the allocation is done here, the atlas image is owned by the shadow map render system.
+	 */
+	class ShadowAtlas {
+	public:
+		static constexpr uint32_t INVALID_NODE = std::numeric_limits<uint32_t>::max();
+
+		struct Tile {
+			uint32_t node = INVALID_NODE;
+			uint32_t x = 0;    // texels from the left of the atlas
+			uint32_t y = 0;    // texels from the top of the atlas
+			uint32_t size = 0; // texels per side
+
+			bool isValid() const { return node != INVALID_NODE; }
+		};
+
+		/**
+		 * @param size Texels per side of the atlas, a power of two.
+		 * @param minTileSize The smallest tile handed out, a power of two.
+		 */
+		ShadowAtlas(uint32_t size, uint32_t minTileSize);
+
+		/**
+		 * @brief Takes a tile of the given size (a power of two between the minimum tile size and the atlas size).
+		 *
+		 * @return The tile, or an invalid one if there is no free space left for it.
+		 */
+		Tile allocate(uint32_t tileSize);
+
+		void free(const Tile& tile);
+
+		void clear();
+
+		uint32_t getSize() const { return m_size; }
+		uint32_t getMinTileSize() const { return m_size >> (m_levelCount - 1); }
+		uint64_t getUsedTexelCount() const { return m_usedTexelCount; }
+
+	private:
+		enum class NodeState : uint8_t {
+			Free,
+			Split,
+			Used
+		};
+
+		// the nodes are stored level after level, the children of node n are 4n + 1 to 4n + 4
+		static uint32_t getFirstNode(uint32_t level) { return ((1u << (2 * level)) - 1) / 3; }
+
+		uint32_t findFreeNode(uint32_t node, uint32_t level, uint32_t targetLevel) const;
+		Tile getTile(uint32_t node, uint32_t level) const;
+
+		uint32_t m_size;
+		uint32_t m_levelCount;
+		std::vector<NodeState> m_nodes;
+		uint64_t m_usedTexelCount = 0;
+	};
+}
@@ -54,23 +54,16 @@ namespace PXTEngine {
         // cleanup synchronization objects
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
             vkDestroySemaphore(m_context.getDevice(), m_imageAvailableSemaphores[i], nullptr);
-            vkDestroyFence(m_context.getDevice(), m_inFlightFences[i], nullptr);
         }
         for (size_t i = 0; i < imageCount(); i++) {
             vkDestroySemaphore(m_context.getDevice(), m_renderFinishedSemaphores[i], nullptr);
         }
     }
 
-    VkFence SwapChain::getInFlightFence(uint32_t frameIndex) const {
+    uint64_t SwapChain::getFrameTimelineValue(uint32_t frameIndex) const {
         // Assert to ensure the index is valid for MAX_FRAMES_IN_FLIGHT
-        PXT_ASSERT(frameIndex < MAX_FRAMES_IN_FLIGHT, "Fence index out of bounds");
-        return m_inFlightFences[frameIndex];
-    }
-
-    VkFence SwapChain::getCurrentFrameFence() const {
-        // This returns the fence for the frame currently being processed (m_currentFrame).
-        // This is the fence that submitCommandBuffers will signal when the GPU work is done.
-        return m_inFlightFences[m_currentFrame];
+        PXT_ASSERT(frameIndex < MAX_FRAMES_IN_FLIGHT, "Frame index out of bounds");
+        return m_frameTimelineValues[frameIndex];
     }
 
     VkSemaphore SwapChain::getImageAvailableSemaphore() const {
@@ -85,8 +78,8 @@ namespace PXTEngine {
     }
 
     VkResult SwapChain::acquireNextImage(uint32_t *imageIndex) {
-        vkWaitForFences(m_context.getDevice(), 1, &m_inFlightFences[m_currentFrame], VK_TRUE,
-                        std::numeric_limits<uint64_t>::max());
+        // the resources of this frame index are free once its last submission is complete
+        m_context.getFrameTimeline().wait(m_frameTimelineValues[m_currentFrame]);
 
         VkResult result = vkAcquireNextImageKHR(
             m_context.getDevice(), m_swapChain, std::numeric_limits<uint64_t>::max(),
@@ -97,29 +90,50 @@ namespace PXTEngine {
         return result;
     }
 
-    VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer *buffers, uint32_t *imageIndex) {
-        vkWaitForFences(m_context.getDevice(), 1, &m_inFlightFences[m_currentFrame], VK_TRUE, UINT64_MAX);
+    VkResult SwapChain::submitCommandBuffers(const VkCommandBuffer *buffers, uint32_t *imageIndex,
+                                             const std::vector<SemaphoreWait>& waits) {
+        TimelineSemaphore& frameTimeline = m_context.getFrameTimeline();
 
         VkSubmitInfo submitInfo = {};
         submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-        VkSemaphore waitSemaphores[] = {m_imageAvailableSemaphores[m_currentFrame]};
-        VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = waitSemaphores;
-        submitInfo.pWaitDstStageMask = waitStages;
+        // the values of the binary semaphores are ignored
+        std::vector<VkSemaphore> waitSemaphores = {m_imageAvailableSemaphores[m_currentFrame]};
+        std::vector<VkPipelineStageFlags> waitStages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+        std::vector<uint64_t> waitValues = {0};
+        for (const SemaphoreWait& wait : waits) {
+            waitSemaphores.push_back(wait.semaphore);
+            waitStages.push_back(wait.stage);
+            waitValues.push_back(wait.value);
+        }
+
+        submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+        submitInfo.pWaitSemaphores = waitSemaphores.data();
+        submitInfo.pWaitDstStageMask = waitStages.data();
 
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers = buffers;
 
-        VkSemaphore signalSemaphores[] = {m_renderFinishedSemaphores[*imageIndex]};
-        submitInfo.signalSemaphoreCount = 1;
+        // the frame signals the next value of the frame timeline, together with the semaphore
+        // the presentation waits on
+        const uint64_t frameValue = frameTimeline.advance();
+
+        VkSemaphore signalSemaphores[] = {m_renderFinishedSemaphores[*imageIndex], frameTimeline.getSemaphore()};
+        uint64_t signalValues[] = {0, frameValue};
+        submitInfo.signalSemaphoreCount = 2;
         submitInfo.pSignalSemaphores = signalSemaphores;
 
-        vkResetFences(m_context.getDevice(), 1, &m_inFlightFences[m_currentFrame]);
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+        timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        timelineInfo.signalSemaphoreValueCount = 2;
+        timelineInfo.pSignalSemaphoreValues = signalValues;
+        submitInfo.pNext = &timelineInfo;
+
+        m_frameTimelineValues[m_currentFrame] = frameValue;
 
-        VkResult vkResult = vkQueueSubmit(m_context.getGraphicsQueue(), 1, &submitInfo,
-            m_inFlightFences[m_currentFrame]);
+        VkResult vkResult = vkQueueSubmit(m_context.getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
 
         if (vkResult != VK_SUCCESS) {
 			PXT_ERROR("Failed to submit draw command buffer: {}", STR_VK_RESULT(vkResult));
@@ -129,6 +143,7 @@ namespace PXTEngine {
         VkPresentInfoKHR presentInfo = {};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
+        // binary semaphores only, the frame timeline is not waited on by the presentation
         presentInfo.waitSemaphoreCount = 1;
         presentInfo.pWaitSemaphores = signalSemaphores;
 
@@ -361,21 +376,15 @@ namespace PXTEngine {
     void SwapChain::createSyncObjects() {
         m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
         m_renderFinishedSemaphores.resize(imageCount());
-        m_inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
 
         VkSemaphoreCreateInfo semaphoreInfo = {};
         semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-        VkFenceCreateInfo fenceInfo = {};
-        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
+        // the frames in flight are tracked with the frame timeline of the context, no fences needed
         for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
             if (vkCreateSemaphore(m_context.getDevice(), &semaphoreInfo, nullptr,
-                                  &m_imageAvailableSemaphores[i]) != VK_SUCCESS ||
-                vkCreateFence(m_context.getDevice(), &fenceInfo, nullptr, &m_inFlightFences[i]) !=
-                    VK_SUCCESS) {
-                throw std::runtime_error("failed to create m_imageAvailableSemaphores or m_inFlightFences objects for a frame!");
+                                  &m_imageAvailableSemaphores[i]) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create m_imageAvailableSemaphores objects for a frame!");
             }
         }
 
@@ -5,6 +5,15 @@
 
 namespace PXTEngine {
 
+    /**
+     * @brief A semaphore the submission of a frame waits on, besides the swap chain image.
+     */
+    struct SemaphoreWait {
+        VkSemaphore semaphore;
+        VkPipelineStageFlags stage;
+        uint64_t value = 0; // for timeline semaphores, ignored for binary ones
+    };
+
     /**
      * @class SwapChain
      * 
@@ -32,8 +41,11 @@ namespace PXTEngine {
         SwapChain(Context& context, VkExtent2D windowExtent, Shared<SwapChain> previous);
         ~SwapChain();
 
-        VkFence getInFlightFence(uint32_t frameIndex) const;
-        VkFence getCurrentFrameFence() const;
+        /**
+         * @brief The frame timeline value the last submission of a frame index signals,
+         * the frame index can be reused once the frame timeline reaches it.
+         */
+        uint64_t getFrameTimelineValue(uint32_t frameIndex) const;
         VkSemaphore getImageAvailableSemaphore() const;
         VkSemaphore getRenderFinishedSemaphore(uint32_t imageIndex) const;
 
@@ -117,8 +129,8 @@ namespace PXTEngine {
         /**
          * @brief Acquires the next available swap chain image.
          *
-         * This function waits for the current frame's fence to ensure the GPU has finished
-         * processing previous work. Then, it gets the next available image in the swap chain.
+         * This function waits for the frame timeline to reach the value of the last submission
+         * of the current frame, to ensure the GPU has finished processing previous work. Then, it gets the next available image in the swap chain.
          *
          * @param imageIndex Pointer to store the acquired image index.
          * @return Vulkan result indicating success or failure.
@@ -134,10 +146,12 @@ namespace PXTEngine {
          * 
          * @param buffers Pointer to the command buffers.
          * @param imageIndex Pointer to the index of the image to render to.
+         * @param waits Semaphores waited on besides the image available one (e.g. the async compute timeline).
          * 
          * @return Vulkan result indicating success or failure.
          */
-        VkResult submitCommandBuffers(const VkCommandBuffer *buffers, uint32_t *imageIndex);
+        VkResult submitCommandBuffers(const VkCommandBuffer *buffers, uint32_t *imageIndex,
+                                      const std::vector<SemaphoreWait>& waits = {});
         
         /**
          * @brief This function compares the image and depth formats of the swap chain with another swap chain.
@@ -216,8 +230,8 @@ namespace PXTEngine {
         /**
          * @brief Creates synchronization objects.
          * 
-         * This includes semaphores and fences to ensure proper synchronization
-         * between CPU and GPU, preventing race conditions while rendering frames.
+         * These are the binary semaphores of the image acquisition and presentation, the
+         * synchronization between CPU and GPU uses the frame timeline of the context.
          * 
          * @throws std::runtime_error If synchronization object creation fails.
          */
@@ -282,7 +296,10 @@ namespace PXTEngine {
 
         std::vector<VkSemaphore> m_imageAvailableSemaphores;
         std::vector<VkSemaphore> m_renderFinishedSemaphores;
-        std::vector<VkFence> m_inFlightFences;
+
+        // the frame timeline value signaled by the last submission of each frame index,
+        // waited on before reusing its resources
+        std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_frameTimelineValues{};
     };
 
 }
\ No newline at end of file
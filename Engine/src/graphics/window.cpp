@@ -9,6 +9,8 @@
 namespace PXTEngine {
 
     Window::Window(const WindowData& props): m_data(props) {
+        PXT_STARTUP_PHASE("Create window");
+
         glfwInit();
 
         glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
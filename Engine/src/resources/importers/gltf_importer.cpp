@@ -0,0 +1,632 @@
+#include "resources/importers/gltf_importer.hpp"
+
+#include "resources/importers/mesh_importer.hpp"
+#include "resources/types/skeleton.hpp"
+#include "resources/types/animation_clip.hpp"
+#include "graphics/resources/vk_mesh.hpp"
+
+// JSON is a subset of YAML, the parser already used by the scene serializer reads it just fine
+#include "yaml-cpp/yaml.h"
+
+#include <glm/gtx/matrix_decompose.hpp>
+
+#include <numeric>
+
+namespace PXTEngine {
+
+	namespace {
+		constexpr uint32_t GLB_MAGIC = 0x46546C67;		 // "glTF"
+		constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;	 // "JSON"
+		constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;	 // "BIN\0"
+
+		constexpr uint32_t COMPONENT_BYTE = 5120;
+		constexpr uint32_t COMPONENT_UNSIGNED_BYTE = 5121;
+		constexpr uint32_t COMPONENT_SHORT = 5122;
+		constexpr uint32_t COMPONENT_UNSIGNED_SHORT = 5123;
+		constexpr uint32_t COMPONENT_UNSIGNED_INT = 5125;
+		constexpr uint32_t COMPONENT_FLOAT = 5126;
+
+		constexpr uint32_t PRIMITIVE_MODE_TRIANGLES = 4;
+
+		struct GltfFile {
+			YAML::Node json;
+			std::vector<std::vector<uint8_t>> buffers;
+		};
+
+		/**
+		 * @brief Strided view over the elements of an accessor.
+		 */
+		struct AccessorView {
+			const uint8_t* data = nullptr; // nullptr if the accessor has no buffer view (all zeros)
+			size_t count = 0;
+			uint32_t componentCount = 0;
+			uint32_t componentType = COMPONENT_FLOAT;
+			size_t stride = 0;
+			bool normalized = false;
+		};
+
+		std::vector<uint8_t> readBinaryFile(const std::filesystem::path& filePath) {
+			std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+			if (!file.is_open()) {
+				throw std::runtime_error("Failed to open file: " + filePath.string());
+			}
+
+			const size_t size = static_cast<size_t>(file.tellg());
+			std::vector<uint8_t> data(size);
+
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size));
+			StartupProfiler::recordRead(size);
+
+			return data;
+		}
+
+		uint32_t readU32(const std::vector<uint8_t>& data, const size_t offset) {
+			if (offset + sizeof(uint32_t) > data.size()) {
+				throw std::runtime_error("Unexpected end of GLB file");
+			}
+
+			uint32_t value;
+			std::memcpy(&value, data.data() + offset, sizeof(uint32_t));
+			return value;
+		}
+
+		GltfFile loadGltf(const std::filesystem::path& filePath) {
+			GltfFile gltf;
+			std::vector<uint8_t> binaryChunk;
+
+			std::vector<uint8_t> fileData = readBinaryFile(filePath);
+
+			if (filePath.extension() == ".glb") {
+				if (readU32(fileData, 0) != GLB_MAGIC) {
+					throw std::runtime_error("Invalid GLB file: " + filePath.string());
+				}
+
+				// 12 bytes header, then chunks made of length, type and data
+				size_t offset = 12;
+				while (offset + 8 <= fileData.size()) {
+					const uint32_t chunkLength = readU32(fileData, offset);
+					const uint32_t chunkType = readU32(fileData, offset + 4);
+					offset += 8;
+
+					if (offset + chunkLength > fileData.size()) {
+						throw std::runtime_error("Unexpected end of GLB file: " + filePath.string());
+					}
+
+					const auto chunkBegin = fileData.begin() + static_cast<std::ptrdiff_t>(offset);
+					if (chunkType == GLB_CHUNK_JSON) {
+						gltf.json = YAML::Load(std::string(chunkBegin, chunkBegin + chunkLength));
+					} else if (chunkType == GLB_CHUNK_BIN && binaryChunk.empty()) {
+						binaryChunk.assign(chunkBegin, chunkBegin + chunkLength);
+					}
+
+					offset += chunkLength;
+				}
+			} else {
+				gltf.json = YAML::Load(std::string(fileData.begin(), fileData.end()));
+			}
+
+			if (!gltf.json || !gltf.json.IsMap()) {
+				throw std::runtime_error("Invalid glTF file: " + filePath.string());
+			}
+
+			for (const auto& buffer : gltf.json["buffers"]) {
+				if (!buffer["uri"]) {
+					// only the first buffer of a GLB can be stored in the binary chunk
+					if (!gltf.buffers.empty() || binaryChunk.empty()) {
+						throw std::runtime_error("glTF buffer without uri: " + filePath.string());
+					}
+
+					gltf.buffers.push_back(std::move(binaryChunk));
+					continue;
+				}
+
+				const std::string uri = buffer["uri"].as<std::string>();
+				if (uri.rfind("data:", 0) == 0) {
+					throw std::runtime_error("Embedded glTF buffers are not supported: " + filePath.string());
+				}
+
+				gltf.buffers.push_back(readBinaryFile(filePath.parent_path() / uri));
+			}
+
+			return gltf;
+		}
+
+		uint32_t getComponentSize(const uint32_t componentType) {
+			switch (componentType) {
+				case COMPONENT_BYTE:
+				case COMPONENT_UNSIGNED_BYTE: return 1;
+				case COMPONENT_SHORT:
+				case COMPONENT_UNSIGNED_SHORT: return 2;
+				case COMPONENT_UNSIGNED_INT:
+				case COMPONENT_FLOAT: return 4;
+				default: throw std::runtime_error("Unsupported glTF component type: " + std::to_string(componentType));
+			}
+		}
+
+		uint32_t getComponentCount(const std::string& type) {
+			if (type == "SCALAR") return 1;
+			if (type == "VEC2") return 2;
+			if (type == "VEC3") return 3;
+			if (type == "VEC4") return 4;
+			if (type == "MAT4") return 16;
+			throw std::runtime_error("Unsupported glTF accessor type: " + type);
+		}
+
+		AccessorView getAccessorView(const GltfFile& gltf, const uint32_t accessorIndex) {
+			const YAML::Node accessor = gltf.json["accessors"][accessorIndex];
+			if (!accessor) {
+				throw std::runtime_error("Invalid glTF accessor index: " + std::to_string(accessorIndex));
+			}
+			if (accessor["sparse"]) {
+				throw std::runtime_error("Sparse glTF accessors are not supported");
+			}
+
+			AccessorView view;
+			view.count = accessor["count"].as<size_t>();
+			view.componentCount = getComponentCount(accessor["type"].as<std::string>());
+			view.componentType = accessor["componentType"].as<uint32_t>();
+			view.normalized = accessor["normalized"] && accessor["normalized"].as<bool>();
+
+			const size_t elementSize = static_cast<size_t>(getComponentSize(view.componentType)) * view.componentCount;
+			view.stride = elementSize;
+
+			if (!accessor["bufferView"]) {
+				return view;
+			}
+
+			const YAML::Node bufferView = gltf.json["bufferViews"][accessor["bufferView"].as<uint32_t>()];
+			const std::vector<uint8_t>& buffer = gltf.buffers.at(bufferView["buffer"].as<uint32_t>());
+
+			if (bufferView["byteStride"]) {
+				view.stride = bufferView["byteStride"].as<size_t>();
+			}
+
+			const size_t offset = (bufferView["byteOffset"] ? bufferView["byteOffset"].as<size_t>() : 0) +
+				(accessor["byteOffset"] ? accessor["byteOffset"].as<size_t>() : 0);
+
+			if (view.count > 0 && offset + (view.count - 1) * view.stride + elementSize > buffer.size()) {
+				throw std::runtime_error("glTF accessor out of the buffer bounds");
+			}
+
+			view.data = buffer.data() + offset;
+			return view;
+		}
+
+		template<typename T>
+		T readComponentAs(const uint8_t* data, const uint32_t componentType) {
+			switch (componentType) {
+				case COMPONENT_BYTE: { int8_t v; std::memcpy(&v, data, sizeof(v)); return static_cast<T>(v); }
+				case COMPONENT_UNSIGNED_BYTE: { uint8_t v; std::memcpy(&v, data, sizeof(v)); return static_cast<T>(v); }
+				case COMPONENT_SHORT: { int16_t v; std::memcpy(&v, data, sizeof(v)); return static_cast<T>(v); }
+				case COMPONENT_UNSIGNED_SHORT: { uint16_t v; std::memcpy(&v, data, sizeof(v)); return static_cast<T>(v); }
+				case COMPONENT_UNSIGNED_INT: { uint32_t v; std::memcpy(&v, data, sizeof(v)); return static_cast<T>(v); }
+				case COMPONENT_FLOAT: { float v; std::memcpy(&v, data, sizeof(v)); return static_cast<T>(v); }
+				default: throw std::runtime_error("Unsupported glTF component type: " + std::to_string(componentType));
+			}
+		}
+
+		float readFloatComponent(const uint8_t* data, const uint32_t componentType, const bool normalized) {
+			const float value = readComponentAs<float>(data, componentType);
+			if (!normalized) return value;
+
+			// normalized integers, as defined by the glTF specification
+			switch (componentType) {
+				case COMPONENT_BYTE: return glm::max(value / 127.0f, -1.0f);
+				case COMPONENT_UNSIGNED_BYTE: return value / 255.0f;
+				case COMPONENT_SHORT: return glm::max(value / 32767.0f, -1.0f);
+				case COMPONENT_UNSIGNED_SHORT: return value / 65535.0f;
+				default: return value;
+			}
+		}
+
+		/**
+		 * @brief Reads an accessor of up to 4 components, the missing ones are set to zero.
+		 */
+		std::vector<glm::vec4> readVec4Accessor(const GltfFile& gltf, const uint32_t accessorIndex) {
+			const AccessorView view = getAccessorView(gltf, accessorIndex);
+			if (view.componentCount > 4) {
+				throw std::runtime_error("Unexpected glTF matrix accessor");
+			}
+
+			std::vector<glm::vec4> values(view.count, glm::vec4(0.0f));
+			if (view.data == nullptr) return values;
+
+			const uint32_t componentSize = getComponentSize(view.componentType);
+			for (size_t i = 0; i < view.count; i++) {
+				const uint8_t* element = view.data + i * view.stride;
+				for (uint32_t c = 0; c < view.componentCount; c++) {
+					values[i][c] = readFloatComponent(element + c * componentSize, view.componentType, view.normalized);
+				}
+			}
+
+			return values;
+		}
+
+		std::vector<glm::uvec4> readUVec4Accessor(const GltfFile& gltf, const uint32_t accessorIndex) {
+			const AccessorView view = getAccessorView(gltf, accessorIndex);
+			if (view.componentCount > 4) {
+				throw std::runtime_error("Unexpected glTF matrix accessor");
+			}
+
+			std::vector<glm::uvec4> values(view.count, glm::uvec4(0));
+			if (view.data == nullptr) return values;
+
+			const uint32_t componentSize = getComponentSize(view.componentType);
+			for (size_t i = 0; i < view.count; i++) {
+				const uint8_t* element = view.data + i * view.stride;
+				for (uint32_t c = 0; c < view.componentCount; c++) {
+					values[i][c] = readComponentAs<uint32_t>(element + c * componentSize, view.componentType);
+				}
+			}
+
+			return values;
+		}
+
+		std::vector<float> readScalarAccessor(const GltfFile& gltf, const uint32_t accessorIndex) {
+			std::vector<glm::vec4> values = readVec4Accessor(gltf, accessorIndex);
+
+			std::vector<float> scalars(values.size());
+			for (size_t i = 0; i < values.size(); i++) {
+				scalars[i] = values[i].x;
+			}
+
+			return scalars;
+		}
+
+		std::vector<glm::mat4> readMat4Accessor(const GltfFile& gltf, const uint32_t accessorIndex) {
+			const AccessorView view = getAccessorView(gltf, accessorIndex);
+			if (view.componentCount != 16 || view.componentType != COMPONENT_FLOAT) {
+				throw std::runtime_error("Expected a glTF MAT4 float accessor");
+			}
+
+			std::vector<glm::mat4> values(view.count, glm::mat4(1.0f));
+			if (view.data == nullptr) return values;
+
+			for (size_t i = 0; i < view.count; i++) {
+				// glTF matrices are column-major like glm
+				std::memcpy(glm::value_ptr(values[i]), view.data + i * view.stride, sizeof(glm::mat4));
+			}
+
+			return values;
+		}
+
+		/**
+		 * @brief Reads the local transform of a node, given either as a matrix or as TRS.
+		 */
+		void readNodeTransform(const YAML::Node& node, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale) {
+			translation = glm::vec3(0.0f);
+			rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+			scale = glm::vec3(1.0f);
+
+			if (node["matrix"]) {
+				glm::mat4 matrix;
+				for (int i = 0; i < 16; i++) {
+					glm::value_ptr(matrix)[i] = node["matrix"][i].as<float>();
+				}
+
+				glm::vec3 skew;
+				glm::vec4 perspective;
+				glm::decompose(matrix, scale, rotation, translation, skew, perspective);
+				return;
+			}
+
+			if (const YAML::Node t = node["translation"]) {
+				translation = { t[0].as<float>(), t[1].as<float>(), t[2].as<float>() };
+			}
+			if (const YAML::Node r = node["rotation"]) {
+				// stored as (x, y, z, w)
+				rotation = glm::quat(r[3].as<float>(), r[0].as<float>(), r[1].as<float>(), r[2].as<float>());
+			}
+			if (const YAML::Node s = node["scale"]) {
+				scale = { s[0].as<float>(), s[1].as<float>(), s[2].as<float>() };
+			}
+		}
+
+		glm::mat4 getNodeLocalMatrix(const YAML::Node& node) {
+			glm::vec3 translation, scale;
+			glm::quat rotation;
+			readNodeTransform(node, translation, rotation, scale);
+
+			return glm::translate(glm::mat4(1.0f), translation) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+		}
+
+		void importPrimitives(const GltfFile& gltf, const YAML::Node& mesh, const bool isSkinned,
+			std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices,
+			std::vector<Mesh::SkinWeights>& skinWeights) {
+
+			for (const auto& primitive : mesh["primitives"]) {
+				if (primitive["mode"] && primitive["mode"].as<uint32_t>() != PRIMITIVE_MODE_TRIANGLES) {
+					PXT_WARN("Skipping glTF primitive that is not a triangle list");
+					continue;
+				}
+
+				const YAML::Node attributes = primitive["attributes"];
+				if (!attributes["POSITION"]) {
+					throw std::runtime_error("glTF primitive without POSITION attribute");
+				}
+
+				std::vector<glm::vec4> positions = readVec4Accessor(gltf, attributes["POSITION"].as<uint32_t>());
+				const size_t vertexCount = positions.size();
+
+				std::vector<Mesh::Vertex> primitiveVertices(vertexCount);
+				for (size_t i = 0; i < vertexCount; i++) {
+					primitiveVertices[i].position = glm::vec4(glm::vec3(positions[i]), 1.0f);
+					primitiveVertices[i].uv = { 0.0f, 0.0f, 1.0f, 1.0f };
+				}
+
+				if (attributes["NORMAL"]) {
+					std::vector<glm::vec4> normals = readVec4Accessor(gltf, attributes["NORMAL"].as<uint32_t>());
+					for (size_t i = 0; i < vertexCount; i++) {
+						primitiveVertices[i].normal = glm::vec4(glm::vec3(normals[i]), 1.0f);
+					}
+				}
+
+				if (attributes["TEXCOORD_0"]) {
+					// glTF uvs already have their origin at the top left, no flip needed
+					std::vector<glm::vec4> uvs = readVec4Accessor(gltf, attributes["TEXCOORD_0"].as<uint32_t>());
+					for (size_t i = 0; i < vertexCount; i++) {
+						primitiveVertices[i].uv = { uvs[i].x, uvs[i].y, 1.0f, 1.0f };
+					}
+				}
+
+				std::vector<uint32_t> primitiveIndices;
+				if (primitive["indices"]) {
+					std::vector<glm::uvec4> indexValues = readUVec4Accessor(gltf, primitive["indices"].as<uint32_t>());
+					primitiveIndices.reserve(indexValues.size());
+					for (const glm::uvec4& index : indexValues) {
+						primitiveIndices.push_back(index.x);
+					}
+				} else {
+					primitiveIndices.resize(vertexCount);
+					std::iota(primitiveIndices.begin(), primitiveIndices.end(), 0);
+				}
+
+				if (attributes["TANGENT"]) {
+					std::vector<glm::vec4> tangents = readVec4Accessor(gltf, attributes["TANGENT"].as<uint32_t>());
+					for (size_t i = 0; i < vertexCount; i++) {
+						primitiveVertices[i].tangent = tangents[i];
+					}
+				} else {
+					MeshImporter::computeTangents(primitiveVertices, primitiveIndices, attributes["TEXCOORD_0"].IsDefined());
+				}
+
+				if (isSkinned) {
+					std::vector<glm::uvec4> joints(vertexCount, glm::uvec4(0));
+					std::vector<glm::vec4> weights(vertexCount, glm::vec4(1.0f, 0.0f, 0.0f, 0.0f));
+
+					if (attributes["JOINTS_0"] && attributes["WEIGHTS_0"]) {
+						joints = readUVec4Accessor(gltf, attributes["JOINTS_0"].as<uint32_t>());
+						weights = readVec4Accessor(gltf, attributes["WEIGHTS_0"].as<uint32_t>());
+					}
+
+					for (size_t i = 0; i < vertexCount; i++) {
+						Mesh::SkinWeights skin{};
+						skin.joints = joints[i];
+
+						// exporters do not always write weights that sum exactly to one
+						const float weightSum = weights[i].x + weights[i].y + weights[i].z + weights[i].w;
+						skin.weights = weightSum > 0.0f ? weights[i] / weightSum : glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+
+						skinWeights.push_back(skin);
+					}
+				}
+
+				const uint32_t indexOffset = static_cast<uint32_t>(vertices.size());
+				for (const uint32_t index : primitiveIndices) {
+					if (index >= vertexCount) {
+						throw std::runtime_error("glTF primitive index out of range");
+					}
+					indices.push_back(index + indexOffset);
+				}
+
+				vertices.insert(vertices.end(), primitiveVertices.begin(), primitiveVertices.end());
+			}
+		}
+	}
+
+	Shared<Mesh> GltfImporter::import(ResourceManager& rm, const std::filesystem::path& filePath,
+		ResourceInfo* resourceInfo) {
+
+		const GltfFile gltf = loadGltf(filePath);
+		const YAML::Node nodes = gltf.json["nodes"];
+
+		const size_t nodeCount = nodes ? nodes.size() : 0;
+
+		// the node hierarchy is only stored top down
+		std::vector<int32_t> nodeParents(nodeCount, Skeleton::NO_PARENT);
+		for (size_t i = 0; i < nodeCount; i++) {
+			for (const auto& child : nodes[i]["children"]) {
+				nodeParents.at(child.as<size_t>()) = static_cast<int32_t>(i);
+			}
+		}
+
+		// only the first mesh of the file is imported, along with its skin
+		YAML::Node mesh;
+		YAML::Node skin;
+		for (size_t i = 0; i < nodeCount; i++) {
+			if (nodes[i]["mesh"]) {
+				mesh = gltf.json["meshes"][nodes[i]["mesh"].as<uint32_t>()];
+				if (nodes[i]["skin"]) {
+					skin = gltf.json["skins"][nodes[i]["skin"].as<uint32_t>()];
+				}
+				break;
+			}
+		}
+
+		if (!mesh && gltf.json["meshes"] && gltf.json["meshes"].size() > 0) {
+			mesh = gltf.json["meshes"][0];
+		}
+		if (!mesh) {
+			throw std::runtime_error("No mesh found in glTF file: " + filePath.string());
+		}
+
+		const bool isSkinned = skin && skin["joints"] && skin["joints"].size() > 0;
+
+		std::vector<Mesh::Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		std::vector<Mesh::SkinWeights> skinWeights{};
+
+		importPrimitives(gltf, mesh, isSkinned, vertices, indices, skinWeights);
+
+		if (vertices.empty()) {
+			throw std::runtime_error("No triangles found in glTF file: " + filePath.string());
+		}
+
+		if (!isSkinned) {
+			return VulkanMesh::create(vertices, indices);
+		}
+
+		// --- skeleton ---
+
+		const size_t skinJointCount = skin["joints"].size();
+
+		std::unordered_map<uint32_t, uint32_t> nodeToSkinJoint;
+		std::vector<uint32_t> jointNodes(skinJointCount);
+		for (size_t i = 0; i < skinJointCount; i++) {
+			jointNodes[i] = skin["joints"][i].as<uint32_t>();
+			nodeToSkinJoint[jointNodes[i]] = static_cast<uint32_t>(i);
+		}
+
+		// the parent of a joint is its closest ancestor that is also a joint of the skin
+		std::vector<int32_t> skinJointParents(skinJointCount, Skeleton::NO_PARENT);
+		std::vector<uint32_t> skinJointDepths(skinJointCount, 0);
+		for (size_t i = 0; i < skinJointCount; i++) {
+			for (int32_t node = nodeParents.at(jointNodes[i]); node != Skeleton::NO_PARENT; node = nodeParents[node]) {
+				auto it = nodeToSkinJoint.find(static_cast<uint32_t>(node));
+				if (it == nodeToSkinJoint.end()) continue;
+
+				if (skinJointParents[i] == Skeleton::NO_PARENT) {
+					skinJointParents[i] = static_cast<int32_t>(it->second);
+				}
+				skinJointDepths[i]++;
+			}
+		}
+
+		// sort the joints parents first, as required by the skeleton
+		std::vector<uint32_t> sortedSkinJoints(skinJointCount);
+		std::iota(sortedSkinJoints.begin(), sortedSkinJoints.end(), 0);
+		std::stable_sort(sortedSkinJoints.begin(), sortedSkinJoints.end(), [&](uint32_t a, uint32_t b) {
+			return skinJointDepths[a] < skinJointDepths[b];
+		});
+
+		std::vector<uint32_t> skinJointToJoint(skinJointCount);
+		for (size_t i = 0; i < skinJointCount; i++) {
+			skinJointToJoint[sortedSkinJoints[i]] = static_cast<uint32_t>(i);
+		}
+
+		std::vector<glm::mat4> inverseBindMatrices(skinJointCount, glm::mat4(1.0f));
+		if (skin["inverseBindMatrices"]) {
+			inverseBindMatrices = readMat4Accessor(gltf, skin["inverseBindMatrices"].as<uint32_t>());
+			if (inverseBindMatrices.size() < skinJointCount) {
+				throw std::runtime_error("Not enough glTF inverse bind matrices: " + filePath.string());
+			}
+		}
+
+		std::vector<Skeleton::Joint> joints(skinJointCount);
+		SkeletonPose restPose;
+		restPose.resize(skinJointCount);
+
+		for (size_t i = 0; i < skinJointCount; i++) {
+			const uint32_t skinJoint = sortedSkinJoints[i];
+			const YAML::Node node = nodes[jointNodes[skinJoint]];
+
+			Skeleton::Joint& joint = joints[i];
+			joint.name = node["name"] ? node["name"].as<std::string>() : "joint_" + std::to_string(skinJoint);
+			joint.parentIndex = skinJointParents[skinJoint] == Skeleton::NO_PARENT
+				? Skeleton::NO_PARENT
+				: static_cast<int32_t>(skinJointToJoint[skinJointParents[skinJoint]]);
+			joint.inverseBindMatrix = inverseBindMatrices[skinJoint];
+
+			readNodeTransform(node, restPose.translations[i], restPose.rotations[i], restPose.scales[i]);
+		}
+
+		// the nodes above the root joint still move the whole skeleton
+		glm::mat4 rootTransform(1.0f);
+		for (int32_t node = nodeParents.at(jointNodes[sortedSkinJoints[0]]); node != Skeleton::NO_PARENT; node = nodeParents[node]) {
+			rootTransform = getNodeLocalMatrix(nodes[node]) * rootTransform;
+		}
+
+		for (Mesh::SkinWeights& weights : skinWeights) {
+			for (int c = 0; c < 4; c++) {
+				if (weights.joints[c] >= skinJointCount) {
+					throw std::runtime_error("glTF joint index out of range: " + filePath.string());
+				}
+				weights.joints[c] = skinJointToJoint[weights.joints[c]];
+			}
+		}
+
+		auto skeleton = createShared<Skeleton>(std::move(joints), std::move(restPose), rootTransform);
+		rm.add(skeleton, filePath.string() + "#skeleton");
+
+		// --- animations ---
+
+		uint32_t animationIndex = 0;
+		for (const auto& animation : gltf.json["animations"]) {
+			std::vector<AnimationClip::Channel> channels;
+
+			for (const auto& gltfChannel : animation["channels"]) {
+				const YAML::Node target = gltfChannel["target"];
+				if (!target["node"]) continue;
+
+				auto it = nodeToSkinJoint.find(target["node"].as<uint32_t>());
+				if (it == nodeToSkinJoint.end()) continue;
+
+				AnimationClip::Channel channel;
+				channel.jointIndex = skinJointToJoint[it->second];
+
+				const std::string path = target["path"].as<std::string>();
+				if (path == "translation") {
+					channel.path = AnimationClip::Path::Translation;
+				} else if (path == "rotation") {
+					channel.path = AnimationClip::Path::Rotation;
+				} else if (path == "scale") {
+					channel.path = AnimationClip::Path::Scale;
+				} else {
+					continue; // morph target weights
+				}
+
+				const YAML::Node sampler = animation["samplers"][gltfChannel["sampler"].as<uint32_t>()];
+				const std::string interpolation = sampler["interpolation"]
+					? sampler["interpolation"].as<std::string>()
+					: "LINEAR";
+
+				channel.interpolation = interpolation == "STEP"
+					? AnimationClip::Interpolation::Step
+					: AnimationClip::Interpolation::Linear;
+
+				channel.times = readScalarAccessor(gltf, sampler["input"].as<uint32_t>());
+				std::vector<glm::vec4> values = readVec4Accessor(gltf, sampler["output"].as<uint32_t>());
+
+				if (interpolation == "CUBICSPLINE") {
+					// in-tangent, value and out-tangent for each keyframe: keep the
+					// values only, the clip is resampled densely enough to be linear
+					for (size_t k = 0; k < channel.times.size() && 3 * k + 1 < values.size(); k++) {
+						channel.values.push_back(values[3 * k + 1]);
+					}
+				} else {
+					channel.values = std::move(values);
+				}
+
+				if (channel.times.empty() || channel.values.size() != channel.times.size()) {
+					PXT_WARN("Skipping malformed glTF animation channel in {}", filePath.string());
+					continue;
+				}
+
+				channels.push_back(std::move(channel));
+			}
+
+			if (!channels.empty()) {
+				const std::string name = animation["name"]
+					? animation["name"].as<std::string>()
+					: std::to_string(animationIndex);
+
+				rm.add(createShared<AnimationClip>(*skeleton, channels), filePath.string() + "#animation/" + name);
+			}
+
+			animationIndex++;
+		}
+
+		return VulkanMesh::create(vertices, indices, skinWeights);
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "resources/types/mesh.hpp"
+#include "resources/resource_manager.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @class GltfImporter
+	 *
+	 * @brief Imports the first mesh of a glTF 2.0 file (.gltf with external buffers or .glb).
+	 *
+	 * If the mesh is skinned, its skeleton and animations are imported too and added to the
+	 * resource manager as "<file>#skeleton" and "<file>#animation/<name>".
+	 * Embedded (data URI) buffers, sparse accessors and morph targets are not supported.
+	 */
+	class GltfImporter {
+	public:
+		static Shared<Mesh> import(ResourceManager& rm, const std::filesystem::path& filePath,
+			ResourceInfo* resourceInfo = nullptr);
+	};
+}
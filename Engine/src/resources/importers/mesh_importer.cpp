@@ -8,6 +8,55 @@
 
 namespace PXTEngine {
 
+	// Iterate through triangles and calculate per-triangle tangents and bitangents
+	void MeshImporter::computeTangents(std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices, bool hasUvs) {
+            if (hasUvs) {
+                for (size_t i = 0; i < indices.size(); i += 3) {
+                    Mesh::Vertex& v0 = vertices[indices[i + 0]];
+                    Mesh::Vertex& v1 = vertices[indices[i + 1]];
+                    Mesh::Vertex& v2 = vertices[indices[i + 2]];
+
+                    glm::vec3 edge1 = v1.position - v0.position;
+                    glm::vec3 edge2 = v2.position - v0.position;
+
+                    glm::vec2 deltaUV1 = glm::vec2(v1.uv) - glm::vec2(v0.uv);
+                    glm::vec2 deltaUV2 = glm::vec2(v2.uv) - glm::vec2(v0.uv);
+
+                    float det = (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
+
+                    // Check for zero determinant to avoid division by zero
+                    if (glm::abs(det) < 1e-6f) {
+                        v0.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+                        v1.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+                        v2.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+                        continue; // Skip to the next triangle
+                    }
+
+                    float f = 1.0f / det;
+
+                    glm::vec3 tangent;
+                    tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
+                    tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
+                    tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
+
+                    tangent = glm::normalize(tangent);
+
+                    float handedness = (glm::dot(glm::cross(glm::vec3(v0.normal), glm::vec3(v1.normal)), tangent) < 0.0f) ? -1.0f : 1.0f;
+                    glm::vec4 tangent4 = glm::vec4(tangent, handedness);
+
+                    v0.tangent = tangent4;
+                    v1.tangent = tangent4;
+                    v2.tangent = tangent4;
+                }
+            }
+            else {
+                // Assign default tangents if no UVs are present
+                for (Mesh::Vertex& v : vertices) {
+                    v.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
+                }
+            }
+	}
+
 	Shared<Mesh> MeshImporter::importObj(ResourceManager& rm, const std::filesystem::path& filePath,
         ResourceInfo* resourceInfo) {
 
@@ -23,10 +72,16 @@ namespace PXTEngine {
             throw std::runtime_error(warn + err);
         }
 
-        vertices.clear();
-        indices.clear();
+        StartupProfiler::recordFileRead(filePath);
+
+        // one vertex per triangle corner, merged by deduplicateVertices
+        std::vector<Mesh::Vertex> corners{};
+        size_t cornerCount = 0;
+        for (const auto& shape : shapes) {
+            cornerCount += shape.mesh.indices.size();
+        }
+        corners.reserve(cornerCount);
 
-        std::unordered_map<Mesh::Vertex, uint32_t> uniqueVertices{};
         for (const auto& shape : shapes) {
             for (const auto& index : shape.mesh.indices) {
                 Mesh::Vertex vertex{};
@@ -66,61 +121,14 @@ namespace PXTEngine {
 					vertex.uv = { 0.0f, 0.0f, 1.0f, 1.0f };
                 }
 
-				if (!uniqueVertices.contains(vertex)) {
-				    uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-				    vertices.push_back(vertex);
-				}
-				indices.push_back(uniqueVertices[vertex]);
+				corners.push_back(vertex);
             }
         }
 
-        // Iterate through triangles and calculate per-triangle tangents and bitangents
-        // Only calculate tangents if the model has UV coordinates
-        if (!attrib.texcoords.empty()) {
-            for (size_t i = 0; i < indices.size(); i += 3) {
-                Mesh::Vertex& v0 = vertices[indices[i + 0]];
-                Mesh::Vertex& v1 = vertices[indices[i + 1]];
-                Mesh::Vertex& v2 = vertices[indices[i + 2]];
-
-                glm::vec3 edge1 = v1.position - v0.position;
-                glm::vec3 edge2 = v2.position - v0.position;
-
-                glm::vec2 deltaUV1 = glm::vec2(v1.uv) - glm::vec2(v0.uv);
-                glm::vec2 deltaUV2 = glm::vec2(v2.uv) - glm::vec2(v0.uv);
-
-                float det = (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-
-                // Check for zero determinant to avoid division by zero
-                if (glm::abs(det) < 1e-6f) {
-                    v0.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
-                    v1.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
-                    v2.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
-                    continue; // Skip to the next triangle
-                }
-
-                float f = 1.0f / det;
-
-                glm::vec3 tangent;
-                tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-                tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-                tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
+        deduplicateVertices(corners, vertices, indices);
 
-                tangent = glm::normalize(tangent);
-
-                float handedness = (glm::dot(glm::cross(glm::vec3(v0.normal), glm::vec3(v1.normal)), tangent) < 0.0f) ? -1.0f : 1.0f;
-                glm::vec4 tangent4 = glm::vec4(tangent, handedness);
-
-                v0.tangent = tangent4;
-                v1.tangent = tangent4;
-                v2.tangent = tangent4;
-            }
-        }
-        else {
-            // Assign default tangents if no UVs are present
-            for (Mesh::Vertex& v : vertices) {
-                v.tangent = glm::vec4(1.0f, 0.0f, 0.0f, 1.0f);
-            }
-        }
+        // Only calculate tangents if the model has UV coordinates
+        computeTangents(vertices, indices, !attrib.texcoords.empty());
 
 		return VulkanMesh::create(vertices, indices);
 	}
@@ -10,5 +10,19 @@ namespace PXTEngine {
 	public:
 		static Shared<Mesh> importObj(ResourceManager& rm, const std::filesystem::path& filePath,
 			ResourceInfo* resourceInfo = nullptr);
+
+		/**
+		 * @brief Merges the identical vertices of a triangle list with one vertex per corner,
+		 * appending the unique vertices and the index of every corner.
+		 */
+		static void deduplicateVertices(const std::vector<Mesh::Vertex>& corners,
+			std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		/**
+		 * @brief Computes per-triangle tangents from the uv layout, or assigns a default
+		 * tangent to every vertex if the mesh has no uvs.
+		 */
+		static void computeTangents(std::vector<Mesh::Vertex>& vertices, const std::vector<uint32_t>& indices,
+			bool hasUvs);
 	};
 }
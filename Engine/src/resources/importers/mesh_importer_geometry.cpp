@@ -0,0 +1,22 @@
+#include "resources/importers/mesh_importer.hpp"
+
+// The vertex processing of MeshImporter that doesn't create Vulkan resources,
+// in its own translation unit so that the benchmarks can link it.
+
+namespace PXTEngine {
+
+	void MeshImporter::deduplicateVertices(const std::vector<Mesh::Vertex>& corners,
+		std::vector<Mesh::Vertex>& vertices, std::vector<uint32_t>& indices) {
+
+		indices.reserve(indices.size() + corners.size());
+
+		std::unordered_map<Mesh::Vertex, uint32_t> uniqueVertices{};
+		for (const Mesh::Vertex& vertex : corners) {
+			auto [it, inserted] = uniqueVertices.try_emplace(vertex, static_cast<uint32_t>(vertices.size()));
+			if (inserted) {
+				vertices.push_back(vertex);
+			}
+			indices.push_back(it->second);
+		}
+	}
+}
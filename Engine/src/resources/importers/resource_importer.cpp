@@ -3,6 +3,7 @@
 #include "resources/resource.hpp"
 #include "resources/importers/texture_importer.hpp"
 #include "resources/importers/mesh_importer.hpp"
+#include "resources/importers/gltf_importer.hpp"
 
 namespace PXTEngine {
 
@@ -13,11 +14,18 @@ namespace PXTEngine {
             ResourceInfo* resourceInfo
         )>;
 
-        std::unordered_map<std::string, ResourceImportFunction> extensionToImportFunction = {
-            {".png", TextureImporter::import},
-            {".jpg", TextureImporter::import},
-            {".jpeg", TextureImporter::import},
-            {".obj", MeshImporter::importObj}
+        struct ResourceImporterEntry {
+            ResourceImportFunction function;
+            const char* startupPhase; // the imports of a type are grouped in the startup report
+        };
+
+        std::unordered_map<std::string, ResourceImporterEntry> extensionToImportFunction = {
+            {".png", {TextureImporter::import, "Import texture"}},
+            {".jpg", {TextureImporter::import, "Import texture"}},
+            {".jpeg", {TextureImporter::import, "Import texture"}},
+            {".obj", {MeshImporter::importObj, "Import mesh"}},
+            {".gltf", {GltfImporter::import, "Import mesh"}},
+            {".glb", {GltfImporter::import, "Import mesh"}}
         };
     }
 
@@ -32,6 +40,8 @@ namespace PXTEngine {
             throw std::runtime_error("Unsupported file extension: " + extension);
         }
 
-        return it->second(rm, filePath, resourceInfo);
+        PXT_STARTUP_PHASE(it->second.startupPhase);
+
+        return it->second.function(rm, filePath, resourceInfo);
     }
 }
\ No newline at end of file
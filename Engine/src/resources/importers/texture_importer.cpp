@@ -67,6 +67,8 @@ namespace PXTEngine {
 		}
 
 		pixels.size = width * height * requestedChannels * channelBitsPerPixel;
+
+		StartupProfiler::recordFileRead(filePath);
 		
 		if (!pixels) {
             pixels.release();
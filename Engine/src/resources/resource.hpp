@@ -31,6 +31,9 @@ namespace PXTEngine {
 			Model,
 			Mesh,
 			Material,
+			DensityGrid,
+			Skeleton,
+			AnimationClip,
 		};
 
 		Resource() = default;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "core/pch.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @struct ResourceHandle
+	 *
+	 * @brief A 32-bit reference to a resource stored in a ResourcePool: the slot index in
+	 * the low bits and the generation of the slot in the high bits.
+	 *
+	 * Handles are plain values, copying one does not touch any reference count. When a slot
+	 * is released its generation is bumped, so a handle outliving its resource fails the
+	 * lookup instead of pointing at whatever reused the slot.
+	 *
+	 * The generations start at 1, a default constructed handle (value 0) is never valid.
+	 *
+	 * @tparam T The type of the resource.
+	 */
+	template<typename T>
+	struct ResourceHandle {
+		static constexpr uint32_t INDEX_BITS = 20;
+		static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+		static constexpr uint32_t MAX_INDEX = INDEX_MASK;
+		static constexpr uint32_t MAX_GENERATION = (1u << (32 - INDEX_BITS)) - 1;
+
+		uint32_t value = 0;
+
+		ResourceHandle() = default;
+		ResourceHandle(const uint32_t index, const uint32_t generation)
+			: value((generation << INDEX_BITS) | (index & INDEX_MASK)) {}
+
+		uint32_t getIndex() const { return value & INDEX_MASK; }
+		uint32_t getGeneration() const { return value >> INDEX_BITS; }
+
+		// only tells if the handle was ever set, the pool tells if it is still valid
+		explicit operator bool() const { return value != 0; }
+
+		bool operator==(const ResourceHandle& other) const { return value == other.value; }
+	};
+}
+
+template<typename T>
+struct std::hash<PXTEngine::ResourceHandle<T>> {
+	size_t operator()(const PXTEngine::ResourceHandle<T>& handle) const noexcept {
+		return std::hash<uint32_t>()(handle.value);
+	}
+};
@@ -1,6 +1,10 @@
 #include "resources/resource_manager.hpp"
 
 #include "resources/importers/resource_importer.hpp"
+#include "resources/types/mesh.hpp"
+#include "resources/types/material.hpp"
+#include "resources/types/image.hpp"
+#include "resources/types/density_grid.hpp"
 
 namespace PXTEngine {
 
@@ -11,6 +15,7 @@ namespace PXTEngine {
 	}
 
 	Shared<Resource> ResourceManager::get(const std::string& alias, ResourceInfo* resourceInfo) {
+		PXT_ALLOCATION_SCOPE("Resources");
 
 		auto aliasIt = m_aliases.find(alias);
 
@@ -44,9 +49,37 @@ namespace PXTEngine {
 
 		resource->alias = alias;
 
+		registerHandle(resource);
+
 		return id;
 	}
 
+	void ResourceManager::registerHandle(const Shared<Resource>& resource) {
+		// the manager's reference, taken once even if the resource is added under several aliases
+		auto acquireOnce = [&]<typename T>(ResourcePool<T>& pool) {
+			if (!pool.find(resource->id)) {
+				pool.acquire(std::static_pointer_cast<T>(resource));
+			}
+		};
+
+		switch (resource->getType()) {
+			case Resource::Type::Mesh:
+				acquireOnce(m_pools.get<Mesh>());
+				break;
+			case Resource::Type::Material:
+				acquireOnce(m_pools.get<Material>());
+				break;
+			case Resource::Type::Image:
+				acquireOnce(m_pools.get<Image>());
+				break;
+			case Resource::Type::DensityGrid:
+				acquireOnce(m_pools.get<DensityGrid>());
+				break;
+			default:
+				break;
+		}
+	}
+
 	void ResourceManager::foreach(const std::function<void(const Shared<Resource>&)>& function) {
 		for (const auto& resource : m_resources | std::views::values) {
 			function(resource);
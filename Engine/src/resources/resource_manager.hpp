@@ -2,16 +2,18 @@
 
 #include "core/pch.hpp"
 #include "resources/resource.hpp"
+#include "resources/resource_pool.hpp"
 
 namespace PXTEngine {
 
-	// forward declaration
-	class Material;
-
 	/**
 	 * @class ResourceManager
 	 *
 	 * @brief Manages resources in the engine, allowing for retrieval and storage of resources.
+	 *
+	 * The meshes, materials, images and density grids are also stored in ResourcePools,
+	 * the components refer to them by ResourceHandle. Every resource added to the manager
+	 * holds one reference in its pool for the lifetime of the manager.
 	 */
 	class ResourceManager {
 	public:
@@ -63,10 +65,86 @@ namespace PXTEngine {
 		 */
 		void foreach(const std::function<void(const Shared<Resource>&)>& function);
 
+		/**
+		 * @brief Adds a reference to a resource, storing it in its pool the first time.
+		 * Used for the resources not added to the manager (e.g. per-entity meshes),
+		 * every acquire must be paired with a release.
+		 *
+		 * @param resource The resource to acquire.
+		 *
+		 * @return The handle of the resource.
+		 */
+		template<typename T>
+		ResourceHandle<T> acquire(const Shared<T>& resource) {
+			return m_pools.get<T>().acquire(resource);
+		}
+
+		/**
+		 * @brief Removes a reference acquired with acquire().
+		 *
+		 * @param handle The handle of the resource to release.
+		 */
+		template<typename T>
+		void release(const ResourceHandle<T> handle) {
+			m_pools.get<T>().release(handle);
+		}
+
+		/**
+		 * @brief Retrieves the handle of a resource stored in the pools.
+		 *
+		 * @param resource The resource.
+		 *
+		 * @return The handle, a null handle if the resource is not stored.
+		 */
+		template<typename T>
+		ResourceHandle<T> getHandle(const Shared<T>& resource) const {
+			return resource != nullptr ? m_pools.get<T>().find(resource->id) : ResourceHandle<T>();
+		}
+
+		/**
+		 * @brief Retrieves (loading it if needed, see get()) a resource by its alias
+		 * and returns its handle.
+		 *
+		 * @param alias The alias of the resource to retrieve.
+		 * @param resourceInfo Optional pointer to store additional resource information.
+		 *
+		 * @return The handle, a null handle if the resource could not be retrieved.
+		 */
+		template<typename T>
+		ResourceHandle<T> getHandle(const std::string& alias, ResourceInfo* resourceInfo = nullptr) {
+			return getHandle(get<T>(alias, resourceInfo));
+		}
+
+		/**
+		 * @brief Resolves a handle, O(1).
+		 *
+		 * @return The resource, nullptr if the handle is null or stale.
+		 */
+		template<typename T>
+		T* resolve(const ResourceHandle<T> handle) const {
+			return m_pools.get<T>().get(handle);
+		}
+
+		/**
+		 * @brief Same as resolve, for the APIs that keep the resource alive themselves.
+		 */
+		template<typename T>
+		const Shared<T>& getShared(const ResourceHandle<T> handle) const {
+			return m_pools.get<T>().getShared(handle);
+		}
+
+		const ResourcePools& getPools() const { return m_pools; }
+
 		static Shared<Material> defaultMaterial;
 	          
 	private:
+		/**
+		 * @brief Stores a resource of a pooled type in its pool.
+		 */
+		void registerHandle(const Shared<Resource>& resource);
+
 	    std::unordered_map<ResourceId, Shared<Resource>> m_resources;
 		std::unordered_map<std::string, ResourceId> m_aliases;
+		ResourcePools m_pools;
 	};
 }
\ No newline at end of file
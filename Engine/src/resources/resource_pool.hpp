@@ -0,0 +1,165 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "resources/resource.hpp"
+#include "resources/resource_handle.hpp"
+
+namespace PXTEngine {
+
+	// forward declarations
+	class Mesh;
+	class Material;
+	class Image;
+	class DensityGrid;
+
+	/**
+	 * @class ResourcePool
+	 *
+	 * @brief Dense storage of the resources of one type, addressed by ResourceHandle.
+	 *
+	 * The reference count of a slot is only touched at the explicit acquire and release
+	 * points (the ResourceManager registering a resource, a system creating a resource it
+	 * owns), never when a handle is copied. When it drops to zero the slot is freed and its
+	 * generation bumped, the handles still around become invalid. A slot that reaches the
+	 * maximum generation is retired instead of being reused.
+	 *
+	 * Lookups are an index and a generation check, a stale or null handle resolves to nullptr.
+	 *
+	 * @tparam T The type of the resource.
+	 */
+	template<typename T>
+	class ResourcePool {
+	public:
+		using Handle = ResourceHandle<T>;
+
+		/**
+		 * @brief Adds a reference to a resource, storing it in a slot the first time.
+		 *
+		 * @param resource The resource, acquiring the same resource twice returns the same handle.
+		 *
+		 * @return The handle of the resource.
+		 */
+		Handle acquire(const Shared<T>& resource) {
+			PXT_ASSERT(resource != nullptr, "Cannot acquire a null resource");
+
+			auto [it, isNew] = m_indices.try_emplace(resource->id, 0);
+
+			if (isNew) {
+				if (m_freeSlots.empty()) {
+					PXT_ASSERT(m_resources.size() <= Handle::MAX_INDEX, "Resource pool is full");
+
+					it->second = static_cast<uint32_t>(m_resources.size());
+					m_resources.emplace_back();
+					m_generations.push_back(1);
+					m_refCounts.push_back(0);
+				} else {
+					it->second = m_freeSlots.back();
+					m_freeSlots.pop_back();
+				}
+				m_resources[it->second] = resource;
+			}
+
+			m_refCounts[it->second]++;
+			return Handle(it->second, m_generations[it->second]);
+		}
+
+		/**
+		 * @brief Adds a reference to the resource of a valid handle.
+		 */
+		void acquire(const Handle handle) {
+			PXT_ASSERT(isValid(handle), "Cannot acquire an invalid resource handle");
+			m_refCounts[handle.getIndex()]++;
+		}
+
+		/**
+		 * @brief Removes a reference, freeing the slot when it was the last one.
+		 * Releasing a stale or null handle does nothing.
+		 */
+		void release(const Handle handle) {
+			if (!isValid(handle)) return;
+
+			const uint32_t index = handle.getIndex();
+			if (--m_refCounts[index] > 0) return;
+
+			m_indices.erase(m_resources[index]->id);
+			m_resources[index] = nullptr;
+
+			// a slot whose generation saturates is retired rather than wrapped back to 1, the
+			// handles of its first resource would otherwise become valid again
+			if (m_generations[index] == Handle::MAX_GENERATION) {
+				m_generations[index] = RETIRED_GENERATION;
+				return;
+			}
+
+			m_generations[index]++;
+			m_freeSlots.push_back(index);
+		}
+
+		bool isValid(const Handle handle) const {
+			const uint32_t index = handle.getIndex();
+			return index < m_generations.size() && m_generations[index] != RETIRED_GENERATION
+				&& m_generations[index] == handle.getGeneration();
+		}
+
+		/**
+		 * @brief The resource of a handle, nullptr if the handle is null or stale.
+		 */
+		T* get(const Handle handle) const {
+			return isValid(handle) ? m_resources[handle.getIndex()].get() : nullptr;
+		}
+
+		/**
+		 * @brief Same as get, for the APIs that keep the resource alive themselves
+		 * (e.g. the BLAS registry).
+		 */
+		const Shared<T>& getShared(const Handle handle) const {
+			static const Shared<T> nullResource = nullptr;
+			return isValid(handle) ? m_resources[handle.getIndex()] : nullResource;
+		}
+
+		/**
+		 * @brief The handle of a stored resource, a null handle if it is not in the pool.
+		 */
+		Handle find(const ResourceId& id) const {
+			auto it = m_indices.find(id);
+			return it != m_indices.end() ? Handle(it->second, m_generations[it->second]) : Handle();
+		}
+
+		uint32_t getCount() const { return static_cast<uint32_t>(m_indices.size()); }
+
+	private:
+		// generation 0 is the one of the null handle, no handle resolves to a retired slot
+		static constexpr uint32_t RETIRED_GENERATION = 0;
+
+		std::vector<Shared<T>> m_resources;
+		std::vector<uint32_t> m_generations;
+		std::vector<uint32_t> m_refCounts;
+		std::vector<uint32_t> m_freeSlots;
+		std::unordered_map<ResourceId, uint32_t> m_indices;
+	};
+
+	/**
+	 * @class ResourcePools
+	 *
+	 * @brief The pools of the resource types referenced by the components.
+	 */
+	class ResourcePools {
+	public:
+		template<typename T>
+		ResourcePool<T>& get() { return std::get<ResourcePool<T>>(m_pools); }
+
+		template<typename T>
+		const ResourcePool<T>& get() const { return std::get<ResourcePool<T>>(m_pools); }
+
+		template<typename T>
+		T* resolve(const ResourceHandle<T> handle) const { return get<T>().get(handle); }
+
+	private:
+		std::tuple<
+			ResourcePool<Mesh>,
+			ResourcePool<Material>,
+			ResourcePool<Image>,
+			ResourcePool<DensityGrid>
+		> m_pools;
+	};
+}
@@ -0,0 +1,155 @@
+#include "resources/types/animation_clip.hpp"
+
+namespace PXTEngine {
+
+	AnimationClip::AnimationClip(const Skeleton& skeleton, const std::vector<Channel>& channels, const float sampleRate)
+		: m_jointCount(skeleton.getJointCount()), m_sampleRate(sampleRate) {
+		PXT_ASSERT(m_sampleRate > 0.0f, "The animation sample rate must be positive");
+
+		for (const Channel& channel : channels) {
+			PXT_ASSERT(channel.times.size() == channel.values.size(), "Animation channel times and values do not match");
+			PXT_ASSERT(channel.jointIndex < m_jointCount, "Animation channel targets a joint outside the skeleton");
+
+			if (!channel.times.empty()) {
+				m_duration = std::max(m_duration, channel.times.back());
+			}
+		}
+
+		m_frameCount = static_cast<uint32_t>(std::ceil(m_duration * m_sampleRate)) + 1;
+
+		m_tracks.resize(static_cast<size_t>(m_frameCount) * TrackComponentCount * m_jointCount);
+
+		// joints without channels keep the rest pose in every frame
+		const SkeletonPose& restPose = skeleton.getRestPose();
+		for (uint32_t frame = 0; frame < m_frameCount; frame++) {
+			for (uint32_t joint = 0; joint < m_jointCount; joint++) {
+				const glm::quat& rotation = restPose.rotations[joint];
+
+				setTransform(frame, joint, Path::Translation, glm::vec4(restPose.translations[joint], 0.0f));
+				setTransform(frame, joint, Path::Rotation, { rotation.x, rotation.y, rotation.z, rotation.w });
+				setTransform(frame, joint, Path::Scale, glm::vec4(restPose.scales[joint], 0.0f));
+			}
+		}
+
+		for (const Channel& channel : channels) {
+			if (channel.times.empty()) continue;
+
+			for (uint32_t frame = 0; frame < m_frameCount; frame++) {
+				const float time = std::min(static_cast<float>(frame) / m_sampleRate, m_duration);
+				setTransform(frame, channel.jointIndex, channel.path, sampleChannel(channel, time));
+			}
+		}
+	}
+
+	void AnimationClip::setTransform(const uint32_t frame, const uint32_t joint, const Path path, const glm::vec4& value) {
+		const uint32_t firstComponent = path == Path::Translation ? TranslationX : path == Path::Rotation ? RotationX : ScaleX;
+		const uint32_t componentCount = path == Path::Rotation ? 4 : 3;
+
+		for (uint32_t i = 0; i < componentCount; i++) {
+			getTrack(frame, firstComponent + i)[joint] = value[i];
+		}
+	}
+
+	glm::vec4 AnimationClip::sampleChannel(const Channel& channel, const float time) {
+		const std::vector<float>& times = channel.times;
+
+		if (time <= times.front()) return channel.values.front();
+		if (time >= times.back()) return channel.values.back();
+
+		const size_t next = std::upper_bound(times.begin(), times.end(), time) - times.begin();
+		const size_t previous = next - 1;
+
+		if (channel.interpolation == Interpolation::Step) {
+			return channel.values[previous];
+		}
+
+		const float alpha = (time - times[previous]) / (times[next] - times[previous]);
+
+		if (channel.path == Path::Rotation) {
+			const glm::vec4& a = channel.values[previous];
+			const glm::vec4& b = channel.values[next];
+			const glm::quat rotation = glm::slerp(glm::quat(a.w, a.x, a.y, a.z), glm::quat(b.w, b.x, b.y, b.z), alpha);
+
+			return { rotation.x, rotation.y, rotation.z, rotation.w };
+		}
+
+		return glm::mix(channel.values[previous], channel.values[next], alpha);
+	}
+
+	void AnimationClip::sample(const float time, SkeletonPose& pose) const {
+		pose.resize(m_jointCount);
+
+		// the two frames and the blend factor are the same for every joint
+		const float framePosition = std::clamp(time, 0.0f, m_duration) * m_sampleRate;
+		const uint32_t frame0 = std::min(static_cast<uint32_t>(framePosition), m_frameCount - 1);
+		const uint32_t frame1 = std::min(frame0 + 1, m_frameCount - 1);
+		const float alpha = framePosition - static_cast<float>(frame0);
+
+		const uint32_t jointCount = m_jointCount;
+
+		// blended with the same layout as a frame
+		FrameVector<float> blended(static_cast<size_t>(TrackComponentCount) * jointCount);
+		const auto getBlendedTrack = [&](const uint32_t component) {
+			return blended.data() + static_cast<size_t>(component) * jointCount;
+		};
+
+		for (const uint32_t component : { TranslationX, TranslationY, TranslationZ, ScaleX, ScaleY, ScaleZ }) {
+			const float* track0 = getTrack(frame0, component);
+			const float* track1 = getTrack(frame1, component);
+			float* output = getBlendedTrack(component);
+
+			for (uint32_t j = 0; j < jointCount; j++) {
+				output[j] = track0[j] + (track1[j] - track0[j]) * alpha;
+			}
+		}
+
+		// frames are close enough for a normalized lerp, the sign of the weight of the second
+		// frame keeps the shortest path
+		FrameVector<float> weights(jointCount, 0.0f);
+		for (uint32_t component = RotationX; component <= RotationW; component++) {
+			const float* track0 = getTrack(frame0, component);
+			const float* track1 = getTrack(frame1, component);
+
+			for (uint32_t j = 0; j < jointCount; j++) {
+				weights[j] += track0[j] * track1[j];
+			}
+		}
+
+		for (uint32_t j = 0; j < jointCount; j++) {
+			weights[j] = weights[j] < 0.0f ? -alpha : alpha;
+		}
+
+		for (uint32_t component = RotationX; component <= RotationW; component++) {
+			const float* track0 = getTrack(frame0, component);
+			const float* track1 = getTrack(frame1, component);
+			float* output = getBlendedTrack(component);
+
+			for (uint32_t j = 0; j < jointCount; j++) {
+				output[j] = track0[j] * (1.0f - alpha) + track1[j] * weights[j];
+			}
+		}
+
+		const float* x = getBlendedTrack(RotationX);
+		const float* y = getBlendedTrack(RotationY);
+		const float* z = getBlendedTrack(RotationZ);
+		const float* w = getBlendedTrack(RotationW);
+
+		// the weights are reused for the inverse lengths of the rotations
+		for (uint32_t j = 0; j < jointCount; j++) {
+			weights[j] = 1.0f / std::sqrt(x[j] * x[j] + y[j] * y[j] + z[j] * z[j] + w[j] * w[j]);
+		}
+
+		const float* translationX = getBlendedTrack(TranslationX);
+		const float* translationY = getBlendedTrack(TranslationY);
+		const float* translationZ = getBlendedTrack(TranslationZ);
+		const float* scaleX = getBlendedTrack(ScaleX);
+		const float* scaleY = getBlendedTrack(ScaleY);
+		const float* scaleZ = getBlendedTrack(ScaleZ);
+
+		for (uint32_t j = 0; j < jointCount; j++) {
+			pose.translations[j] = { translationX[j], translationY[j], translationZ[j] };
+			pose.rotations[j] = glm::quat(w[j] * weights[j], x[j] * weights[j], y[j] * weights[j], z[j] * weights[j]);
+			pose.scales[j] = { scaleX[j], scaleY[j], scaleZ[j] };
+		}
+	}
+}
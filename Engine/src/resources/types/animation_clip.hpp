@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "resources/resource.hpp"
+#include "resources/types/skeleton.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @class AnimationClip
+	 *
+	 * @brief Represents a skeletal animation, the local transforms of the joints over time.
+	 *
+	 * The keyframes of the source channels (each with its own times) are resampled at a
+	 * fixed rate when the clip is created. All the joints then share the same frames, so a
+	 * pose is sampled by finding the two frames once and interpolating every joint with the
+	 * same factor. Each frame stores one track of floats per transform component, the
+	 * interpolation runs over these tracks in plain loops that the compiler can vectorize.
+	 */
+	class AnimationClip : public Resource {
+	public:
+		static constexpr float DEFAULT_SAMPLE_RATE = 30.0f;
+
+		enum class Path : uint8_t {
+			Translation,
+			Rotation,
+			Scale,
+		};
+
+		enum class Interpolation : uint8_t {
+			Step,
+			Linear,
+		};
+
+		/**
+		 * @brief Source animation data of one component of a joint.
+		 * Rotation values are quaternions stored as (x, y, z, w), the others only use xyz.
+		 */
+		struct Channel {
+			uint32_t jointIndex = 0;
+			Path path = Path::Translation;
+			Interpolation interpolation = Interpolation::Linear;
+			std::vector<float> times;
+			std::vector<glm::vec4> values;
+		};
+
+		/**
+		 * @brief Creates the clip by resampling the channels.
+		 *
+		 * @param skeleton The skeleton the clip animates, joints without channels keep the rest pose.
+		 * @param channels The source keyframes.
+		 * @param sampleRate Frames per second of the resampled clip.
+		 */
+		AnimationClip(const Skeleton& skeleton, const std::vector<Channel>& channels, float sampleRate = DEFAULT_SAMPLE_RATE);
+
+		Type getType() const override { return Type::AnimationClip; }
+
+		float getDuration() const { return m_duration; }
+		uint32_t getJointCount() const { return m_jointCount; }
+
+		/**
+		 * @brief Evaluates the local transforms of all the joints at the given time.
+		 *
+		 * @param time Time in seconds, clamped to the clip duration.
+		 * @param pose Output, resized to the number of joints.
+		 */
+		void sample(float time, SkeletonPose& pose) const;
+
+	private:
+		// the components of a joint transform, each one is a track of the frames
+		enum TrackComponent : uint32_t {
+			TranslationX, TranslationY, TranslationZ,
+			RotationX, RotationY, RotationZ, RotationW,
+			ScaleX, ScaleY, ScaleZ,
+			TrackComponentCount
+		};
+
+		static glm::vec4 sampleChannel(const Channel& channel, float time);
+
+		/**
+		 * @brief Writes a component of a joint at a frame, in the layout of the channel values.
+		 */
+		void setTransform(uint32_t frame, uint32_t joint, Path path, const glm::vec4& value);
+
+		float* getTrack(const uint32_t frame, const uint32_t component) {
+			return m_tracks.data() + (static_cast<size_t>(frame) * TrackComponentCount + component) * m_jointCount;
+		}
+		const float* getTrack(const uint32_t frame, const uint32_t component) const {
+			return m_tracks.data() + (static_cast<size_t>(frame) * TrackComponentCount + component) * m_jointCount;
+		}
+
+		uint32_t m_jointCount = 0;
+		uint32_t m_frameCount = 0;
+		float m_sampleRate = DEFAULT_SAMPLE_RATE;
+		float m_duration = 0.0f;
+
+		// frame-major, then component: component c of joint j at frame f is at
+		// [(f * TrackComponentCount + c) * m_jointCount + j], see getTrack()
+		std::vector<float> m_tracks;
+	};
+}
@@ -0,0 +1,66 @@
+#include "resources/types/density_grid.hpp"
+
+namespace PXTEngine {
+
+	namespace {
+		// same hash of the density_texture compute shader
+		glm::vec3 hash33(const glm::vec3& p) {
+			const glm::vec3 q{
+				glm::dot(p, glm::vec3(127.1f, 311.7f, 74.7f)),
+				glm::dot(p, glm::vec3(269.5f, 183.3f, 246.1f)),
+				glm::dot(p, glm::vec3(113.5f, 271.9f, 124.6f))
+			};
+			return glm::fract(glm::sin(q) * 43758.5453123f);
+		}
+
+		float worleyNoise(const glm::vec3& p, const int frequency) {
+			const glm::vec3 i = glm::floor(p);
+			const glm::vec3 f = p - i;
+
+			float minDistanceSq = 100.0f;
+
+			for (int z = -1; z <= 1; z++) {
+				for (int y = -1; y <= 1; y++) {
+					for (int x = -1; x <= 1; x++) {
+						const glm::ivec3 neighborCell = glm::ivec3(i) + glm::ivec3(x, y, z);
+
+						// wrap around the frequency to make the noise tileable (same as GLSL's % on ints)
+						const glm::ivec3 periodicCell{
+							neighborCell.x % frequency,
+							neighborCell.y % frequency,
+							neighborCell.z % frequency
+						};
+
+						const glm::vec3 toPoint = glm::vec3(x, y, z) + hash33(glm::vec3(periodicCell)) - f;
+						minDistanceSq = std::min(minDistanceSq, glm::dot(toPoint, toPoint));
+					}
+				}
+			}
+
+			return std::sqrt(minDistanceSq);
+		}
+	}
+
+	Shared<DensityGrid> DensityGrid::createWorley(const glm::uvec3 resolution, const float frequency, const float exponent) {
+		const int periodicFrequency = std::max(static_cast<int>(frequency + 0.5f), 1);
+
+		std::vector<float> values(static_cast<size_t>(resolution.x) * resolution.y * resolution.z);
+
+		size_t index = 0;
+		for (uint32_t z = 0; z < resolution.z; z++) {
+			for (uint32_t y = 0; y < resolution.y; y++) {
+				for (uint32_t x = 0; x < resolution.x; x++) {
+					const glm::vec3 uvw = glm::vec3(x, y, z) / glm::vec3(resolution);
+					const float distance = worleyNoise(uvw * frequency, periodicFrequency);
+
+					values[index++] = std::pow(std::clamp(1.0f - distance, 0.0f, 1.0f), exponent);
+				}
+			}
+		}
+
+		Shared<DensityGrid> grid = createShared<DensityGrid>(resolution, std::move(values));
+		grid->m_worleyParams = WorleyParams{ resolution, frequency, exponent };
+
+		return grid;
+	}
+}
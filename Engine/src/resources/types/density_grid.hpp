@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "resources/resource.hpp"
+
+namespace PXTEngine {
+
+	/**
+	 * @class DensityGrid
+	 *
+	 * @brief Represents a dense grid of density values for a participating medium.
+	 *
+	 * The grid covers the [-1, 1] cube in the object space of the volume it is assigned to,
+	 * values are stored in x-major order (x, then y, then z) and are expected to be >= 0.
+	 * On the GPU the grids are not uploaded as they are: they are split in bricks and stored
+	 * in the shared VolumeBrickAtlas.
+	 */
+	class DensityGrid : public Resource {
+	public:
+		/**
+		 * @brief The parameters of a grid generated by createWorley, kept so that the scene
+		 * serializer can save the grid as the way to generate it again.
+		 */
+		struct WorleyParams {
+			glm::uvec3 resolution{ 64 };
+			float frequency = 4.0f;
+			float exponent = 2.0f;
+		};
+
+		DensityGrid(const glm::uvec3 resolution, std::vector<float> values)
+			: m_resolution(resolution), m_values(std::move(values)) {
+			PXT_ASSERT(m_values.size() == static_cast<size_t>(resolution.x) * resolution.y * resolution.z,
+				"The number of density values does not match the grid resolution");
+		}
+
+		/**
+		 * @brief Creates a tileable Worley noise grid, the same noise generated on the GPU
+		 * by the density_texture compute shader.
+		 *
+		 * @param resolution Number of values per axis.
+		 * @param frequency Number of noise cells per axis.
+		 * @param exponent Falloff exponent applied to the inverted distance.
+		 * @return The generated grid.
+		 */
+		static Shared<DensityGrid> createWorley(glm::uvec3 resolution, float frequency, float exponent);
+
+		Type getType() const override { return Type::DensityGrid; }
+
+		const glm::uvec3& getResolution() const { return m_resolution; }
+		const std::vector<float>& getValues() const { return m_values; }
+
+		// set only for the grids created by createWorley
+		const std::optional<WorleyParams>& getWorleyParams() const { return m_worleyParams; }
+
+		float at(const uint32_t x, const uint32_t y, const uint32_t z) const {
+			return m_values[(static_cast<size_t>(z) * m_resolution.y + y) * m_resolution.x + x];
+		}
+
+	private:
+		glm::uvec3 m_resolution;
+		std::vector<float> m_values;
+		std::optional<WorleyParams> m_worleyParams;
+	};
+}
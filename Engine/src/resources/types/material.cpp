@@ -58,7 +58,32 @@ namespace PXTEngine {
     float Material::getBlinnPhongSpecularIntensity() const { return m_blinnPhongSpecularIntensity;}
     float Material::getBlinnPhongSpecularShininess() const { return m_blinnPhongSpecularShininess; }
 
-    bool Material::isEmissive() {
+    void Material::setMetallic(const float metallic) {
+		m_metallic = metallic;
+		markDirty();
+	}
+
+	void Material::setRoughness(const float roughness) {
+		m_roughness = roughness;
+		markDirty();
+	}
+
+	void Material::setEmissiveColor(const glm::vec4& color) {
+		m_emissiveColor = color;
+		markDirty();
+	}
+
+	void Material::setTransmission(const float transmission) {
+		m_transmission = transmission;
+		markDirty();
+	}
+
+	void Material::setIndexOfRefraction(const float ior) {
+		m_ior = ior;
+		markDirty();
+	}
+
+    bool Material::isEmissive() const {
         return m_emissiveColor.a > 0.0f;
     }
 
@@ -171,8 +196,12 @@ namespace PXTEngine {
 
 	// -------- UI --------
     void Material::drawMaterialUi() {
-        ImGui::SliderFloat("Metallic", &m_metallic, 0.0f, 1.0f);
-        ImGui::SliderFloat("Roughness", &m_roughness, 0.0f, 1.0f);
+        // every widget reports whether it changed the value, so that
+        // the material version is bumped only on actual edits
+        bool changed = false;
+
+        changed |= ImGui::SliderFloat("Metallic", &m_metallic, 0.0f, 1.0f);
+        changed |= ImGui::SliderFloat("Roughness", &m_roughness, 0.0f, 1.0f);
 
         if (ImGui::TreeNode("Textures (Work in progress)")) {
             // TODO: handle texture window on selection
@@ -207,17 +236,21 @@ namespace PXTEngine {
 			ImGui::TreePop();
         }
 
-		ImGui::ColorEdit3("Emissive Color", glm::value_ptr(m_emissiveColor));
-		ImGui::SliderFloat("Emissive Intensity", &m_emissiveColor.a, 0.0f, 100.0f);
+		changed |= ImGui::ColorEdit3("Emissive Color", glm::value_ptr(m_emissiveColor));
+		changed |= ImGui::SliderFloat("Emissive Intensity", &m_emissiveColor.a, 0.0f, 100.0f);
 
-		ImGui::SliderFloat("Transmission", &m_transmission, 0.0f, 1.0f);
-		ImGui::SliderFloat("Index of Refraction", &m_ior, 1.0f, 3.0f);
+		changed |= ImGui::SliderFloat("Transmission", &m_transmission, 0.0f, 1.0f);
+		changed |= ImGui::SliderFloat("Index of Refraction", &m_ior, 1.0f, 3.0f);
 
         if (ImGui::TreeNode("Blinn-Phong Specular Parameters")) {
-            ImGui::SliderFloat("Specular Intensity", &m_blinnPhongSpecularIntensity, 0.0f, 1.0f);
-            ImGui::SliderFloat("Specular Shininess", &m_blinnPhongSpecularShininess, 1.0f, 50.0f);
+            changed |= ImGui::SliderFloat("Specular Intensity", &m_blinnPhongSpecularIntensity, 0.0f, 1.0f);
+            changed |= ImGui::SliderFloat("Specular Shininess", &m_blinnPhongSpecularShininess, 1.0f, 50.0f);
 
             ImGui::TreePop();
-        }   
+        }
+
+        if (changed) {
+            markDirty();
+        }
     }
 }
\ No newline at end of file
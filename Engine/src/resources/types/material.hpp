@@ -88,13 +88,28 @@ namespace PXTEngine {
         float getBlinnPhongSpecularIntensity() const;
         float getBlinnPhongSpecularShininess() const;
 
-        /*void setMetallic(float metallic) { m_metallic = metallic; }
-		void setRoughness(float roughness) { m_roughness = roughness; }
-		void setEmissiveColor(const glm::vec4& color) { m_emissiveColor = color; }
-		void setTransmission(float transmission) { m_transmission = transmission; }
-		void setIndexOfRefraction(float ior) { m_ior = ior; }*/
+        void setMetallic(float metallic);
+		void setRoughness(float roughness);
+		void setEmissiveColor(const glm::vec4& color);
+		void setTransmission(float transmission);
+		void setIndexOfRefraction(float ior);
 
-        bool isEmissive();
+        /**
+         * @brief Returns the version of the material parameters.
+         * The version is incremented every time a parameter changes (through a setter
+         * or the material UI), so consumers that cache GPU data (e.g. MaterialRegistry)
+         * can detect when their copy is stale.
+         *
+         * @return The current version of the material.
+         */
+        uint32_t getVersion() const { return m_version; }
+
+        /**
+         * @brief Marks the material as modified, bumping its version.
+         */
+        void markDirty() { m_version++; }
+
+        bool isEmissive() const;
 
         void drawMaterialUi();
 
@@ -113,5 +128,7 @@ namespace PXTEngine {
 		float m_ior{ 1.3f };
         float m_blinnPhongSpecularIntensity{ 0.0 };
         float m_blinnPhongSpecularShininess{ 1.0 };
+
+        uint32_t m_version = 0;
     };
 }
\ No newline at end of file
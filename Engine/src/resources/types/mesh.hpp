@@ -43,10 +43,52 @@ namespace PXTEngine {
             }
         };
 
+        /**
+         * @struct SkinWeights
+         *
+         * @brief Optional per-vertex stream of skinned meshes: the joints that move the vertex
+         * (indices in the Skeleton) and how much each of them contributes.
+         */
+        struct alignas(16) SkinWeights {
+            glm::uvec4 joints{ 0 };
+            glm::vec4 weights{ 0.0f }; // expected to sum to 1
+        };
+
         virtual const uint32_t getVertexCount() const = 0;
         virtual const uint32_t getIndexCount() const  = 0;
 
+        /**
+         * @brief Object space sphere enclosing the vertices: center (xyz) and radius (w).
+         */
+        const glm::vec4& getBoundingSphere() const { return m_boundingSphere; }
+
         static Type getStaticType() { return Type::Mesh; }
+
+        /**
+         * @brief Sphere centered in the bounding box of the vertices, large enough to contain them.
+         */
+        static glm::vec4 computeBoundingSphere(const std::vector<Vertex>& vertices) {
+            if (vertices.empty()) return glm::vec4(0.0f);
+
+            glm::vec3 min = vertices[0].position;
+            glm::vec3 max = vertices[0].position;
+            for (const Vertex& vertex : vertices) {
+                min = glm::min(min, glm::vec3(vertex.position));
+                max = glm::max(max, glm::vec3(vertex.position));
+            }
+
+            const glm::vec3 center = (min + max) * 0.5f;
+            float radiusSquared = 0.0f;
+            for (const Vertex& vertex : vertices) {
+                const glm::vec3 offset = glm::vec3(vertex.position) - center;
+                radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+            }
+
+            return glm::vec4(center, std::sqrt(radiusSquared));
+        }
+
+    protected:
+        glm::vec4 m_boundingSphere{ 0.0f };
     };
 }
 
@@ -0,0 +1,42 @@
+#include "resources/types/skeleton.hpp"
+
+namespace PXTEngine {
+
+	Skeleton::Skeleton(std::vector<Joint> joints, SkeletonPose restPose, const glm::mat4& rootTransform)
+		: m_joints(std::move(joints)), m_restPose(std::move(restPose)), m_rootTransform(rootTransform) {
+		PXT_ASSERT(m_restPose.getJointCount() == m_joints.size(), "The rest pose does not match the skeleton joints");
+
+		for (size_t i = 0; i < m_joints.size(); i++) {
+			PXT_ASSERT(m_joints[i].parentIndex < static_cast<int32_t>(i), "Skeleton joints must be sorted parents first");
+		}
+	}
+
+	void Skeleton::computeSkinningMatrices(const SkeletonPose& pose, std::vector<glm::mat4>& skinningMatrices) const {
+		const size_t jointCount = m_joints.size();
+		PXT_ASSERT(pose.getJointCount() == jointCount, "The pose does not match the skeleton joints");
+
+		skinningMatrices.resize(jointCount);
+
+		// local transforms, independent for each joint
+		for (size_t i = 0; i < jointCount; i++) {
+			glm::mat4 local = glm::mat4_cast(pose.rotations[i]);
+			local[0] *= pose.scales[i].x;
+			local[1] *= pose.scales[i].y;
+			local[2] *= pose.scales[i].z;
+			local[3] = glm::vec4(pose.translations[i], 1.0f);
+
+			skinningMatrices[i] = local;
+		}
+
+		// model space transforms, the parent is always already computed
+		for (size_t i = 0; i < jointCount; i++) {
+			const int32_t parent = m_joints[i].parentIndex;
+			skinningMatrices[i] = (parent != NO_PARENT ? skinningMatrices[parent] : m_rootTransform) * skinningMatrices[i];
+		}
+
+		// the inverse bind matrices can only be applied once all the joints are in model space
+		for (size_t i = 0; i < jointCount; i++) {
+			skinningMatrices[i] = skinningMatrices[i] * m_joints[i].inverseBindMatrix;
+		}
+	}
+}
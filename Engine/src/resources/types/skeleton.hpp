@@ -0,0 +1,82 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "resources/resource.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace PXTEngine {
+
+	/**
+	 * @struct SkeletonPose
+	 *
+	 * @brief Local transforms of all the joints of a skeleton.
+	 * Stored as one array per component (structure of arrays) so that the poses can be
+	 * evaluated and blended with tight loops over the joints.
+	 */
+	struct SkeletonPose {
+		std::vector<glm::vec3> translations;
+		std::vector<glm::quat> rotations;
+		std::vector<glm::vec3> scales;
+
+		void resize(const size_t jointCount) {
+			translations.resize(jointCount, glm::vec3(0.0f));
+			rotations.resize(jointCount, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+			scales.resize(jointCount, glm::vec3(1.0f));
+		}
+
+		size_t getJointCount() const { return translations.size(); }
+	};
+
+	/**
+	 * @class Skeleton
+	 *
+	 * @brief Represents the joint hierarchy a skinned mesh is bound to.
+	 *
+	 * Joints are sorted so that every parent comes before its children, this way
+	 * the model space transforms can be computed with a single pass over the joints.
+	 * The joint indices of the mesh skin weights refer to this order.
+	 */
+	class Skeleton : public Resource {
+	public:
+		static constexpr int32_t NO_PARENT = -1;
+
+		struct Joint {
+			std::string name;
+			int32_t parentIndex = NO_PARENT;
+			glm::mat4 inverseBindMatrix{ 1.0f }; // from model space to the joint space in bind pose
+		};
+
+		/**
+		 * @param joints The joints, sorted parents first.
+		 * @param restPose The local transforms of the joints when no animation is applied.
+		 * @param rootTransform Transform applied to the joints without a parent (e.g. the
+		 *                      nodes above the skeleton in the source file).
+		 */
+		Skeleton(std::vector<Joint> joints, SkeletonPose restPose, const glm::mat4& rootTransform = glm::mat4(1.0f));
+
+		Type getType() const override { return Type::Skeleton; }
+
+		uint32_t getJointCount() const { return static_cast<uint32_t>(m_joints.size()); }
+		const std::vector<Joint>& getJoints() const { return m_joints; }
+
+		/**
+		 * @brief The local transforms of the joints when no animation is applied.
+		 */
+		const SkeletonPose& getRestPose() const { return m_restPose; }
+
+		/**
+		 * @brief Computes the matrices used to skin the mesh vertices (model space pose
+		 * of each joint times its inverse bind matrix).
+		 *
+		 * @param pose The local transforms of the joints.
+		 * @param skinningMatrices Output, resized to the number of joints.
+		 */
+		void computeSkinningMatrices(const SkeletonPose& pose, std::vector<glm::mat4>& skinningMatrices) const;
+
+	private:
+		std::vector<Joint> m_joints;
+		SkeletonPose m_restPose;
+		glm::mat4 m_rootTransform;
+	};
+}
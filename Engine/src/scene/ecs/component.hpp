@@ -4,6 +4,10 @@
 #include "core/uuid.hpp"
 #include "resources/types/mesh.hpp"
 #include "resources/types/material.hpp" 
+#include "resources/types/density_grid.hpp"
+#include "resources/types/skeleton.hpp"
+#include "resources/types/animation_clip.hpp"
+#include "resources/resource_handle.hpp"
 #include "scene/camera.hpp"       
            
 
@@ -46,6 +50,12 @@ namespace PXTEngine
 		operator const glm::vec3& () const { return color; }
 	};
 
+	/**
+	 * @struct VolumeComponent
+	 *
+	 * @brief The participating medium inside the mesh of an entity. Can be edited in place,
+	 * the render packets of the volumes are rebuilt every frame.
+	 */
 	struct VolumeComponent {
 		struct Volume {
 			glm::vec4 absorption{0.0f};
@@ -55,8 +65,9 @@ namespace PXTEngine
 			// phaseFunctionG > 0.0 for forward scattering
 			// phaseFunctionG < 0.0 for backward scattering
 			float phaseFunctionG = 0;
-			Shared<Image> densityTexture{};
-			Shared<Image> detailTexture{}; // for edge details of the volume
+			ResourceHandle<Image> densityTexture{};
+			ResourceHandle<Image> detailTexture{}; // for edge details of the volume
+			ResourceHandle<DensityGrid> densityGrid{}; // if not set the procedural density volume is used
 		};
 
 		Volume volume;
@@ -83,16 +94,21 @@ namespace PXTEngine
 				return *this;
 			}
 
-			Builder& setDensityTexture(Shared<Image> texture) {
+			Builder& setDensityTexture(ResourceHandle<Image> texture) {
 				volume.densityTexture = texture;
 				return *this;
 			}
 
-			Builder& setDetailTexture(Shared<Image> texture) {
+			Builder& setDetailTexture(ResourceHandle<Image> texture) {
 				volume.detailTexture = texture;
 				return *this;
 			}
 
+			Builder& setDensityGrid(ResourceHandle<DensityGrid> densityGrid) {
+				volume.densityGrid = densityGrid;
+				return *this;
+			}
+
 			VolumeComponent build() {
 				return VolumeComponent(volume);
 			}
@@ -100,8 +116,16 @@ namespace PXTEngine
 	
 	};
 
+	/**
+	 * @struct MaterialComponent
+	 *
+	 * @brief The material of an entity with a mesh. The fields and the parameters of the
+	 * material (through its setters, which bump its version) can be edited in place, the
+	 * render packet is checked against the handle, the tint, the tiling and the material
+	 * version it was built from.
+	 */
 	struct MaterialComponent {
-		Shared<Material> material;
+		ResourceHandle<Material> material;
 		float tilingFactor = 1.0f;
 		glm::vec3 tint{ 1.0f };
 
@@ -109,16 +133,16 @@ namespace PXTEngine
 
 		MaterialComponent(const MaterialComponent&) = default;
 		
-		MaterialComponent(const Shared<Material>& material, float tilingFactor, const glm::vec3& tint)
+		MaterialComponent(ResourceHandle<Material> material, float tilingFactor, const glm::vec3& tint)
 			: material(material), tilingFactor(tilingFactor), tint(tint) {
 		}
 
 		struct Builder {
-			Shared<Material> material;
+			ResourceHandle<Material> material;
 			float tilingFactor = 1.0f;
 			glm::vec3 tint{ 1.0f };
 
-			Builder& setMaterial(const Shared<Material>& material) {
+			Builder& setMaterial(ResourceHandle<Material> material) {
 				this->material = material;
 				return *this;
 			}
@@ -186,8 +210,65 @@ namespace PXTEngine
 		 *
 		 * @return glm::mat4
 		 */
-		glm::mat4 mat4();
-		glm::mat3 normalMatrix();
+		glm::mat4 mat4() const {
+			const float c3 = glm::cos(rotation.z);
+			const float s3 = glm::sin(rotation.z);
+			const float c2 = glm::cos(rotation.x);
+			const float s2 = glm::sin(rotation.x);
+			const float c1 = glm::cos(rotation.y);
+			const float s1 = glm::sin(rotation.y);
+			return glm::mat4{
+				{
+					scale.x * (c1 * c3 + s1 * s2 * s3),
+					scale.x * (c2 * s3),
+					scale.x * (c1 * s2 * s3 - c3 * s1),
+					0.0f,
+				},
+				{
+					scale.y * (c3 * s1 * s2 - c1 * s3),
+					scale.y * (c2 * c3),
+					scale.y * (c1 * c3 * s2 + s1 * s3),
+					0.0f,
+				},
+				{
+					scale.z * (c2 * s1),
+					scale.z * (-s2),
+					scale.z * (c1 * c2),
+					0.0f,
+				},
+				{translation.x, translation.y, translation.z, 1.0f} };
+		}
+
+		/**
+		 * @brief Inverse transpose of the upper 3x3 of mat4(), to transform normals.
+		 */
+		glm::mat3 normalMatrix() const {
+			const float c3 = glm::cos(rotation.z);
+			const float s3 = glm::sin(rotation.z);
+			const float c2 = glm::cos(rotation.x);
+			const float s2 = glm::sin(rotation.x);
+			const float c1 = glm::cos(rotation.y);
+			const float s1 = glm::sin(rotation.y);
+			const glm::vec3 inverseScale = 1.0f / scale;
+
+			return glm::mat3{
+				{
+					inverseScale.x * (c1 * c3 + s1 * s2 * s3),
+					inverseScale.x * (c2 * s3),
+					inverseScale.x * (c1 * s2 * s3 - c3 * s1),
+				},
+				{
+					inverseScale.y * (c3 * s1 * s2 - c1 * s3),
+					inverseScale.y * (c2 * c3),
+					inverseScale.y * (c1 * c3 * s2 + s1 * s3),
+				},
+				{
+					inverseScale.z * (c2 * s1),
+					inverseScale.z * (-s2),
+					inverseScale.z * (c1 * c2),
+				},
+			};
+		}
 
 		TransformComponent() = default;
 		TransformComponent(const TransformComponent&) = default;
@@ -205,16 +286,113 @@ namespace PXTEngine
 		}
 
 		// Conversion operator calling the mat4 function
-		operator glm::mat4() { return mat4(); }
+		operator glm::mat4() const { return mat4(); }
 	};
 
+	/**
+	 * @struct MeshComponent
+	 *
+	 * @brief The mesh of an entity, adding it adds the RenderPacketComponent. The handles can
+	 * be edited in place, the render packet is checked against the render mesh it was built from.
+	 */
 	struct MeshComponent {
-		Shared<Mesh> mesh;
+		ResourceHandle<Mesh> mesh;
+
+		// per-entity copy of a skinned mesh, written by the skinning pass (not serialized)
+		ResourceHandle<Mesh> deformedMesh{};
 
 		MeshComponent() = default;
 		MeshComponent(const MeshComponent&) = default;
 
-		MeshComponent(const Shared<Mesh>& mesh) : mesh(mesh) {}
+		MeshComponent(ResourceHandle<Mesh> mesh) : mesh(mesh) {}
+
+		/**
+		 * @brief The mesh to draw and trace: the deformed one if the entity is skinned.
+		 */
+		ResourceHandle<Mesh> getRenderMesh() const {
+			return deformedMesh ? deformedMesh : mesh;
+		}
+	};
+
+	/**
+	 * @struct RenderPacketComponent
+	 *
+	 * @brief The draw data the renderer prepared for an entity with a mesh, rebuilt only when
+	 * what it was built from changes (see RayTracingSceneData::build) and read as is when
+	 * the frame is recorded.
+	 *
+	 * The scene adds it with the MeshComponent and marks it dirty through the registry
+	 * signals when the mesh, material or volume components are added, replaced or removed.
+	 * The components are also edited in place (get<T>() returns a mutable reference), so
+	 * a packet is only reused if it was built from the same transform, render mesh,
+	 * material handle, tint, tiling and material version, which are cheap to compare.
+	 * Entity::patch forces a rebuild for anything else. Not serialized.
+	 */
+	struct RenderPacketComponent {
+		static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+		// the transform the packet was built from
+		glm::vec3 translation{};
+		glm::vec3 scale{};
+		glm::vec3 rotation{};
+		glm::mat4 objectToWorld{ 1.0f };
+
+		ResourceHandle<Mesh> meshHandle{};
+		Mesh* mesh = nullptr; // the render mesh, nullptr if the handle did not resolve
+
+		// the material component the packet was built from
+		ResourceHandle<Material> materialHandle{};
+		const Material* material = nullptr; // nullptr if the handle did not resolve
+		uint32_t materialVersion = 0;
+		float tilingFactor = 1.0f;
+		glm::vec3 tint{ 1.0f };
+
+		VkDeviceAddress blasAddress = 0;
+		uint32_t objectIndex = INVALID_INDEX; // slot in the scene buffer, INVALID_INDEX if the entity is not rendered
+		uint32_t emitterIndex = INVALID_INDEX;
+		uint32_t emitterFaceCount = 0;
+		uint32_t materialFeatures = 0; // MaterialFeature flags, the raster shader variant of the material
+		bool hasMaterial = false;
+		bool hasVolume = false;
+		bool isDirty = true;
+
+		bool isBuiltFrom(const TransformComponent& transform) const {
+			return translation == transform.translation && scale == transform.scale && rotation == transform.rotation;
+		}
+
+		/**
+		 * @param materialComponent The material component of the entity, nullptr if it has none.
+		 * @param material The material it resolves to.
+		 */
+		bool isBuiltFrom(const MaterialComponent* materialComponent, const Material* material) const {
+			if (materialComponent == nullptr) return !hasMaterial;
+
+			return hasMaterial &&
+				materialHandle == materialComponent->material &&
+				this->material == material &&
+				(material == nullptr || materialVersion == material->getVersion()) &&
+				tilingFactor == materialComponent->tilingFactor &&
+				tint == materialComponent->tint;
+		}
+	};
+
+	struct SkinnedMeshComponent {
+		Shared<Skeleton> skeleton;
+		Shared<AnimationClip> animation = nullptr; // if not set the skeleton stays in the rest pose
+		float time = 0.0f;
+		float speed = 1.0f;
+		bool isLooping = true;
+		bool isPlaying = true;
+
+		// evaluated every frame by the scene update
+		SkeletonPose pose{};
+		std::vector<glm::mat4> skinningMatrices{};
+
+		SkinnedMeshComponent() = default;
+		SkinnedMeshComponent(const SkinnedMeshComponent&) = default;
+
+		SkinnedMeshComponent(const Shared<Skeleton>& skeleton, const Shared<AnimationClip>& animation = nullptr)
+			: skeleton(skeleton), animation(animation) {}
 	};
 
 	class Script; // Forward declaration of Script class			
@@ -256,4 +434,9 @@ namespace PXTEngine
 		
 		PointLightComponent(const float intensity) : lightIntensity(intensity) {}
 	};
+
+	// the components referring to resources are copied without touching any reference count
+	static_assert(std::is_trivially_copyable_v<VolumeComponent>);
+	static_assert(std::is_trivially_copyable_v<MaterialComponent>);
+	static_assert(std::is_trivially_copyable_v<MeshComponent>);
 }
\ No newline at end of file
@@ -74,6 +74,19 @@ namespace PXTEngine {
             return m_scene->m_registry.emplace<Component>(m_enttEntity, std::forward<Args>(args)...);
         }
 
+        /**
+         * @brief Notify that a component was changed in place, so that the data cached
+         * from it (e.g. the RenderPacketComponent) is rebuilt
+         *
+         * @tparam Component type
+         */
+        template <typename Component>
+        void patch() {
+            PXT_ASSERT(has<Component>(), "Entity does not have component");
+
+            m_scene->m_registry.patch<Component>(m_enttEntity);
+        }
+
         /**
          * @brief Remove a component from entity
          * 
@@ -5,6 +5,9 @@
 namespace PXTEngine {
 
 	void Environment::setSkybox(const std::array<std::string, 6>& skyboxTextures) {
-		m_skybox = VulkanSkybox::create(skyboxTextures);
+		Shared<VulkanSkybox> skybox = VulkanSkybox::create(skyboxTextures);
+
+		m_irradianceSH = skybox->getIrradianceSH();
+		m_skybox = skybox;
 	}
 }
\ No newline at end of file
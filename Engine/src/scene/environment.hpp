@@ -2,6 +2,7 @@
 
 #include "core/pch.hpp"
 #include "scene/skybox.hpp"
+#include "graphics/ibl.hpp"
 
 namespace PXTEngine {
 
@@ -34,9 +35,19 @@ namespace PXTEngine {
 		 */
 		void setSkybox(const std::array<std::string, 6>& skyboxTextures);
 
+		/**
+		 * @brief Get the diffuse irradiance of the environment as spherical harmonics.
+		 * It is recomputed every time the skybox changes, without a skybox the environment
+		 * is a constant white radiance (so the ambient light alone controls the result).
+		 *
+		 * @return The irradiance spherical harmonics.
+		 */
+		const IBL::IrradianceSH& getIrradianceSH() const { return m_irradianceSH; }
+
 	private:
 		glm::vec4 m_ambientLight = glm::vec4{ 0.67f, 0.85f, 0.9f, .02f };
 
 		Shared<Skybox> m_skybox = nullptr; 
+		IBL::IrradianceSH m_irradianceSH = IBL::IrradianceSH::constant(glm::vec3(1.0f));
 	};
 }
\ No newline at end of file
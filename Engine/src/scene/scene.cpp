@@ -6,6 +6,50 @@
 
 namespace PXTEngine {
 
+    namespace {
+        void onMeshChanged(entt::registry& registry, const entt::entity entity) {
+            registry.get_or_emplace<RenderPacketComponent>(entity).isDirty = true;
+        }
+
+        void onMeshRemoved(entt::registry& registry, const entt::entity entity) {
+            registry.remove<RenderPacketComponent>(entity);
+        }
+
+        // the packet is never added here, these also run while the entity is being destroyed
+        void onRenderDataChanged(entt::registry& registry, const entt::entity entity) {
+            if (auto* packet = registry.try_get<RenderPacketComponent>(entity)) {
+                packet->isDirty = true;
+            }
+        }
+
+        void onSkinnedMeshRemoved(entt::registry& registry, const entt::entity entity) {
+            // back to the bind pose mesh, the deformed one is released by the skinning system
+            if (auto* meshComponent = registry.try_get<MeshComponent>(entity)) {
+                meshComponent->deformedMesh = {};
+            }
+        }
+    }
+
+    Scene::Scene() {
+        connectRenderPacketSignals();
+    }
+
+    void Scene::connectRenderPacketSignals() {
+        m_registry.on_construct<MeshComponent>().connect<&onMeshChanged>();
+        m_registry.on_update<MeshComponent>().connect<&onMeshChanged>();
+        m_registry.on_destroy<MeshComponent>().connect<&onMeshRemoved>();
+
+        m_registry.on_construct<MaterialComponent>().connect<&onRenderDataChanged>();
+        m_registry.on_update<MaterialComponent>().connect<&onRenderDataChanged>();
+        m_registry.on_destroy<MaterialComponent>().connect<&onRenderDataChanged>();
+
+        m_registry.on_construct<VolumeComponent>().connect<&onRenderDataChanged>();
+        m_registry.on_update<VolumeComponent>().connect<&onRenderDataChanged>();
+        m_registry.on_destroy<VolumeComponent>().connect<&onRenderDataChanged>();
+
+        m_registry.on_destroy<SkinnedMeshComponent>().connect<&onSkinnedMeshRemoved>();
+    }
+
     Entity Scene::createEntity(const std::string& name, UUID id) {
         Entity entity = { m_registry.create(), this };
 
@@ -49,10 +93,40 @@ namespace PXTEngine {
     }
 
     void Scene::onUpdate(float delta) {
+        PXT_ALLOCATION_SCOPE("Scene");
+
         getEntitiesWith<ScriptComponent>().each([=](auto entity, auto& scriptComponent) {
             
             scriptComponent.script->onUpdate(delta);
             
         });
+
+        // after the scripts, so the animations they change are applied in this frame
+        updateAnimations(delta);
+    }
+
+    void Scene::updateAnimations(float delta) {
+        getEntitiesWith<SkinnedMeshComponent>().each([=](auto entity, auto& skinned) {
+            if (skinned.skeleton == nullptr) return;
+
+            if (skinned.animation != nullptr) {
+                const float duration = skinned.animation->getDuration();
+
+                if (skinned.isPlaying) {
+                    skinned.time += delta * skinned.speed;
+
+                    if (skinned.isLooping && duration > 0.0f) {
+                        skinned.time = std::fmod(skinned.time, duration);
+                        if (skinned.time < 0.0f) skinned.time += duration;
+                    }
+                }
+
+                skinned.animation->sample(skinned.time, skinned.pose);
+            } else {
+                skinned.pose = skinned.skeleton->getRestPose();
+            }
+
+            skinned.skeleton->computeSkinningMatrices(skinned.pose, skinned.skinningMatrices);
+        });
     }
 }
\ No newline at end of file
@@ -18,7 +18,7 @@ namespace PXTEngine {
      */
     class Scene {
     public:
-        Scene() = default;
+        Scene();
         ~Scene() = default;
 
 		std::string getName() const { return m_name; }
@@ -81,6 +81,18 @@ namespace PXTEngine {
         Shared<Environment> getEnvironment() const { return m_environment; }
 
     private:
+        /**
+         * @brief Connects the registry signals keeping the RenderPacketComponents in sync
+         * with the components they are built from.
+         */
+        void connectRenderPacketSignals();
+
+        /**
+         * @brief Advances the animations and computes the skinning matrices of the skinned meshes.
+         * @param delta Time elapsed since the last update.
+         */
+        void updateAnimations(float delta);
+
 		std::string m_name = "Unnamed-Scene";
         std::unordered_map<UUID, entt::entity> m_entityMap;
         
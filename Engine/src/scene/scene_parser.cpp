@@ -0,0 +1,96 @@
+#include "scene/scene_parser.hpp"
+
+namespace PXTEngine {
+
+	void SceneParser::parseEntities(Scene& scene, const YAML::Node& entities, std::vector<EntityResourceNodes>& resourceNodes) {
+		for (auto entityNode : entities) {
+			std::string uuid = entityNode["entity"].as<std::string>();
+
+			// Deserialize NameComponent
+			std::string name = "Unnamed-Entity";
+			if (auto nameComponentNode = entityNode["NameComponent"]) {
+				name = nameComponentNode.as<std::string>();
+			}
+
+			Entity entity = scene.createEntity(name, UUID(uuid));
+
+			// Deserialize TransformComponent
+			if (auto transformComponentNode = entityNode["TransformComponent"]) {
+				auto translation = transformComponentNode["translation"].as<std::vector<float>>();
+				auto scale = transformComponentNode["scale"].as<std::vector<float>>();
+				auto rotation = transformComponentNode["rotation"].as<std::vector<float>>();
+				entity.add<TransformComponent>(
+					glm::vec3(translation[0], translation[1], translation[2]),
+					glm::vec3(scale[0], scale[1], scale[2]),
+					glm::vec3(rotation[0], rotation[1], rotation[2])
+				);
+			}
+
+			// Deserialize Transform2dComponent
+			if (auto transform2dComponentNode = entityNode["Transform2dComponent"]) {
+				auto translation = transform2dComponentNode["translation"].as<std::vector<float>>();
+				auto scale = transform2dComponentNode["scale"].as<std::vector<float>>();
+				float rotation = transform2dComponentNode["rotation"].as<float>();
+				entity.add<Transform2dComponent>(
+					glm::vec2(translation[0], translation[1]),
+					glm::vec2(scale[0], scale[1]),
+					rotation
+				);
+			}
+
+			// Deserialize ColorComponent
+			if (auto colorComponentNode = entityNode["ColorComponent"]) {
+				auto color = colorComponentNode["color"].as<std::vector<float>>();
+
+				entity.add<ColorComponent>(glm::vec3{ color[0], color[1], color[2] });
+			}
+
+			// Deserialize VolumeComponent
+			if (auto volumeComponentNode = entityNode["VolumeComponent"]) {
+				auto absorption = volumeComponentNode["absorption"].as<std::vector<float>>();
+				auto scattering = volumeComponentNode["scattering"].as<std::vector<float>>();
+				auto phaseFunctionG = volumeComponentNode["phaseFunctionG"].as<float>();
+
+				entity.add<VolumeComponent>(VolumeComponent::Builder()
+					.setAbsorption({ absorption[0], absorption[1], absorption[2], absorption[3] })
+					.setScattering({ scattering[0], scattering[1], scattering[2], scattering[3] })
+					.setPhaseFunctionG(phaseFunctionG)
+					.build()
+				);
+			}
+
+			// Deserialize CameraComponent
+			if (auto cameraComponentNode = entityNode["CameraComponent"]) {
+				bool isMainCamera = cameraComponentNode["isMainCamera"].as<bool>();
+				bool isPerspective = cameraComponentNode["isPerspective"].as<bool>();
+				float nearPlane = cameraComponentNode["nearPlane"].as<float>();
+				float farPlane = cameraComponentNode["farPlane"].as<float>();
+				float fovYDegrees = cameraComponentNode["fovYDegrees"].as<float>();
+				auto orthoParams = cameraComponentNode["orthoParams"].as<std::vector<float>>();
+				Camera camera;
+				camera.setPerspectiveParams(fovYDegrees, nearPlane, farPlane);
+				camera.setOrthographicParams(orthoParams[0], orthoParams[1], orthoParams[2], orthoParams[3], nearPlane, farPlane);
+				camera.setIsPerspective(isPerspective);
+				entity.add<CameraComponent>(camera);
+			}
+
+			// Deserialize PointLightComponent
+			if (auto pointLightComponentNode = entityNode["PointLightComponent"]) {
+				float lightIntensity = pointLightComponentNode["lightIntensity"].as<float>();
+				entity.add<PointLightComponent>(lightIntensity);
+			}
+
+			// the mesh, material and density grid are added by the serializer, they need the resource manager
+			auto meshComponentNode = entityNode["MeshComponent"];
+			auto materialComponentNode = entityNode["MaterialComponent"];
+			YAML::Node densityGridNode;
+			if (auto volumeComponentNode = entityNode["VolumeComponent"]) {
+				densityGridNode = volumeComponentNode["densityGrid"];
+			}
+
+			if (meshComponentNode || materialComponentNode || densityGridNode) {
+				resourceNodes.push_back({ entity, name, meshComponentNode, materialComponentNode, densityGridNode });
+			}
+		}
+	}
+}
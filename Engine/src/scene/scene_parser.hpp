@@ -0,0 +1,43 @@
+#pragma once
+
+#include "core/pch.hpp"
+#include "scene/scene.hpp"
+#include "scene/ecs/entity.hpp"
+
+#include "yaml-cpp/yaml.h"
+
+namespace PXTEngine {
+
+	/**
+	 * @brief The components of a parsed entity that reference resources, SceneSerializer adds
+	 * them once the resource manager has imported what they reference.
+	 */
+	struct EntityResourceNodes {
+		Entity entity;
+		std::string name;
+		YAML::Node mesh;     // the MeshComponent node, undefined if the entity has none
+		YAML::Node material; // the MaterialComponent node, undefined if the entity has none
+		YAML::Node densityGrid; // the densityGrid node of the VolumeComponent, undefined if the entity has none
+	};
+
+	/**
+	 * @class SceneParser
+	 *
+	 * @brief The parse step of SceneSerializer::deserialize: creates the entities of a scene
+	 * document with the components that don't reference resources.
+	 *
+	 * It uses neither the resource manager nor the device, so it can run on its own (the
+	 * benchmarks parse the documents with it).
+	 */
+	class SceneParser {
+	public:
+		/**
+		 * @brief Creates the entities of the "entities" node of a scene document in the scene.
+		 *
+		 * @param scene The scene to create the entities in.
+		 * @param entities The "entities" node of the document.
+		 * @param resourceNodes Output: the components left to add, one element per entity that has any.
+		 */
+		static void parseEntities(Scene& scene, const YAML::Node& entities, std::vector<EntityResourceNodes>& resourceNodes);
+	};
+}
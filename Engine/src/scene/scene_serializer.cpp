@@ -1,4 +1,5 @@
 #include "scene/scene_serializer.hpp"
+#include "scene/scene_parser.hpp"
 
 #include "scene/ecs/component.hpp"
 #include "scene/ecs/entity.hpp"
@@ -7,26 +8,27 @@
 
 namespace PXTEngine {
 
-	using SerializerFunction = std::function<void(Entity, YAML::Emitter&)>;
+	// the resource manager resolves the handles held by the components
+	using SerializerFunction = std::function<void(Entity, const ResourceManager&, YAML::Emitter&)>;
 
 	template<typename T, typename Fn>
 	static SerializerFunction makeSerializer(Fn&& fn) {
-		return [func = std::forward<Fn>(fn)](Entity entity, YAML::Emitter& out) {
+		return [func = std::forward<Fn>(fn)](Entity entity, const ResourceManager& rm, YAML::Emitter& out) {
 			if (!entity.has<T>())
 				return;
 			auto& component = entity.get<T>();
-			func(component, out);
+			func(component, rm, out);
 		};
 	}
 
 	static std::unordered_map<std::type_index, SerializerFunction> s_ComponentSerializers = {
 		// Name Component
-		{ typeid(NameComponent), makeSerializer<NameComponent>([](auto& c, YAML::Emitter& out) {
+		{ typeid(NameComponent), makeSerializer<NameComponent>([](auto& c, const ResourceManager& rm, YAML::Emitter& out) {
 			out << YAML::Key << "NameComponent" << YAML::Value << c.name;
 		})},
 
 		// Color Component
-		{ typeid(ColorComponent), makeSerializer<ColorComponent>([](auto& c, YAML::Emitter& out) {
+		{ typeid(ColorComponent), makeSerializer<ColorComponent>([](auto& c, const ResourceManager& rm, YAML::Emitter& out) {
 			out << YAML::Key << "ColorComponent";
 			out << YAML::BeginMap;
 			out << YAML::Key << "color" << YAML::Value << YAML::Flow << YAML::BeginSeq << c.color.x << c.color.y << c.color.z << YAML::EndSeq;
@@ -34,7 +36,7 @@ namespace PXTEngine {
 		})},
 
 		// Transform Component
-		{ typeid(TransformComponent), makeSerializer<TransformComponent>([](auto& c, YAML::Emitter& out) {
+		{ typeid(TransformComponent), makeSerializer<TransformComponent>([](auto& c, const ResourceManager& rm, YAML::Emitter& out) {
 			out << YAML::Key << "TransformComponent";
 			out << YAML::BeginMap;
 			out << YAML::Key << "translation" << YAML::Value << YAML::Flow << YAML::BeginSeq << c.translation.x << c.translation.y << c.translation.z << YAML::EndSeq;
@@ -44,7 +46,7 @@ namespace PXTEngine {
 		})},
 
 		// Transform2d Component
-		{ typeid(Transform2dComponent), makeSerializer<Transform2dComponent>([](auto& c, YAML::Emitter& out) {
+		{ typeid(Transform2dComponent), makeSerializer<Transform2dComponent>([](auto& c, const ResourceManager& rm, YAML::Emitter& out) {
 			out << YAML::Key << "Transform2dComponent";
 			out << YAML::BeginMap;
 			out << YAML::Key << "translation" << YAML::Value << YAML::Flow << YAML::BeginSeq << c.translation.x << c.translation.y << YAML::EndSeq;
@@ -54,7 +56,7 @@ namespace PXTEngine {
 		})},
 
 		// Volume Component
-		{ typeid(VolumeComponent), makeSerializer<VolumeComponent>([](auto& c, YAML::Emitter& out) {
+		{ typeid(VolumeComponent), makeSerializer<VolumeComponent>([](auto& c, const ResourceManager& rm, YAML::Emitter& out) {
 			out << YAML::Key << "VolumeComponent";
 			out << YAML::BeginMap;
 			out << YAML::Key << "absorption" << YAML::Value << YAML::Flow << YAML::BeginSeq
@@ -62,6 +64,21 @@ namespace PXTEngine {
 			out << YAML::Key << "scattering" << YAML::Value << YAML::Flow << YAML::BeginSeq
 				<< c.volume.scattering.r << c.volume.scattering.g << c.volume.scattering.b << c.volume.scattering.a << YAML::EndSeq;
 			out << YAML::Key << "phaseFunctionG" << YAML::Value << c.volume.phaseFunctionG;
+
+			// only the generated grids can be saved, as the parameters to generate them again
+			const DensityGrid* densityGrid = rm.resolve(c.volume.densityGrid);
+			if (densityGrid != nullptr && densityGrid->getWorleyParams()) {
+				const DensityGrid::WorleyParams& params = *densityGrid->getWorleyParams();
+
+				out << YAML::Key << "densityGrid";
+				out << YAML::BeginMap;
+				out << YAML::Key << "type" << YAML::Value << "worley";
+				out << YAML::Key << "resolution" << YAML::Value << YAML::Flow << YAML::BeginSeq
+					<< params.resolution.x << params.resolution.y << params.resolution.z << YAML::EndSeq;
+				out << YAML::Key << "frequency" << YAML::Value << params.frequency;
+				out << YAML::Key << "exponent" << YAML::Value << params.exponent;
+				out << YAML::EndMap;
+			}
 			// TODO: volume textures
 			//out << YAML::Key << "densityTextureId" << YAML::Value << c.volume.densityTextureId;
 			//out << YAML::Key << "detailTextureId" << YAML::Value << c.volume.detailTextureId;
@@ -69,39 +86,45 @@ namespace PXTEngine {
 		})},
 
 		// Mesh Component
-		{ typeid(MeshComponent), makeSerializer<MeshComponent>([](auto& c, YAML::Emitter& out) {
+		{ typeid(MeshComponent), makeSerializer<MeshComponent>([](auto& c, const ResourceManager& rm, YAML::Emitter& out) {
+			const Mesh* mesh = rm.resolve(c.mesh);
+			if (mesh == nullptr) return;
+
 			out << YAML::Key << "MeshComponent";
 			out << YAML::BeginMap;
-			out << YAML::Key << "meshId" << YAML::Value << c.mesh->id.toString();
-			out << YAML::Key << "mesh" << YAML::Value << c.mesh->alias;
+			out << YAML::Key << "meshId" << YAML::Value << mesh->id.toString();
+			out << YAML::Key << "mesh" << YAML::Value << mesh->alias;
 			out << YAML::EndMap;
 		})},
 
 		// Material Component
 		// TODO: maybe reuse material if different entities use the same params
-		{ typeid(MaterialComponent), makeSerializer<MaterialComponent>([](auto& c, YAML::Emitter& out) {
+		{ typeid(MaterialComponent), makeSerializer<MaterialComponent>([](auto& c, const ResourceManager& rm, YAML::Emitter& out) {
+			const Material* material = rm.resolve(c.material);
+			if (material == nullptr) return;
+
 			out << YAML::Key << "MaterialComponent";
 			out << YAML::BeginMap;
-			out << YAML::Key << "materialId" << YAML::Value << c.material->id.toString();
-			out << YAML::Key << "material" << YAML::Value << c.material->alias;
-			auto albedoColor = c.material->getAlbedoColor();
+			out << YAML::Key << "materialId" << YAML::Value << material->id.toString();
+			out << YAML::Key << "material" << YAML::Value << material->alias;
+			auto albedoColor = material->getAlbedoColor();
 			out << YAML::Key << "albedoColor" << YAML::Value << YAML::Flow << YAML::BeginSeq
 				<< albedoColor.r << albedoColor.g << albedoColor.b << albedoColor.a << YAML::EndSeq;
-			out << YAML::Key << "albedoMap" << YAML::Value << (c.material->getAlbedoMap() ? c.material->getAlbedoMap()->alias : "null");
-			out << YAML::Key << "metallic" << YAML::Value << c.material->getMetallic();
-			out << YAML::Key << "metallicMap" << YAML::Value << (c.material->getMetallicMap() ? c.material->getMetallicMap()->alias : "null");
-			out << YAML::Key << "roughness" << YAML::Value << c.material->getRoughness();
-			out << YAML::Key << "roughnessMap" << YAML::Value << (c.material->getRoughnessMap() ? c.material->getRoughnessMap()->alias : "null");
-			out << YAML::Key << "normalMap" << YAML::Value << (c.material->getNormalMap() ? c.material->getNormalMap()->alias : "null");
-			out << YAML::Key << "ambientOcclusionMap" << YAML::Value << (c.material->getAmbientOcclusionMap() ? c.material->getAmbientOcclusionMap()->alias : "null");
-			auto emissiveColor = c.material->getEmissiveColor();
+			out << YAML::Key << "albedoMap" << YAML::Value << (material->getAlbedoMap() ? material->getAlbedoMap()->alias : "null");
+			out << YAML::Key << "metallic" << YAML::Value << material->getMetallic();
+			out << YAML::Key << "metallicMap" << YAML::Value << (material->getMetallicMap() ? material->getMetallicMap()->alias : "null");
+			out << YAML::Key << "roughness" << YAML::Value << material->getRoughness();
+			out << YAML::Key << "roughnessMap" << YAML::Value << (material->getRoughnessMap() ? material->getRoughnessMap()->alias : "null");
+			out << YAML::Key << "normalMap" << YAML::Value << (material->getNormalMap() ? material->getNormalMap()->alias : "null");
+			out << YAML::Key << "ambientOcclusionMap" << YAML::Value << (material->getAmbientOcclusionMap() ? material->getAmbientOcclusionMap()->alias : "null");
+			auto emissiveColor = material->getEmissiveColor();
 			out << YAML::Key << "emissiveColor" << YAML::Value << YAML::Flow << YAML::BeginSeq
 				<< emissiveColor.r << emissiveColor.g << emissiveColor.b << emissiveColor.a << YAML::EndSeq;
-			out << YAML::Key << "emissiveMap" << YAML::Value << (c.material->getEmissiveMap() ? c.material->getEmissiveMap()->alias : "null");
-			out << YAML::Key << "transmission" << YAML::Value << c.material->getTransmission();
-			out << YAML::Key << "indexOfRefraction" << YAML::Value << c.material->getIndexOfRefraction();
-			out << YAML::Key << "blinnPhongSpecularIntensity" << YAML::Value << c.material->getBlinnPhongSpecularIntensity();
-			out << YAML::Key << "blinnPhongSpecularShininess" << YAML::Value << c.material->getBlinnPhongSpecularShininess();
+			out << YAML::Key << "emissiveMap" << YAML::Value << (material->getEmissiveMap() ? material->getEmissiveMap()->alias : "null");
+			out << YAML::Key << "transmission" << YAML::Value << material->getTransmission();
+			out << YAML::Key << "indexOfRefraction" << YAML::Value << material->getIndexOfRefraction();
+			out << YAML::Key << "blinnPhongSpecularIntensity" << YAML::Value << material->getBlinnPhongSpecularIntensity();
+			out << YAML::Key << "blinnPhongSpecularShininess" << YAML::Value << material->getBlinnPhongSpecularShininess();
 			out << YAML::Key << "tilingFactor" << YAML::Value << c.tilingFactor;
 			out << YAML::Key << "tint" << YAML::Value << YAML::Flow << YAML::BeginSeq
 				<< c.tint.r << c.tint.g << c.tint.b << YAML::EndSeq;
@@ -109,7 +132,7 @@ namespace PXTEngine {
 		})},
 
 		// Camera Component
-		{ typeid(CameraComponent), makeSerializer<CameraComponent>([](auto& c, YAML::Emitter& out) {
+		{ typeid(CameraComponent), makeSerializer<CameraComponent>([](auto& c, const ResourceManager& rm, YAML::Emitter& out) {
 			out << YAML::Key << "CameraComponent";
 			out << YAML::BeginMap;
 			out << YAML::Key << "isMainCamera" << YAML::Value << c.isMainCamera;
@@ -124,7 +147,7 @@ namespace PXTEngine {
 		})},
 
 		// PointLight Component
-		{ typeid(PointLightComponent), makeSerializer<PointLightComponent>([](auto& c, YAML::Emitter& out) {
+		{ typeid(PointLightComponent), makeSerializer<PointLightComponent>([](auto& c, const ResourceManager& rm, YAML::Emitter& out) {
 			out << YAML::Key << "PointLightComponent";
 			out << YAML::BeginMap;
 			out << YAML::Key << "lightIntensity" << YAML::Value << c.lightIntensity;
@@ -135,7 +158,7 @@ namespace PXTEngine {
 	SceneSerializer::SceneSerializer(Scene* scene, ResourceManager* resourceManager) 
 		: m_scene(scene), m_resourceManager(resourceManager) {}
 
-	static void serializeEntity(Entity entity, YAML::Emitter& out) {
+	static void serializeEntity(Entity entity, const ResourceManager& rm, YAML::Emitter& out) {
 		// Entity Map
 		out << YAML::BeginMap;
 
@@ -143,7 +166,7 @@ namespace PXTEngine {
 
 		// Serialize Components
 		for (auto& [name, fn] : s_ComponentSerializers)
-			fn(entity, out);
+			fn(entity, rm, out);
 		
 		// End Entity Map
 		out << YAML::EndMap;
@@ -155,6 +178,8 @@ namespace PXTEngine {
 	}
 
 	void SceneSerializer::serialize(const std::string& filepath) {
+		PXT_ALLOCATION_SCOPE("SceneSerializer");
+
 		YAML::Emitter out;
 
 		// Scene Map
@@ -172,7 +197,7 @@ namespace PXTEngine {
 		for (auto& entityHandle : m_scene->getEntitiesWith<IDComponent>()) {
 			Entity entity = { entityHandle, m_scene };
 
-			serializeEntity(entity, out);
+			serializeEntity(entity, *m_resourceManager, out);
 		}
 
 		// End Entities Sequence
@@ -197,10 +222,14 @@ namespace PXTEngine {
 	}
 
 	bool SceneSerializer::deserialize(const std::string& filepath) {
+		PXT_ALLOCATION_SCOPE("SceneSerializer");
+		PXT_STARTUP_PHASE("Deserialize scene");
+
 		YAML::Node data;
 
 		try {
 			data = YAML::LoadFile(filepath);
+			StartupProfiler::recordFileRead(filepath);
 		} catch (YAML::ParserException& e) {
 			PXT_ERROR("Could not deserialize the Scene in '{}': {}", filepath, e.what());
 			return false;
@@ -238,72 +267,47 @@ namespace PXTEngine {
 		environment->setSkybox(skyboxTextures);
 		// ----------------
 
-		for (auto entityNode : entities) {
-			std::string uuid = entityNode["entity"].as<std::string>();
+		std::vector<EntityResourceNodes> resourceNodes;
+		SceneParser::parseEntities(*m_scene, entities, resourceNodes);
 
-			// Deserialize NameComponent
-			std::string name = "Unnamed-Entity";
-			if (auto nameComponentNode = entityNode["NameComponent"]) {
-				name = nameComponentNode.as<std::string>();
-			}
+		// the volumes with the same grid parameters share the grid
+		std::unordered_map<std::string, ResourceHandle<DensityGrid>> densityGrids;
 
-			Entity entity = m_scene->createEntity(name, UUID(uuid));
-
-			// Deserialize TransformComponent
-			if (auto transformComponentNode = entityNode["TransformComponent"]) {
-				auto translation = transformComponentNode["translation"].as<std::vector<float>>();
-				auto scale = transformComponentNode["scale"].as<std::vector<float>>();
-				auto rotation = transformComponentNode["rotation"].as<std::vector<float>>();
-				entity.add<TransformComponent>(
-					glm::vec3(translation[0], translation[1], translation[2]),
-					glm::vec3(scale[0], scale[1], scale[2]),
-					glm::vec3(rotation[0], rotation[1], rotation[2])
-				);
-			}
-
-			// Deserialize Transform2dComponent
-			if (auto transform2dComponentNode = entityNode["Transform2dComponent"]) {
-				auto translation = transform2dComponentNode["translation"].as<std::vector<float>>();
-				auto scale = transform2dComponentNode["scale"].as<std::vector<float>>();
-				float rotation = transform2dComponentNode["rotation"].as<float>();
-				entity.add<Transform2dComponent>(
-					glm::vec2(translation[0], translation[1]),
-					glm::vec2(scale[0], scale[1]),
-					rotation
-				);
-			}
+		for (auto& resourceNode : resourceNodes) {
+			// Deserialize the density grid of the VolumeComponent
+			if (auto densityGridNode = resourceNode.densityGrid) {
+				const std::string type = densityGridNode["type"].as<std::string>();
 
-			// Deserialize ColorComponent
-			if (auto colorComponentNode = entityNode["ColorComponent"]) {
-				auto color = colorComponentNode["color"].as<std::vector<float>>();
+				if (type == "worley") {
+					auto resolution = densityGridNode["resolution"].as<std::vector<uint32_t>>();
+					float frequency = densityGridNode["frequency"].as<float>();
+					float exponent = densityGridNode["exponent"].as<float>();
 
-				entity.add<ColorComponent>(glm::vec3{ color[0], color[1], color[2] });
-			}
+					const std::string alias = std::format("worley_{}x{}x{}_{}_{}",
+						resolution[0], resolution[1], resolution[2], frequency, exponent);
 
-			// Deserialize VolumeComponent
-			if (auto volumeComponentNode = entityNode["VolumeComponent"]) {
-				auto absorption = volumeComponentNode["absorption"].as<std::vector<float>>();
-				auto scattering = volumeComponentNode["scattering"].as<std::vector<float>>();
-				auto phaseFunctionG = volumeComponentNode["phaseFunctionG"].as<float>();
+					ResourceHandle<DensityGrid>& densityGrid = densityGrids[alias];
+					if (!densityGrid) {
+						auto grid = DensityGrid::createWorley({ resolution[0], resolution[1], resolution[2] }, frequency, exponent);
+						rm->add(grid, alias);
+						densityGrid = rm->getHandle(grid);
+					}
 
-				entity.add<VolumeComponent>(VolumeComponent::Builder()
-					.setAbsorption({ absorption[0], absorption[1], absorption[2], absorption[3] })
-					.setScattering({ scattering[0], scattering[1], scattering[2], scattering[3] })
-					.setPhaseFunctionG(phaseFunctionG)
-					.build()
-				);
+					resourceNode.entity.get<VolumeComponent>().volume.densityGrid = densityGrid;
+				} else {
+					PXT_WARN("Unknown density grid type '{}' for entity '{}', the procedural density is used", type, resourceNode.name);
+				}
 			}
+
 			// Deserialize MeshComponent
-			if (auto meshComponentNode = entityNode["MeshComponent"]) {
+			if (auto meshComponentNode = resourceNode.mesh) {
 				std::string meshAlias = meshComponentNode["mesh"].as<std::string>();
 
-				auto mesh = rm->get<Mesh>(meshAlias);
-
-				entity.add<MeshComponent>(mesh);
+				resourceNode.entity.add<MeshComponent>(rm->getHandle<Mesh>(meshAlias));
 			}
 
 			// Deserialize MaterialComponent
-			if (auto materialComponentNode = entityNode["MaterialComponent"]) {
+			if (auto materialComponentNode = resourceNode.material) {
 				std::string materialAlias = materialComponentNode["material"].as<std::string>();
 
 				ImageInfo albedoInfo{};
@@ -350,7 +354,7 @@ namespace PXTEngine {
 				}
 				auto material = materialBuilder.build();
 
-				rm->add(material, "mat-" + name);
+				rm->add(material, "mat-" + resourceNode.name);
 
 				float tilingFactor = 1.0f;
 				if (auto tilingFactorNode = materialComponentNode["tilingFactor"]) {
@@ -363,34 +367,13 @@ namespace PXTEngine {
 					tint = { tintVec[0], tintVec[1], tintVec[2] };
 				}
 
-				entity.add<MaterialComponent>(MaterialComponent::Builder()
-					.setMaterial(material)
+				resourceNode.entity.add<MaterialComponent>(MaterialComponent::Builder()
+					.setMaterial(rm->getHandle(material))
 					.setTilingFactor(tilingFactor)
 					.setTint(tint)
 					.build()
 				);
 			}
-
-			// Deserialize CameraComponent
-			if (auto cameraComponentNode = entityNode["CameraComponent"]) {
-				bool isMainCamera = cameraComponentNode["isMainCamera"].as<bool>();
-				bool isPerspective = cameraComponentNode["isPerspective"].as<bool>();
-				float nearPlane = cameraComponentNode["nearPlane"].as<float>();
-				float farPlane = cameraComponentNode["farPlane"].as<float>();
-				float fovYDegrees = cameraComponentNode["fovYDegrees"].as<float>();
-				auto orthoParams = cameraComponentNode["orthoParams"].as<std::vector<float>>();
-				Camera camera;
-				camera.setPerspectiveParams(fovYDegrees, nearPlane, farPlane);
-				camera.setOrthographicParams(orthoParams[0], orthoParams[1], orthoParams[2], orthoParams[3], nearPlane, farPlane);
-				camera.setIsPerspective(isPerspective);
-				entity.add<CameraComponent>(camera);
-			}
-
-			// Deserialize PointLightComponent
-			if (auto pointLightComponentNode = entityNode["PointLightComponent"]) {
-				float lightIntensity = pointLightComponentNode["lightIntensity"].as<float>();
-				entity.add<PointLightComponent>(lightIntensity);
-			}
 		}
 
 		return true;
@@ -18,18 +18,6 @@ struct Material {
     float blinnPhongSpecularShininess;
 };
 
-struct MeshInstanceDescription {
-    uint64_t vertexAddress;  
-    uint64_t indexAddress;   
-    uint materialIndex;
-    uint emitterIndex;
-    uint volumeIndex;
-    float textureTilingFactor;
-    vec4 textureTintColor;
-    mat4 objectToWorld;
-    mat4 worldToObject;
-};
-
 struct Emitter {
     uint instanceIndex;
     uint numberOfFaces;
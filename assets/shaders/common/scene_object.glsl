@@ -0,0 +1,21 @@
+#ifndef _SCENE_OBJECT_
+#define _SCENE_OBJECT_
+
+// Entry of the scene buffer, matches SceneObjectData in scene_object_table.hpp.
+// Requires GL_EXT_shader_explicit_arithmetic_types_int64.
+struct SceneObject {
+    mat4 objectToWorld;
+    mat4 worldToObject;
+    vec4 boundingSphere; // world space: xyz = center, w = radius
+    vec4 textureTintColor;
+    uint64_t vertexAddress;
+    uint64_t indexAddress;
+    uint vertexCount;
+    uint indexCount;
+    uint materialIndex;
+    uint emitterIndex;
+    uint volumeIndex;
+    float textureTilingFactor;
+};
+
+#endif
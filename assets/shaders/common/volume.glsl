@@ -1,6 +1,12 @@
 #ifndef _VOLUME_
 #define _VOLUME_
 
+// Entry of the brick table, matches BrickEntry in volume_brick_atlas.hpp
+struct BrickEntry {
+    uint atlasSlot; // UINT_MAX if the brick is not stored
+    float majorant;
+};
+
 struct Volume {
     vec4 absorption;
     vec4 scattering;
@@ -12,6 +18,10 @@ struct Volume {
     uint densityTextureId;
     uint detailTextureId; // for edge details of the volume
     uint instanceIndex;
+    // density grid stored in the brick atlas:
+    // xyz = resolution of the grid, w = first entry in the brick table (UINT_MAX if the volume has no grid)
+    uvec4 densityGrid;
+    float densityMajorant; // maximum density of the grid
 };
 
 // Finds the intersection points with a bounding box along the given ray.
@@ -5,22 +5,19 @@
 
 layout(location = 0) in vec4 position;
 
-layout(location = 0) out vec3 fragPosWorld;
-layout(location = 1) out vec3 fragLightPos;
+layout(location = 0) out vec3 fragPosLight;
 
 layout(push_constant) uniform Push {
-  // it will be modified to translate the object to the light position (i think so?)
   mat4 modelMatrix;
-  // it will be modified to render the different faces
-  mat4 cubeFaceView;
+  // the view of the cube face being rendered, translated to the light position
+  mat4 lightFaceView;
 } push;
 
 
 void main() {
-  vec4 posWorld = push.modelMatrix * position;
-  vec4 posWorldFromLight = ubo.lightOriginModel * posWorld;
-  gl_Position = ubo.projection * push.cubeFaceView * posWorldFromLight;
+  vec4 posLight = push.lightFaceView * push.modelMatrix * position;
+  gl_Position = ubo.projection * posLight;
 
-  fragPosWorld = posWorld.xyz;
-  fragLightPos = ubo.pointLights[0].position.xyz;
-}
\ No newline at end of file
+  // the face view only rotates around the light, the distance is kept
+  fragPosLight = posLight.xyz;
+}
@@ -0,0 +1,52 @@
+#ifndef _IBL_COMMON_
+#define _IBL_COMMON_
+
+#include "../common/math.glsl"
+
+/**
+ * Returns the i-th point of a Hammersley sequence of the given size.
+ */
+vec2 hammersley(uint i, uint sampleCount) {
+    uint bits = bitfieldReverse(i);
+    return vec2(float(i) / float(sampleCount), float(bits) * INV_UINT_MAX);
+}
+
+/**
+ * Importance samples the GGX distribution around the normal n.
+ * Returns the sampled half vector in world space.
+ */
+vec3 importanceSampleGGX(vec2 xi, vec3 n, float roughness) {
+    float a = roughness * roughness;
+
+    float phi = TWO_PI * xi.x;
+    float cosTheta = sqrt((1.0 - xi.y) / (1.0 + (a * a - 1.0) * xi.y));
+    float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+
+    vec3 h = vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+
+    // tangent space to world space
+    vec3 up = abs(n.z) < 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
+    vec3 tangent = normalize(cross(up, n));
+    vec3 bitangent = cross(n, tangent);
+
+    return normalize(tangent * h.x + bitangent * h.y + n * h.z);
+}
+
+/**
+ * Returns the direction of a cube map texel, with u and v in [-1, 1].
+ * Uses the Vulkan face order (+X, -X, +Y, -Y, +Z, -Z).
+ */
+vec3 cubeMapDirection(uint face, float u, float v) {
+    vec3 dir;
+    switch (face) {
+        case 0: dir = vec3(1.0, -v, -u); break;
+        case 1: dir = vec3(-1.0, -v, u); break;
+        case 2: dir = vec3(u, 1.0, v); break;
+        case 3: dir = vec3(u, -1.0, -v); break;
+        case 4: dir = vec3(u, -v, 1.0); break;
+        default: dir = vec3(-u, -v, -1.0); break;
+    }
+    return normalize(dir);
+}
+
+#endif
@@ -5,35 +5,63 @@
 #include "../ubo/global_ubo.glsl"
 
 /*
- * Compute diffuse and specular lighting (Blinn-Phong model).
+ * Add the diffuse and specular lighting of a point light (Blinn-Phong model).
  *
- * Calculates the total diffuse and specular contributions from all active point lights.
+ * The contribution is scaled by the visibility of the light from the surface
+ * (1 when lit, lower when in shadow).
+ */
+void addBlinnPhongPointLight(PointLight light, vec3 surfaceNormal, vec3 viewDirection, vec3 worldPosition,
+	float shininess, float specularIntensity, float visibility, inout vec3 diffuseLight, inout vec3 specularLight) {
+
+    vec3 vectorToLight = light.position.xyz - worldPosition;
+    float attenuation = 1.0 / dot(vectorToLight, vectorToLight);
+    vec3 directionToLight = normalize(vectorToLight);
+    float cosAngleIncidence = max(dot(surfaceNormal, directionToLight), 0.0);
+    vec3 lightColor = light.color.xyz * light.color.w * attenuation * visibility;
+
+    // Diffuse component
+    diffuseLight += lightColor * cosAngleIncidence;
+
+    // Specular component (Blinn-Phong)
+    vec3 halfAngle = normalize(directionToLight + viewDirection);
+    float blinnTerm = saturate(dot(surfaceNormal, halfAngle));
+    blinnTerm = pow(blinnTerm, shininess);
+
+    specularLight += lightColor * blinnTerm * specularIntensity;
+}
+
+/*
+ * Compute direct diffuse and specular lighting (Blinn-Phong model).
+ *
+ * Calculates the total diffuse and specular contributions from all active point lights,
+ * without any ambient term.
  * Uses Blinn-Phong reflection for specular highlights.
  */
-void computeBlinnPhongLighting(vec3 surfaceNormal, vec3 viewDirection, vec3 worldPosition,
+void computeBlinnPhongDirectLighting(vec3 surfaceNormal, vec3 viewDirection, vec3 worldPosition,
 	float shininess, float specularIntensity, out vec3 diffuseLight, out vec3 specularLight) {
 
-    diffuseLight = ubo.ambientLightColor.xyz * ubo.ambientLightColor.w;
+    diffuseLight = vec3(0.0);
     specularLight = vec3(0.0);
 
     for (int i = 0; i < ubo.numLights; i++) {
-        PointLight light = ubo.pointLights[i];
-        vec3 vectorToLight = light.position.xyz - worldPosition;
-        float attenuation = 1.0 / dot(vectorToLight, vectorToLight);
-        vec3 directionToLight = normalize(vectorToLight);
-        float cosAngleIncidence = max(dot(surfaceNormal, directionToLight), 0.0);
-        vec3 lightColor = light.color.xyz * light.color.w * attenuation;
-
-        // Diffuse component
-        diffuseLight += lightColor * cosAngleIncidence;
-
-        // Specular component (Blinn-Phong)
-        vec3 halfAngle = normalize(directionToLight + viewDirection);
-        float blinnTerm = saturate(dot(surfaceNormal, halfAngle));
-        blinnTerm = pow(blinnTerm, shininess);
-
-        specularLight += lightColor * blinnTerm * specularIntensity;
+        addBlinnPhongPointLight(ubo.pointLights[i], surfaceNormal, viewDirection, worldPosition,
+            shininess, specularIntensity, 1.0, diffuseLight, specularLight);
     }
 }
 
+/*
+ * Compute diffuse and specular lighting (Blinn-Phong model).
+ *
+ * Same as computeBlinnPhongDirectLighting, with the flat ambient light of the ubo
+ * added to the diffuse term.
+ */
+void computeBlinnPhongLighting(vec3 surfaceNormal, vec3 viewDirection, vec3 worldPosition,
+	float shininess, float specularIntensity, out vec3 diffuseLight, out vec3 specularLight) {
+
+    computeBlinnPhongDirectLighting(surfaceNormal, viewDirection, worldPosition,
+        shininess, specularIntensity, diffuseLight, specularLight);
+
+    diffuseLight += ubo.ambientLightColor.xyz * ubo.ambientLightColor.w;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef _ENVIRONMENT_LIGHTING_
+#define _ENVIRONMENT_LIGHTING_
+
+#include "../common/math.glsl"
+#include "../ubo/global_ubo.glsl"
+
+// Image based lighting baked from the skybox (see IBLBaker)
+layout(set = 3, binding = 0) uniform samplerCube prefilteredEnvironmentMap;
+layout(set = 3, binding = 1) uniform sampler2D brdfLut;
+
+/*
+ * Evaluates the L2 spherical harmonics stored in the ubo.
+ *
+ * The coefficients already include the cosine convolution and the division by PI,
+ * so the result is the diffuse radiance reflected by a white lambertian surface.
+ */
+vec3 evaluateIrradianceSH(vec3 n) {
+    vec3 result =
+        ubo.irradianceSH[0].rgb * 0.282095 +
+        ubo.irradianceSH[1].rgb * 0.488603 * n.y +
+        ubo.irradianceSH[2].rgb * 0.488603 * n.z +
+        ubo.irradianceSH[3].rgb * 0.488603 * n.x +
+        ubo.irradianceSH[4].rgb * 1.092548 * n.x * n.y +
+        ubo.irradianceSH[5].rgb * 1.092548 * n.y * n.z +
+        ubo.irradianceSH[6].rgb * 0.315392 * (3.0 * n.z * n.z - 1.0) +
+        ubo.irradianceSH[7].rgb * 1.092548 * n.x * n.z +
+        ubo.irradianceSH[8].rgb * 0.546274 * (n.x * n.x - n.y * n.y);
+
+    return max(result, vec3(0.0));
+}
+
+/*
+ * Fresnel-Schlick with a roughness term, to avoid too bright rims on rough surfaces
+ * when the light is integrated over the whole hemisphere.
+ */
+vec3 fresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness) {
+    return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow5(1.0 - cosTheta);
+}
+
+/*
+ * Computes the ambient lighting of a surface from the environment:
+ * diffuse from the spherical harmonics and specular with the split sum approximation.
+ *
+ * The environment is scaled by the ambient light color and intensity, the same way the
+ * ray tracer scales the sky radiance.
+ */
+vec3 computeEnvironmentLighting(vec3 surfaceNormal, vec3 viewDirection, vec3 albedo, float metallic, float roughness) {
+    float NdotV = max(dot(surfaceNormal, viewDirection), 1e-4);
+
+    vec3 F0 = mix(vec3(0.04), albedo, metallic);
+    vec3 F = fresnelSchlickRoughness(NdotV, F0, roughness);
+
+    // Diffuse
+    vec3 diffuseWeight = (1.0 - F) * (1.0 - metallic);
+    vec3 diffuse = diffuseWeight * albedo * evaluateIrradianceSH(surfaceNormal);
+
+    // Specular
+    vec3 reflection = reflect(-viewDirection, surfaceNormal);
+    float maxLod = float(textureQueryLevels(prefilteredEnvironmentMap) - 1);
+    vec3 prefilteredColor = textureLod(prefilteredEnvironmentMap, reflection, roughness * maxLod).rgb;
+    vec2 brdf = texture(brdfLut, vec2(NdotV, roughness)).rg;
+    vec3 specular = prefilteredColor * (F0 * brdf.x + brdf.y);
+
+    return (diffuse + specular) * ubo.ambientLightColor.rgb * ubo.ambientLightColor.w;
+}
+
+#endif
@@ -9,39 +9,98 @@
 #define PCF_RADIUS 0.003
 
 /*
- * Computes the shadow factor for the fragment based on the distance to the light source
+ * The atlas tiles of a point light, one per cube face (see ShadowMapRenderSystem).
+ */
+struct ShadowLight {
+    vec4 faceRects[6]; // .xy = uv offset of the face tile in the atlas, .zw = uv size
+    vec4 position;     // .xyz = the position the tiles were rendered from
+    vec4 params;       // .x = 1 if the light is shadowed, .y = size of a texel at distance 1
+};
+
+layout(set = 2, binding = 0) uniform sampler2D shadowAtlas;
+
+layout(set = 2, binding = 1) uniform ShadowAtlasTable {
+    mat4 faceViewProjections[6]; // the same for every light, from the light position
+    ShadowLight lights[MAX_LIGHTS];
+} shadowTable;
+
+// spread over a sphere, fewer than the 27 of a full 3x3x3 kernel as it is paid per light
+const vec3 PCF_OFFSETS[20] = vec3[](
+    vec3( 1,  1,  1), vec3( 1, -1,  1), vec3(-1, -1,  1), vec3(-1,  1,  1),
+    vec3( 1,  1, -1), vec3( 1, -1, -1), vec3(-1, -1, -1), vec3(-1,  1, -1),
+    vec3( 1,  1,  0), vec3( 1, -1,  0), vec3(-1, -1,  0), vec3(-1,  1,  0),
+    vec3( 1,  0,  1), vec3(-1,  0,  1), vec3( 1,  0, -1), vec3(-1,  0, -1),
+    vec3( 0,  1,  1), vec3( 0, -1,  1), vec3( 0, -1, -1), vec3( 0,  1, -1)
+);
+
+/*
+ * The cube face a direction from the light falls in, in the CubeFace order (+X, -X, +Y, -Y, +Z, -Z).
+ */
+int getShadowCubeFace(vec3 direction) {
+    vec3 absDirection = abs(direction);
+
+    if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z) {
+        return direction.x > 0.0 ? 0 : 1;
+    }
+    if (absDirection.y >= absDirection.z) {
+        return direction.y > 0.0 ? 2 : 3;
+    }
+    return direction.z > 0.0 ? 4 : 5;
+}
+
+/*
+ * Samples the distance to the closest occluder stored in the atlas for a direction from the light.
+ *
+ * The direction is projected on its cube face like the face was rendered, and the sample is
+ * kept half a texel inside the tile so that it never reads the neighbouring tiles.
+ */
+float sampleShadowAtlas(ShadowLight light, vec3 lightVec) {
+    int face = getShadowCubeFace(lightVec);
+
+    vec4 clipPos = shadowTable.faceViewProjections[face] * vec4(lightVec, 1.0);
+    vec2 faceUV = clipPos.xy / clipPos.w * 0.5 + 0.5;
+
+    vec4 rect = light.faceRects[face];
+    vec2 halfTexel = 0.5 / (rect.zw * vec2(textureSize(shadowAtlas, 0)));
+    faceUV = clamp(faceUV, halfTexel, 1.0 - halfTexel);
+
+    return textureLod(shadowAtlas, rect.xy + faceUV * rect.zw, 0.0).r;
+}
+
+/*
+ * Computes the shadow factor of a point light for the fragment based on the distance to the light source
  *
  * Determines whether the fragment is in shadow by comparing the distance from
- * the fragment to the light against the sampled depth from the cube map.
- * A bias is applied to avoid shadow acne artifacts.
+ * the fragment to the light against the distances sampled around it in the light tiles.
+ * A bias is applied to avoid shadow acne artifacts, larger for the smaller tiles.
+ * The lights without tiles are not shadowed.
  */
-float computeShadowFactor(samplerCube shadowCubeMap, vec3 surfaceNormal, vec3 fragPosWorld) {
-    vec3 lightVec = fragPosWorld - ubo.pointLights[0].position.xyz;
+float computeShadowFactor(int lightIndex, vec3 surfaceNormal, vec3 fragPosWorld) {
+    ShadowLight light = shadowTable.lights[lightIndex];
+    if (light.params.x == 0.0) {
+        return 1.0;
+    }
+
+    vec3 lightVec = fragPosWorld - light.position.xyz;
     vec3 lightDir = normalize(lightVec);
-    float bias = max(SHADOW_BIAS * (1.0 - dot(surfaceNormal, lightDir)), SHADOW_BIAS_MIN);
     float dist = length(lightVec);
 
+    // a texel covers more of the surface the further it is from the light
+    float texelSize = light.params.y * dist;
+    float bias = max(SHADOW_BIAS * (1.0 - dot(surfaceNormal, lightDir)), SHADOW_BIAS_MIN) + texelSize;
+    float filterRadius = PCF_RADIUS + texelSize;
+
     float shadow = 0.0;
 
-    int totalSamples = 0;
-    float sampledDist = 0.0;
-
-    for (int x = -1; x <= 1; ++x) {
-        for (int y = -1; y <= 1; ++y) {
-            for (int z = -1; z <= 1; ++z) {
-                vec3 offset = vec3(x, y, z);
-                vec3 offsetDir = normalize(lightVec + (offset * PCF_RADIUS));
-                sampledDist = texture(shadowCubeMap, offsetDir).r;
-                if (dist > sampledDist + bias) {
-                    shadow += 1.0;
-                }
-                totalSamples++;
-            }
+    for (int i = 0; i < PCF_OFFSETS.length(); i++) {
+        float sampledDist = sampleShadowAtlas(light, lightVec + PCF_OFFSETS[i] * filterRadius);
+        if (dist > sampledDist + bias) {
+            shadow += 1.0;
         }
     }
 
-    float shadowFactor = 1.0 - (shadow / float(totalSamples));
+    float shadowFactor = 1.0 - (shadow / float(PCF_OFFSETS.length()));
     return mix(SHADOW_OPACITY, 1.0, shadowFactor); // soft blend
 }
 
-#endif
\ No newline at end of file
+#endif
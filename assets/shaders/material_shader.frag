@@ -1,11 +1,27 @@
 #version 460
 #extension GL_EXT_nonuniform_qualifier : enable
 #extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
 
 #include "ubo/global_ubo.glsl"
+#include "common/scene_object.glsl"
+#include "common/material.glsl"
 #include "material/surface_normal.glsl"
 #include "lighting/blinn_phong_lighting.glsl"
 #include "lighting/shadow_map.glsl"
+#include "lighting/environment_lighting.glsl"
+
+// The material features are set by the shader variants (see material_shader_variants.hpp),
+// compiled without MATERIAL_VARIANT (the precompiled shader) every feature is enabled
+#ifndef MATERIAL_VARIANT
+#define HAS_ALBEDO_MAP
+#define HAS_NORMAL_MAP
+#define HAS_AMBIENT_OCCLUSION_MAP
+#define IS_EMISSIVE
+#define HAS_EMISSIVE_MAP
+#define HAS_POINT_LIGHTS
+#define HAS_SHADOWS
+#endif
 
 layout(location = 0) in vec3 fragPosWorld;
 layout(location = 1) in vec3 fragNormalWorld;
@@ -18,51 +34,84 @@ layout(location = 0) out vec4 outColor;
 // #include "ubo/global_ubo.glsl"
 // layout(set = 0, binding = 0) uniform _ubo { GlobalUbo ubo; };
 layout(set = 1, binding = 0) uniform sampler2D textures[];
-layout(set = 2, binding = 0) uniform samplerCube shadowCubeMap;
+// set 2 is the shadow atlas, see lighting/shadow_map.glsl
+
+layout(set = 4, binding = 0, std430) readonly buffer SceneObjectsSSBO {
+    SceneObject o[];
+} sceneObjects;
+
+layout(set = 5, binding = 0, std430) readonly buffer MaterialsSSBO {
+    Material m[];
+} materials;
 
 layout(push_constant) uniform Push {
-    mat4 modelMatrix;
-    mat4 normalMatrix;
-    vec4 color;
-    float specularIntensity;
-    float shininess;
-    int textureIndex;
-    int normalMapIndex;
-    int ambientOcclusionMapIndex;
-    int metallicMapIndex;
-	int roughnessMapIndex;
-    float tilingFactor;
+    uint objectIndex;
 } push;
 
 /*
  * Applies ambient occlusion to the given color using the ambient occlusion map.
  */
-void applyAmbientOcclusion(inout vec3 color, vec2 texCoords) {
-    float ao = texture(textures[push.ambientOcclusionMapIndex], texCoords).r;
+void applyAmbientOcclusion(inout vec3 color, vec2 texCoords, int ambientOcclusionMapIndex) {
+    float ao = texture(textures[ambientOcclusionMapIndex], texCoords).r;
     color *= ao;
 }
 
 void main() {
-    vec2 texCoords = fragUV * push.tilingFactor;
+    SceneObject object = sceneObjects.o[push.objectIndex];
+    Material material = materials.m[object.materialIndex];
 
-    vec3 surfaceNormal = calculateSurfaceNormal(textures[push.normalMapIndex], texCoords, fragTBN);
+    vec2 texCoords = fragUV * object.textureTilingFactor;
+
+#ifdef HAS_NORMAL_MAP
+    vec3 surfaceNormal = calculateSurfaceNormal(textures[material.normalMapIndex], texCoords, fragTBN);
+#else
+    vec3 surfaceNormal = normalize(fragTBN[2]);
+#endif
 
     vec3 cameraPosWorld = ubo.inverseViewMatrix[3].xyz;
     vec3 viewDirection = normalize(cameraPosWorld - fragPosWorld);
 
-    vec3 diffuseLight, specularLight;
-    computeBlinnPhongLighting(surfaceNormal, viewDirection, fragPosWorld, 
-        push.shininess, push.specularIntensity, diffuseLight, specularLight);
+    // every point light is dimmed by its own shadow, the environment is not shadowed
+    vec3 diffuseLight = vec3(0.0);
+    vec3 specularLight = vec3(0.0);
+#ifdef HAS_POINT_LIGHTS
+    for (int i = 0; i < ubo.numLights; i++) {
+#ifdef HAS_SHADOWS
+        float shadow = computeShadowFactor(i, surfaceNormal, fragPosWorld);
+#else
+        float shadow = 1.0;
+#endif
+        addBlinnPhongPointLight(ubo.pointLights[i], surfaceNormal, viewDirection, fragPosWorld,
+            material.blinnPhongSpecularShininess, material.blinnPhongSpecularIntensity, shadow, diffuseLight, specularLight);
+    }
+#endif
 
-    vec3 imageColor = texture(textures[push.textureIndex], texCoords).rgb;
+    vec3 albedo = material.albedoColor.rgb * object.textureTintColor.rgb;
+#ifdef HAS_ALBEDO_MAP
+    albedo *= texture(textures[material.albedoMapIndex], texCoords).rgb;
+#endif
 
     // we need to add control coefficients to regulate both terms (diffuse/specular)
     // for now we use fragColor for both which is ideal for metallic objects
-    vec3 baseColor = (diffuseLight * push.color.rgb + specularLight * push.color.rgb) * imageColor;
+    vec3 directColor = (diffuseLight + specularLight) * albedo;
+
+    vec3 ambientColor = computeEnvironmentLighting(surfaceNormal, viewDirection, albedo,
+        clamp(material.metallic, 0.0, 1.0), clamp(material.roughness, 0.0, 1.0));
+
+    vec3 baseColor = directColor + ambientColor;
 
-    applyAmbientOcclusion(baseColor, texCoords);
+#ifdef HAS_AMBIENT_OCCLUSION_MAP
+    applyAmbientOcclusion(baseColor, texCoords, material.ambientOcclusionMapIndex);
+#endif
 
-    float shadow = computeShadowFactor(shadowCubeMap, surfaceNormal, fragPosWorld);
+#ifdef IS_EMISSIVE
+    // the variant is only used by emissive materials, non emissive ones have alpha 0 anyway
+    vec3 emission = material.emissiveColor.rgb * material.emissiveColor.a;
+#ifdef HAS_EMISSIVE_MAP
+    emission *= texture(textures[material.emissiveMapIndex], texCoords).rgb;
+#endif
+    baseColor += emission;
+#endif
 
-    outColor = vec4(baseColor * shadow, 1.0);
+    outColor = vec4(baseColor, 1.0);
 }
@@ -1,7 +1,9 @@
 #version 460
 #extension GL_GOOGLE_include_directive : require
+#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require
 
 #include "ubo/global_ubo.glsl"
+#include "common/scene_object.glsl"
 #include "material/surface_normal.glsl"
 
 layout(location = 0) in vec4 position;
@@ -14,26 +16,23 @@ layout(location = 1) out vec3 fragNormalWorld;
 layout(location = 2) out vec2 fragUV;
 layout(location = 3) out mat3 fragTBN;
 
+layout(set = 4, binding = 0, std430) readonly buffer SceneObjectsSSBO {
+	SceneObject o[];
+} sceneObjects;
+
 layout(push_constant) uniform Push {
-	mat4 modelMatrix;
-	mat4 normalMatrix;
-	vec4 color;
-	float specularIntensity;
-	float shininess;
-	int textureIndex;
-	int normalMapIndex;
-	int ambientOcclusionMapIndex;
-	int metallicMapIndex;
-	int roughnessMapIndex;
-	float tilingFactor;
+	uint objectIndex;
 } push;
 
-
 void main() {
-	vec4 positionWorld = push.modelMatrix * position;
+	SceneObject object = sceneObjects.o[push.objectIndex];
+
+	vec4 positionWorld = object.objectToWorld * position;
 	gl_Position = ubo.projectionMatrix * ubo.viewMatrix * positionWorld;
 
-	mat3 TBN = calculateTBN(normal, tangent, mat3(push.normalMatrix));
+	// inverse transpose of the model matrix, the inverse is already in the scene buffer
+	mat3 normalMatrix = transpose(mat3(object.worldToObject));
+	mat3 TBN = calculateTBN(normal, tangent, normalMatrix);
  
 	fragPosWorld = positionWorld.xyz;
 	fragNormalWorld = vec3(normal);
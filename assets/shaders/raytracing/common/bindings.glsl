@@ -3,6 +3,8 @@
 
 #extension GL_EXT_scalar_block_layout : require
 
+#include "../../common/scene_object.glsl"
+
 layout(set = 1, binding = 0) uniform accelerationStructureEXT TLAS;
 
 layout(set = 2, binding = 0) uniform sampler2D textures[];
@@ -16,9 +18,10 @@ layout(set = 4, binding = 0, std430, scalar) readonly buffer materialsSSBO {
     Material m[];
 } materials;
 
-layout(set = 6, binding = 0, std430) readonly buffer meshInstancesSSBO {
-    MeshInstanceDescription i[];
-} meshInstances;
+// persistent scene buffer, indexed by gl_InstanceCustomIndexEXT (see GpuScene)
+layout(set = 6, binding = 0, std430) readonly buffer sceneObjectsSSBO {
+    SceneObject o[];
+} sceneObjects;
 
 layout(set = 7, binding = 0, std430) readonly buffer emittersSSBO {
     uint numEmitters;
@@ -29,6 +32,12 @@ layout(set = 8, binding = 0, std430) readonly buffer volumesSSBO {
     Volume volumes[];
 } volumes;
 
+// bricks of the volumes density grids, see brick_atlas.glsl
+layout(set = 8, binding = 1) uniform sampler3D brickAtlas;
+layout(set = 8, binding = 2, std430) readonly buffer brickTableSSBO {
+    BrickEntry entries[];
+} brickTable;
+
 layout(set = 9, binding = 0, std430) readonly buffer blueNoiseSSBO {
     uint indeces[]; // Indices of the blue noise textures in the texture array
 } blueNoiseTextures;
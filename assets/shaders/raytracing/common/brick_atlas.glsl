@@ -0,0 +1,70 @@
+#ifndef _BRICK_ATLAS_
+#define _BRICK_ATLAS_
+
+#include "bindings.glsl"
+
+// must match the constants of VolumeBrickAtlas
+#define BRICK_SIZE 8
+#define BRICK_EMPTY 4294967295u
+#define BRICK_SLOTS_PER_ROW 16
+#define BRICK_SLOTS_PER_LAYER (BRICK_SLOTS_PER_ROW * BRICK_SLOTS_PER_ROW)
+
+bool hasDensityGrid(Volume volume) {
+    return volume.densityGrid.w != BRICK_EMPTY;
+}
+
+// Reads the density grid of the volume at the given position, in the [0, 1] range
+// over the grid. The grid is not filtered: bricks are stored without borders.
+float sampleDensityGrid(Volume volume, vec3 uvw) {
+    if (any(lessThan(uvw, vec3(0.0))) || any(greaterThanEqual(uvw, vec3(1.0)))) return 0.0;
+
+    uvec3 resolution = volume.densityGrid.xyz;
+    uvec3 voxel = min(uvec3(uvw * vec3(resolution)), resolution - 1u);
+
+    uvec3 brickGridSize = (resolution + BRICK_SIZE - 1) / BRICK_SIZE;
+    uvec3 brick = voxel / BRICK_SIZE;
+    uint entryIndex = volume.densityGrid.w + (brick.z * brickGridSize.y + brick.y) * brickGridSize.x + brick.x;
+
+    uint slot = brickTable.entries[entryIndex].atlasSlot;
+    if (slot == BRICK_EMPTY) return 0.0;
+
+    uvec3 slotOrigin = uvec3(
+        slot % BRICK_SLOTS_PER_ROW,
+        (slot / BRICK_SLOTS_PER_ROW) % BRICK_SLOTS_PER_ROW,
+        slot / BRICK_SLOTS_PER_LAYER
+    ) * BRICK_SIZE;
+
+    return texelFetch(brickAtlas, ivec3(slotOrigin + voxel % BRICK_SIZE), 0).r;
+}
+
+// Majorant of the brick containing the given position, for the delta tracking to skip the
+// empty bricks and to take short steps only in the dense ones.
+// uvwDirection is the derivative of uvw along the ray: tExit is the distance along the ray
+// after which the brick is left and the majorant has to be looked up again. Out of the grid
+// the majorant is 0 and tExit is the distance to the grid (FLT_MAX if the ray misses it).
+float getBrickMajorant(Volume volume, vec3 uvw, vec3 uvwDirection, out float tExit) {
+    vec3 resolution = vec3(volume.densityGrid.xyz);
+    vec3 position = uvw * resolution;
+    vec3 direction = uvwDirection * resolution;
+
+    if (any(lessThan(position, vec3(0.0))) || any(greaterThanEqual(position, resolution))) {
+        vec2 t = intersectAABB(position, direction, vec3(0.0), resolution);
+        tExit = t.x <= t.y && t.x > 0.0 ? t.x : FLT_MAX;
+        return 0.0;
+    }
+
+    // on a brick boundary, the brick the ray is going into
+    vec3 biasedPosition = position - vec3(lessThan(direction, vec3(0.0))) * 1e-4;
+    uvec3 brick = uvec3(max(biasedPosition, vec3(0.0))) / BRICK_SIZE;
+
+    vec3 brickMin = vec3(brick * BRICK_SIZE);
+    vec3 brickMax = min(brickMin + BRICK_SIZE, resolution);
+    tExit = intersectAABB(position, direction, brickMin, brickMax).y;
+
+    uvec3 brickGridSize = (volume.densityGrid.xyz + BRICK_SIZE - 1) / BRICK_SIZE;
+    uint entryIndex = volume.densityGrid.w + (brick.z * brickGridSize.y + brick.y) * brickGridSize.x + brick.x;
+
+    return brickTable.entries[entryIndex].majorant;
+}
+
+#endif
@@ -31,7 +31,7 @@ EmitterSample sampleEmitterAt(uint emitterIndex, uint faceIndex, vec2 barycentri
     smpl.faceIndex = faceIndex;
 
     const Emitter emitter = emitters.e[emitterIndex];  
-    const MeshInstanceDescription instance = meshInstances.i[emitter.instanceIndex];
+    const SceneObject instance = sceneObjects.o[emitter.instanceIndex];
     const Material material = materials.m[instance.materialIndex];
 
     const Triangle triangle = getTriangle(instance.indexAddress, instance.vertexAddress, faceIndex);
@@ -140,14 +140,14 @@ vec3 evaluateTransmittance(inout EmitterSample emitterSample, vec3 worldPosition
         }
 
         uint instanceIndex = uint(p_visibility.instance);
-        const MeshInstanceDescription instance = meshInstances.i[instanceIndex];
+        const SceneObject instance = sceneObjects.o[instanceIndex];
 
         uint topStackInstanceIndex = interactionStack[stackPtr];
         int volumeIndex;
         bool doVolumeInteraction = false;
 
         if (topStackInstanceIndex != INVALID_INDEX) {
-            const MeshInstanceDescription topStackInstance = meshInstances.i[topStackInstanceIndex];
+            const SceneObject topStackInstance = sceneObjects.o[topStackInstanceIndex];
             // if we had a volume still in the stack, we need to do medium interaction before popping it
             doVolumeInteraction = topStackInstance.volumeIndex != INVALID_INDEX;
             volumeIndex = int(topStackInstance.volumeIndex);
@@ -267,7 +267,7 @@ vec3 evaluateTransmittance(inout EmitterSample emitterSample, vec3 worldPosition
 void sampleEmitter(uint emitterIndex, vec3 worldPosition, out EmitterSample smpl, inout uint seed) {
     // Sample a mesh emitter
     const Emitter emitter = emitters.e[emitterIndex];
-    const MeshInstanceDescription emitterInstance = meshInstances.i[emitter.instanceIndex];
+    const SceneObject emitterInstance = sceneObjects.o[emitter.instanceIndex];
     const Material material = materials.m[emitterInstance.materialIndex];
         
     const uint faceIndex = nextUint(seed, emitter.numberOfFaces);
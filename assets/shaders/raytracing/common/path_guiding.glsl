@@ -0,0 +1,181 @@
+#ifndef _PATH_GUIDING_RT_
+#define _PATH_GUIDING_RT_
+
+#include "../../common/math.glsl"
+
+/*
+ * Path guiding (see PathGuidingSystem).
+ *
+ * The scene bounds are divided in a grid of cells, each with a histogram of the radiance
+ * arriving at the cell from every direction. The directions are binned with an equal area
+ * mapping of the sphere (cos theta and phi in uniform steps): every bin covers the same solid
+ * angle, so a direction sampled uniformly in a bin has the same pdf everywhere in it.
+ *
+ * The path tracer splats the radiance it finds coming to its first surface vertices, divided
+ * by the pdf of the direction it came from (so that the bins estimate the integral of the
+ * incident radiance over their solid angle), and the training pass folds the splats into
+ * the running estimates and rebuilds the cdf of every cell between frames.
+ */
+
+// the compute shaders bind the guiding buffers on their own set
+#ifndef PATH_GUIDING_SET
+#define PATH_GUIDING_SET 11
+#endif
+
+// must match PathGuidingSystem
+#define GUIDING_GRID_RESOLUTION 16
+#define GUIDING_PHI_BINS 16u
+#define GUIDING_COS_BINS 8u
+#define GUIDING_BIN_COUNT (GUIDING_PHI_BINS * GUIDING_COS_BINS)
+
+// the splats are added with integer atomics, in fixed point
+#define GUIDING_FIXED_POINT_SCALE 16.0
+#define GUIDING_MAX_FIXED_POINT 0xFFFFFFFFu
+
+// bounds a single splat, a firefly would otherwise take over the distribution of its cell
+#define GUIDING_MAX_SPLAT 1024.0
+
+// the share of the distribution spread on all the directions, so that none is left out
+// because it was never sampled
+#define GUIDING_UNIFORM_WEIGHT 0.1
+
+// the path vertices a cell needs to have recorded before its distribution is sampled
+#define GUIDING_MIN_CELL_SAMPLES 64.0
+
+// the narrower lobes are left to the BSDF, a bin of the distribution is much wider than them
+#define GUIDING_MIN_ROUGHNESS 0.3
+
+layout(set = PATH_GUIDING_SET, binding = 0, std430) readonly buffer GuidingGridSSBO {
+    vec4 origin;      // xyz: min corner of the grid in world space
+    vec4 invCellSize; // xyz: cells per world unit
+} guidingGrid;
+
+// splatted by the path tracer since the last training, per cell and bin, in fixed point
+layout(set = PATH_GUIDING_SET, binding = 1, std430) buffer GuidingSplatsSSBO {
+    uint guidingSplats[];
+};
+
+// path vertices recorded since the last training, per cell
+layout(set = PATH_GUIDING_SET, binding = 2, std430) buffer GuidingSampleCountsSSBO {
+    uint guidingSampleCounts[];
+};
+
+// sum of the splats since the reset (aged when objects move), per cell and bin
+layout(set = PATH_GUIDING_SET, binding = 3, std430) buffer GuidingEstimatesSSBO {
+    float guidingEstimates[];
+};
+
+// inclusive cdf of the bins, per cell and bin
+layout(set = PATH_GUIDING_SET, binding = 4, std430) buffer GuidingCdfSSBO {
+    float guidingCdf[];
+};
+
+// per cell, x: sum of the estimates (0 if nothing was found), y: path vertices recorded since the reset
+layout(set = PATH_GUIDING_SET, binding = 5, std430) buffer GuidingCellsSSBO {
+    vec2 guidingCells[];
+};
+
+/**
+ * @brief The cell of the grid containing a world position, the positions out of the
+ * scene bounds go to the closest cell.
+ */
+uint getGuidingCell(vec3 worldPosition) {
+    ivec3 cell = ivec3(floor((worldPosition - guidingGrid.origin.xyz) * guidingGrid.invCellSize.xyz));
+    cell = clamp(cell, ivec3(0), ivec3(GUIDING_GRID_RESOLUTION - 1));
+
+    return uint(cell.x + GUIDING_GRID_RESOLUTION * (cell.y + GUIDING_GRID_RESOLUTION * cell.z));
+}
+
+/**
+ * @brief The bin of a world space direction.
+ */
+uint getGuidingBin(vec3 direction) {
+    const float u = direction.z * 0.5 + 0.5;
+    const float v = atan(direction.y, direction.x) * INV_TWO_PI + 0.5;
+
+    const uint cosBin = min(uint(u * GUIDING_COS_BINS), GUIDING_COS_BINS - 1u);
+    const uint phiBin = min(uint(v * GUIDING_PHI_BINS), GUIDING_PHI_BINS - 1u);
+
+    return cosBin * GUIDING_PHI_BINS + phiBin;
+}
+
+bool isGuidingCellTrained(uint cell) {
+    const vec2 cellData = guidingCells[cell];
+    return cellData.x > 0.0 && cellData.y >= GUIDING_MIN_CELL_SAMPLES;
+}
+
+/**
+ * @brief The solid angle pdf of a bin: its probability over the solid angle of a bin (4 pi / bin count).
+ */
+float getGuidingBinPdf(uint cell, uint bin) {
+    const uint base = cell * GUIDING_BIN_COUNT;
+    const float probability = guidingCdf[base + bin] - (bin > 0u ? guidingCdf[base + bin - 1] : 0.0);
+
+    return probability * (GUIDING_BIN_COUNT / (4.0 * PI));
+}
+
+/**
+ * @brief The pdf with which sampleGuiding() returns a world space direction.
+ */
+float pdfGuiding(uint cell, vec3 direction) {
+    return getGuidingBinPdf(cell, getGuidingBin(direction));
+}
+
+/**
+ * @brief Samples a world space direction from the distribution of a trained cell.
+ *
+ * @param cell The cell of the grid.
+ * @param u Three uniform random numbers in [0, 1): the first picks the bin, the others the direction in it.
+ * @param pdf Output: the solid angle pdf of the direction.
+ */
+vec3 sampleGuiding(uint cell, vec3 u, out float pdf) {
+    const uint base = cell * GUIDING_BIN_COUNT;
+
+    // first bin whose cdf is above u.x
+    uint bin = 0u;
+    uint count = GUIDING_BIN_COUNT;
+    while (count > 0u) {
+        const uint halfCount = count / 2u;
+        if (guidingCdf[base + bin + halfCount] <= u.x) {
+            bin += halfCount + 1u;
+            count -= halfCount + 1u;
+        } else {
+            count = halfCount;
+        }
+    }
+    bin = min(bin, GUIDING_BIN_COUNT - 1u);
+
+    pdf = getGuidingBinPdf(cell, bin);
+
+    const uint cosBin = bin / GUIDING_PHI_BINS;
+    const uint phiBin = bin % GUIDING_PHI_BINS;
+
+    const float cosTheta = (float(cosBin) + u.y) / GUIDING_COS_BINS * 2.0 - 1.0;
+    const float phi = ((float(phiBin) + u.z) / GUIDING_PHI_BINS - 0.5) * TWO_PI;
+    const float sinTheta = sqrt(max(0.0, 1.0 - pow2(cosTheta)));
+
+    return vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+}
+
+/**
+ * @brief Adds an estimate of the radiance arriving at a cell from the directions of a bin.
+ *
+ * @param rounding A uniform random number in [0, 1): the fixed point value is rounded
+ * stochastically, the small splats would otherwise all be lost.
+ */
+void splatGuiding(uint cell, uint bin, float value, float rounding) {
+    const uint fixedPointValue = uint(min(value, GUIDING_MAX_SPLAT) * GUIDING_FIXED_POINT_SCALE + rounding);
+
+    if (fixedPointValue > 0u) {
+        const uint index = cell * GUIDING_BIN_COUNT + bin;
+
+        // a bin of a bright cell can collect more than a uint holds in a frame: the adds that
+        // wrap around saturate it instead (the later adds see it full and saturate it again)
+        const uint previous = atomicAdd(guidingSplats[index], fixedPointValue);
+        if (previous > GUIDING_MAX_FIXED_POINT - fixedPointValue) {
+            atomicMax(guidingSplats[index], GUIDING_MAX_FIXED_POINT);
+        }
+    }
+}
+
+#endif
@@ -8,14 +8,9 @@ layout(push_constant) uniform RayTracingPushConstantData {
 	bool selectSingleTextures;  // Whether to select single textures or use
 							    // different blue noise textures every frame
 
-	// temporary
-	float metalness;
-	float roughness;
-	float transmission;
-	float ior;
-	vec4 albedo;
-	
 	uint blueNoiseDebugIndex;   // Index of the blue noise texture to use in case selectSingleTextures is true
+	uint samplesPerPixel;       // Chosen each frame to fit the GPU time budget
+	float guidingProbability;   // Chance of sampling the path guiding distribution, 0 when guiding is off
 } push;
 
 #endif
\ No newline at end of file
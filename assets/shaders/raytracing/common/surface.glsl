@@ -44,7 +44,7 @@ float getMetalness(const Material material, const vec2 uv) {
 	return clamp(metallic, 0.0, 1.0);
 }
 
-SurfaceData getSurfaceData(const MeshInstanceDescription instance, const Material material, const vec2 uv, const mat3 tbn, bool isBackFace) {
+SurfaceData getSurfaceData(const SceneObject instance, const Material material, const vec2 uv, const mat3 tbn, bool isBackFace) {
     SurfaceData surface;
     surface.tbn = tbn;
     surface.isBackFace = isBackFace;
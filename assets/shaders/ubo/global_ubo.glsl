@@ -13,6 +13,7 @@ layout(set = 0, binding = 0) uniform GlobalUbo {
     PointLight pointLights[MAX_LIGHTS];
     int numLights;
     uint frameCount;
+    vec4 irradianceSH[9]; // L2 spherical harmonics of the environment (rgb), see IBL::IrradianceSH
 } ubo;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace PXTEngine::Bench {
+
+	/**
+	 * @brief State handed to every benchmark body.
+	 *
+	 * The body iterates over the state with a range-for; every iteration is one
+	 * measured run of the code under test:
+	 *
+	 *     PXT_BENCHMARK("uuid/generate") {
+	 *         for (auto _ : state) {
+	 *             doNotOptimize(UUID());
+	 *         }
+	 *     }
+	 *
+	 * Expensive per-iteration setup can be excluded from the measurement with
+	 * pauseTiming() / resumeTiming().
+	 */
+	class State {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit State(const uint64_t iterations) : m_iterations(iterations) {}
+
+		// Value produced by each iteration, empty on purpose (it only drives the range-for).
+		struct [[maybe_unused]] Value {};
+
+		struct Iterator {
+			State* state;
+			uint64_t remaining;
+
+			bool operator!=(const Iterator&) const {
+				if (remaining != 0) return true;
+				state->stop();
+				return false;
+			}
+			void operator++() { remaining--; }
+			Value operator*() const { return {}; }
+		};
+
+		Iterator begin() {
+			start();
+			return { this, m_iterations };
+		}
+		Iterator end() { return { this, 0 }; }
+
+		void pauseTiming() { m_elapsed += Clock::now() - m_start; }
+		void resumeTiming() { m_start = Clock::now(); }
+
+		/**
+		 * @brief Declares how many logical items (entities, vertices, ...) one
+		 * iteration processes, used to report a throughput.
+		 */
+		void setItemsPerIteration(const uint64_t items) { m_itemsPerIteration = items; }
+
+		uint64_t iterations() const { return m_iterations; }
+		uint64_t itemsPerIteration() const { return m_itemsPerIteration; }
+		double elapsedSeconds() const { return std::chrono::duration<double>(m_elapsed).count(); }
+
+	private:
+		void start() {
+			m_elapsed = Clock::duration::zero();
+			m_start = Clock::now();
+		}
+		void stop() { m_elapsed += Clock::now() - m_start; }
+
+		uint64_t m_iterations;
+		uint64_t m_itemsPerIteration = 1;
+		Clock::time_point m_start;
+		Clock::duration m_elapsed = Clock::duration::zero();
+	};
+
+	using BenchmarkFn = std::function<void(State&)>;
+
+	struct Benchmark {
+		std::string name;
+		BenchmarkFn fn;
+	};
+
+	std::vector<Benchmark>& registry();
+
+	struct Registrar {
+		Registrar(std::string name, BenchmarkFn fn) {
+			registry().push_back({ std::move(name), std::move(fn) });
+		}
+	};
+
+	/**
+	 * @brief Prevents the compiler from optimizing away a computed value.
+	 */
+	template <typename T>
+	inline void doNotOptimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+}
+
+#define PXT_BENCH_CONCAT_IMPL(a, b) a##b
+#define PXT_BENCH_CONCAT(a, b) PXT_BENCH_CONCAT_IMPL(a, b)
+
+// Defines and registers a benchmark, the body receives a `PXTEngine::Bench::State& state`.
+#define PXT_BENCHMARK(name) \
+	static void PXT_BENCH_CONCAT(pxtBenchmark_, __LINE__)(PXTEngine::Bench::State& state); \
+	static PXTEngine::Bench::Registrar PXT_BENCH_CONCAT(pxtBenchmarkRegistrar_, __LINE__)( \
+		name, PXT_BENCH_CONCAT(pxtBenchmark_, __LINE__)); \
+	static void PXT_BENCH_CONCAT(pxtBenchmark_, __LINE__)([[maybe_unused]] PXTEngine::Bench::State& state)
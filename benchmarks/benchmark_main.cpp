@@ -0,0 +1,168 @@
+#include "benchmark.hpp"
+
+#include "core/allocation_tracker.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace PXTEngine::Bench {
+
+	std::vector<Benchmark>& registry() {
+		static std::vector<Benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	namespace {
+
+		struct Options {
+			const char* filter = nullptr;   // substring a benchmark name must contain
+			double minTime = 0.5;           // seconds each benchmark should at least run for
+			const char* jsonPath = nullptr; // file the results are also written to
+		};
+
+		struct SubsystemAllocations {
+			std::string subsystem;
+			uint64_t allocationCount = 0;
+			uint64_t allocatedBytes = 0;
+		};
+
+		struct Result {
+			std::string name;
+			uint64_t iterations = 0;
+			double nsPerIteration = 0.0;
+			double itemsPerSecond = 0.0;
+			std::vector<SubsystemAllocations> allocations; // of the measured run, setup included
+		};
+
+		Options parseOptions(int argc, char** argv) {
+			Options options;
+			for (int i = 1; i < argc; i++) {
+				if (std::strncmp(argv[i], "--filter=", 9) == 0) {
+					options.filter = argv[i] + 9;
+				} else if (std::strncmp(argv[i], "--min-time=", 11) == 0) {
+					options.minTime = std::atof(argv[i] + 11);
+				} else if (std::strncmp(argv[i], "--json=", 7) == 0) {
+					options.jsonPath = argv[i] + 7;
+				} else {
+					std::printf("usage: %s [--filter=<substring>] [--min-time=<seconds>] [--json=<path>]\n", argv[0]);
+					std::exit(1);
+				}
+			}
+			return options;
+		}
+
+		/**
+		 * @brief Allocations made per subsystem between two snapshots of the allocation tracker
+		 * (empty unless built with PXT_TRACK_ALLOCATIONS).
+		 */
+		std::vector<SubsystemAllocations> diffAllocations(
+			const std::vector<AllocationTracker::SubsystemStats>& before,
+			const std::vector<AllocationTracker::SubsystemStats>& after) {
+			std::vector<SubsystemAllocations> allocations;
+			for (size_t i = 0; i < after.size(); i++) {
+				const uint64_t countBefore = i < before.size() ? before[i].allocationCount : 0;
+				const uint64_t bytesBefore = i < before.size() ? before[i].allocatedBytes : 0;
+				if (after[i].allocationCount == countBefore) continue;
+
+				allocations.push_back({ after[i].name, after[i].allocationCount - countBefore, after[i].allocatedBytes - bytesBefore });
+			}
+			return allocations;
+		}
+
+		void writeJson(const char* path, const std::vector<Result>& results) {
+			FILE* file = std::fopen(path, "w");
+			if (!file) {
+				std::printf("could not open %s for writing\n", path);
+				std::exit(1);
+			}
+
+			std::fprintf(file, "{\n  \"allocation_tracking\": %s,\n  \"benchmarks\": [", AllocationTracker::isEnabled() ? "true" : "false");
+			for (size_t i = 0; i < results.size(); i++) {
+				const Result& result = results[i];
+				std::fprintf(file, "%s\n    {\n", i > 0 ? "," : "");
+				std::fprintf(file, "      \"name\": \"%s\",\n", result.name.c_str());
+				std::fprintf(file, "      \"iterations\": %llu,\n", static_cast<unsigned long long>(result.iterations));
+				std::fprintf(file, "      \"ns_per_iteration\": %.3f,\n", result.nsPerIteration);
+				std::fprintf(file, "      \"items_per_second\": %.6g,\n", result.itemsPerSecond);
+				std::fprintf(file, "      \"allocations\": [");
+				for (size_t j = 0; j < result.allocations.size(); j++) {
+					const SubsystemAllocations& allocations = result.allocations[j];
+					const double iterations = static_cast<double>(result.iterations);
+					std::fprintf(file, "%s\n        { \"subsystem\": \"%s\", \"count\": %llu, \"bytes\": %llu, \"count_per_iteration\": %.3f, \"bytes_per_iteration\": %.3f }",
+						j > 0 ? "," : "",
+						allocations.subsystem.c_str(),
+						static_cast<unsigned long long>(allocations.allocationCount),
+						static_cast<unsigned long long>(allocations.allocatedBytes),
+						static_cast<double>(allocations.allocationCount) / iterations,
+						static_cast<double>(allocations.allocatedBytes) / iterations);
+				}
+				std::fprintf(file, "%s]\n    }", result.allocations.empty() ? "" : "\n      ");
+			}
+			std::fprintf(file, "\n  ]\n}\n");
+			std::fclose(file);
+		}
+
+		/**
+		 * @brief Runs a benchmark with a growing iteration count until it runs
+		 * for at least minTime seconds, and returns the state of the final run.
+		 */
+		State measure(const Benchmark& benchmark, const double minTime, std::vector<SubsystemAllocations>& allocations) {
+			uint64_t iterations = 1;
+			while (true) {
+				const std::vector<AllocationTracker::SubsystemStats> statsBefore = AllocationTracker::getStats();
+
+				State state(iterations);
+				benchmark.fn(state);
+
+				const double elapsed = state.elapsedSeconds();
+				if (elapsed >= minTime || iterations >= (1ull << 40)) {
+					allocations = diffAllocations(statsBefore, AllocationTracker::getStats());
+					return state;
+				}
+
+				// Aim a bit past the target so we converge in a couple of runs.
+				const double scale = elapsed > 0.0 ? (minTime * 1.4) / elapsed : 10.0;
+				iterations = static_cast<uint64_t>(static_cast<double>(iterations) * std::min(std::max(scale, 2.0), 100.0));
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	using namespace PXTEngine::Bench;
+
+	const Options options = parseOptions(argc, argv);
+
+	std::printf("%-48s %14s %12s %16s\n", "Benchmark", "Time/iter", "Iterations", "Items/s");
+	std::printf("%s\n", std::string(93, '-').c_str());
+
+	std::vector<Result> results;
+
+	for (const Benchmark& benchmark : registry()) {
+		if (options.filter && benchmark.name.find(options.filter) == std::string::npos) continue;
+
+		Result result;
+		const State state = measure(benchmark, options.minTime, result.allocations);
+
+		result.name = benchmark.name;
+		result.iterations = state.iterations();
+		result.nsPerIteration = state.elapsedSeconds() * 1e9 / static_cast<double>(state.iterations());
+		result.itemsPerSecond = static_cast<double>(state.iterations() * state.itemsPerIteration()) / state.elapsedSeconds();
+
+		std::printf("%-48s %11.1f ns %12llu %16.4g\n",
+			result.name.c_str(),
+			result.nsPerIteration,
+			static_cast<unsigned long long>(result.iterations),
+			result.itemsPerSecond);
+
+		results.push_back(std::move(result));
+	}
+
+	if (options.jsonPath) {
+		writeJson(options.jsonPath, results);
+	}
+
+	return 0;
+}
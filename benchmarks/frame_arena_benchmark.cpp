@@ -0,0 +1,56 @@
+#include "benchmark.hpp"
+
+#include "core/frame_arena.hpp"
+
+using namespace PXTEngine;
+using namespace PXTEngine::Bench;
+
+namespace {
+	constexpr uint32_t ELEMENT_COUNT = 1024;
+}
+
+PXT_BENCHMARK("frame_arena/std_vector_push_back") {
+	state.setItemsPerIteration(ELEMENT_COUNT);
+	for (auto _ : state) {
+		std::vector<uint64_t> values;
+		for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+			values.push_back(i);
+		}
+		doNotOptimize(values.data());
+	}
+}
+
+PXT_BENCHMARK("frame_arena/frame_vector_push_back") {
+	state.setItemsPerIteration(ELEMENT_COUNT);
+	for (auto _ : state) {
+		// one frame per iteration, like the render systems see it
+		FrameArena::beginFrame();
+
+		FrameVector<uint64_t> values;
+		for (uint32_t i = 0; i < ELEMENT_COUNT; i++) {
+			values.push_back(i);
+		}
+		doNotOptimize(values.data());
+	}
+}
+
+PXT_BENCHMARK("frame_arena/sort_lights") {
+	// Mirrors the back to front sort of PointLightSystem::render
+	constexpr uint32_t lightCount = 64;
+
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<float> distances(0.0f, 100.0f);
+
+	state.setItemsPerIteration(lightCount);
+	for (auto _ : state) {
+		FrameArena::beginFrame();
+
+		FrameVector<std::pair<float, entt::entity>> sorted;
+		for (uint32_t i = 0; i < lightCount; i++) {
+			sorted.emplace_back(distances(generator), static_cast<entt::entity>(i));
+		}
+		std::ranges::sort(sorted, std::ranges::greater{}, &std::pair<float, entt::entity>::first);
+
+		doNotOptimize(sorted.data());
+	}
+}
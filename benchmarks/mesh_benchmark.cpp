@@ -0,0 +1,70 @@
+#include "benchmark.hpp"
+
+#include "resources/importers/mesh_importer.hpp"
+#include "resources/types/mesh.hpp"
+
+using namespace PXTEngine;
+using namespace PXTEngine::Bench;
+
+namespace {
+	/**
+	 * @brief Vertices of an indexed grid, emitted once per triangle corner like the obj loader does,
+	 * so that every inner vertex appears up to six times.
+	 */
+	std::vector<Mesh::Vertex> makeTriangleSoup(const uint32_t gridSize) {
+		auto makeVertex = [gridSize](const uint32_t x, const uint32_t y) {
+			const float u = static_cast<float>(x) / static_cast<float>(gridSize);
+			const float v = static_cast<float>(y) / static_cast<float>(gridSize);
+
+			Mesh::Vertex vertex{};
+			vertex.position = { u, 0.0f, v, 1.0f };
+			vertex.normal = { 0.0f, 1.0f, 0.0f, 1.0f };
+			vertex.uv = { u, 1.0f - v, 1.0f, 1.0f };
+			return vertex;
+		};
+
+		std::vector<Mesh::Vertex> soup;
+		soup.reserve(static_cast<size_t>(gridSize) * gridSize * 6);
+		for (uint32_t y = 0; y < gridSize; y++) {
+			for (uint32_t x = 0; x < gridSize; x++) {
+				soup.push_back(makeVertex(x, y));
+				soup.push_back(makeVertex(x + 1, y));
+				soup.push_back(makeVertex(x, y + 1));
+
+				soup.push_back(makeVertex(x + 1, y));
+				soup.push_back(makeVertex(x + 1, y + 1));
+				soup.push_back(makeVertex(x, y + 1));
+			}
+		}
+		return soup;
+	}
+}
+
+PXT_BENCHMARK("mesh/vertex_hash") {
+	const std::vector<Mesh::Vertex> vertices = makeTriangleSoup(16);
+	const size_t count = vertices.size();
+	const std::hash<Mesh::Vertex> hasher;
+	size_t i = 0;
+	for (auto _ : state) {
+		doNotOptimize(hasher(vertices[i]));
+		if (++i == count) i = 0;
+	}
+}
+
+PXT_BENCHMARK("mesh/vertex_dedup") {
+	const std::vector<Mesh::Vertex> soup = makeTriangleSoup(128);
+
+	std::vector<Mesh::Vertex> vertices;
+	std::vector<uint32_t> indices;
+
+	state.setItemsPerIteration(soup.size());
+	for (auto _ : state) {
+		vertices.clear();
+		indices.clear();
+
+		MeshImporter::deduplicateVertices(soup, vertices, indices);
+
+		doNotOptimize(vertices.data());
+		doNotOptimize(indices.data());
+	}
+}
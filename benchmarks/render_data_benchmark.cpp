@@ -0,0 +1,202 @@
+#include "benchmark.hpp"
+
+#include "graphics/raytracing_scene_data.hpp"
+#include "graphics/scene_object_table.hpp"
+#include "graphics/resources/material_data.hpp"
+#include "resources/resource_manager.hpp"
+#include "resources/types/image.hpp"
+#include "scene/ecs/component.hpp"
+#include "scene/ecs/entity.hpp"
+
+using namespace PXTEngine;
+using namespace PXTEngine::Bench;
+
+namespace PXTEngine {
+	// resource_manager.cpp is not compiled in, every material here sets all of its maps
+	Shared<Material> ResourceManager::defaultMaterial = nullptr;
+}
+
+namespace {
+	constexpr uint32_t MATERIAL_COUNT = 64;
+	constexpr uint32_t INSTANCE_COUNT = 10000;
+	constexpr uint32_t MOVING_INSTANCE_COUNT = 100;
+
+	// Stand-ins for the Vulkan resources, only their ids and sizes are read on the CPU
+
+	class BenchImage : public Image {
+	public:
+		uint32_t getWidth() override { return 1; }
+		uint32_t getHeight() override { return 1; }
+		uint16_t getChannels() override { return 4; }
+		ImageFormat getFormat() override { return RGBA8_SRGB; }
+		Type getType() const override { return Type::Image; }
+	};
+
+	class BenchMesh : public Mesh {
+	public:
+		const uint32_t getVertexCount() const override { return 2562; }
+		const uint32_t getIndexCount() const override { return 15360; }
+		Type getType() const override { return Type::Mesh; }
+	};
+
+	std::vector<Shared<Material>> makeMaterials(const uint32_t count) {
+		const Shared<Image> image = createShared<BenchImage>();
+
+		std::vector<Shared<Material>> materials;
+		materials.reserve(count);
+		for (uint32_t i = 0; i < count; i++) {
+			// one material out of eight is an emitter
+			const glm::vec4 emissive = i % 8 == 0 ? glm::vec4(1.0f, 1.0f, 1.0f, 5.0f) : glm::vec4(0.0f);
+
+			materials.push_back(Material::Builder()
+				.setAlbedoMap(image)
+				.setNormalMap(image)
+				.setAmbientOcclusionMap(image)
+				.setEmissiveMap(image)
+				.setMetallicMap(i % 2 == 0 ? image : nullptr)
+				.setRoughness(0.5f)
+				.setEmissiveColor(emissive)
+				.build());
+		}
+		return materials;
+	}
+
+	// Index lookups as cheap as possible, the benchmarks measure the packing and the scene walk
+	uint32_t hashIndex(const ResourceId& id) {
+		return static_cast<uint32_t>(std::hash<ResourceId>()(id) & 0xFFFF);
+	}
+
+	RayTracingSceneData::Resolver makeResolver() {
+		RayTracingSceneData::Resolver resolver;
+		resolver.getMeshAddresses = [](const ResourceHandle<Mesh>, const Mesh& mesh) {
+			const auto address = reinterpret_cast<VkDeviceAddress>(&mesh);
+			return RayTracingSceneData::MeshAddresses{ address, address + 1, address + 2 };
+		};
+		resolver.getMaterialIndex = hashIndex;
+		resolver.getTextureIndex = hashIndex;
+		return resolver;
+	}
+
+	Unique<Scene> makeRayTracingScene(ResourcePools& resources, const std::vector<Shared<Material>>& materials, const uint32_t instanceCount) {
+		Unique<Scene> scene = createUnique<Scene>();
+		const ResourceHandle<Mesh> mesh = resources.get<Mesh>().acquire(createShared<BenchMesh>());
+
+		std::vector<ResourceHandle<Material>> materialHandles;
+		for (const Shared<Material>& material : materials) {
+			materialHandles.push_back(resources.get<Material>().acquire(material));
+		}
+
+		for (uint32_t i = 0; i < instanceCount; i++) {
+			const float t = static_cast<float>(i);
+
+			Entity entity = scene->createEntity("instance");
+			entity.add<TransformComponent>(glm::vec3(t, 0.0f, -t), glm::vec3(1.0f), glm::vec3(0.0f, t * 0.01f, 0.0f));
+			entity.add<MeshComponent>(mesh);
+			entity.add<MaterialComponent>(materialHandles[i % materialHandles.size()], 1.0f, glm::vec3(1.0f));
+
+			// a few volumes without density grid, like the default fog
+			if (i % 100 == 0) {
+				entity.add<VolumeComponent>(VolumeComponent::Volume{ .absorption = glm::vec4(0.1f), .scattering = glm::vec4(0.5f) });
+			}
+		}
+		return scene;
+	}
+}
+
+PXT_BENCHMARK("material/pack_material_data") {
+	const std::vector<Shared<Material>> materials = makeMaterials(MATERIAL_COUNT);
+	uint32_t i = 0;
+	for (auto _ : state) {
+		doNotOptimize(packMaterialData(*materials[i++ & (MATERIAL_COUNT - 1)], hashIndex));
+	}
+}
+
+PXT_BENCHMARK("raytracing/build_scene_data_10k") {
+	// The CPU part of GpuScene::update on a static scene: the render packets are reused and
+	// nothing is queued for upload
+	const std::vector<Shared<Material>> materials = makeMaterials(MATERIAL_COUNT);
+	ResourcePools resources;
+	Unique<Scene> scene = makeRayTracingScene(resources, materials, INSTANCE_COUNT);
+	const RayTracingSceneData::Resolver resolver = makeResolver();
+
+	RayTracingSceneData sceneData;
+	SceneObjectTable objects;
+
+	state.setItemsPerIteration(INSTANCE_COUNT);
+	for (auto _ : state) {
+		sceneData.build(*scene, resources, resolver, objects);
+		objects.clearUpdates();
+		doNotOptimize(sceneData.instances.data());
+	}
+}
+
+PXT_BENCHMARK("raytracing/rebuild_scene_data_10k") {
+	// Same scene with every render packet out of date, e.g. after toggling ray tracing
+	const std::vector<Shared<Material>> materials = makeMaterials(MATERIAL_COUNT);
+	ResourcePools resources;
+	Unique<Scene> scene = makeRayTracingScene(resources, materials, INSTANCE_COUNT);
+	const RayTracingSceneData::Resolver resolver = makeResolver();
+
+	RayTracingSceneData sceneData;
+	SceneObjectTable objects;
+
+	state.setItemsPerIteration(INSTANCE_COUNT);
+	for (auto _ : state) {
+		RayTracingSceneData::invalidate(*scene);
+		sceneData.build(*scene, resources, resolver, objects);
+		objects.clearUpdates();
+		doNotOptimize(sceneData.instances.data());
+	}
+}
+
+PXT_BENCHMARK("gpu_scene/build_10k_moving_100") {
+	// Same walk with a few entities moving every frame, only those are queued for upload
+	const std::vector<Shared<Material>> materials = makeMaterials(MATERIAL_COUNT);
+	ResourcePools resources;
+	Unique<Scene> scene = makeRayTracingScene(resources, materials, INSTANCE_COUNT);
+	const RayTracingSceneData::Resolver resolver = makeResolver();
+
+	std::vector<TransformComponent*> movingTransforms;
+	for (auto [entityHandle, transform] : scene->getEntitiesWith<TransformComponent>().each()) {
+		if (movingTransforms.size() == MOVING_INSTANCE_COUNT) break;
+		movingTransforms.push_back(&transform);
+	}
+
+	RayTracingSceneData sceneData;
+	SceneObjectTable objects;
+	float offset = 0.0f;
+
+	state.setItemsPerIteration(INSTANCE_COUNT);
+	for (auto _ : state) {
+		offset += 0.01f;
+		for (TransformComponent* transform : movingTransforms) {
+			transform->translation.y = offset;
+		}
+
+		sceneData.build(*scene, resources, resolver, objects);
+		doNotOptimize(objects.getUpdates().data());
+		objects.clearUpdates();
+	}
+}
+
+PXT_BENCHMARK("resources/resolve_handle") {
+	// The lookup done per entity and per pass by the render systems
+	ResourcePools resources;
+	std::vector<ResourceHandle<Mesh>> handles;
+	for (uint32_t i = 0; i < MATERIAL_COUNT; i++) {
+		handles.push_back(resources.get<Mesh>().acquire(createShared<BenchMesh>()));
+	}
+
+	uint32_t i = 0;
+	for (auto _ : state) {
+		doNotOptimize(resources.resolve(handles[i++ & (MATERIAL_COUNT - 1)]));
+	}
+}
+
+PXT_BENCHMARK("raytracing/to_vk_transform_matrix") {
+	const TransformComponent transform(glm::vec3(1.0f, 2.0f, 3.0f), glm::vec3(2.0f), glm::vec3(0.1f, 0.2f, 0.3f));
+	const glm::mat4 matrix = transform.mat4();
+	for (auto _ : state) {
+		doNotOptimize(RayTracingSceneData::toVkTransformMatrix(matrix));
+	}
+}
@@ -0,0 +1,93 @@
+#include "benchmark.hpp"
+
+#include "core/uuid.hpp"
+#include "scene/scene.hpp"
+#include "scene/scene_parser.hpp"
+#include "scene/ecs/component.hpp"
+#include "scene/ecs/entity.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+using namespace PXTEngine;
+using namespace PXTEngine::Bench;
+
+namespace {
+	constexpr uint32_t SCENE_ENTITY_COUNT = 1000;
+
+	/**
+	 * @brief Writes a .pxtscene document with the layout produced by SceneSerializer::serialize.
+	 */
+	std::string makeSceneDocument(const uint32_t entityCount) {
+		YAML::Emitter out;
+		out << YAML::BeginMap;
+		out << YAML::Key << "scene" << YAML::Value << "Benchmark-Scene";
+		out << YAML::Key << "entities" << YAML::Value << YAML::BeginSeq;
+
+		for (uint32_t i = 0; i < entityCount; i++) {
+			const float t = static_cast<float>(i);
+
+			out << YAML::BeginMap;
+			out << YAML::Key << "entity" << YAML::Value << UUID().toString();
+			out << YAML::Key << "NameComponent" << YAML::Value << "entity " + std::to_string(i);
+
+			out << YAML::Key << "MaterialComponent" << YAML::Value << YAML::BeginMap;
+			out << YAML::Key << "materialId" << YAML::Value << UUID().toString();
+			out << YAML::Key << "albedoColor" << YAML::Value << YAML::Flow << std::vector<float>{ 1.0f, 1.0f, 1.0f, 1.0f };
+			out << YAML::Key << "metallic" << YAML::Value << 0.0f;
+			out << YAML::Key << "roughness" << YAML::Value << 0.5f;
+			out << YAML::Key << "emissiveColor" << YAML::Value << YAML::Flow << std::vector<float>{ 0.0f, 0.0f, 0.0f, 0.0f };
+			out << YAML::Key << "tilingFactor" << YAML::Value << 1.0f;
+			out << YAML::Key << "tint" << YAML::Value << YAML::Flow << std::vector<float>{ 1.0f, 1.0f, 1.0f };
+			out << YAML::EndMap;
+
+			out << YAML::Key << "TransformComponent" << YAML::Value << YAML::BeginMap;
+			out << YAML::Key << "translation" << YAML::Value << YAML::Flow << std::vector<float>{ t, 0.0f, -t };
+			out << YAML::Key << "scale" << YAML::Value << YAML::Flow << std::vector<float>{ 1.0f, 1.0f, 1.0f };
+			out << YAML::Key << "rotation" << YAML::Value << YAML::Flow << std::vector<float>{ 0.0f, t * 0.01f, 0.0f };
+			out << YAML::EndMap;
+
+			out << YAML::Key << "MeshComponent" << YAML::Value << YAML::BeginMap;
+			out << YAML::Key << "meshId" << YAML::Value << UUID().toString();
+			out << YAML::Key << "mesh" << YAML::Value << "../assets/models/sphere.obj";
+			out << YAML::EndMap;
+
+			out << YAML::EndMap;
+		}
+
+		out << YAML::EndSeq;
+		out << YAML::EndMap;
+		return out.c_str();
+	}
+}
+
+PXT_BENCHMARK("scene_serializer/load_yaml") {
+	const std::string document = makeSceneDocument(SCENE_ENTITY_COUNT);
+
+	state.setItemsPerIteration(SCENE_ENTITY_COUNT);
+	for (auto _ : state) {
+		doNotOptimize(YAML::Load(document));
+	}
+}
+
+PXT_BENCHMARK("scene_serializer/parse_entities") {
+	// The parse step of SceneSerializer::deserialize, the mesh and material components are
+	// left out: they are added once the resource manager has imported what they reference.
+	const std::string document = makeSceneDocument(SCENE_ENTITY_COUNT);
+
+	state.setItemsPerIteration(SCENE_ENTITY_COUNT);
+	for (auto _ : state) {
+		Unique<Scene> scene = createUnique<Scene>();
+		std::vector<EntityResourceNodes> resourceNodes;
+
+		const YAML::Node data = YAML::Load(document);
+		doNotOptimize(data["scene"].as<std::string>());
+
+		SceneParser::parseEntities(*scene, data["entities"], resourceNodes);
+		doNotOptimize(resourceNodes.data());
+
+		state.pauseTiming();
+		resourceNodes.clear();
+		scene.reset();
+		state.resumeTiming();
+	}
+}
@@ -0,0 +1,95 @@
+#include "benchmark.hpp"
+
+#include "scene/scene.hpp"
+#include "scene/ecs/component.hpp"
+#include "scene/ecs/entity.hpp"
+
+using namespace PXTEngine;
+using namespace PXTEngine::Bench;
+
+namespace {
+	constexpr uint32_t TRANSFORM_COUNT = 1024;
+
+	std::vector<TransformComponent> makeTransforms(const uint32_t count) {
+		std::vector<TransformComponent> transforms(count);
+		for (uint32_t i = 0; i < count; i++) {
+			const float t = static_cast<float>(i);
+			transforms[i].translation = { t, t * 0.5f, -t };
+			transforms[i].scale = { 1.0f + t * 0.001f, 1.0f, 2.0f };
+			transforms[i].rotation = { t * 0.01f, t * 0.02f, t * 0.03f };
+		}
+		return transforms;
+	}
+
+	Unique<Scene> makeTransformScene(const uint32_t entityCount) {
+		Unique<Scene> scene = createUnique<Scene>();
+		const std::vector<TransformComponent> transforms = makeTransforms(entityCount);
+		for (uint32_t i = 0; i < entityCount; i++) {
+			Entity entity = scene->createEntity("entity");
+			entity.add<TransformComponent>(transforms[i]);
+
+			// half of the entities also have a color, so that the multi-component view has to skip some
+			if (i % 2 == 0) {
+				entity.add<ColorComponent>(glm::vec3(1.0f));
+			}
+		}
+		return scene;
+	}
+}
+
+PXT_BENCHMARK("transform/mat4") {
+	const std::vector<TransformComponent> transforms = makeTransforms(TRANSFORM_COUNT);
+	uint32_t i = 0;
+	for (auto _ : state) {
+		doNotOptimize(transforms[i++ & (TRANSFORM_COUNT - 1)].mat4());
+	}
+}
+
+PXT_BENCHMARK("transform/normal_matrix") {
+	const std::vector<TransformComponent> transforms = makeTransforms(TRANSFORM_COUNT);
+	uint32_t i = 0;
+	for (auto _ : state) {
+		doNotOptimize(transforms[i++ & (TRANSFORM_COUNT - 1)].normalMatrix());
+	}
+}
+
+PXT_BENCHMARK("scene/view_transforms_10k") {
+	constexpr uint32_t entityCount = 10000;
+	Unique<Scene> scene = makeTransformScene(entityCount);
+
+	state.setItemsPerIteration(entityCount);
+	for (auto _ : state) {
+		// what the render systems do every frame to build their push constants
+		auto view = scene->getEntitiesWith<TransformComponent>();
+		for (auto entity : view) {
+			doNotOptimize(view.get<TransformComponent>(entity).mat4());
+		}
+	}
+}
+
+PXT_BENCHMARK("scene/view_transforms_100k") {
+	constexpr uint32_t entityCount = 100000;
+	Unique<Scene> scene = makeTransformScene(entityCount);
+
+	state.setItemsPerIteration(entityCount);
+	for (auto _ : state) {
+		auto view = scene->getEntitiesWith<TransformComponent>();
+		for (auto entity : view) {
+			doNotOptimize(view.get<TransformComponent>(entity).mat4());
+		}
+	}
+}
+
+PXT_BENCHMARK("scene/view_transform_color_100k") {
+	constexpr uint32_t entityCount = 100000;
+	Unique<Scene> scene = makeTransformScene(entityCount);
+
+	state.setItemsPerIteration(entityCount / 2);
+	for (auto _ : state) {
+		auto view = scene->getEntitiesWith<TransformComponent, ColorComponent>();
+		for (auto entity : view) {
+			const auto& [transform, color] = view.get<TransformComponent, ColorComponent>(entity);
+			doNotOptimize(transform.translation + color.color);
+		}
+	}
+}
@@ -0,0 +1,98 @@
+#include "benchmark.hpp"
+
+#include "core/uuid.hpp"
+#include "scene/scene.hpp"
+#include "scene/ecs/entity.hpp"
+
+using namespace PXTEngine;
+using namespace PXTEngine::Bench;
+
+namespace {
+	constexpr uint64_t BULK_ENTITY_COUNT = 10000;
+
+	std::vector<std::string> makeUUIDStrings(const size_t count) {
+		std::vector<std::string> strings;
+		strings.reserve(count);
+		for (size_t i = 0; i < count; i++) {
+			strings.push_back(UUID().toString());
+		}
+		return strings;
+	}
+}
+
+PXT_BENCHMARK("uuid/generate_v7") {
+	for (auto _ : state) {
+		doNotOptimize(UUID());
+	}
+}
+
+PXT_BENCHMARK("uuid/generate_v4") {
+	for (auto _ : state) {
+		doNotOptimize(UUID(V4));
+	}
+}
+
+PXT_BENCHMARK("uuid/to_string") {
+	const UUID uuid;
+	for (auto _ : state) {
+		doNotOptimize(uuid.toString());
+	}
+}
+
+PXT_BENCHMARK("uuid/to_chars") {
+	const UUID uuid;
+	char buffer[UUID::STRING_LENGTH];
+	for (auto _ : state) {
+		uuid.toChars(buffer);
+		doNotOptimize(buffer);
+	}
+}
+
+PXT_BENCHMARK("uuid/parse") {
+	const std::vector<std::string> strings = makeUUIDStrings(1024);
+	size_t i = 0;
+	for (auto _ : state) {
+		doNotOptimize(UUID(strings[i++ & 1023]));
+	}
+}
+
+PXT_BENCHMARK("uuid/hash") {
+	std::vector<UUID> uuids(1024);
+	constexpr std::hash<UUID> hasher;
+	size_t i = 0;
+	for (auto _ : state) {
+		doNotOptimize(hasher(uuids[i++ & 1023]));
+	}
+}
+
+PXT_BENCHMARK("scene/create_entities_bulk") {
+	state.setItemsPerIteration(BULK_ENTITY_COUNT);
+	for (auto _ : state) {
+		Unique<Scene> scene = createUnique<Scene>();
+		for (uint64_t i = 0; i < BULK_ENTITY_COUNT; i++) {
+			doNotOptimize(scene->createEntity("entity"));
+		}
+
+		// exclude the scene teardown from the measurement
+		state.pauseTiming();
+		scene.reset();
+		state.resumeTiming();
+	}
+}
+
+PXT_BENCHMARK("scene/create_entities_bulk_from_strings") {
+	// Mirrors SceneSerializer::deserialize, which recreates every entity from its stored UUID string
+	const std::vector<std::string> strings = makeUUIDStrings(BULK_ENTITY_COUNT);
+
+	state.setItemsPerIteration(BULK_ENTITY_COUNT);
+	for (auto _ : state) {
+		Unique<Scene> scene = createUnique<Scene>();
+		for (const std::string& uuid : strings) {
+			doNotOptimize(scene->createEntity("entity", UUID(uuid)));
+		}
+
+		state.pauseTiming();
+		scene.reset();
+		state.resumeTiming();
+	}
+}